@@ -0,0 +1,243 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_ShaderInclude.h
+	Shader source preprocessing: '#include' directives are expanded on the
+		CPU before compiling, and the files each shader was built from are
+		recorded in a dependency graph so that only the shaders affected by
+		a changed file need to be rebuilt. Batches of files can be expanded
+		on worker threads while the graphics thread compiles.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_SHADERINCLUDE_H
+#define __ANIMAL3D_SHADERINCLUDE_H
+
+
+#include "animal3D-A3DG/a3graphics/a3_ShaderProgram.h"
+#include "animal3D/a3utility/a3_Stream.h"
+#include "animal3D/a3utility/a3_Thread.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_ShaderIncludeGraph	a3_ShaderIncludeGraph;
+	typedef struct a3_ShaderIncludeStage	a3_ShaderIncludeStage;
+	typedef struct a3_ShaderIncludeBatch	a3_ShaderIncludeBatch;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Limits of include expansion.
+	enum a3_ShaderIncludeMax
+	{
+		a3shader_includePathMax = 256,	// max length of a file path
+		a3shader_includeDepthMax = 16,	// max nesting of includes
+		a3shader_includeFileMax = 64,	// max unique files in one expansion
+		a3shader_includeThreadMax = 8,	// max worker threads in a batch
+	};
+
+
+	// A3: Dependency graph of shader source files. Nodes are files and
+	//		targets (user-defined indices, e.g. shaders); edges record
+	//		which files include which and which files each target was
+	//		built from directly.
+	//	member filePath: path of each file
+	//	member fileTime: modification time of each file when last read
+	//	member includeEdge: pairs of file indices (includer, included)
+	//	member targetEdge: pairs of target and file indices (target, file)
+	//	members fileCount, includeCount, targetEdgeCount: number in use
+	//	members fileCapacity, includeCapacity, targetEdgeCapacity: space
+	//	member targetCount: number of targets
+	struct a3_ShaderIncludeGraph
+	{
+		a3byte(*filePath)[a3shader_includePathMax];
+		a3i64 *fileTime;
+		a3ui32(*includeEdge)[2];
+		a3ui32(*targetEdge)[2];
+		a3ui32 fileCount, includeCount, targetEdgeCount;
+		a3ui32 fileCapacity, includeCapacity, targetEdgeCapacity;
+		a3ui32 targetCount;
+	};
+
+
+	// A3: Source file expanded by a batch.
+	//	member source: expanded source once done
+	//	member graph: files read for this source only, if tracking; 
+	//		merged into the batch owner's graph when the batch ends
+	//	member filePath: path of file
+	//	member sourceIndex: index of source in its shader's list of strings
+	//	member result: length of expanded source when done; 0 if failed
+	//	member done: raised when expansion has finished
+	struct a3_ShaderIncludeStage
+	{
+		a3_Stream source[1];
+		a3_ShaderIncludeGraph graph[1];
+		const a3byte *filePath;
+		a3ui32 sourceIndex;
+		a3ret result;
+		volatile a3boolean done;
+	};
+
+
+	// A3: Files being expanded on worker threads while the calling thread 
+	//		is free to compile the sources that are already done.
+	//	member thread: worker threads
+	//	member stageList: stages, one per file
+	//	member count: number of stages
+	//	member threadCount: number of worker threads launched
+	//	member next: index of next stage to be claimed by a worker
+	struct a3_ShaderIncludeBatch
+	{
+		a3_Thread thread[a3shader_includeThreadMax];
+		a3_ShaderIncludeStage *stageList;
+		a3ui32 count, threadCount;
+		volatile a3i32 next;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Create empty dependency graph.
+	//	param graph_out: non-null pointer to unused graph
+	//	param targetCount: non-zero number of targets to track
+	//	return: targetCount if success
+	//	return: 0 if failed to allocate
+	//	return: -1 if invalid params or graph already in-use
+	a3ret a3shaderIncludeGraphCreate(a3_ShaderIncludeGraph *graph_out, const a3ui32 targetCount);
+
+	// A3: Forget files recorded for target, e.g. before rebuilding it.
+	//	param graph: non-null pointer to created graph
+	//	param target: index of target in graph
+	//	return: number of edges removed
+	//	return: -1 if invalid params
+	a3ret a3shaderIncludeGraphClearTarget(a3_ShaderIncludeGraph *graph, const a3ui32 target);
+
+	// A3: Check recorded files for modification since they were last read
+	//		and flag every target that depends on a modified file, directly
+	//		or through includes. Modified files are not reported again.
+	//	param graph: non-null pointer to created graph
+	//	param targetChanged_out: non-null array of one flag per target; set
+	//		to 1 if target is affected, 0 otherwise
+	//	return: number of affected targets
+	//	return: -1 if invalid params
+	a3ret a3shaderIncludeGraphPoll(a3_ShaderIncludeGraph *graph, a3boolean *targetChanged_out);
+
+	// A3: Release dependency graph.
+	//	param graph: non-null pointer to created graph
+	//	return: 1 if success
+	//	return: -1 if invalid param or not created
+	a3ret a3shaderIncludeGraphRelease(a3_ShaderIncludeGraph *graph);
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Load shader source file and expand its '#include "path"' lines,
+	//		with paths relative to the including file. Each file is
+	//		expanded at most once, which also breaks include cycles;
+	//		'#line' directives keep compiler messages pointing at the
+	//		original line numbers, and '#version' lines in included files
+	//		are commented out. Directives inside comments are ignored.
+	//	param source_out: non-null pointer to unused stream; receives
+	//		null-terminated expanded source (release with stream release)
+	//	param filePath: non-null, non-empty cstring of file path
+	//	param sourceIndex: index of the expanded source in the list of 
+	//		strings it will be compiled with; '#line' directives name it
+	//	param graph_opt: optional graph to record dependencies in
+	//	param target: index of target to record file under (ignored if
+	//		graph is null)
+	//	return: length of expanded source if success
+	//	return: 0 if file or one of its includes could not be read
+	//	return: -1 if invalid params or stream already in-use
+	a3ret a3shaderIncludeResolve(a3_Stream *source_out, const a3byte *filePath, const a3ui32 sourceIndex, a3_ShaderIncludeGraph *graph_opt, const a3ui32 target);
+
+	// A3: Create GLSL shader from multiple text files with includes
+	//		expanded, recording dependencies; replaces previously recorded
+	//		dependencies of target.
+	//	param shader_out: non-null pointer to uninitialized shader descriptor
+	//	param name_opt: optional cstring for short name/description; max 31
+	//		chars + null terminator; pass null for default name
+	//	param type: shader type
+	//	param filePathList: non-null array of cstrings of shader file paths;
+	//		null or empty strings will be ignored
+	//	param count: non-zero file path string count
+	//	param graph_opt: optional graph to record dependencies in
+	//	param target: index of target in graph (ignored if graph is null)
+	//	return: number of sources compiled into shader if success
+	//	return: 0 if compile failed or no valid strings
+	//	return: -1 if invalid params or shader is already initialized
+	a3ret a3shaderCreateFromFileListTracked(a3_Shader *shader_out, const a3byte name_opt[32], const a3_ShaderType type, const a3byte **filePathList, const a3ui32 count, a3_ShaderIncludeGraph *graph_opt, const a3ui32 target);
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Start expanding list of source files on worker threads (see 
+	//		resolve above); returns immediately. Stages are expanded in 
+	//		list order, so waiting for them in order waits the least.
+	//	param batch_out: non-null pointer to unused batch
+	//	param stageList_out: non-null array of unused stages, one per file; 
+	//		must remain valid until batch ends
+	//	param filePathList: non-null array of cstrings of file paths; must 
+	//		remain valid until batch ends
+	//	param sourceIndexList_opt: optional index of each expanded source 
+	//		in the list of strings it will be compiled with (see resolve 
+	//		above); pass null if every file is compiled as the first
+	//	param count: non-zero number of files
+	//	param track: non-zero to record dependencies of each stage
+	//	param threadCount: number of worker threads; clamped to the range 
+	//		[1, include thread max] and to the number of files
+	//	return: number of worker threads launched
+	//	return: 0 if failed to launch threads (nothing started)
+	//	return: -1 if invalid params or batch already in-use
+	a3ret a3shaderIncludeBatchBegin(a3_ShaderIncludeBatch *batch_out, a3_ShaderIncludeStage *stageList_out, const a3byte **filePathList, const a3ui32 *sourceIndexList_opt, const a3ui32 count, const a3boolean track, const a3ui32 threadCount);
+
+	// A3: Wait until stage is done; its source may be used immediately.
+	//	param batch: non-null pointer to begun batch
+	//	param index: index of stage in batch
+	//	return: length of expanded source if success
+	//	return: 0 if stage failed
+	//	return: -1 if invalid params
+	a3ret a3shaderIncludeBatchWait(a3_ShaderIncludeBatch *batch, const a3ui32 index);
+
+	// A3: Wait for all stages, record their dependencies in graph and 
+	//		release their sources.
+	//	param batch: non-null pointer to begun batch
+	//	param graph_opt: optional graph to merge stage dependencies into; 
+	//		previous dependencies of every listed target are replaced
+	//	param targetList_opt: target of each stage in graph; required if 
+	//		graph is provided
+	//	return: number of stages that succeeded
+	//	return: -1 if invalid params or batch not begun
+	a3ret a3shaderIncludeBatchEnd(a3_ShaderIncludeBatch *batch, a3_ShaderIncludeGraph *graph_opt, const a3ui32 *targetList_opt);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_SHADERINCLUDE_H
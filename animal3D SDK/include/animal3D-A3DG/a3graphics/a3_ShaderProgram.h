@@ -62,7 +62,8 @@ extern "C"
 	// A3: GLSL shader object descriptor.
 	//	member handle: graphics handle container
 	//	member type: which type of shader is this
-	//	member compiled: compile status of shader (should be 1 after creation)
+	//	member compiled: compile status of shader (should be 1 after creation; 
+	//		negative while a deferred compile is pending)
 	//	member attached: counter for the number of programs using this shader 
 	//		(can be used more than once; in fact, it's better to load a shared 
 	//		shader and have it be used multiple times instead of loading it 
@@ -79,7 +80,8 @@ extern "C"
 	
 	// A3: GLSL shader program object descriptor.
 	//	member handle: graphics handle container
-	//	member linked: link status of program (can modify if not linked)
+	//	member linked: link status of program (can modify if not linked; 
+	//		negative while a deferred link is pending)
 	//	member validated: validation status of program (optional)
 	//	member shadersAttached: handles of each shader type attached to the 
 	//		program; only one shader of each type can be attached; compute 
@@ -166,6 +168,38 @@ extern "C"
 	//	return: -1 if invalid params or shader is already initialized
 	a3ret a3shaderCreateFromFileList(a3_Shader *shader_out, const a3byte name_opt[32], const a3_ShaderType type, const a3byte **filePathList, const a3ui32 count);
 
+	// A3: Create GLSL shader from multiple raw sources without waiting for 
+	//		the compiler; sources are copied and may be released right away. 
+	//		Where the driver supports parallel compiling 
+	//		(GL_KHR_parallel_shader_compile), compiling continues in the 
+	//		background; the shader may be attached while pending.
+	//	param shader_out: non-null pointer to uninitialized shader descriptor
+	//	param name_opt: optional cstring for short name/description; max 31 
+	//		chars + null terminator; pass null for default name
+	//	param type: shader type
+	//	param sourceList: non-null array of cstrings of GLSL shader sources; 
+	//		null or empty strings will be ignored
+	//	param count: non-zero source string count
+	//	return: number of sources submitted if success; shader is pending
+	//	return: 0 if no valid strings or shader could not be created
+	//	return: -1 if invalid params or shader is already initialized
+	a3ret a3shaderCreateFromSourceListDeferred(a3_Shader *shader_out, const a3byte name_opt[32], const a3_ShaderType type, const a3byte **sourceList, const a3ui32 count);
+
+	// A3: Check if deferred compile is done without waiting; always done 
+	//		if the driver does not compile in parallel.
+	//	param shader: non-null pointer to shader descriptor
+	//	return: 1 if done or not pending
+	//	return: 0 if still compiling
+	//	return: -1 if invalid param or internal handle is zero
+	a3ret a3shaderIsCompileDone(const a3_Shader *shader);
+
+	// A3: Wait for deferred compile to finish and check its result.
+	//	param shader: non-null pointer to pending shader descriptor
+	//	return: number of sources compiled into shader if success
+	//	return: 0 if compile failed; shader is released
+	//	return: -1 if invalid param, internal handle is zero or not pending
+	a3ret a3shaderFinishCompile(a3_Shader *shader);
+
 	// A3: Reference shader.
 	//	param shader: non-null pointer to shader descriptor to be referenced
 	//	return: reference count if success
@@ -221,6 +255,29 @@ extern "C"
 	//	return: -1 if invalid param or internal handle is zero
 	a3ret a3shaderProgramLink(a3_ShaderProgram *program);
 
+	// A3: Link program without waiting for the linker (see deferred 
+	//		compile above); the program must not be changed while pending.
+	//	param program: non-null pointer to program descriptor
+	//	return: 1 if success; link is pending
+	//	return: 0 if already linked
+	//	return: -1 if invalid param or internal handle is zero
+	a3ret a3shaderProgramLinkDeferred(a3_ShaderProgram *program);
+
+	// A3: Check if deferred link is done without waiting.
+	//	param program: non-null pointer to program descriptor
+	//	return: 1 if done or not pending
+	//	return: 0 if still linking
+	//	return: -1 if invalid param or internal handle is zero
+	a3ret a3shaderProgramIsLinkDone(const a3_ShaderProgram *program);
+
+	// A3: Wait for deferred link to finish and check its result; 
+	//		validating a pending program also finishes it.
+	//	param program: non-null pointer to pending program descriptor
+	//	return: 1 if success; program object cannot be changed
+	//	return: 0 if link failed
+	//	return: -1 if invalid param, internal handle is zero or not pending
+	a3ret a3shaderProgramFinishLink(a3_ShaderProgram *program);
+
 	// A3: Validate program; optional step after linking. This is used to 
 	//		identify hardware-specific problems that may occur with the 
 	//		attached shader objects.
@@ -231,11 +288,13 @@ extern "C"
 	a3ret a3shaderProgramValidate(a3_ShaderProgram *program);
 
 	// A3: Save program binary to file.
-	//	param program: non-null pointer to linked program
+	//	param program: non-null pointer to linked program; a deferred 
+	//		link must be finished first
 	//	param filePath: non-null, non-empty cstring of file location
 	//	return: 1 if success
 	//	return: 0 if failed
-	//	return: -1 if invalid param or internal handle is zero
+	//	return: -1 if invalid param, internal handle is zero or program is 
+	//		not linked
 	a3ret a3shaderProgramSaveBinary(const a3_ShaderProgram *program, const a3byte *filePath);
 
 	// A3: Load program binary from file.
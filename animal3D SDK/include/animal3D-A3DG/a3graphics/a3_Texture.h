@@ -30,6 +30,7 @@
 
 #include "animal3D/a3/a3types_integer.h"
 #include "a3_GraphicsObjectHandle.h"
+#include "a3_TextureCompress.h"
 
 
 #ifdef __cplusplus
@@ -38,6 +39,7 @@ extern "C"
 #else	// !__cplusplus
 	typedef struct a3_Texture						a3_Texture;
 	typedef struct a3_TexturePixelFormatDescriptor	a3_TexturePixelFormatDescriptor;
+	typedef struct a3_TextureStage					a3_TextureStage;
 	typedef enum a3_TexturePixelType				a3_TexturePixelType;
 	typedef enum a3_TextureUnit						a3_TextureUnit;
 	typedef enum a3_TextureFilterOption				a3_TextureFilterOption;
@@ -108,6 +110,9 @@ extern "C"
 		a3tex_depth24,			// 24-bit depth
 		a3tex_depth32,			// 32-bit depth (a3i32)
 		a3tex_depth24_stencil8,	// 24-bit depth with 8-bit stencil
+
+		// half-float red-green-blue-alpha
+		a3tex_rgba16F,			// 16 bits per channel (half)
 	};
 
 	// A3: Texture unit for activating textures.
@@ -138,11 +143,19 @@ extern "C"
 	};
 
 
+	// A3: Maximum number of threads decoding staged images.
+	enum a3_TextureStageThreadsMax
+	{
+		a3tex_stageThreadMax = 8
+	};
+
+
 	// A3: Texture setting options for filter.
 	enum a3_TextureFilterOption
 	{
 		a3tex_filterNearest,	// magnified pixels clamp to nearest neighbor
 		a3tex_filterLinear,		// magnified pixels blend with neighbors
+		a3tex_filterLinearMipmap,	// linear, minified pixels blend mip levels
 	};
 
 	// A3: Texture setting options for repeating textures.
@@ -153,6 +166,28 @@ extern "C"
 		a3tex_repeatNormal,		// texture repeats
 	};
 
+
+	// A3: Image decoded from file and staged in memory for upload.
+	//	member filePath: path of image file
+	//	member data: decoded pixels, in the same layout as files loaded 
+	//		directly (first row is the bottom of the image)
+	//	members width, height: the dimensions of the image
+	//	member pixelType: format of data (rgb8, rgb16, rgba8 or rgba16)
+	//	member compressFormat: if not none, data holds compressed blocks 
+	//		instead of pixels (see compressed cache below)
+	//	member size: size of data in bytes
+	//	member result: 1 if decoded; 0 if failed
+	struct a3_TextureStage
+	{
+		const a3byte *filePath;
+		void *data;
+		a3ui32 width, height;
+		a3_TexturePixelType pixelType;
+		a3_TextureCompressFormat compressFormat;
+		a3ui32 size;
+		a3ret result;
+	};
+
 	
 //-----------------------------------------------------------------------------
 
@@ -171,7 +206,20 @@ extern "C"
 	//	return: 0 if already initialized
 	a3ret a3textureInitializeImageLibrary();
 
-	// A3: Load texture from image file.
+	// A3: Enable or disable the compressed texture cache. While enabled, 
+	//		8-bit images loaded from files (directly or staged) are block 
+	//		compressed and saved to the cache directory the first time, and 
+	//		later loads of the same file contents use the cached blocks 
+	//		without decoding the image.
+	//	param cacheDir_opt: optional cstring of cache directory, created if 
+	//		missing; pass null or empty to disable the cache
+	//	param format: compression format to use; none disables the cache
+	//	return: 1 if enabled
+	//	return: 0 if disabled
+	a3ret a3textureSetCompressCache(const a3byte *cacheDir_opt, const a3_TextureCompressFormat format);
+
+	// A3: Load texture from image file; uses the compressed texture cache 
+	//		if it is enabled (see above).
 	//	param texture_out: non-null pointer to uninitialized texture
 	//	param name_opt: optional cstring for short name/description; max 31 
 	//		chars + null terminator; pass null for default name
@@ -181,6 +229,55 @@ extern "C"
 	//	return: -1 if invalid params or already initialized
 	a3ret a3textureCreateFromFile(a3_Texture *texture_out, const a3byte name_opt[32], const a3byte *filePath);
 
+	// A3: Decode list of image files into staged memory using multiple 
+	//		threads; does not touch the graphics context, so textures are 
+	//		created from the results afterwards on the context thread. 
+	//		Files are read ahead on a stream queue (one I/O thread, batched 
+	//		where the platform allows). If the compressed cache is enabled, 
+	//		cached images skip decoding and new ones are compressed on these 
+	//		threads. Limit: the image library (DevIL) is not re-entrant, so 
+	//		only one image decodes at a time, under one global lock shared 
+	//		with every other staged decode; extra threads only overlap cache 
+	//		lookups and compression with it, so lists of uncached images do 
+	//		not decode faster with more threads.
+	//	param stageList_out: non-null array of unused stages, one per file
+	//	param filePathList: non-null array of non-null file path cstrings
+	//	param count: number of files to decode
+	//	param threadCount: number of threads to use, including the calling 
+	//		thread; clamped to the range [1, thread max]
+	//	return: number of images decoded
+	//	return: -1 if invalid params
+	a3ret a3textureStageDecodeFileList(a3_TextureStage *stageList_out, const a3byte **filePathList, const a3ui32 count, const a3ui32 threadCount);
+
+	// A3: Create texture from staged image by allocating it and replacing 
+	//		its contents with the staged data; only uploads, no decoding.
+	//	param texture_out: non-null pointer to uninitialized texture
+	//	param name_opt: optional cstring for short name/description; max 31 
+	//		chars + null terminator; pass null for default name
+	//	param stage: non-null pointer to decoded stage
+	//	return: 1 if successful creation
+	//	return: 0 if creation failed or stage was not decoded
+	//	return: -1 if invalid params or already initialized
+	a3ret a3textureCreateFromStage(a3_Texture *texture_out, const a3byte name_opt[32], const a3_TextureStage *stage);
+
+	// A3: Create texture from block compressed image; compressed textures 
+	//		cannot have their data replaced.
+	//	param texture_out: non-null pointer to uninitialized texture
+	//	param name_opt: optional cstring for short name/description; max 31 
+	//		chars + null terminator; pass null for default name
+	//	param compressed: non-null pointer to compressed image
+	//	return: 1 if successful creation
+	//	return: 0 if creation failed
+	//	return: -1 if invalid params or already initialized
+	a3ret a3textureCreateFromCompressed(a3_Texture *texture_out, const a3byte name_opt[32], const a3_TextureCompressed *compressed);
+
+	// A3: Release staged image data.
+	//	param stage: non-null pointer to stage
+	//	return: 1 if released
+	//	return: 0 if stage holds no data
+	//	return: -1 if invalid param
+	a3ret a3textureStageRelease(a3_TextureStage *stage);
+
 	// A3: Create texture from raw data.
 	//	param texture_out: non-null pointer to uninitialized texture
 	//	param name_opt: optional cstring for short name/description; max 31 
@@ -206,6 +303,18 @@ extern "C"
 	//	return: -1 if invalid params or not initialized
 	a3ret a3textureReplaceData(const a3_Texture *texture, const a3ui32 offsetWidth, const a3ui32 offsetHeight, const a3ui32 replaceWidth, const a3ui32 replaceHeight, const void *data_opt, a3boolean dataFlipped);
 
+	// A3: Replace a whole mip level of a texture; levels above zero are 
+	//		half the size of the one before (at least 1) and are allocated 
+	//		when first replaced. Replaced levels become the texture's range.
+	//	param texture: non-null pointer to initialized texture
+	//	param level: mip level to replace; 0 is the base image
+	//	param data_opt: optional pointer to level data, not flipped; pass 
+	//		null to erase the level
+	//	return: 1 if successful
+	//	return: 0 if failed
+	//	return: -1 if invalid params or not initialized
+	a3ret a3textureReplaceDataLevel(const a3_Texture *texture, const a3ui32 level, const void *data_opt);
+
 	// A3: Use a texture for rendering.
 	//	param texture: pointer to initialized texture; pass null or 
 	//		uninitialized texture to deactivate
@@ -41,6 +41,7 @@ extern "C"
 #else	// !__cplusplus
 	typedef struct a3_TextureAtlas				a3_TextureAtlas;
 	typedef struct a3_TextureAtlasCell			a3_TextureAtlasCell;
+	typedef struct a3_TextureAtlasImage			a3_TextureAtlasImage;
 #endif	// __cplusplus
 
 
@@ -73,6 +74,18 @@ extern "C"
 		a3ui32 numCells;
 	};
 
+	// A3: Source image to be packed into a texture atlas.
+	//	member data: pixels of image, in the same format as the atlas and 
+	//		the same layout as textures (first row is the bottom)
+	//	members width, height: dimensions of image in pixels
+	//	member localOffset: local offset given to the image's cell
+	struct a3_TextureAtlasImage
+	{
+		const void *data;
+		a3ui32 width, height;
+		a3i32 localOffset[2];
+	};
+
 
 //-----------------------------------------------------------------------------
 
@@ -90,6 +103,7 @@ extern "C"
 	//	param textureAtlas: non-null pointer to uninitialized texture atlas
 	//	param numCells: non-zero number of cells to allocate
 	//	return: numCells if success
+	//	return: 0 if allocation failed
 	//	return: -1 if invalid params
 	a3ret a3textureAtlasAllocateCells(a3_TextureAtlas *textureAtlas, const a3ui32 numCells);
 
@@ -113,6 +127,43 @@ extern "C"
 	//	return: -1 if invalid params
 	a3ret a3textureAtlasAllocateEvenCells(a3_TextureAtlas *textureAtlas, const a3ui32 columns, const a3ui32 rows);
 
+	// A3: Arrange images in an atlas without overlap (skyline bottom-left); 
+	//		tries several atlas widths and keeps the smallest area that fits. 
+	//		Does not touch images or graphics, so it can be used offline.
+	//	param pixelOffsetList_out: non-null array of 2 * count integers to 
+	//		store the bottom-left corner of each image in the atlas
+	//	params atlasWidth_out, atlasHeight_out: non-null pointers to store 
+	//		the resulting atlas dimensions
+	//	param imageList: non-null array of images to pack; only dimensions 
+	//		are used, data may be null
+	//	param count: non-zero number of images
+	//	param maxSize: positive maximum width and height of the atlas
+	//	param padding: space kept around each image in pixels
+	//	param powerOfTwo: non-zero if atlas dimensions must be powers of two
+	//	return: count if all images were placed
+	//	return: 0 if images do not fit in the maximum size
+	//	return: -1 if invalid params
+	a3ret a3textureAtlasPackLayout(a3i32 *pixelOffsetList_out, a3ui32 *atlasWidth_out, a3ui32 *atlasHeight_out, const a3_TextureAtlasImage *imageList, const a3ui32 count, const a3ui32 maxSize, const a3ui32 padding, const a3boolean powerOfTwo);
+
+	// A3: Pack images into a new texture and fill the atlas with one cell 
+	//		per image, in list order; padding is filled by stretching each 
+	//		image's edge pixels so filtering does not bleed between cells.
+	//	param textureAtlas: non-null pointer to texture atlas without cells 
+	//		or texture
+	//	param texture_out: non-null pointer to uninitialized texture to 
+	//		create; it is set as the atlas texture (see set texture above)
+	//	param name_opt: optional name for the texture
+	//	param pixelFormat: non-null pointer to format of images and atlas
+	//	param imageList: non-null array of images with data to pack
+	//	param count: non-zero number of images
+	//	param maxSize: positive maximum width and height of the atlas
+	//	param padding: space kept around each image in pixels
+	//	param powerOfTwo: non-zero if atlas dimensions must be powers of two
+	//	return: number of cells if success
+	//	return: 0 if images do not fit, texture could not be created or allocation failed
+	//	return: -1 if invalid params
+	a3ret a3textureAtlasPackImages(a3_TextureAtlas *textureAtlas, a3_Texture *texture_out, const a3byte name_opt[32], const a3_TexturePixelFormatDescriptor *pixelFormat, const a3_TextureAtlasImage *imageList, const a3ui32 count, const a3ui32 maxSize, const a3ui32 padding, const a3boolean powerOfTwo);
+
 	// A3: Set info for a single cell; texture must be set.
 	//	param textureAtlas: non-null pointer to initialized texture atlas
 	//	param index: index of cell to set; must be less than count in sheet
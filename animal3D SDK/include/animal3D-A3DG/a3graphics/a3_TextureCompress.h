@@ -0,0 +1,129 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_TextureCompress.h
+	Block compression of images on the CPU (BC1, BC3, BC5 and BC7) and a
+		file cache of compressed images, keyed by a hash of the source
+		image file, so images are only decoded and encoded once.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_TEXTURECOMPRESS_H
+#define __ANIMAL3D_TEXTURECOMPRESS_H
+
+
+#include "animal3D/a3/a3types_integer.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_TextureCompressed		a3_TextureCompressed;
+	typedef enum a3_TextureCompressFormat	a3_TextureCompressFormat;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Block compression format; every format encodes 4x4 pixel blocks.
+	enum a3_TextureCompressFormat
+	{
+		a3tex_compressNone,		// not compressed
+		a3tex_compressBC1,		// rgb, 8 bytes per block (alpha ignored)
+		a3tex_compressBC3,		// rgba, 16 bytes per block
+		a3tex_compressBC5,		// two channels (red, green), 16 bytes per block
+		a3tex_compressBC7,		// rgba, high quality, 16 bytes per block
+	};
+
+
+	// A3: Compressed image.
+	//	member data: blocks, row by row from the first row of the image
+	//	member size: size of data in bytes
+	//	members width, height: dimensions of the image in pixels
+	//	member format: block compression format
+	//	member hash: key of the source image in the cache
+	struct a3_TextureCompressed
+	{
+		void *data;
+		a3ui32 size;
+		a3ui32 width, height;
+		a3_TextureCompressFormat format;
+		a3ui64 hash;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Get hash of source data, used as its key in the cache.
+	//	param data: non-null pointer to data (e.g. image file contents)
+	//	param size: size of data in bytes
+	//	return: non-zero hash of data
+	//	return: 0 if invalid params
+	a3ui64 a3textureCompressHash(const void *data, const a3ui32 size);
+
+	// A3: Compress image; edge blocks of images whose dimensions are not
+	//		multiples of 4 repeat the last row and column.
+	//	param compressed_out: non-null pointer to unused compressed image
+	//	param format: compression format to use
+	//	params width, height: positive dimensions of image
+	//	param data: non-null pointer to rgba8 pixels, tightly packed
+	//	param hash: key to store with the result (see hash above)
+	//	return: size of compressed data if success
+	//	return: 0 if failed to allocate
+	//	return: -1 if invalid params or compressed image already in-use
+	a3ret a3textureCompressEncode(a3_TextureCompressed *compressed_out, const a3_TextureCompressFormat format, const a3ui32 width, const a3ui32 height, const void *data, const a3ui64 hash);
+
+	// A3: Save compressed image to cache directory; file is named after
+	//		its hash and format.
+	//	param compressed: non-null pointer to compressed image
+	//	param cacheDir: non-null, non-empty cstring of existing directory
+	//	return: number of bytes written if success
+	//	return: 0 if failed to write
+	//	return: -1 if invalid params
+	a3ret a3textureCompressSaveCache(const a3_TextureCompressed *compressed, const a3byte *cacheDir);
+
+	// A3: Load compressed image from cache directory.
+	//	param compressed_out: non-null pointer to unused compressed image
+	//	param cacheDir: non-null, non-empty cstring of cache directory
+	//	param hash: hash of source data
+	//	param format: compression format wanted
+	//	return: size of compressed data if found
+	//	return: 0 if not in cache
+	//	return: -1 if invalid params or compressed image already in-use
+	a3ret a3textureCompressLoadCache(a3_TextureCompressed *compressed_out, const a3byte *cacheDir, const a3ui64 hash, const a3_TextureCompressFormat format);
+
+	// A3: Release compressed image.
+	//	param compressed: non-null pointer to compressed image
+	//	return: size released if success
+	//	return: -1 if invalid param or unused
+	a3ret a3textureCompressRelease(a3_TextureCompressed *compressed);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_TEXTURECOMPRESS_H
@@ -0,0 +1,126 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_TextureMipmap.h
+	CPU mipmap chain generation: images are filtered down in linear space
+		without a graphics context, so chains can be generated when baking
+		assets offline and give the same result on every machine.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_TEXTUREMIPMAP_H
+#define __ANIMAL3D_TEXTUREMIPMAP_H
+
+
+#include "animal3D/a3/a3types_integer.h"
+#include "animal3D-A3DG/a3graphics/a3_Texture.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_TextureMipmapChain	a3_TextureMipmapChain;
+	typedef enum a3_TextureMipmapFilter		a3_TextureMipmapFilter;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Maximum number of levels in a chain, including the base image.
+	enum a3_TextureMipmapLevelsMax
+	{
+		a3tex_mipLevelMax = 16
+	};
+
+
+	// A3: Filter used to reduce each level to the next.
+	enum a3_TextureMipmapFilter
+	{
+		a3tex_mipFilterBox,		// average of covered pixels; soft, fast
+		a3tex_mipFilterKaiser,	// Kaiser-windowed sinc; sharper, may ring
+	};
+
+
+	// A3: Mipmap chain; all levels are stored one after another in the
+	//		same pixel format and row order as the base image.
+	//	member data: pixels of all levels
+	//	member offset: byte offset of each level in data
+	//	members width, height: dimensions of each level
+	//	member levels: number of levels including the base image
+	//	member size: total size of data in bytes
+	//	member pixelType: format of every level
+	struct a3_TextureMipmapChain
+	{
+		void *data;
+		a3ui32 offset[a3tex_mipLevelMax];
+		a3ui32 width[a3tex_mipLevelMax], height[a3tex_mipLevelMax];
+		a3ui32 levels;
+		a3ui32 size;
+		a3_TexturePixelType pixelType;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Generate mipmap chain from image, down to 1x1 or level max.
+	//		Levels are filtered in linear space; 8-bit color can be
+	//		decoded from sRGB first and encoded back after filtering,
+	//		alpha is always linear. Rows are split among threads; the
+	//		result does not depend on the number of threads used.
+	//	param chain_out: non-null pointer to unused chain
+	//	param pixelType: format of image; must be rgba8, rgba16F or rgba32F
+	//	params width, height: positive dimensions of image
+	//	param data: non-null pointer to image pixels, tightly packed
+	//	param filter: filter to reduce each level with
+	//	param srgb: non-zero if 8-bit color is sRGB-encoded (ignored for
+	//		float formats, which are already linear)
+	//	param threadCount: number of threads to use, including the calling
+	//		thread; clamped to the range [1, stage thread max]
+	//	return: number of levels if success
+	//	return: 0 if failed to allocate
+	//	return: -1 if invalid params or chain already in-use
+	a3ret a3textureMipmapGenerate(a3_TextureMipmapChain *chain_out, const a3_TexturePixelType pixelType, const a3ui32 width, const a3ui32 height, const void *data, const a3_TextureMipmapFilter filter, const a3boolean srgb, const a3ui32 threadCount);
+
+	// A3: Upload all levels of chain to texture, one level at a time.
+	//	param texture: non-null pointer to initialized texture with the
+	//		same format and dimensions as the base level of the chain
+	//	param chain: non-null pointer to generated chain
+	//	return: number of levels uploaded
+	//	return: -1 if invalid params
+	a3ret a3textureMipmapUpload(const a3_Texture *texture, const a3_TextureMipmapChain *chain);
+
+	// A3: Release mipmap chain.
+	//	param chain: non-null pointer to generated chain
+	//	return: number of levels released
+	//	return: -1 if invalid param or not generated
+	a3ret a3textureMipmapRelease(a3_TextureMipmapChain *chain);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_TEXTUREMIPMAP_H
@@ -123,6 +123,12 @@ extern "C"
 		a3attrib_dvec2,		// 2D double vector
 		a3attrib_dvec3,		// 3D double vector
 		a3attrib_dvec4,		// 4D double vector
+
+		// packed types, read as float vectors in shaders
+		a3attrib_half4,		// 4D half-float vector (e.g. position, w = 1)
+		a3attrib_snorm16x2,	// 2D signed normalized short vector (e.g. octahedral normal)
+		a3attrib_unorm16x2,	// 2D unsigned normalized short vector (e.g. texcoord)
+		a3attrib_unorm8x4,	// 4D unsigned normalized byte vector (e.g. color, blend weights)
 	};
 
 
@@ -34,10 +34,13 @@
 
 #include "animal3D-A3DG/a3graphics/a3_TextRenderer.h"
 #include "animal3D-A3DG/a3graphics/a3_GraphicsObjectHandle.h"
+#include "animal3D-A3DG/a3graphics/a3_TextureCompress.h"
 #include "animal3D-A3DG/a3graphics/a3_Texture.h"
+#include "animal3D-A3DG/a3graphics/a3_TextureMipmap.h"
 #include "animal3D-A3DG/a3graphics/a3_TextureAtlas.h"
 #include "animal3D-A3DG/a3graphics/a3_Framebuffer.h"
 #include "animal3D-A3DG/a3graphics/a3_ShaderProgram.h"
+#include "animal3D-A3DG/a3graphics/a3_ShaderInclude.h"
 #include "animal3D-A3DG/a3graphics/a3_BufferObject.h"
 #include "animal3D-A3DG/a3graphics/a3_UniformBuffer.h"
 #include "animal3D-A3DG/a3graphics/a3_Material.h"
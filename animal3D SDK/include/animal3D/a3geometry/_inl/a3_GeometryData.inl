@@ -67,7 +67,7 @@ A3_INLINE a3ret a3geometryGetAddressBitangent(const void **attribDataPtr_out, co
 	if (attribDataPtr_out && geom && geom->data)
 	{
 		*attribDataPtr_out = geom->attribData[a3attrib_geomTangent] ? 
-			(a3f32 *)geom->attribData[a3attrib_geomTangent] + (geom->numVertices * 3) : 0;
+			(a3byte *)geom->attribData[a3attrib_geomTangent] + (geom->numVertices * geom->vertexFormat->attribSize[a3attrib_tangent]) : 0;
 		return (*attribDataPtr_out != 0);
 	}
 	return -1;
@@ -78,7 +78,7 @@ A3_INLINE a3ret a3geometryGetAddressBlendingInd(const void **attribDataPtr_out,
 	if (attribDataPtr_out && geom && geom->data)
 	{
 		*attribDataPtr_out = geom->attribData[a3attrib_geomBlending] ?
-			(a3f32 *)geom->attribData[a3attrib_geomBlending] + (geom->numVertices * 4) : 0;
+			(a3byte *)geom->attribData[a3attrib_geomBlending] + (geom->numVertices * geom->vertexFormat->attribSize[a3attrib_blendWeights]) : 0;
 		return (*attribDataPtr_out != 0);
 	}
 	return -1;
@@ -0,0 +1,50 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_GeometryOptimize.inl
+	Inline definitions for geometry optimization.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifdef __ANIMAL3D_GEOMETRYOPTIMIZE_H
+#ifndef __ANIMAL3D_GEOMETRYOPTIMIZE_INL
+#define __ANIMAL3D_GEOMETRYOPTIMIZE_INL
+
+
+//-----------------------------------------------------------------------------
+
+A3_INLINE a3ret a3geometryOptimize(a3_GeometryData *geom, const a3ui32 cacheSize)
+{
+	a3i32 result = a3geometryOptimizeVertexCache(geom, cacheSize);
+	if (result > 0)
+	{
+		result = a3geometryOptimizeVertexFetch(geom);
+		return (result > 0);
+	}
+	return result;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// !__ANIMAL3D_GEOMETRYOPTIMIZE_INL
+#endif	// __ANIMAL3D_GEOMETRYOPTIMIZE_H
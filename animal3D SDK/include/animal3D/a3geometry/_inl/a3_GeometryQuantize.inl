@@ -0,0 +1,95 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_GeometryQuantize.inl
+	Inline definitions for geometry attribute packing.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifdef __ANIMAL3D_GEOMETRYQUANTIZE_H
+#ifndef __ANIMAL3D_GEOMETRYQUANTIZE_INL
+#define __ANIMAL3D_GEOMETRYQUANTIZE_INL
+
+
+//-----------------------------------------------------------------------------
+
+A3_INLINE a3i16 *a3geometryPackOctahedral(a3i16 *oct_out, const a3f32 *v)
+{
+	a3f32 x, y, l1 = (v[0] < 0.0f ? -v[0] : v[0]) + (v[1] < 0.0f ? -v[1] : v[1]) + (v[2] < 0.0f ? -v[2] : v[2]);
+	if (l1 > 0.0f)
+	{
+		// project onto octahedron, fold lower hemisphere over
+		l1 = 1.0f / l1;
+		x = v[0] * l1;
+		y = v[1] * l1;
+		if (v[2] < 0.0f)
+		{
+			l1 = x;
+			x = (1.0f - (y < 0.0f ? -y : y)) * (x >= 0.0f ? +1.0f : -1.0f);
+			y = (1.0f - (l1 < 0.0f ? -l1 : l1)) * (y >= 0.0f ? +1.0f : -1.0f);
+		}
+	}
+	else
+		x = y = 0.0f;
+	oct_out[0] = (a3i16)(x * 32767.0f + (x >= 0.0f ? +0.5f : -0.5f));
+	oct_out[1] = (a3i16)(y * 32767.0f + (y >= 0.0f ? +0.5f : -0.5f));
+	return oct_out;
+}
+
+A3_INLINE a3ui16 a3geometryPackUnorm16(const a3f32 x)
+{
+	return (a3ui16)((x <= 0.0f ? 0.0f : x >= 1.0f ? 1.0f : x) * 65535.0f + 0.5f);
+}
+
+A3_INLINE a3ubyte a3geometryPackUnorm8(const a3f32 x)
+{
+	return (a3ubyte)((x <= 0.0f ? 0.0f : x >= 1.0f ? 1.0f : x) * 255.0f + 0.5f);
+}
+
+A3_INLINE a3ubyte *a3geometryPackWeights(a3ubyte *weights_out, const a3f32 *weights)
+{
+	a3f32 sum = 0.0f;
+	a3i32 total = 0;
+	a3ui32 i, largest = 0;
+	for (i = 0; i < 4; ++i)
+	{
+		sum += weights[i] > 0.0f ? weights[i] : 0.0f;
+		if (weights[i] > weights[largest])
+			largest = i;
+	}
+	if (sum > 0.0f)
+	{
+		// normalize, then give rounding error to the largest weight
+		for (i = 0; i < 4; ++i)
+			total += weights_out[i] = a3geometryPackUnorm8(weights[i] / sum);
+		weights_out[largest] = (a3ubyte)(weights_out[largest] + 255 - total);
+	}
+	else
+		weights_out[0] = weights_out[1] = weights_out[2] = weights_out[3] = 0;
+	return weights_out;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// !__ANIMAL3D_GEOMETRYQUANTIZE_INL
+#endif	// __ANIMAL3D_GEOMETRYQUANTIZE_H
@@ -0,0 +1,57 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_GeometrySimplify.inl
+	Inline definitions for geometry simplification.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifdef __ANIMAL3D_GEOMETRYSIMPLIFY_H
+#ifndef __ANIMAL3D_GEOMETRYSIMPLIFY_INL
+#define __ANIMAL3D_GEOMETRYSIMPLIFY_INL
+
+
+//-----------------------------------------------------------------------------
+
+A3_INLINE a3ret a3geometryLODSelect(const a3_GeometryLOD *lod, const a3f32 distance, const a3f32 projectionScale, const a3f32 pixelErrorMax, const a3f32 scale)
+{
+	a3ui32 i;
+	if (lod && lod->numLevels)
+	{
+		// object is at or behind the viewer: full detail
+		if (distance <= 0.0f)
+			return 0;
+
+		// levels are ordered by error, so walk back from the coarsest
+		for (i = lod->numLevels - 1; i > 0; --i)
+			if (lod->error[i] * scale * projectionScale / distance <= pixelErrorMax)
+				break;
+		return i;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// !__ANIMAL3D_GEOMETRYSIMPLIFY_INL
+#endif	// __ANIMAL3D_GEOMETRYSIMPLIFY_H
@@ -33,6 +33,7 @@
 #include "animal3D/a3/a3types_integer.h"
 #include "animal3D/a3/a3types_real.h"
 #include "animal3D/a3utility/a3_Stream.h"
+#include "animal3D/a3utility/a3_Allocator.h"
 #include "animal3D-A3DG/a3graphics/a3_VertexDrawable.h"
 
 
@@ -76,6 +77,7 @@ extern "C"
 	//	member data: pointer to raw geometry data; should be null if unused
 	//	member attribData: array of pointers to specific attribute data
 	//	member indexData: pointer to indexing data (may not be used)
+	//	member allocator: allocator that owns data; null for heap
 	struct a3_GeometryData
 	{
 		a3_VertexFormatDescriptor vertexFormat[1];
@@ -85,6 +87,7 @@ extern "C"
 		void *data;
 		const void *attribData[a3attrib_geomNameMax];
 		const void *indexData;
+		a3_Allocator *allocator;
 	};
 
 
@@ -199,7 +202,9 @@ extern "C"
 	//	return: -1 if invalid params
 	a3ret a3geometrySaveDataBinary(const a3_GeometryData *geom, const a3_FileStream *fileStream);
 
-	// A3: Load geometry data from file.
+	// A3: Load geometry data from file; usable as a file stream read 
+	//		function, so the allocator is passed in the container: set 
+	//		geom_out->allocator first to load into it, otherwise uses heap.
 	//	param geom_out: non-null pointer to unused data container
 	//	param fileStream: non-null pointer to file stream opened in read mode
 	//	return: number of bytes read if success
@@ -216,7 +221,7 @@ extern "C"
 	//	return: -1 if invalid params
 	a3ret a3geometryCopyDataToString(const a3_GeometryData *geom, a3byte *str);
 
-	// A3: Copy geometry data from string.
+	// A3: Copy geometry data from string; allocates like binary load.
 	//	param geom_out: non-null pointer to unused data container
 	//	param str: non-null pointer to storage string
 	//	return: number of bytes read if success
@@ -230,7 +235,8 @@ extern "C"
 	//	return: -1 if invalid param
 	a3ret a3geometryGetStringSize(const a3_GeometryData *geom);
 
-	// A3: Release geometry data container.
+	// A3: Release geometry data container; data is returned to the 
+	//		allocator it came from.
 	//	param geom: non-null pointer to initialized data container
 	//	return: 1 if success; object passed is reset
 	//	return: -1 if invalid param or uninitialized
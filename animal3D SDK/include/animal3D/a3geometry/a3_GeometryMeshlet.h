@@ -0,0 +1,134 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_GeometryMeshlet.h
+	Partition triangle geometry into small clusters (meshlets) with bounds
+		for CPU-side culling and finer-grained processing.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_GEOMETRYMESHLET_H
+#define __ANIMAL3D_GEOMETRYMESHLET_H
+
+
+#include "a3_GeometryData.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_GeometryMeshlet		a3_GeometryMeshlet;
+	typedef struct a3_GeometryMeshletData	a3_GeometryMeshletData;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Meshlet size limits; vertex limit keeps local indices in a byte.
+	enum a3_GeometryMeshletLimit
+	{
+		a3geomMeshlet_verticesDefault = 64,
+		a3geomMeshlet_verticesMax = 255,
+		a3geomMeshlet_trianglesDefault = 124,
+		a3geomMeshlet_trianglesMax = 512,
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Single meshlet: a range of unique vertices and local triangles.
+	//	members vertexOffset, vertexCount: range in the vertex index list
+	//	members triangleOffset, triangleCount: range in the triangle list;
+	//		each triangle is 3 local indices into this meshlet's vertices
+	//	members center, radius: bounding sphere of meshlet positions
+	//	members coneApex, coneAxis, coneCutoff: normal cone of meshlet 
+	//		triangles; apex is placed so every triangle's plane is in front 
+	//		of it, axis is unit length, cutoff is the sine of the cone's 
+	//		half-angle (1 if the cone is too wide to be useful for culling)
+	struct a3_GeometryMeshlet
+	{
+		a3ui32 vertexOffset, vertexCount;
+		a3ui32 triangleOffset, triangleCount;
+		a3f32 center[3], radius;
+		a3f32 coneApex[3];
+		a3f32 coneAxis[3], coneCutoff;
+	};
+
+	// A3: Container for all meshlets generated from one geometry.
+	//	member meshlet: array of meshlets
+	//	member vertexIndex: original vertex index for each meshlet vertex
+	//	member triangleIndex: local indices, 3 per triangle
+	//	members numMeshlets, numVertexIndices, numTriangles: counts
+	//	member data: pointer to raw storage; should be null if unused
+	struct a3_GeometryMeshletData
+	{
+		a3_GeometryMeshlet *meshlet;
+		a3ui32 *vertexIndex;
+		a3ubyte *triangleIndex;
+		a3ui32 numMeshlets, numVertexIndices, numTriangles;
+		void *data;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Partition geometry into meshlets. Triangles are consumed in index
+	//		order, so running the vertex cache optimizer first gives tighter
+	//		clusters. Output is deterministic for the same input.
+	//	param meshlets_out: non-null pointer to unused meshlet container
+	//	param geom: non-null pointer to initialized geometry data; must use
+	//		the triangle list primitive type (indexed or not) with float positions
+	//	param maxVertices: max unique vertices per meshlet; pass zero for
+	//		default, otherwise clamped to [3, max] from the enum above
+	//	param maxTriangles: max triangles per meshlet; pass zero for
+	//		default, otherwise clamped to [1, max] from the enum above
+	//	return: number of meshlets generated if success
+	//	return: 0 if geometry cannot be partitioned (not triangles, or an 
+	//		index is not less than the vertex count) or failed to allocate
+	//	return: -1 if invalid params
+	a3ret a3geometryGenerateMeshlets(a3_GeometryMeshletData *meshlets_out, const a3_GeometryData *geom, a3ui32 maxVertices, a3ui32 maxTriangles);
+
+	// A3: Test whether every triangle in a meshlet faces away from a viewer.
+	//	param meshlet: non-null pointer to meshlet
+	//	param viewPosition: non-null array of 3 floats, viewer position in
+	//		the same space as the geometry
+	//	return: 1 if meshlet can be culled
+	//	return: 0 if meshlet may be visible
+	//	return: -1 if invalid params
+	a3ret a3geometryMeshletIsBackfacing(const a3_GeometryMeshlet *meshlet, const a3f32 *viewPosition);
+
+	// A3: Release meshlet container.
+	//	param meshlets: non-null pointer to initialized meshlet container
+	//	return: 1 if success; object passed is reset
+	//	return: -1 if invalid param or uninitialized
+	a3ret a3geometryReleaseMeshlets(a3_GeometryMeshletData *meshlets);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_GEOMETRYMESHLET_H
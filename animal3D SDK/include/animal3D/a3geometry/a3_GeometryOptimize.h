@@ -0,0 +1,108 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_GeometryOptimize.h
+	Post-process utilities to reorder indexed triangle geometry for better
+		post-transform vertex cache reuse and vertex fetch locality.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_GEOMETRYOPTIMIZE_H
+#define __ANIMAL3D_GEOMETRYOPTIMIZE_H
+
+
+#include "a3_GeometryData.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Vertex cache sizes used by the optimizer.
+	enum a3_GeometryOptimizeCacheSize
+	{
+		a3geomOptimize_cacheSizeMin = 4,
+		a3geomOptimize_cacheSizeDefault = 32,
+		a3geomOptimize_cacheSizeMax = 64,
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Reorder triangles in geometry's index data to improve reuse of the
+	//		post-transform vertex cache (Forsyth's linear-speed algorithm);
+	//		vertex data is untouched.
+	//	param geom: non-null pointer to initialized geometry data; must be
+	//		indexed and use the triangle list primitive type
+	//	param cacheSize: size of simulated LRU cache; pass zero for default,
+	//		otherwise clamped to the range above
+	//	return: number of triangles reordered if success
+	//	return: 0 if geometry cannot be optimized (not indexed triangles)
+	//	return: -1 if invalid params
+	a3ret a3geometryOptimizeVertexCache(a3_GeometryData *geom, a3ui32 cacheSize);
+
+	// A3: Reorder vertices in geometry's attribute data in the order they
+	//		are first referenced by the index data, and remap indices;
+	//		unreferenced vertices are moved to the end. Run this after the
+	//		vertex cache pass so fetches follow draw order.
+	//	param geom: non-null pointer to initialized geometry data; must be
+	//		indexed
+	//	return: number of vertices referenced by indices if success
+	//	return: 0 if geometry cannot be optimized (not indexed)
+	//	return: -1 if invalid params
+	a3ret a3geometryOptimizeVertexFetch(a3_GeometryData *geom);
+
+	// A3: Perform vertex cache and vertex fetch optimization, in that order.
+	//	param geom: non-null pointer to initialized geometry data
+	//	param cacheSize: size of simulated LRU cache; pass zero for default
+	//	return: 1 if success
+	//	return: 0 if geometry cannot be optimized (not indexed triangles)
+	//	return: -1 if invalid params
+	a3ret a3geometryOptimize(a3_GeometryData *geom, const a3ui32 cacheSize);
+
+	// A3: Calculate average cache miss ratio (transformed vertices per
+	//		triangle) for geometry, simulating a FIFO cache; use to compare
+	//		before and after optimization. Lower is better; 0.5 is ideal
+	//		for regular grids, 3.0 is the worst case.
+	//	param geom: non-null pointer to initialized geometry data; must be
+	//		indexed triangles
+	//	param cacheSize: size of simulated FIFO cache; pass zero for default
+	//	return: average cache miss ratio if success
+	//	return: -1 if invalid params or not indexed triangles
+	a3f32 a3geometryCalculateACMR(const a3_GeometryData *geom, a3ui32 cacheSize);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#include "_inl/a3_GeometryOptimize.inl"
+
+
+#endif	// !__ANIMAL3D_GEOMETRYOPTIMIZE_H
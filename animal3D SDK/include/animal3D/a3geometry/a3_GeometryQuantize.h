@@ -0,0 +1,132 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_GeometryQuantize.h
+	Pack geometry attributes into smaller vertex formats to reduce vertex
+		buffer size and bandwidth.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_GEOMETRYQUANTIZE_H
+#define __ANIMAL3D_GEOMETRYQUANTIZE_H
+
+
+#include "a3_GeometryData.h"
+#include "animal3D/a3utility/a3_Half.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef enum a3_GeometryQuantizeFlag	a3_GeometryQuantizeFlag;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Flags to select which geometry attributes are packed; each flag
+	//		matches the bit of the geometry attribute name.
+	enum a3_GeometryQuantizeFlag
+	{
+		a3geomQuantize_position = 1 << a3attrib_geomPosition,	// vec3 -> half4 (w = 1), 8 bytes
+		a3geomQuantize_normal = 1 << a3attrib_geomNormal,		// vec3 -> octahedral snorm16x2, 4 bytes
+		a3geomQuantize_color = 1 << a3attrib_geomColor,			// vec4 -> unorm8x4, 4 bytes
+		a3geomQuantize_texcoord = 1 << a3attrib_geomTexcoord,	// vec2 -> unorm16x2, 4 bytes; only if in [0, 1]
+		a3geomQuantize_tangent = 1 << a3attrib_geomTangent,		// tangent and bitangent as normal
+		a3geomQuantize_blending = 1 << a3attrib_geomBlending,	// weights vec4 -> unorm8x4; indices unchanged
+		a3geomQuantize_all = 0x3f,
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Encode unit vector using octahedral mapping; decode in shaders
+	//		with the matching GLSL utility.
+	//	param oct_out: non-null array of 2 signed normalized shorts
+	//	param v: non-null array of 3 floats; need not be unit length
+	//	return: oct_out
+	a3i16 *a3geometryPackOctahedral(a3i16 *oct_out, const a3f32 *v);
+
+	// A3: Decode octahedral-mapped vector.
+	//	param v_out: non-null array of 3 floats; result is unit length
+	//	param oct: non-null array of 2 signed normalized shorts
+	//	return: v_out
+	a3f32 *a3geometryUnpackOctahedral(a3f32 *v_out, const a3i16 *oct);
+
+	// A3: Convert value in [0, 1] to 16-bit unsigned normalized.
+	//	param x: value to convert; clamped
+	//	return: unsigned normalized short
+	a3ui16 a3geometryPackUnorm16(const a3f32 x);
+
+	// A3: Convert value in [0, 1] to 8-bit unsigned normalized.
+	//	param x: value to convert; clamped
+	//	return: unsigned normalized byte
+	a3ubyte a3geometryPackUnorm8(const a3f32 x);
+
+	// A3: Convert 4 blend weights to 8-bit unsigned normalized such that
+	//		the packed weights still sum to exactly one.
+	//	param weights_out: non-null array of 4 bytes
+	//	param weights: non-null array of 4 floats
+	//	return: weights_out
+	a3ubyte *a3geometryPackWeights(a3ubyte *weights_out, const a3f32 *weights);
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Create vertex format descriptor with packed attribute types;
+	//		otherwise identical to a3geometryCreateVertexFormat.
+	//	param vertexFormat_out: the vertex format to be stored
+	//	param attribNameList: non-null array of geometry attribute names
+	//	param attribNameCount: non-zero count of attribute names, less than max
+	//	param quantizeFlags: which attributes are packed (see above)
+	//	return: total number of attributes specified if success
+	//	return: -1 if invalid params
+	a3ret a3geometryCreateVertexFormatQuantized(a3_VertexFormatDescriptor *vertexFormat_out, const a3_GeometryVertexAttributeName *attribNameList, a3ui32 attribNameCount, const a3ui32 quantizeFlags);
+
+	// A3: Pack geometry attributes. The result can be saved, loaded and
+	//		passed to a3geometryGenerateDrawable like any other geometry;
+	//		vertex arrays made from it read packed attributes as floats.
+	//		Do other processing (simplification, meshlets) first since
+	//		those expect float positions.
+	//	param geom_out: non-null pointer to unused geometry data
+	//	param geom: non-null pointer to initialized geometry data using the
+	//		default (float) geometry vertex format
+	//	param quantizeFlags: which attributes are packed (see above)
+	//	return: vertex size in bytes of the result if success
+	//	return: 0 if geometry is already packed or format is unrecognized,
+	//		or failed to allocate
+	//	return: -1 if invalid params
+	a3ret a3geometryQuantize(a3_GeometryData *geom_out, const a3_GeometryData *geom, a3ui32 quantizeFlags);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#include "_inl/a3_GeometryQuantize.inl"
+
+
+#endif	// !__ANIMAL3D_GEOMETRYQUANTIZE_H
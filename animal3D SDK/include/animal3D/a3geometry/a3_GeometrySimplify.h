@@ -0,0 +1,131 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_GeometrySimplify.h
+	Quadric error mesh simplification to generate level of detail (LOD)
+		chains that share a single set of vertices.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_GEOMETRYSIMPLIFY_H
+#define __ANIMAL3D_GEOMETRYSIMPLIFY_H
+
+
+#include "a3_GeometryData.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_GeometryLOD	a3_GeometryLOD;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Maximum number of detail levels, including the original.
+	enum a3_GeometryLODMax
+	{
+		a3geomLOD_levelMax = 8
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Description of detail levels stored in one geometry's indices.
+	//	member numLevels: number of valid levels; level 0 is the original
+	//	members indexOffset, indexCount: range of each level in index data
+	//		(measured in indices, not bytes)
+	//	member error: approximate object-space deviation of each level from
+	//		the original surface; non-decreasing
+	struct a3_GeometryLOD
+	{
+		a3ui32 numLevels;
+		a3ui32 indexOffset[a3geomLOD_levelMax];
+		a3ui32 indexCount[a3geomLOD_levelMax];
+		a3f32 error[a3geomLOD_levelMax];
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Generate a chain of simplified detail levels using quadric error
+	//		edge collapses. Each collapse moves one vertex onto a neighbor,
+	//		so all levels share the original vertex data; only indices
+	//		differ. Vertices at the same position are welded, so split
+	//		corners (loaded or faceted meshes) collapse together; vertices
+	//		on attribute seams (same position, different colors, texture
+	//		coordinates or blending) and open borders are never moved, so
+	//		seams and silhouettes of open meshes are preserved.
+	//	param geom_out: non-null pointer to unused geometry data; receives a
+	//		copy of the vertex data and the indices of all levels back to back
+	//	param lod_out: non-null pointer to level description
+	//	param geom: non-null pointer to initialized geometry data; must be
+	//		indexed triangles with float positions
+	//	param numLevels: number of levels including the original; clamped
+	//		to the max above
+	//	param reduction: ratio of triangles kept from one level to the next
+	//		in (0, 1); invalid values use one half
+	//	return: number of levels generated if success; may be fewer than
+	//		requested if the mesh cannot be simplified further
+	//	return: 0 if geometry cannot be simplified (not indexed triangles)
+	//		or failed to allocate
+	//	return: -1 if invalid params
+	a3ret a3geometryGenerateLOD(a3_GeometryData *geom_out, a3_GeometryLOD *lod_out, const a3_GeometryData *geom, a3ui32 numLevels, a3f32 reduction);
+
+	// A3: Generate one drawable per detail level; vertex and index data are
+	//		stored once and each drawable refers to its own index range.
+	//	param drawables_out: non-null array of uninitialized drawables, at
+	//		least as many as there are levels
+	//	param geom: non-null pointer to geometry generated with the above
+	//	param lod: non-null pointer to level description generated with it
+	//	params vertexArray, indexBuffer, commonIndexFormat_opt,
+	//		vertexBufferOffset_out_opt, indexBufferOffset_out_opt: see
+	//		a3geometryGenerateDrawable
+	//	return: size of vertex data stored if succeeded
+	//	return: -1 if invalid params
+	a3ret a3geometryGenerateDrawableLOD(a3_VertexDrawable *drawables_out, const a3_GeometryData *geom, const a3_GeometryLOD *lod, a3_VertexArrayDescriptor *vertexArray, a3_IndexBuffer *indexBuffer, const a3_IndexFormatDescriptor *commonIndexFormat_opt, a3ui32 *vertexBufferOffset_out_opt, a3ui32 *indexBufferOffset_out_opt);
+
+	// A3: Select detail level by projected screen-space error.
+	//	param lod: non-null pointer to level description
+	//	param distance: view-space distance to the object
+	//	param projectionScale: pixels per unit at distance 1; for a
+	//		perspective projection this is viewport height * 0.5 * m[1][1]
+	//	param pixelErrorMax: largest acceptable error in pixels
+	//	param scale: uniform scale applied to the object (use 1 if none)
+	//	return: coarsest level whose projected error is acceptable
+	//	return: -1 if invalid params
+	a3ret a3geometryLODSelect(const a3_GeometryLOD *lod, const a3f32 distance, const a3f32 projectionScale, const a3f32 pixelErrorMax, const a3f32 scale);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#include "_inl/a3_GeometrySimplify.inl"
+
+
+#endif	// !__ANIMAL3D_GEOMETRYSIMPLIFY_H
@@ -49,6 +49,8 @@ extern "C"
 
 	// A3: Flags for model loader.
 	// NOTE: file must have texture coordinates to calculate tangents.
+	// NOTE: optimization flag may be combined with any of the others; it 
+	//	reorders triangles and vertices for the vertex cache after loading.
 	enum a3_ModelLoaderFlag
 	{
 		a3model_loadTexcoords = 1,
@@ -60,6 +62,7 @@ extern "C"
 		a3model_calculateVertexNormals = 20,
 		a3model_calculateVertexNormals_loadTexcoords,
 		a3model_calculateVertexTangents = 61,
+		a3model_optimizeVertexCache = 64,
 	};
 
 
@@ -73,10 +76,12 @@ extern "C"
 	//	param flags: load options; see above enum
 	//	param transform_opt: optional array of 16 floats representing a 
 	//		*column-major* transformation matrix for all vertices
+	//	param allocator_opt: allocator for geometry data; null to use heap 
+	//		(temporary load data always uses its own scratch arena)
 	//	return: 1 if success
 	//	return: 0 if failed
 	//	return: -1 if invalid params
-	a3ret a3modelLoadOBJ(a3_GeometryData *geom_out, const a3byte *filePath, const a3_ModelLoaderFlag flags, const a3f32 *transform_opt);
+	a3ret a3modelLoadOBJ(a3_GeometryData *geom_out, const a3byte *filePath, const a3_ModelLoaderFlag flags, const a3f32 *transform_opt, a3_Allocator *allocator_opt);
 
 	// A3: Load a Wavefront OBJ file's model data, and a text skin weights 
 	//		file exported from Maya in XML format.
@@ -93,10 +98,11 @@ extern "C"
 	//	param numInfluences: non-zero influence count
 	//	param transform_opt: optional array of 16 floats representing a 
 	//		*column-major* transformation matrix for all vertices
+	//	param allocator_opt: allocator for geometry data; null to use heap
 	//	return: 1 if success
 	//	return: 0 if failed
 	//	return: -1 if invalid params
-	a3ret a3modelLoadOBJSkinWeights(a3_GeometryData *geom_out, const a3byte *filePath, const a3_ModelLoaderFlag flags, const a3byte *weightsFilePath, const a3byte *influenceNames[], const a3ui32 numInfluences, const a3f32 *transform_opt);
+	a3ret a3modelLoadOBJSkinWeights(a3_GeometryData *geom_out, const a3byte *filePath, const a3_ModelLoaderFlag flags, const a3byte *weightsFilePath, const a3byte *influenceNames[], const a3ui32 numInfluences, const a3f32 *transform_opt, a3_Allocator *allocator_opt);
 
 
 //-----------------------------------------------------------------------------
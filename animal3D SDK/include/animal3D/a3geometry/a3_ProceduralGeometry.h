@@ -363,9 +363,23 @@ extern "C"
 	//	param geom: non-null pointer to initialized procedural shape descriptor
 	//	param transform_opt: optional array of 16 floats representing a 
 	//		*column-major* transformation matrix for all vertices
+	//	param allocator_opt: allocator for geometry data; null to use heap
 	//	return: 1 if success
 	//	return: -1 if invalid params
-	a3ret a3proceduralGenerateGeometryData(a3_GeometryData *geomData_out, const a3_ProceduralGeometryDescriptor *geom, const a3f32 *transform_opt);
+	a3ret a3proceduralGenerateGeometryData(a3_GeometryData *geomData_out, const a3_ProceduralGeometryDescriptor *geom, const a3f32 *transform_opt, a3_Allocator *allocator_opt);
+
+	// A3: Generate data for a procedural shape, then reorder triangles and 
+	//		vertices for the vertex cache (see a3_GeometryOptimize.h); 
+	//		shapes that are not indexed triangles are left as generated.
+	//	param geomData_out: non-null pointer to uninitialized geometry data
+	//	param geom: non-null pointer to initialized procedural shape descriptor
+	//	param transform_opt: optional array of 16 floats representing a 
+	//		*column-major* transformation matrix for all vertices
+	//	param cacheSize: size of simulated vertex cache; pass zero for default
+	//	param allocator_opt: allocator for geometry data; null to use heap
+	//	return: 1 if success
+	//	return: -1 if invalid params
+	a3ret a3proceduralGenerateGeometryDataOptimized(a3_GeometryData *geomData_out, const a3_ProceduralGeometryDescriptor *geom, const a3f32 *transform_opt, const a3ui32 cacheSize, a3_Allocator *allocator_opt);
 
 
 //-----------------------------------------------------------------------------
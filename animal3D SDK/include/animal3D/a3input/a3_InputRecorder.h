@@ -0,0 +1,160 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_InputRecorder.h
+	Record and replay of input: the current state of the keyboard, mouse
+		and controller is captured once per tick as the bytes that changed
+		since the previous tick, along with the character keys pressed
+		since the previous tick, and can be written back exactly on a
+		later run, so that runs driven by input can be repeated.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_INPUTRECORDER_H
+#define __ANIMAL3D_INPUTRECORDER_H
+
+
+#include "a3_KeyboardInput.h"
+#include "a3_MouseInput.h"
+#include "a3_XboxControllerInput.h"
+#include "animal3D/a3utility/a3_Stream.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_InputRecorder			a3_InputRecorder;
+	typedef enum a3_InputRecorderMode		a3_InputRecorderMode;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Limits of recorder.
+	enum a3_InputRecorderMax
+	{
+		a3input_recorderFrameMax = 512,		// max bytes in one snapshot
+		a3input_recorderKeyCharMax = 64,	// max character keys in one tick
+		a3input_recorderPathMax = 256,		// max length of file path
+	};
+
+
+	// A3: Recorder modes.
+	enum a3_InputRecorderMode
+	{
+		a3input_recorderIdle,		// not in use, or replay finished
+		a3input_recorderRecord,		// capturing every tick
+		a3input_recorderReplay,		// writing recorded ticks back
+	};
+
+
+	// A3: Input recorder.
+	//	member frame: snapshot of the previous tick
+	//	member keyChar: character keys of the tick; pressed since the last
+	//		tick while recording, or replayed by the last tick; the high
+	//		bit is set for held (repeated) keys
+	//	member keyCharCount: number of character keys of the tick
+	//	member data: recorded stream while recording
+	//	members size, capacity: bytes used and allocated in data
+	//	member stream: loaded stream while replaying
+	//	member ticks: number of ticks recorded or replayed so far
+	//	member tickCount: number of ticks in replayed stream
+	//	member mode: recorder mode
+	//	member filePath: file to save to when recording ends
+	struct a3_InputRecorder
+	{
+		a3ubyte frame[a3input_recorderFrameMax];
+		a3ubyte keyChar[a3input_recorderKeyCharMax];
+		a3ui32 keyCharCount;
+		a3ubyte *data;
+		a3ui32 size, capacity;
+		a3_Stream stream[1];
+		a3ui32 ticks, tickCount;
+		a3_InputRecorderMode mode;
+		a3byte filePath[a3input_recorderPathMax];
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Start recording input.
+	//	param recorder_out: non-null pointer to unused recorder
+	//	param filePath: non-null, non-empty cstring of file to save to when
+	//		recording ends
+	//	return: 1 if success
+	//	return: 0 if failed to allocate
+	//	return: -1 if invalid params or recorder in-use
+	a3ret a3inputRecorderBeginRecord(a3_InputRecorder *recorder_out, const a3byte *filePath);
+
+	// A3: Start replaying input from file.
+	//	param recorder_out: non-null pointer to unused recorder
+	//	param filePath: non-null, non-empty cstring of recorded file
+	//	return: number of ticks in file if success
+	//	return: 0 if file could not be read or is not a recording of this
+	//		build's input layout
+	//	return: -1 if invalid params or recorder in-use
+	a3ret a3inputRecorderBeginReplay(a3_InputRecorder *recorder_out, const a3byte *filePath);
+
+	// A3: Record character key event, to be saved with the next tick; call
+	//		where the event is handled, and while replaying, ignore live
+	//		events and handle the recorded ones instead (see tick below).
+	//	param recorder: non-null pointer to recorder
+	//	param asciiKey: character of key, in [0, 127]
+	//	param hold: true if key is held (repeated), false if pressed
+	//	return: 1 if event was recorded
+	//	return: 0 if not recording
+	//	return: -1 if invalid params or too many events in one tick
+	a3ret a3inputRecorderKeyChar(a3_InputRecorder *recorder, const a3i32 asciiKey, const a3boolean hold);
+
+	// A3: Process one tick: when recording, the current input states and
+	//		the character keys recorded since the last tick are captured;
+	//		when replaying, the input states are overwritten with the next
+	//		recorded tick and its character keys are set in the recorder,
+	//		to be passed to the same handlers, in order, by the caller.
+	//		Call once per tick at the same point of the loop (before the
+	//		input is read) when recording and replaying.
+	//	param recorder: non-null pointer to recorder
+	//	param keyboard: non-null pointer to keyboard state
+	//	param mouse: non-null pointer to mouse state
+	//	param xcontrol: non-null pointer to controller state
+	//	return: 1 if tick was recorded or replayed
+	//	return: 0 if recorder is idle (replay finished or not in use)
+	//	return: -1 if invalid params or recorded stream is damaged (the
+	//		recorder becomes idle)
+	a3ret a3inputRecorderTick(a3_InputRecorder *recorder, a3_KeyboardInput *keyboard, a3_MouseInput *mouse, a3_XboxControllerInput *xcontrol);
+
+	// A3: Stop recorder; a recording is saved to its file first.
+	//	param recorder: non-null pointer to recorder
+	//	return: number of ticks recorded or replayed
+	//	return: -1 if invalid param or recording could not be saved
+	a3ret a3inputRecorderEnd(a3_InputRecorder *recorder);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_INPUTRECORDER_H
@@ -0,0 +1,105 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_Half.inl
+	Inline definitions for half-float conversion.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifdef __ANIMAL3D_HALF_H
+#ifndef __ANIMAL3D_HALF_INL
+#define __ANIMAL3D_HALF_INL
+
+
+//-----------------------------------------------------------------------------
+
+A3_INLINE a3ui16 a3halfPack(const a3f32 x)
+{
+	union { a3f32 f; a3ui32 u; } bits;
+	a3ui32 sign, exponent, mantissa;
+	bits.f = x;
+	sign = (bits.u >> 16) & 0x8000;
+	exponent = (bits.u >> 23) & 0xff;
+	mantissa = bits.u & 0x007fffff;
+
+	// infinity or nan
+	if (exponent == 0xff)
+		return (a3ui16)(sign | 0x7c00 | (mantissa ? 0x0200 : 0));
+
+	// overflow: infinity
+	if (exponent > 142)
+		return (a3ui16)(sign | 0x7c00);
+
+	// normal: round mantissa to nearest even
+	if (exponent > 112)
+	{
+		bits.u = ((exponent - 112) << 10) | (mantissa >> 13);
+		mantissa &= 0x1fff;
+		bits.u += (mantissa > 0x1000 || (mantissa == 0x1000 && (bits.u & 1)));
+		return (a3ui16)(sign | bits.u);
+	}
+
+	// subnormal or zero
+	if (exponent > 101)
+	{
+		mantissa |= 0x00800000;
+		exponent = 126 - exponent;
+		bits.u = mantissa >> exponent;
+		mantissa &= (1u << exponent) - 1;
+		bits.u += (mantissa > (1u << (exponent - 1)) || (mantissa == (1u << (exponent - 1)) && (bits.u & 1)));
+		return (a3ui16)(sign | bits.u);
+	}
+	return (a3ui16)sign;
+}
+
+A3_INLINE a3f32 a3halfUnpack(const a3ui16 h)
+{
+	union { a3f32 f; a3ui32 u; } bits;
+	const a3ui32 sign = (a3ui32)(h & 0x8000) << 16;
+	a3ui32 exponent = (h >> 10) & 0x1f;
+	a3ui32 mantissa = h & 0x03ff;
+
+	if (exponent == 0x1f)
+		bits.u = sign | 0x7f800000 | (mantissa << 13);
+	else if (exponent)
+		bits.u = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	else if (mantissa)
+	{
+		// subnormal: normalize
+		exponent = 113;
+		while (!(mantissa & 0x0400))
+		{
+			mantissa <<= 1;
+			--exponent;
+		}
+		bits.u = sign | (exponent << 23) | ((mantissa & 0x03ff) << 13);
+	}
+	else
+		bits.u = sign;
+	return bits.f;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// !__ANIMAL3D_HALF_INL
+#endif	// __ANIMAL3D_HALF_H
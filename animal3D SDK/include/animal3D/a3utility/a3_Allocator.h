@@ -0,0 +1,206 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_Allocator.h
+	Memory allocators: general interface, linear arena and fixed-size pool.
+		Loaders accept an optional allocator so that their outputs can be
+		placed somewhere other than the heap; arenas and pools are not
+		thread-safe, so use one per thread or per load.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_ALLOCATOR_H
+#define __ANIMAL3D_ALLOCATOR_H
+
+
+#include "animal3D/a3/a3types_integer.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_Allocator		a3_Allocator;
+	typedef struct a3_Arena			a3_Arena;
+	typedef struct a3_Pool			a3_Pool;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Alignment of all blocks returned by allocators.
+	enum a3_AllocatorAlignment
+	{
+		a3allocator_alignment = 16,
+	};
+
+
+	// A3: General form of allocator functions.
+	//	Alloc: takes the allocator and a size in bytes; returns block or null
+	//	Free: takes the allocator and a block it returned
+	typedef void *(*a3_AllocatorAllocFunc)(a3_Allocator *, const a3ui32);
+	typedef void(*a3_AllocatorFreeFunc)(a3_Allocator *, void *);
+
+
+	// A3: Allocator interface; first member of arenas and pools, pass their
+	//		'allocator' member wherever an allocator is accepted.
+	//	member allocFunc: function used to allocate
+	//	member freeFunc: function used to free
+	struct a3_Allocator
+	{
+		a3_AllocatorAllocFunc allocFunc;
+		a3_AllocatorFreeFunc freeFunc;
+	};
+
+
+	// A3: Linear arena: allocations are bumped from large blocks and only
+	//		returned all at once by resetting or releasing the arena; freeing
+	//		a single allocation does nothing.
+	//	member allocator: interface for this arena
+	//	member block: current block (internal)
+	//	member blockSize: minimum size of each block
+	//	member blockUsed: bytes used in current block
+	//	member blockCapacity: usable bytes in current block
+	//	member used: total bytes allocated since last reset
+	//	member peak: most bytes ever allocated between resets
+	struct a3_Arena
+	{
+		a3_Allocator allocator[1];
+		void *block;
+		a3ui32 blockSize;
+		a3ui32 blockUsed;
+		a3ui32 blockCapacity;
+		a3ui32 used;
+		a3ui32 peak;
+	};
+
+
+	// A3: Fixed-size pool: blocks of one size are carved from chunks and
+	//		recycled through a free list.
+	//	member allocator: interface for this pool
+	//	member chunk: most recent chunk (internal)
+	//	member freeList: first free block (internal)
+	//	member blockSize: size of each block
+	//	member blocksPerChunk: number of blocks added when the pool is empty
+	//	member count: number of blocks in use
+	struct a3_Pool
+	{
+		a3_Allocator allocator[1];
+		void *chunk;
+		void *freeList;
+		a3ui32 blockSize;
+		a3ui32 blocksPerChunk;
+		a3ui32 count;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Allocate using allocator, or the heap if none is given.
+	//	param allocator_opt: pointer to allocator; null to use heap
+	//	param size: non-zero number of bytes
+	//	return: pointer to block if success
+	//	return: null if failed or invalid param
+	void *a3allocatorAlloc(a3_Allocator *allocator_opt, const a3ui32 size);
+
+	// A3: Free block using allocator, or the heap if none is given.
+	//	param allocator_opt: pointer to allocator that returned the block;
+	//		null if the block came from the heap
+	//	param block: pointer to block; null is ignored
+	//	return: 1 if success
+	//	return: 0 if block is null
+	a3ret a3allocatorFree(a3_Allocator *allocator_opt, void *block);
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Create arena and allocate its first block.
+	//	param arena_out: non-null pointer to unused arena
+	//	param blockSize: non-zero minimum size of each block; allocations
+	//		larger than this get a block of their own
+	//	return: block size if success
+	//	return: 0 if failed to allocate
+	//	return: -1 if invalid params or arena already in-use
+	a3ret a3arenaCreate(a3_Arena *arena_out, const a3ui32 blockSize);
+
+	// A3: Allocate from arena.
+	//	param arena: non-null pointer to initialized arena
+	//	param size: non-zero number of bytes
+	//	return: pointer to block if success
+	//	return: null if failed or invalid params
+	void *a3arenaAlloc(a3_Arena *arena, const a3ui32 size);
+
+	// A3: Return all allocations to arena at once; if the arena had to
+	//		grow, its blocks are replaced by one block large enough for
+	//		everything that was allocated (or, if that cannot be allocated,
+	//		by the newest block, and the arena grows again on demand).
+	//	param arena: non-null pointer to initialized arena
+	//	return: number of bytes that were allocated (released) if success
+	//	return: -1 if invalid param
+	a3ret a3arenaReset(a3_Arena *arena);
+
+	// A3: Release all arena memory.
+	//	param arena: non-null pointer to initialized arena
+	//	return: peak number of bytes allocated between resets
+	//	return: -1 if invalid param
+	a3ret a3arenaRelease(a3_Arena *arena);
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Create pool and allocate its first chunk.
+	//	param pool_out: non-null pointer to unused pool
+	//	param blockSize: non-zero size of each block
+	//	param blocksPerChunk: non-zero number of blocks per chunk
+	//	return: number of blocks available if success
+	//	return: 0 if failed to allocate
+	//	return: -1 if invalid params or pool already in-use
+	a3ret a3poolCreate(a3_Pool *pool_out, const a3ui32 blockSize, const a3ui32 blocksPerChunk);
+
+	// A3: Take a block from pool; adds a chunk if none are free.
+	//	param pool: non-null pointer to initialized pool
+	//	return: pointer to block if success
+	//	return: null if failed or invalid param
+	void *a3poolAlloc(a3_Pool *pool);
+
+	// A3: Return a block to pool.
+	//	param pool: non-null pointer to initialized pool
+	//	param block: non-null pointer to block taken from this pool
+	//	return: number of blocks still in use if success
+	//	return: -1 if invalid params
+	a3ret a3poolFree(a3_Pool *pool, void *block);
+
+	// A3: Release all pool memory, including blocks still in use.
+	//	param pool: non-null pointer to initialized pool
+	//	return: number of blocks that were still in use
+	//	return: -1 if invalid param
+	a3ret a3poolRelease(a3_Pool *pool);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_ALLOCATOR_H
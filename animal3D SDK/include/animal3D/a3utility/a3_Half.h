@@ -0,0 +1,66 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+	
+	a3_Half.h
+	Half-float (16-bit) conversion, shared by geometry packing and 
+		texture processing.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_HALF_H
+#define __ANIMAL3D_HALF_H
+
+
+#include "animal3D/a3/a3types_integer.h"
+#include "animal3D/a3/a3types_real.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Convert float to half-float bits, rounding to nearest even.
+	//	param x: value to convert
+	//	return: half-float bits
+	a3ui16 a3halfPack(const a3f32 x);
+
+	// A3: Convert half-float bits to float.
+	//	param h: half-float bits
+	//	return: float value
+	a3f32 a3halfUnpack(const a3ui16 h);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#include "_inl/a3_Half.inl"
+
+
+#endif	// !__ANIMAL3D_HALF_H
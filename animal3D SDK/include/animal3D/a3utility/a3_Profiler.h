@@ -0,0 +1,123 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_Profiler.h
+	Low-overhead CPU profiler: timed zones are recorded per thread and
+		written as Chrome Trace Event JSON (open with chrome://tracing
+		or Perfetto).
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_PROFILER_H
+#define __ANIMAL3D_PROFILER_H
+
+
+#include "animal3D/a3/a3types_integer.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_ProfileZone	a3_ProfileZone;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Profiler limits.
+	//	threadMax: number of threads that can record zones at once; threads
+	//		launched with a3threadLaunch give up their slot when they exit,
+	//		and extra threads are ignored
+	//	eventMax: zones each thread can hold between flushes (power of two);
+	//		zones beyond this are dropped and counted
+	enum a3_ProfilerLimit
+	{
+		a3profiler_threadMax = 16,
+		a3profiler_eventMax = 4096,
+	};
+
+
+	// A3: Zone being timed; keep on the stack between begin and end.
+	//	member name: zone name; must remain valid until flushed (use string
+	//		literals); null if the zone is not being recorded
+	//	member start: counter value when zone began
+	struct a3_ProfileZone
+	{
+		const a3byte *name;
+		a3i64 start;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Start a capture; zones are recorded until capture ends.
+	//	param filePath: non-null cstring path of trace file to write
+	//	return: 1 if capture started
+	//	return: 0 if already capturing or file could not be opened
+	//	return: -1 if invalid param
+	a3ret a3profilerBeginCapture(const a3byte *filePath);
+
+	// A3: Write recorded zones from all threads to the capture file; call
+	//		regularly (e.g. once per frame) from one thread only.
+	//	return: number of zones written
+	//	return: 0 if not capturing
+	a3ret a3profilerFlush();
+
+	// A3: Flush remaining zones and close the capture file.
+	//	return: total number of zones written during capture
+	//	return: 0 if not capturing
+	a3ret a3profilerEndCapture();
+
+	// A3: Check if a capture is running.
+	//	return: 1 if capturing
+	//	return: 0 if not capturing
+	a3ret a3profilerIsCapturing();
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Begin timing a zone; cheap no-op when not capturing.
+	//	param zone: non-null pointer to zone
+	//	param name: non-null cstring name (see zone description)
+	//	return: 1 if zone is being recorded
+	//	return: 0 if not capturing
+	//	return: -1 if invalid params
+	a3ret a3profileZoneBegin(a3_ProfileZone *zone, const a3byte *name);
+
+	// A3: End timing a zone and record it for the calling thread; zones
+	//		must end in reverse order of beginning on each thread.
+	//	param zone: non-null pointer to zone passed to begin
+	//	return: 1 if zone was recorded
+	//	return: 0 if not recorded (not capturing or buffer full)
+	//	return: -1 if invalid param
+	a3ret a3profileZoneEnd(a3_ProfileZone *zone);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_PROFILER_H
@@ -0,0 +1,198 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_Serializer.h
+	Versioned, chunked serialization of a structure's fields: each section
+		of the structure is saved as a chunk that describes its own fields,
+		so it can be restored into a structure whose layout has changed.
+		Chunks whose contents did not change since the last save are not
+		saved again.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_SERIALIZER_H
+#define __ANIMAL3D_SERIALIZER_H
+
+
+#include "animal3D/a3/a3types_integer.h"
+
+#include <stddef.h>
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_SerializerField		a3_SerializerField;
+	typedef struct a3_SerializerSection		a3_SerializerSection;
+	typedef struct a3_SerializerChunk		a3_SerializerChunk;
+	typedef struct a3_Serializer			a3_Serializer;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Limits of serializer.
+	enum a3_SerializerMax
+	{
+		a3serializer_nameMax = 32,		// max length of section or field name
+		a3serializer_chunkMax = 32,		// max sections in one serializer
+	};
+
+
+	// A3: Describe a field of a structure type for a section.
+	//	param type: structure type
+	//	param member: name of member; anonymous union members are allowed
+#define a3serializerField(type, member)	{ #member, (a3ui32)offsetof(type, member), (a3ui32)sizeof(((type *)0)->member) }
+
+
+	// A3: Field migration callback; called for a saved field whose size or
+	//		section version differs from the current one.
+	//	param object: structure being restored
+	//	param field: description of current field
+	//	param savedVersion: version of the section when it was saved
+	//	param savedData: saved contents of field
+	//	param savedSize: size of saved contents
+	//	return: positive if field was restored; zero or negative otherwise
+	typedef a3ret(*a3_SerializerMigrateFunc)(void *object, const a3_SerializerField *field, const a3ui32 savedVersion, const void *savedData, const a3ui32 savedSize);
+
+
+	// A3: Field of a structure.
+	//	member name: unique name of field in section; used to match saved
+	//		fields with current ones
+	//	member offset: offset of field in structure
+	//	member size: size of field in bytes
+	struct a3_SerializerField
+	{
+		const a3byte *name;
+		a3ui32 offset, size;
+	};
+
+
+	// A3: Section of a structure, saved and restored as one chunk.
+	//	member name: unique name of section
+	//	member version: version of section's contents; fields of a chunk
+	//		saved with a different version are only restored by migration
+	//	member fieldList: fields in section
+	//	member fieldCount: number of fields
+	//	member migrate_opt: optional field migration callback
+	struct a3_SerializerSection
+	{
+		const a3byte *name;
+		a3ui32 version;
+		const a3_SerializerField *fieldList;
+		a3ui32 fieldCount;
+		a3_SerializerMigrateFunc migrate_opt;
+	};
+
+
+	// A3: Saved section.
+	//	member name: name of section
+	//	member version: version of section when saved
+	//	member fieldCount: number of saved fields
+	//	member size: size of data in bytes
+	//	member layout: hash of section's version and field names and sizes
+	//	member hash: hash of saved field contents
+	//	member data: field descriptions followed by field contents
+	struct a3_SerializerChunk
+	{
+		a3byte name[a3serializer_nameMax];
+		a3ui32 version, fieldCount, size;
+		a3ui64 layout, hash;
+		void *data;
+	};
+
+
+	// A3: Serializer; holds saved chunks in memory, e.g. to pass state
+	//		from one build of a library to the next.
+	//	member tag: identifies a created serializer (see check below)
+	//	member chunkCount: number of chunks
+	//	member chunk: saved chunks
+	struct a3_Serializer
+	{
+		a3ui32 tag;
+		a3ui32 chunkCount;
+		a3_SerializerChunk chunk[a3serializer_chunkMax];
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Create empty serializer.
+	//	param serializer_out: non-null pointer to unused serializer
+	//	return: 1 if success
+	//	return: -1 if invalid param or serializer already in-use
+	a3ret a3serializerCreate(a3_Serializer *serializer_out);
+
+	// A3: Check if memory holds a created serializer, e.g. to tell a
+	//		serializer from a raw structure passed through the same pointer.
+	//	param ptr: non-null pointer to memory to check
+	//	return: 1 if memory holds a serializer
+	//	return: 0 if not
+	//	return: -1 if invalid param
+	a3ret a3serializerCheck(const void *ptr);
+
+	// A3: Save sections of structure; sections whose layout and contents
+	//		match their saved chunks are skipped.
+	//	param serializer: non-null pointer to created serializer
+	//	param object: non-null pointer to structure
+	//	param sectionList: non-null array of sections
+	//	param count: number of sections
+	//	return: number of chunks written
+	//	return: -1 if invalid params
+	a3ret a3serializerSave(a3_Serializer *serializer, const void *object, const a3_SerializerSection *sectionList, const a3ui32 count);
+
+	// A3: Restore sections of structure; fields are matched with saved
+	//		fields by name, so fields that were added, removed or moved do
+	//		not prevent others from being restored.
+	//	param serializer: non-null pointer to created serializer
+	//	param object: non-null pointer to structure
+	//	param sectionList: non-null array of sections
+	//	param count: number of sections
+	//	param sectionRestored_out_opt: optional array of one flag per
+	//		section; set to 1 if every field in section was restored
+	//	return: number of sections fully restored
+	//	return: -1 if invalid params
+	a3ret a3serializerLoad(const a3_Serializer *serializer, void *object, const a3_SerializerSection *sectionList, const a3ui32 count, a3boolean *sectionRestored_out_opt);
+
+	// A3: Zero all fields of section in structure.
+	//	param object: non-null pointer to structure
+	//	param section: non-null pointer to section
+	//	return: number of fields cleared
+	//	return: -1 if invalid params
+	a3ret a3serializerClear(void *object, const a3_SerializerSection *section);
+
+	// A3: Release serializer and its chunks.
+	//	param serializer: non-null pointer to created serializer
+	//	return: number of chunks released
+	//	return: -1 if invalid param or not created
+	a3ret a3serializerRelease(a3_Serializer *serializer);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_SERIALIZER_H
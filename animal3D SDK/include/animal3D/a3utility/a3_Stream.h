@@ -30,6 +30,7 @@
 
 
 #include "animal3D/a3/a3types_integer.h"
+#include "animal3D/a3utility/a3_Allocator.h"
 
 
 #ifdef __cplusplus
@@ -48,12 +49,16 @@ extern "C"
 	//	member ptr: iterator for streaming
 	//	member length: length of contents in bytes
 	//	member offset: offset of ptr from contents start
+	//	member allocator: allocator that owns contents; null for heap
+	//	member mapped: contents are a private mapping of a file (see below)
 	struct a3_Stream
 	{
 		const a3byte *contents;
 		a3byte *ptr;
 		a3ui32 length;
 		a3ui32 offset;
+		a3_Allocator *allocator;
+		a3boolean mapped;
 	};
 
 
@@ -100,10 +105,24 @@ extern "C"
 	// A3: Load contents of file.
 	//	param stream_out: non-null pointer to unused stream info structure
 	//	param filePath: non-null, non-empty cstring of relative / absolute path
+	//	param allocator_opt: allocator for contents; null to use heap
 	//	return: file length if success
 	//	return: 0 if file load failed
 	//	return: -1 if invalid params or already in-use
-	a3ret a3streamLoadContents(a3_Stream *stream_out, const a3byte *filePath);
+	a3ret a3streamLoadContents(a3_Stream *stream_out, const a3byte *filePath, a3_Allocator *allocator_opt);
+
+	// A3: Map contents of file into memory instead of copying them; pages 
+	//		are read on first access with sequential read-ahead. Contents 
+	//		are null-terminated and writable like loaded contents (writes 
+	//		are private and never reach the file). Falls back to loading 
+	//		from heap if the file cannot be mapped or its size is an exact 
+	//		multiple of the page size (no room for the terminator).
+	//	param stream_out: non-null pointer to unused stream info structure
+	//	param filePath: non-null, non-empty cstring of relative / absolute path
+	//	return: file length if success
+	//	return: 0 if file load failed
+	//	return: -1 if invalid params or already in-use
+	a3ret a3streamMapContents(a3_Stream *stream_out, const a3byte *filePath);
 
 	// A3: Write contents to file.
 	//	param stream: non-null pointer to stream descriptor to write
@@ -136,7 +155,8 @@ extern "C"
 	a3ret a3streamReset(a3_Stream *stream);
 
 	// A3: Release stream contents; only use this on streams loaded using the 
-	//		above functions to avoid heap corruption.
+	//		above functions to avoid heap corruption. Contents are returned 
+	//		to the allocator they were loaded with, or unmapped.
 	//	param stream: non-null pointer to file descriptor to release
 	//	return: file length if success
 	//	return: -1 if invalid params or stream does not have contents
@@ -0,0 +1,173 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_StreamQueue.h
+	Asynchronous file reading: requests are handed to a background I/O
+		thread so the caller can keep working while files load. On Linux
+		whole-file reads are batched through io_uring when the kernel
+		supports it; otherwise the thread reads files one at a time.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_STREAMQUEUE_H
+#define __ANIMAL3D_STREAMQUEUE_H
+
+
+#include "animal3D/a3/a3types_integer.h"
+#include "animal3D/a3utility/a3_Stream.h"
+#include "animal3D/a3utility/a3_Thread.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_StreamRequest	a3_StreamRequest;
+	typedef struct a3_StreamQueue	a3_StreamQueue;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Completion callback; called from poll or wait on the thread that
+	//		calls them, never from the I/O thread.
+	//	param request: request that finished
+	//	param user: pointer passed when request was submitted
+	typedef void(*a3_StreamRequestFunc)(a3_StreamRequest *request, void *user);
+
+
+	// A3: Read request; owned by the caller and must remain valid until
+	//		it is done, or until its callback was called if it has one.
+	//	member stream: file contents once done (contents read only);
+	//		release with stream release function
+	//	member filePath: path of file being read
+	//	member object: object being read (object read only)
+	//	member readFunc: function reading object (object read only)
+	//	member callback: function to call when done; may be null
+	//	member user: pointer passed to callback
+	//	member next: link to next request (internal)
+	//	member file: file descriptor while being read (internal)
+	//	member result: number of bytes read when done; 0 if failed
+	//	member done: raised when reading has finished (see check below)
+	struct a3_StreamRequest
+	{
+		a3_Stream stream[1];
+		const a3byte *filePath;
+		void *object;
+		a3_FileStreamReadFunc readFunc;
+		a3_StreamRequestFunc callback;
+		void *user;
+		a3_StreamRequest *next;
+		a3i32 file;
+		a3ret result;
+		volatile a3boolean done;
+	};
+
+
+	// A3: Queue of read requests served by one I/O thread.
+	//	member thread: I/O thread
+	//	member internal: platform-specific state (internal)
+	//	member ring: non-zero if whole-file reads go through io_uring
+	struct a3_StreamQueue
+	{
+		a3_Thread thread[1];
+		void *internal;
+		a3boolean ring;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// A3: Create queue and launch its I/O thread.
+	//	param queue_out: non-null pointer to unused queue
+	//	return: 1 if success
+	//	return: 0 if failed to create thread
+	//	return: -1 if invalid param or queue already in-use
+	a3ret a3streamQueueCreate(a3_StreamQueue *queue_out);
+
+	// A3: Submit request to read whole contents of a file into the
+	//		request's stream; same result as loading the stream directly.
+	//	param queue: non-null pointer to initialized queue
+	//	param request: non-null pointer to request whose stream is unused
+	//	param filePath: non-null, non-empty cstring of file path; must
+	//		remain valid until request is done
+	//	param callback_opt: optional function to call when done
+	//	param user_opt: optional pointer to pass to callback
+	//	return: 1 if submitted
+	//	return: -1 if invalid params or request in-use
+	a3ret a3streamQueueReadContents(a3_StreamQueue *queue, a3_StreamRequest *request, const a3byte *filePath, a3_StreamRequestFunc callback_opt, void *user_opt);
+
+	// A3: Submit request to read an object from a file stream; same
+	//		result as opening a file stream and reading the object, except
+	//		that the read function runs on the I/O thread.
+	//	param queue: non-null pointer to initialized queue
+	//	param request: non-null pointer to request whose stream is unused
+	//	param filePath: non-null, non-empty cstring of file path; must
+	//		remain valid until request is done
+	//	param object: non-null pointer to object to read; must not be
+	//		touched by caller until request is done
+	//	param streamReadFunc: non-null function reading object
+	//	param callback_opt: optional function to call when done
+	//	param user_opt: optional pointer to pass to callback
+	//	return: 1 if submitted
+	//	return: -1 if invalid params or request in-use
+	a3ret a3streamQueueReadObject(a3_StreamQueue *queue, a3_StreamRequest *request, const a3byte *filePath, void *object, const a3_FileStreamReadFunc streamReadFunc, a3_StreamRequestFunc callback_opt, void *user_opt);
+
+	// A3: Check if request is done without waiting; suitable for polling
+	//		requests that have no callback.
+	//	param request: non-null pointer to submitted request
+	//	return: 1 if done
+	//	return: 0 if still pending
+	//	return: -1 if invalid param
+	a3ret a3streamRequestIsDone(const a3_StreamRequest *request);
+
+	// A3: Call callbacks of requests that finished since last poll; call
+	//		regularly (e.g. once per frame) from the thread that should
+	//		handle results.
+	//	param queue: non-null pointer to initialized queue
+	//	return: number of callbacks called
+	//	return: -1 if invalid param
+	a3ret a3streamQueuePoll(a3_StreamQueue *queue);
+
+	// A3: Wait until request (or all requests) are done, then poll.
+	//	param queue: non-null pointer to initialized queue
+	//	param request_opt: optional pointer to request to wait for; null
+	//		to wait for everything submitted
+	//	return: number of callbacks called
+	//	return: -1 if invalid params
+	a3ret a3streamQueueWait(a3_StreamQueue *queue, a3_StreamRequest *request_opt);
+
+	// A3: Finish all requests, stop I/O thread and release queue.
+	//	param queue: non-null pointer to initialized queue
+	//	return: number of requests served by the queue
+	//	return: -1 if invalid param
+	a3ret a3streamQueueRelease(a3_StreamQueue *queue);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_STREAMQUEUE_H
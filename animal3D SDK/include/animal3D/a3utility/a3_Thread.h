@@ -145,6 +145,23 @@ extern "C"
 	a3ret a3mutexIsLockedByCaller(a3_MutexHandle *mutex);
 
 
+//-----------------------------------------------------------------------------
+
+	// A3: Atomically add one to a counter shared between threads; use the 
+	//		result to claim work items (e.g. result - 1 as next index).
+	//	param counter: non-null pointer to shared counter
+	//	return: value of counter after adding
+	a3i32 a3atomicIncrement(volatile a3i32 *counter);
+
+	// A3: Full memory barrier; writes before it are visible to other 
+	//		threads before writes after it (e.g. data before a flag).
+	void a3atomicBarrier();
+
+	// A3: Give the rest of the calling thread's time slice to another 
+	//		thread; use in spin-waits.
+	void a3threadYield();
+
+
 //-----------------------------------------------------------------------------
 
 
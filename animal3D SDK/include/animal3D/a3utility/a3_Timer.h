@@ -123,6 +123,22 @@ extern "C"
 	//	return: -1 if invalid param
 	a3ret a3timerUpdate(a3_Timer *timer);
 
+	// A3: Advance timer by exactly one tick without taking a measurement; 
+	//		use to drive fixed-step updates faster or slower than real time.
+	//	param timer: non-null pointer to timer object with a tick rate
+	//	return: 1 if timer ticked
+	//	return: 0 if timer is not running
+	//	return: -1 if invalid param or timer is continuous
+	a3ret a3timerStep(a3_Timer *timer);
+
+	// A3: Read the high-precision counter used by timers without changing 
+	//		any timer; use for cheap timestamps.
+	//	param counter_out: non-null pointer to capture counter value
+	//	param frequency_out_opt: optional pointer to capture counts per second
+	//	return: 1 if success
+	//	return: -1 if invalid param
+	a3ret a3timerGetCounter(a3i64 *counter_out, a3i64 *frequency_out_opt);
+
 
 //-----------------------------------------------------------------------------
 
@@ -32,9 +32,14 @@
 //-----------------------------------------------------------------------------
 // A3: Utility includes.
 
+#include "animal3D/a3utility/a3_Allocator.h"
+#include "animal3D/a3utility/a3_Half.h"
 #include "animal3D/a3utility/a3_Stream.h"
+#include "animal3D/a3utility/a3_StreamQueue.h"
 #include "animal3D/a3utility/a3_Timer.h"
 #include "animal3D/a3utility/a3_Thread.h"
+#include "animal3D/a3utility/a3_Profiler.h"
+#include "animal3D/a3utility/a3_Serializer.h"
 
 
 //-----------------------------------------------------------------------------
@@ -44,6 +49,7 @@
 #include "animal3D/a3input/a3_MouseInput.h"
 #include "animal3D/a3input/a3_KeyboardInput.h"
 #include "animal3D/a3input/a3_XboxControllerInput.h"
+#include "animal3D/a3input/a3_InputRecorder.h"
 
 
 //-----------------------------------------------------------------------------
@@ -52,6 +58,10 @@
 #include "animal3D/a3geometry/a3_GeometryData.h"
 #include "animal3D/a3geometry/a3_ProceduralGeometry.h"
 #include "animal3D/a3geometry/a3_ModelLoader_WavefrontOBJ.h"
+#include "animal3D/a3geometry/a3_GeometryOptimize.h"
+#include "animal3D/a3geometry/a3_GeometryMeshlet.h"
+#include "animal3D/a3geometry/a3_GeometrySimplify.h"
+#include "animal3D/a3geometry/a3_GeometryQuantize.h"
 
 
 //-----------------------------------------------------------------------------
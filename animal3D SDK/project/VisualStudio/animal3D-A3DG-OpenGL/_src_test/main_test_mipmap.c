@@ -0,0 +1,211 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	main_test_mipmap.c
+	Mipmap box filter check: generates chains of float, half and 8-bit
+		images, with even and odd sizes, and compares every level with
+		a reference box filter computed in double precision, where each
+		output pixel is the area-weighted average of the source pixels
+		its footprint covers; stored levels may only differ by rounding.
+		Chains are generated with one thread and with several, and must
+		be identical. Exits with the number of failed cases.
+
+	usage: <test>
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+
+#include "animal3D-A3DG/a3graphics/a3_TextureMipmap.h"
+#include "animal3D/a3utility/a3_Half.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// data
+
+// image sizes: square power of two, wide, odd on both axes
+static const a3ui32 a3test_size[][2] = {
+	{ 256, 256 },
+	{ 512, 32 },
+	{ 300, 201 },
+};
+
+// formats and largest difference from reference (in [0, 1] units)
+static const struct {
+	const a3byte *name;
+	a3_TexturePixelType pixelType;
+	a3f64 tolerance;
+} a3test_format[] = {
+	{ "rgba32F", a3tex_rgba32F, 1.0e-5 },
+	{ "rgba16F", a3tex_rgba16F, 1.0e-3 },
+	{ "rgba8", a3tex_rgba8, 0.5 / 255.0 + 1.0e-5 },
+};
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// pattern in [0, 1] with detail at every scale
+a3f64 a3testInternalPattern(const a3ui32 x, const a3ui32 y, const a3ui32 c)
+{
+	return 0.5 + 0.25 * sin(0.37 * x + 1.3 * c) * cos(0.21 * y) + 0.25 * (((x * 7 + y * 13 + c * 5) % 17) / 16.0 - 0.5);
+}
+
+// value of pixel channel as stored, in [0, 1] units
+a3f64 a3testInternalLoad(const void *data, const a3_TexturePixelType pixelType, const a3ui32 i)
+{
+	if (pixelType == a3tex_rgba8)
+		return ((const a3ubyte *)data)[i] / 255.0;
+	else if (pixelType == a3tex_rgba16F)
+		return a3halfUnpack(((const a3ui16 *)data)[i]);
+	return ((const a3f32 *)data)[i];
+}
+
+// reduce reference level: each output pixel averages the source area
+//	under its footprint, weighted by how much of each pixel it covers
+void a3testInternalBoxFilter(a3f64 *dst, const a3ui32 dstW, const a3ui32 dstH, const a3f64 *src, const a3ui32 srcW, const a3ui32 srcH)
+{
+	const a3f64 sx = (a3f64)srcW / dstW, sy = (a3f64)srcH / dstH;
+	a3f64 x0, x1, y0, y1, wx, wy, sum[4], total;
+	a3ui32 x, y, i, j, c;
+	for (y = 0; y < dstH; ++y)
+		for (x = 0; x < dstW; ++x)
+		{
+			y0 = y * sy, y1 = y0 + sy, x0 = x * sx, x1 = x0 + sx;
+			sum[0] = sum[1] = sum[2] = sum[3] = total = 0.0;
+			for (j = (a3ui32)y0; j < srcH && j < y1; ++j)
+				for (i = (a3ui32)x0; i < srcW && i < x1; ++i)
+				{
+					wy = (j + 1 < y1 ? j + 1 : y1) - (j > y0 ? j : y0);
+					wx = (i + 1 < x1 ? i + 1 : x1) - (i > x0 ? i : x0);
+					for (c = 0; c < 4; ++c)
+						sum[c] += wx * wy * src[(j * srcW + i) * 4 + c];
+					total += wx * wy;
+				}
+			for (c = 0; c < 4; ++c)
+				dst[(y * dstW + x) * 4 + c] = sum[c] / total;
+		}
+}
+
+// generate chain and compare every level; returns number of problems
+a3ui32 a3testInternalRun(const a3ui32 width, const a3ui32 height, const a3ui32 format)
+{
+	const a3_TexturePixelType pixelType = a3test_format[format].pixelType;
+	const a3ui32 pixelSize = pixelType == a3tex_rgba8 ? 4 : pixelType == a3tex_rgba16F ? 8 : 16;
+	a3_TextureMipmapChain chain[1] = { 0 }, chainThreads[1] = { 0 };
+	a3f64 *ref = (a3f64 *)malloc(width * height * 4 * sizeof(a3f64));
+	a3f64 *refNext = (a3f64 *)malloc(width * height * 4 * sizeof(a3f64)), *swap;
+	void *image = malloc(width * height * pixelSize);
+	a3f64 d, worst = 0.0;
+	a3ui32 x, y, c, i, l, n, levels = 0, errors = 0;
+
+	if (!ref || !refNext || !image)
+	{
+		free(ref);
+		free(refNext);
+		free(image);
+		return 1;
+	}
+
+	// image, and reference holding exactly what was stored
+	for (y = 0; y < height; ++y)
+		for (x = 0; x < width; ++x)
+			for (c = 0; c < 4; ++c)
+			{
+				i = (y * width + x) * 4 + c;
+				d = a3testInternalPattern(x, y, c);
+				if (pixelType == a3tex_rgba8)
+					((a3ubyte *)image)[i] = (a3ubyte)(d * 255.0 + 0.5);
+				else if (pixelType == a3tex_rgba16F)
+					((a3ui16 *)image)[i] = a3halfPack((a3f32)d);
+				else
+					((a3f32 *)image)[i] = (a3f32)d;
+				ref[i] = a3testInternalLoad(image, pixelType, i);
+			}
+
+	// one thread and several must agree exactly
+	if (a3textureMipmapGenerate(chain, pixelType, width, height, image, a3tex_mipFilterBox, 0, 1) > 0 &&
+		a3textureMipmapGenerate(chainThreads, pixelType, width, height, image, a3tex_mipFilterBox, 0, 4) > 0)
+	{
+		levels = chain->levels;
+		errors += (chainThreads->levels != levels || chainThreads->size != chain->size);
+		errors += (errors || memcmp(chain->data, chainThreads->data, chain->size) != 0);
+
+		// every level against reference
+		for (l = 1; l < levels && !errors; ++l)
+		{
+			a3testInternalBoxFilter(refNext, chain->width[l], chain->height[l], ref, chain->width[l - 1], chain->height[l - 1]);
+			for (i = 0, n = chain->width[l] * chain->height[l] * 4; i < n; ++i)
+			{
+				d = fabs(a3testInternalLoad((const a3byte *)chain->data + chain->offset[l], pixelType, i) - refNext[i]);
+				worst = d > worst ? d : worst;
+				errors += (d > a3test_format[format].tolerance);
+			}
+
+			// levels are filtered from unrounded values, as generated
+			swap = ref;
+			ref = refNext;
+			refNext = swap;
+		}
+		a3textureMipmapRelease(chain);
+		a3textureMipmapRelease(chainThreads);
+	}
+	else
+		++errors;
+
+	printf("%-8s %4ux%-4u %-4s %2u levels, worst difference %.3g, %u errors\n",
+		a3test_format[format].name, width, height, errors ? "FAIL" : "pass", levels, worst, errors);
+	free(ref);
+	free(refNext);
+	free(image);
+	return errors;
+}
+
+
+//-----------------------------------------------------------------------------
+// main
+
+int main(int argc, char **argv)
+{
+	const a3ui32 sizeCount = sizeof(a3test_size) / sizeof(*a3test_size);
+	const a3ui32 formatCount = sizeof(a3test_format) / sizeof(*a3test_format);
+	a3ui32 s, f, failed = 0;
+
+	if (argc > 1)
+	{
+		printf("usage: %s\n", argv[0]);
+		return -1;
+	}
+
+	printf("mipmap box filter: levels match reference\n");
+	for (f = 0; f < formatCount; ++f)
+		for (s = 0; s < sizeCount; ++s)
+			failed += (a3testInternalRun(a3test_size[s][0], a3test_size[s][1], f) != 0);
+	printf("%u of %u cases failed\n", failed, sizeCount * formatCount);
+	return (int)failed;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,291 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	main_test_texturecompress.c
+	Block compression round trip: encodes 4x4 gradient blocks as BC1 and
+		BC3, decodes the color endpoints and checks that they span the
+		range of every channel of the input, to within the precision of
+		the 565 endpoints. Gradients run along one channel and diagonally
+		across several, in the same and in opposite directions and at
+		different rates, so that the endpoints must be found on the axis
+		of the gradient, at unit length. Then encodes the same gradients,
+		with alpha running across the block, as BC5 and BC7, decodes
+		every pixel and checks that each channel is within half a step
+		of the block's palette (plus endpoint rounding) of the input.
+		Alpha runs along the gradient, so every block lies on one line
+		and one subset can represent it.
+		Exits with the number of failed cases.
+
+	usage: <test>
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+
+#include "animal3D-A3DG/a3graphics/a3_TextureCompress.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+//-----------------------------------------------------------------------------
+// data
+
+// largest distance between an endpoint and the end of the input range:
+//	one step of a five-bit channel
+#define A3_TEST_ENDPOINT_TOLERANCE	9
+
+// largest decoded error past half a palette step: BC5 endpoints are
+//	exact, BC7 endpoints lose their low bit to the shared bit
+#define A3_TEST_ROUNDTRIP_TOLERANCE_BC5	1
+#define A3_TEST_ROUNDTRIP_TOLERANCE_BC7	2
+
+// one gradient: channel c of pixel (x, y) is base[c] + dx[c] * x + dy[c] * y
+typedef struct a3_TestGradient
+{
+	const a3byte *name;
+	a3i32 base[3], dx[3], dy[3];
+} a3_TestGradient;
+
+static const a3_TestGradient a3test_gradient[] = {
+	{ "red along x",				{   0,   0,   0 },	{  80,   0,   0 },	{   0,   0,   0 } },
+	{ "red and green along x",		{   0,   0,   0 },	{  80,  80,   0 },	{   0,   0,   0 } },
+	{ "gray along x and y",			{  10,  10,  10 },	{  40,  40,  40 },	{  40,  40,  40 } },
+	{ "green up, blue down",		{  20,  60, 240 },	{   0,  30, -30 },	{   0,  30, -30 } },
+	{ "red steep, blue shallow",	{  16,  32,  48 },	{  30,   0,  15 },	{  30,   0,  15 } },
+};
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// fill 4x4 rgba block with gradient
+void a3testInternalFill(a3ubyte block[16][4], const a3_TestGradient *gradient)
+{
+	a3ui32 x, y, c;
+	for (y = 0; y < 4; ++y)
+		for (x = 0; x < 4; ++x)
+		{
+			for (c = 0; c < 3; ++c)
+				block[y * 4 + x][c] = (a3ubyte)(gradient->base[c] + gradient->dx[c] * (a3i32)x + gradient->dy[c] * (a3i32)y);
+			block[y * 4 + x][3] = 255;
+		}
+}
+
+// decode 565 endpoints of color block to 8 bits per channel
+void a3testInternalDecodeEndpoints(a3i32 endpoint[2][3], const a3ubyte *color)
+{
+	a3ui32 i, c, r, g, b;
+	for (i = 0; i < 2; ++i)
+	{
+		c = (a3ui32)color[i * 2] | ((a3ui32)color[i * 2 + 1] << 8);
+		r = (c >> 11) & 31;
+		g = (c >> 5) & 63;
+		b = c & 31;
+		endpoint[i][0] = (r << 3) | (r >> 2);
+		endpoint[i][1] = (g << 2) | (g >> 4);
+		endpoint[i][2] = (b << 3) | (b >> 2);
+	}
+}
+
+// check that endpoints span the input range of every channel
+a3boolean a3testInternalSpans(a3i32 endpoint[2][3], a3ubyte block[16][4], a3i32 error_out[3])
+{
+	a3i32 lo, hi, eLo, eHi, d;
+	a3ui32 i, c;
+	a3boolean ret = 1;
+	for (c = 0; c < 3; ++c)
+	{
+		for (i = 1, lo = hi = block[0][c]; i < 16; ++i)
+		{
+			lo = block[i][c] < lo ? block[i][c] : lo;
+			hi = block[i][c] > hi ? block[i][c] : hi;
+		}
+		eLo = endpoint[0][c] < endpoint[1][c] ? endpoint[0][c] : endpoint[1][c];
+		eHi = endpoint[0][c] > endpoint[1][c] ? endpoint[0][c] : endpoint[1][c];
+		d = abs(eLo - lo) > abs(eHi - hi) ? abs(eLo - lo) : abs(eHi - hi);
+		error_out[c] = d;
+		if (d > A3_TEST_ENDPOINT_TOLERANCE)
+			ret = 0;
+	}
+	return ret;
+}
+
+// read bits from block, least significant first
+a3ui32 a3testInternalReadBits(const a3ubyte *src, a3ui32 *bit, const a3ui32 count)
+{
+	a3ui32 i, value = 0;
+	for (i = 0; i < count; ++i, ++*bit)
+		value |= (a3ui32)((src[*bit >> 3] >> (*bit & 7)) & 1) << i;
+	return value;
+}
+
+// decode single channel block (BC4, halves of BC5) into one channel
+void a3testInternalDecodeChannel(a3ubyte block_out[16][4], const a3ubyte *src, const a3ui32 channel)
+{
+	const a3i32 e0 = src[0], e1 = src[1];
+	a3i32 palette[8];
+	a3ui32 i, bit = 16;
+	palette[0] = e0;
+	palette[1] = e1;
+	for (i = 2; i < 8; ++i)
+		if (e0 > e1)
+			palette[i] = ((8 - i) * e0 + (i - 1) * e1 + 3) / 7;
+		else
+			palette[i] = i < 6 ? ((6 - i) * e0 + (i - 1) * e1 + 2) / 5 : i < 7 ? 0 : 255;
+	for (i = 0; i < 16; ++i)
+		block_out[i][channel] = (a3ubyte)palette[a3testInternalReadBits(src, &bit, 3)];
+}
+
+// decode BC7 block; only mode 6 (one subset, 4-bit indices) is 
+//	supported, returns 0 for any other mode
+a3boolean a3testInternalDecodeBC7(a3ubyte block_out[16][4], const a3ubyte *src)
+{
+	static const a3i32 weight[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64, };
+	a3i32 e[2][4];
+	a3ui32 i, j, p, index, bit = 0;
+	if (a3testInternalReadBits(src, &bit, 7) != 1 << 6)
+		return 0;
+	for (j = 0; j < 4; ++j)
+		for (i = 0; i < 2; ++i)
+			e[i][j] = (a3i32)a3testInternalReadBits(src, &bit, 7) << 1;
+	for (i = 0; i < 2; ++i)
+		for (j = 0, p = a3testInternalReadBits(src, &bit, 1); j < 4; ++j)
+			e[i][j] |= p;
+	for (i = 0; i < 16; ++i)
+	{
+		index = a3testInternalReadBits(src, &bit, i ? 4 : 3);
+		for (j = 0; j < 4; ++j)
+			block_out[i][j] = (a3ubyte)(((64 - weight[index]) * e[0][j] + weight[index] * e[1][j] + 32) >> 6);
+	}
+	return 1;
+}
+
+// encode one gradient and check the color endpoints
+a3boolean a3testInternalRun(const a3_TestGradient *gradient, const a3_TextureCompressFormat format, const a3ui32 colorOffset, const a3byte *formatName)
+{
+	a3_TextureCompressed compressed[1] = { 0 };
+	a3ubyte block[16][4];
+	a3i32 endpoint[2][3], error[3];
+	a3boolean ret = 0;
+
+	a3testInternalFill(block, gradient);
+	if (a3textureCompressEncode(compressed, format, 4, 4, block, 1) > 0)
+	{
+		a3testInternalDecodeEndpoints(endpoint, (const a3ubyte *)compressed->data + colorOffset);
+		ret = a3testInternalSpans(endpoint, block, error);
+		printf("%-6s %-28s %-4s (%3d %3d %3d) - (%3d %3d %3d), error %d %d %d\n",
+			formatName, gradient->name, ret ? "pass" : "FAIL",
+			endpoint[1][0], endpoint[1][1], endpoint[1][2], endpoint[0][0], endpoint[0][1], endpoint[0][2],
+			error[0], error[1], error[2]);
+		a3textureCompressRelease(compressed);
+	}
+	else
+		printf("%-6s %-28s FAIL (could not encode)\n", formatName, gradient->name);
+	return ret;
+}
+
+// encode one gradient, with alpha, decode it and check every channel 
+//	against the palette resolution of the block
+a3boolean a3testInternalRoundTrip(const a3_TestGradient *gradient, const a3_TextureCompressFormat format, const a3byte *formatName)
+{
+	const a3ui32 channels = format == a3tex_compressBC5 ? 2 : 4, steps = format == a3tex_compressBC5 ? 7 : 15;
+	const a3i32 tolerance = format == a3tex_compressBC5 ? A3_TEST_ROUNDTRIP_TOLERANCE_BC5 : A3_TEST_ROUNDTRIP_TOLERANCE_BC7;
+	a3_TextureCompressed compressed[1] = { 0 };
+	a3ubyte block[16][4], decoded[16][4] = { 0 };
+	a3i32 lo, hi, d, error[4] = { 0 }, limit[4] = { 0 };
+	a3ui32 i, c, x, y;
+	a3boolean ret = 0;
+
+	// alpha runs along the gradient so the block stays on one line
+	a3testInternalFill(block, gradient);
+	for (i = 0, x = (gradient->dx[0] || gradient->dx[1] || gradient->dx[2]), y = (gradient->dy[0] || gradient->dy[1] || gradient->dy[2]); i < 16; ++i)
+		block[i][3] = (a3ubyte)(255 - (i % 4 * x + i / 4 * y) * 30);
+	if (a3textureCompressEncode(compressed, format, 4, 4, block, 1) > 0)
+	{
+		if (format == a3tex_compressBC5)
+		{
+			a3testInternalDecodeChannel(decoded, (const a3ubyte *)compressed->data, 0);
+			a3testInternalDecodeChannel(decoded, (const a3ubyte *)compressed->data + 8, 1);
+			ret = 1;
+		}
+		else
+			ret = a3testInternalDecodeBC7(decoded, (const a3ubyte *)compressed->data);
+
+		// every channel within half a step of the input range
+		for (c = 0; c < channels && ret; ++c)
+		{
+			for (i = 1, lo = hi = block[0][c]; i < 16; ++i)
+			{
+				lo = block[i][c] < lo ? block[i][c] : lo;
+				hi = block[i][c] > hi ? block[i][c] : hi;
+			}
+			limit[c] = (hi - lo + steps) / (steps * 2) + tolerance;
+			for (i = 0; i < 16; ++i)
+			{
+				d = abs((a3i32)decoded[i][c] - (a3i32)block[i][c]);
+				error[c] = d > error[c] ? d : error[c];
+			}
+			ret = (error[c] <= limit[c]);
+		}
+		printf("%-6s %-28s %-4s error %2d %2d %2d %2d, limit %2d %2d %2d %2d\n",
+			formatName, gradient->name, ret ? "pass" : "FAIL",
+			error[0], error[1], error[2], error[3], limit[0], limit[1], limit[2], limit[3]);
+		a3textureCompressRelease(compressed);
+	}
+	else
+		printf("%-6s %-28s FAIL (could not encode)\n", formatName, gradient->name);
+	return ret;
+}
+
+
+//-----------------------------------------------------------------------------
+// main
+
+int main(int argc, char **argv)
+{
+	const a3ui32 count = sizeof(a3test_gradient) / sizeof(*a3test_gradient);
+	a3ui32 i;
+	a3i32 failed = 0;
+
+	if (argc > 1)
+	{
+		printf("usage: %s\n", argv[0]);
+		return -1;
+	}
+
+	printf("texture compression round trip: color endpoints of %u gradients\n", count);
+	for (i = 0; i < count; ++i)
+	{
+		failed += !a3testInternalRun(a3test_gradient + i, a3tex_compressBC1, 0, "BC1");
+		failed += !a3testInternalRun(a3test_gradient + i, a3tex_compressBC3, 8, "BC3");
+	}
+	printf("texture compression round trip: decoded pixels of %u gradients\n", count);
+	for (i = 0; i < count; ++i)
+	{
+		failed += !a3testInternalRoundTrip(a3test_gradient + i, a3tex_compressBC5, "BC5");
+		failed += !a3testInternalRoundTrip(a3test_gradient + i, a3tex_compressBC7, "BC7");
+	}
+	printf("%d of %u cases failed\n", failed, count * 4);
+	return failed;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,417 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	animal3D Math (A3DM) SDK
+	By Daniel S. Buckstein
+
+	main_bench_a3dm.c
+	Micro-benchmarks of hot A3DM functions: each case runs a function over 
+		arrays of inputs until enough time has passed to measure, and the 
+		best of several trials is reported as time per call and throughput.
+		Build once with the default real type and once with A3_REAL_F64 to 
+		compare precisions.
+
+	usage: <bench> [-count <elements>] [-time <ms per trial>] 
+		[-trials <count>] [-filter <substring>] [-csv <file>]
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+
+// compile math inline in this file so that the real type chosen for this 
+//	build is used, not the one the library was compiled with
+#define A3_OPEN_SOURCE
+#include "animal3D-A3DM/animal3D-A3DM.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined _WINDOWS || defined _WIN32)
+#include <Windows.h>
+#else	// !(defined _WINDOWS || defined _WIN32)
+#include <time.h>
+#endif	// (defined _WINDOWS || defined _WIN32)
+
+
+//-----------------------------------------------------------------------------
+// data
+
+// largest number of elements per pass; the default of 1024 keeps every 
+//	array in cache so that the math is measured, not memory
+#define A3_BENCH_COUNT_MAX	65536
+
+// one benchmark case: runs the function once over count elements
+typedef struct a3_BenchCase
+{
+	const a3byte *name;
+	void(*func)(const a3ui32 count);
+	a3ui32 bytesPerOp;
+} a3_BenchCase;
+
+static a3real4x4 *a3bench_mat4[3];
+static a3real4x2 *a3bench_dualquat[5];
+static a3real4 *a3bench_quat[3];
+static a3real3 *a3bench_vec3[3];
+static a3real *a3bench_scalar[5];
+
+// trig table, same resolution as the demos use
+#define A3_BENCH_TRIG_SAMPLES	4
+static a3real a3bench_trigTable[(A3_BENCH_TRIG_SAMPLES * 720 + 1) * 3 + 768 * 2];
+
+// results are summed here so that no case can be optimized away
+static volatile a3real a3bench_sink;
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// read high-precision counter, in seconds
+inline a3f64 a3benchInternalTime()
+{
+#if (defined _WINDOWS || defined _WIN32)
+	LARGE_INTEGER t, f;
+	QueryPerformanceCounter(&t);
+	QueryPerformanceFrequency(&f);
+	return (a3f64)t.QuadPart / (a3f64)f.QuadPart;
+#else	// !(defined _WINDOWS || defined _WIN32)
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (a3f64)t.tv_sec + (a3f64)t.tv_nsec * 1.0e-9;
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+// random real in [-1, 1)
+inline a3real a3benchInternalRandom()
+{
+	return (a3real)(rand() % 20000 - 10000) * (a3real)0.0001;
+}
+
+// fill inputs with valid transforms, unit rotations and non-zero vectors
+a3boolean a3benchInternalInit(const a3ui32 count)
+{
+	a3real3 axis, translate;
+	a3ui32 i, j;
+
+	a3trigInit(A3_BENCH_TRIG_SAMPLES, a3bench_trigTable);
+	for (j = 0; j < 3; ++j)
+	{
+		a3bench_mat4[j] = (a3real4x4 *)malloc(count * sizeof(a3real4x4));
+		a3bench_quat[j] = (a3real4 *)malloc(count * sizeof(a3real4));
+		a3bench_vec3[j] = (a3real3 *)malloc(count * sizeof(a3real3));
+		if (!a3bench_mat4[j] || !a3bench_quat[j] || !a3bench_vec3[j])
+			return 0;
+	}
+	for (j = 0; j < 5; ++j)
+	{
+		a3bench_dualquat[j] = (a3real4x2 *)malloc(count * sizeof(a3real4x2));
+		a3bench_scalar[j] = (a3real *)malloc(count * sizeof(a3real));
+		if (!a3bench_dualquat[j] || !a3bench_scalar[j])
+			return 0;
+	}
+
+	srand(1);
+	for (i = 0; i < count; ++i)
+	{
+		for (j = 0; j < 5; ++j)
+		{
+			a3real3Set(axis, a3benchInternalRandom(), a3benchInternalRandom(), a3real_one);
+			a3real3Set(translate, a3benchInternalRandom(), a3benchInternalRandom(), a3benchInternalRandom());
+			a3real3Normalize(axis);
+			a3dualquatSetAxisAngleTranslate(a3bench_dualquat[j][i], axis, a3benchInternalRandom() * (a3real)180.0, translate);
+			a3bench_scalar[j][i] = a3benchInternalRandom();
+			if (j < 3)
+			{
+				a3quatSetAxisAngle(a3bench_quat[j][i], axis, a3benchInternalRandom() * (a3real)180.0);
+				a3real4x4SetRotateXYZ(a3bench_mat4[j][i], a3benchInternalRandom() * (a3real)180.0, a3benchInternalRandom() * (a3real)180.0, a3benchInternalRandom() * (a3real)180.0);
+				a3real3Set(a3bench_mat4[j][i][3], translate[0], translate[1], translate[2]);
+				a3real3Set(a3bench_vec3[j][i], a3benchInternalRandom(), a3benchInternalRandom(), a3real_one);
+			}
+		}
+	}
+	return 1;
+}
+
+void a3benchInternalRelease()
+{
+	a3ui32 j;
+	for (j = 0; j < 3; ++j)
+	{
+		free(a3bench_mat4[j]);
+		free(a3bench_quat[j]);
+		free(a3bench_vec3[j]);
+	}
+	for (j = 0; j < 5; ++j)
+	{
+		free(a3bench_dualquat[j]);
+		free(a3bench_scalar[j]);
+	}
+	a3trigFree();
+}
+
+
+//-----------------------------------------------------------------------------
+// cases
+
+void a3benchMat4Product(const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i)
+		a3real4x4Product(a3bench_mat4[2][i], a3bench_mat4[0][i], a3bench_mat4[1][i]);
+	a3bench_sink += a3bench_mat4[2][count - 1][3][0];
+}
+
+void a3benchMat4TransformInverse(const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i)
+		a3real4x4TransformInverse(a3bench_mat4[2][i], a3bench_mat4[0][i]);
+	a3bench_sink += a3bench_mat4[2][count - 1][3][0];
+}
+
+void a3benchQuatProduct(const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i)
+		a3quatProduct(a3bench_quat[2][i], a3bench_quat[0][i], a3bench_quat[1][i]);
+	a3bench_sink += a3bench_quat[2][count - 1][3];
+}
+
+void a3benchQuatSlerpUnit(const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i)
+		a3quatSlerpUnit(a3bench_quat[2][i], a3bench_quat[0][i], a3bench_quat[1][i], a3bench_scalar[0][i] * a3real_half + a3real_half);
+	a3bench_sink += a3bench_quat[2][count - 1][3];
+}
+
+void a3benchDualquatProduct(const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i)
+		a3dualquatProduct(a3bench_dualquat[4][i], a3bench_dualquat[0][i], a3bench_dualquat[1][i]);
+	a3bench_sink += a3bench_dualquat[4][count - 1][1][3];
+}
+
+void a3benchDualquatDLB2(const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i)
+		a3dualquatDLB2(a3bench_dualquat[4][i], a3bench_dualquat[0][i], a3bench_dualquat[1][i]);
+	a3bench_sink += a3bench_dualquat[4][count - 1][1][3];
+}
+
+void a3benchDualquatDLB4(const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i)
+		a3dualquatDLB4(a3bench_dualquat[4][i], a3bench_dualquat[0][i], a3bench_dualquat[1][i], a3bench_dualquat[2][i], a3bench_dualquat[3][i]);
+	a3bench_sink += a3bench_dualquat[4][count - 1][1][3];
+}
+
+// array version blends four consecutive inputs
+void a3benchDualquatDLB(const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i)
+		a3dualquatDLB(a3bench_dualquat[4][i], a3bench_dualquat[0] + (i + 4 <= count ? i : count - 4), 4);
+	a3bench_sink += a3bench_dualquat[4][count - 1][1][3];
+}
+
+void a3benchVec3Normalize(const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i)
+	{
+		a3real3Set(a3bench_vec3[2][i], a3bench_vec3[0][i][0], a3bench_vec3[0][i][1], a3bench_vec3[0][i][2]);
+		a3real3Normalize(a3bench_vec3[2][i]);
+	}
+	a3bench_sink += a3bench_vec3[2][count - 1][2];
+}
+
+// same as above using the fast inverse square root (float precision)
+void a3benchVec3Normalize0x(const a3ui32 count)
+{
+	a3ui32 i;
+	a3real lenInv;
+	for (i = 0; i < count; ++i)
+	{
+		lenInv = (a3real)a3sqrtf0xInverse((a3f32)a3real3LengthSquared(a3bench_vec3[0][i]));
+		a3real3ProductS(a3bench_vec3[2][i], a3bench_vec3[0][i], lenInv);
+	}
+	a3bench_sink += a3bench_vec3[2][count - 1][2];
+}
+
+void a3benchVec3Lerp(const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i)
+		a3real3Lerp(a3bench_vec3[2][i], a3bench_vec3[0][i], a3bench_vec3[1][i], a3bench_scalar[0][i]);
+	a3bench_sink += a3bench_vec3[2][count - 1][2];
+}
+
+void a3benchLerp(const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i)
+		a3bench_scalar[4][i] = a3lerpFunc(a3bench_scalar[0][i], a3bench_scalar[1][i], a3bench_scalar[2][i]);
+	a3bench_sink += a3bench_scalar[4][count - 1];
+}
+
+void a3benchCatmullRom(const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i)
+		a3bench_scalar[4][i] = a3CatmullRom(a3bench_scalar[0][i], a3bench_scalar[1][i], a3bench_scalar[2][i], a3bench_scalar[3][i], a3bench_scalar[3][i] * a3real_half + a3real_half);
+	a3bench_sink += a3bench_scalar[4][count - 1];
+}
+
+void a3benchHermiteTangent(const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i)
+		a3bench_scalar[4][i] = a3HermiteTangent(a3bench_scalar[0][i], a3bench_scalar[1][i], a3bench_scalar[2][i], a3bench_scalar[3][i], a3bench_scalar[3][i] * a3real_half + a3real_half);
+	a3bench_sink += a3bench_scalar[4][count - 1];
+}
+
+
+// all cases; bytes per call are inputs read plus outputs written
+static const a3_BenchCase a3bench_case[] = {
+	{ "a3real4x4Product",			a3benchMat4Product,				sizeof(a3real4x4) * 3 },
+	{ "a3real4x4TransformInverse",	a3benchMat4TransformInverse,	sizeof(a3real4x4) * 2 },
+	{ "a3quatProduct",				a3benchQuatProduct,				sizeof(a3real4) * 3 },
+	{ "a3quatSlerpUnit",			a3benchQuatSlerpUnit,			sizeof(a3real4) * 3 + sizeof(a3real) },
+	{ "a3dualquatProduct",			a3benchDualquatProduct,			sizeof(a3real4x2) * 3 },
+	{ "a3dualquatDLB2",				a3benchDualquatDLB2,			sizeof(a3real4x2) * 3 },
+	{ "a3dualquatDLB4",				a3benchDualquatDLB4,			sizeof(a3real4x2) * 5 },
+	{ "a3dualquatDLB (4 inputs)",	a3benchDualquatDLB,				sizeof(a3real4x2) * 5 },
+	{ "a3real3Normalize",			a3benchVec3Normalize,			sizeof(a3real3) * 2 },
+	{ "a3real3Normalize (0x5f3759df)",	a3benchVec3Normalize0x,		sizeof(a3real3) * 2 },
+	{ "a3real3Lerp",				a3benchVec3Lerp,				sizeof(a3real3) * 3 + sizeof(a3real) },
+	{ "a3lerpFunc",					a3benchLerp,					sizeof(a3real) * 4 },
+	{ "a3CatmullRom",				a3benchCatmullRom,				sizeof(a3real) * 5 },
+	{ "a3HermiteTangent",			a3benchHermiteTangent,			sizeof(a3real) * 5 },
+};
+
+
+//-----------------------------------------------------------------------------
+// main
+
+int main(int argc, char **argv)
+{
+	const a3byte *filter = 0;
+	const a3byte *csvPath = 0;
+	a3ui32 count = 1024, trials = 5;
+	a3f64 trialTime = 0.05;
+
+	const a3ui32 caseCount = sizeof(a3bench_case) / sizeof(*a3bench_case);
+	a3f64 t0, dt, best;
+	a3ui32 c, t, r, reps;
+	a3i32 i;
+	FILE *fp = 0;
+
+	// parse options
+	for (i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "-count") && i + 1 < argc)
+			count = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-time") && i + 1 < argc)
+			trialTime = atof(argv[++i]) * 0.001;
+		else if (!strcmp(argv[i], "-trials") && i + 1 < argc)
+			trials = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-filter") && i + 1 < argc)
+			filter = argv[++i];
+		else if (!strcmp(argv[i], "-csv") && i + 1 < argc)
+			csvPath = argv[++i];
+		else
+		{
+			printf("usage: %s [-count <elements>] [-time <ms per trial>] [-trials <count>] [-filter <substring>] [-csv <file>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (count < 4 || count > A3_BENCH_COUNT_MAX || !trials || trialTime <= 0.0)
+	{
+		printf("\n A3 ERROR: Element count must be in [4, %u]; trials and time must be positive.\n", A3_BENCH_COUNT_MAX);
+		return 1;
+	}
+	if (!a3benchInternalInit(count))
+	{
+		printf("\n A3 ERROR: Could not allocate benchmark data.\n");
+		a3benchInternalRelease();
+		return 1;
+	}
+	if (csvPath)
+	{
+		fp = fopen(csvPath, "w");
+		if (!fp)
+		{
+			printf("\n A3 ERROR: Failed to open file: %s\n", csvPath);
+			a3benchInternalRelease();
+			return 1;
+		}
+		fprintf(fp, "case,real,ns_per_op,mops_per_s,gb_per_s\n");
+	}
+
+	printf("A3DM benchmarks: a3real is %u bytes, %u elements per pass, best of %u trials of %.0lf ms\n",
+		(a3ui32)sizeof(a3real), count, trials, trialTime * 1000.0);
+	printf("%-32s %12s %12s %10s\n", "case", "ns/op", "Mop/s", "GB/s");
+	for (c = 0; c < caseCount; ++c)
+	{
+		if (filter && !strstr(a3bench_case[c].name, filter))
+			continue;
+
+		// warm up and find number of passes that fill one trial
+		a3bench_case[c].func(count);
+		for (reps = 1; ; reps *= 2)
+		{
+			t0 = a3benchInternalTime();
+			for (r = 0; r < reps; ++r)
+				a3bench_case[c].func(count);
+			dt = a3benchInternalTime() - t0;
+			if (dt >= trialTime * 0.5 || reps >= 0x40000000u)
+				break;
+		}
+		if (dt < trialTime && dt > 0.0)
+			reps = (a3ui32)((a3f64)reps * trialTime / dt) + 1;
+
+		// time trials and keep best, which is least disturbed by the system
+		for (t = 0, best = 1.0e30; t < trials; ++t)
+		{
+			t0 = a3benchInternalTime();
+			for (r = 0; r < reps; ++r)
+				a3bench_case[c].func(count);
+			dt = (a3benchInternalTime() - t0) / ((a3f64)reps * (a3f64)count);
+			if (dt < best)
+				best = dt;
+		}
+
+		printf("%-32s %12.3lf %12.2lf %10.2lf\n", a3bench_case[c].name,
+			best * 1.0e9, 1.0e-6 / best, (a3f64)a3bench_case[c].bytesPerOp * 1.0e-9 / best);
+		if (fp)
+			fprintf(fp, "\"%s\",f%u,%.4lf,%.4lf,%.4lf\n", a3bench_case[c].name, (a3ui32)sizeof(a3real) * 8,
+				best * 1.0e9, 1.0e-6 / best, (a3f64)a3bench_case[c].bytesPerOp * 1.0e-9 / best);
+	}
+
+	if (fp)
+		fclose(fp);
+	a3benchInternalRelease();
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------
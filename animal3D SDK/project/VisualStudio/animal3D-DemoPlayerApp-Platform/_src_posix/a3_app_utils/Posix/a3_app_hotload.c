@@ -0,0 +1,283 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_app_hotload.c
+	Implementation of demo library hot loading on POSIX platforms.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#if !(defined _WINDOWS || defined _WIN32)
+
+#include "a3_app_utils/Posix/a3_app_hotload.h"
+#include "a3_dylib_config_load.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif	// __linux__
+
+
+// directory of demo libraries, same as the loader's
+#define A3_HOTLOAD_DIR	"./animal3D-demos/"
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// get modification time (ns) and size of file
+static inline a3boolean a3appHotloadInternalStat(const a3byte *filePath, a3i64 *time_out, a3i64 *size_out)
+{
+	struct stat info;
+	if (stat(filePath, &info) == 0)
+	{
+#ifdef __APPLE__
+		*time_out = (a3i64)info.st_mtimespec.tv_sec * 1000000000 + (a3i64)info.st_mtimespec.tv_nsec;
+#else	// !__APPLE__
+		*time_out = (a3i64)info.st_mtim.tv_sec * 1000000000 + (a3i64)info.st_mtim.tv_nsec;
+#endif	// __APPLE__
+		*size_out = (a3i64)info.st_size;
+		return 1;
+	}
+	return 0;
+}
+
+// copy file
+static inline a3boolean a3appHotloadInternalCopy(const a3byte *srcPath, const a3byte *dstPath)
+{
+	a3byte buffer[16384];
+	ssize_t count = -1;
+	a3i32 src, dst;
+	a3boolean result = 0;
+
+	src = open(srcPath, O_RDONLY | O_CLOEXEC);
+	if (src >= 0)
+	{
+		dst = open(dstPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0700);
+		if (dst >= 0)
+		{
+			while ((count = read(src, buffer, sizeof(buffer))) > 0)
+				if (write(dst, buffer, (size_t)count) != count)
+					break;
+			result = (count == 0);
+			close(dst);
+		}
+		close(src);
+	}
+	return result;
+}
+
+// load current build of library into the table that is not current,
+//	then make it current; if handing over, the demo is unloaded with the
+//	old callbacks first and loaded with the new ones after, and the new
+//	build only becomes current if it loads the demo
+a3ret a3appHotloadInternalLoad(a3_HotloadInterface *hotload, const a3boolean handover)
+{
+	a3_DemoWindowInterface stage[1] = { 0 };
+	a3_DemoDescriptor record[1];
+	a3_CallbackFunctions *current, *next;
+	void *data;
+	a3byte stagePath[64];
+	a3i64 libTime, libSize;
+	a3i32 status;
+	a3ui32 index;
+
+	// the loader returns the library already loaded from a path instead
+	//	of loading it again, so each build is loaded from its own copy
+	*record = *hotload->record;
+	sprintf(record->lib, ".a3hotload%u.so", hotload->generation);
+	sprintf(stagePath, A3_HOTLOAD_DIR "%s", record->lib);
+	if (!a3appHotloadInternalStat(hotload->libPath, &libTime, &libSize) ||
+		!a3appHotloadInternalCopy(hotload->libPath, stagePath))
+	{
+		printf("\n A3 ERROR: Failed to copy library: %s", hotload->libPath);
+		return 0;
+	}
+
+	// link callbacks into a staging table so a failed build leaves the
+	//	current one untouched; the copy is not needed once it is mapped
+	a3appSetDummyCallbacks(stage->callbacks);
+	status = a3appLoadCallbacks(stage, record);
+	unlink(stagePath);
+	if (status <= 0)
+	{
+		if (stage->handle)
+			a3dylibUnload((A3DYLIBHANDLE)stage->handle);
+		return 0;
+	}
+
+	// hand the demo's persistent data over as a hot build so that it is
+	//	not set up again; if the new build cannot load it, the current
+	//	build takes it back and stays current
+	current = hotload->current;
+	if (handover)
+	{
+		data = current ? current->callback_unload(hotload->demo->data, 1) : hotload->demo->data;
+		hotload->demo->data = stage->callbacks->callback_load(data, 1);
+		if (!hotload->demo->data)
+		{
+			printf("\n A3 ERROR: New build could not load demo; keeping current build.");
+			if (current)
+				hotload->demo->data = current->callback_load(data, 1);
+			a3dylibUnload((A3DYLIBHANDLE)stage->handle);
+
+			// not retried until the library changes again
+			hotload->libTime = libTime;
+			hotload->libSize = libSize;
+			return 0;
+		}
+	}
+
+	// reuse the slot of the build before the current one, which has not
+	//	been current since the last reload, then swap tables
+	index = (current == hotload->table) ? 1 : 0;
+	next = hotload->table + index;
+	if (hotload->handle[index])
+		a3dylibUnload((A3DYLIBHANDLE)hotload->handle[index]);
+	*next = *stage->callbacks;
+	hotload->handle[index] = stage->handle;
+	__atomic_store_n(&hotload->current, next, __ATOMIC_RELEASE);
+	*hotload->demo->callbacks = *next;
+	hotload->demo->handle = stage->handle;
+
+	hotload->libTime = libTime;
+	hotload->libSize = libSize;
+	++hotload->generation;
+	return status;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3appHotloadCreate(a3_HotloadInterface *hotload_out, a3_DemoWindowInterface *demo, const a3_DemoDescriptor *record)
+{
+	a3i32 status;
+	if (hotload_out && !hotload_out->demo && demo && !demo->handle && record)
+	{
+		memset(hotload_out, 0, sizeof(a3_HotloadInterface));
+		hotload_out->demo = demo;
+		*hotload_out->record = *record;
+		sprintf(hotload_out->libPath, A3_HOTLOAD_DIR "%s", record->lib);
+		hotload_out->notifyHandle = -1;
+
+#ifdef __linux__
+		// watch the directory: builds often replace the file instead of
+		//	writing to it, which would end a watch on the file itself
+		hotload_out->notifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (hotload_out->notifyHandle >= 0 &&
+			inotify_add_watch(hotload_out->notifyHandle, A3_HOTLOAD_DIR, IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+		{
+			close(hotload_out->notifyHandle);
+			hotload_out->notifyHandle = -1;
+		}
+#endif	// __linux__
+
+		status = a3appHotloadInternalLoad(hotload_out, 0);
+		if (status <= 0)
+			a3appHotloadRelease(hotload_out);
+		return status;
+	}
+	return -1;
+}
+
+a3ret a3appHotloadPoll(a3_HotloadInterface *hotload)
+{
+	a3i64 libTime, libSize;
+	if (hotload && hotload->demo)
+	{
+#ifdef __linux__
+		if (hotload->notifyHandle >= 0)
+		{
+			// drain events; only those naming the library matter
+			a3byte buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+			const struct inotify_event *event;
+			a3byte const *itr;
+			a3boolean changed = 0;
+			ssize_t count;
+			while ((count = read(hotload->notifyHandle, buffer, sizeof(buffer))) > 0)
+				for (itr = buffer; itr < buffer + count; itr += sizeof(struct inotify_event) + event->len)
+				{
+					event = (const struct inotify_event *)itr;
+					if (event->len && !strcmp(event->name, hotload->record->lib))
+						changed = 1;
+				}
+			if (!changed)
+				return 0;
+		}
+#endif	// __linux__
+
+		// compare with the loaded build; also catches changes on platforms
+		//	without notification
+		if (a3appHotloadInternalStat(hotload->libPath, &libTime, &libSize) &&
+			(libTime != hotload->libTime || libSize != hotload->libSize))
+			return (a3appHotloadInternalLoad(hotload, 1) > 0);
+		return 0;
+	}
+	return -1;
+}
+
+a3ret a3appHotloadReload(a3_HotloadInterface *hotload)
+{
+	if (hotload && hotload->demo)
+		return a3appHotloadInternalLoad(hotload, 1);
+	return -1;
+}
+
+a3_CallbackFunctions const *a3appHotloadCallbacks(const a3_HotloadInterface *hotload)
+{
+	if (hotload)
+		return __atomic_load_n(&hotload->current, __ATOMIC_ACQUIRE);
+	return 0;
+}
+
+a3ret a3appHotloadRelease(a3_HotloadInterface *hotload)
+{
+	a3ui32 i;
+	if (hotload)
+	{
+#ifdef __linux__
+		if (hotload->notifyHandle >= 0)
+			close(hotload->notifyHandle);
+#endif	// __linux__
+		for (i = 0; i < 2; ++i)
+			if (hotload->handle[i])
+				a3dylibUnload((A3DYLIBHANDLE)hotload->handle[i]);
+		if (hotload->demo)
+		{
+			a3appSetDummyCallbacks(hotload->demo->callbacks);
+			hotload->demo->handle = 0;
+		}
+		memset(hotload, 0, sizeof(a3_HotloadInterface));
+		hotload->notifyHandle = -1;
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// !(defined _WINDOWS || defined _WIN32)
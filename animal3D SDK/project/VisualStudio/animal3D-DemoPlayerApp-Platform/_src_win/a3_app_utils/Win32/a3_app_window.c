@@ -486,6 +486,15 @@ void a3windowInternalHotloadDemoComplete(a3_WindowInterface *window, a3boolean r
 			window->demo->callbacks->callback_windowMove(window->demo->data, window->demo->winPosX, window->demo->winPosY);
 			window->demo->callbacks->callback_windowResize(window->demo->data, window->demo->winSzX, window->demo->winSzY);
 		}
+		else
+		{
+			// build could not be linked: fall back to dummy callbacks and
+			//	keep the data saved by the previous build, untouched, so the
+			//	next build that loads can restore it
+			printf("\n A3 ERROR: Demo build could not be loaded; state kept for next build.");
+			a3appReleaseCallbacks(window->demo);
+			window->demo->id = window->demo->data ? -2 : -1;
+		}
 	}
 
 	// re-enable file menu
@@ -0,0 +1,167 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_app_batch.c
+	Implementation of headless batch runs of demos.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "a3_app_utils/a3_app_batch.h"
+#include "a3_dylib_config_load.h"
+
+#if !(defined _WINDOWS || defined _WIN32)
+#include <time.h>
+#endif	// !(defined _WINDOWS || defined _WIN32)
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// read high-precision counter, in seconds
+inline a3f64 a3appBatchInternalTime()
+{
+#if (defined _WINDOWS || defined _WIN32)
+	LARGE_INTEGER t, f;
+	QueryPerformanceCounter(&t);
+	QueryPerformanceFrequency(&f);
+	return (a3f64)t.QuadPart / (a3f64)f.QuadPart;
+#else	// !(defined _WINDOWS || defined _WIN32)
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (a3f64)t.tv_sec + (a3f64)t.tv_nsec * 1.0e-9;
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+// set variable for the demo to read; empty value clears it
+inline void a3appBatchInternalSetVar(const a3byte *name, const a3byte *value)
+{
+#if (defined _WINDOWS || defined _WIN32)
+	_putenv_s(name, value);
+#else	// !(defined _WINDOWS || defined _WIN32)
+	if (*value)
+		setenv(name, value, 1);
+	else
+		unsetenv(name);
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3appBatchSetInputRecording(const a3byte *recordPath_opt, const a3byte *replayPath_opt)
+{
+	a3appBatchInternalSetVar(A3_APP_INPUT_RECORD_VAR, recordPath_opt ? recordPath_opt : "");
+	a3appBatchInternalSetVar(A3_APP_INPUT_REPLAY_VAR, replayPath_opt ? replayPath_opt : "");
+	return 1;
+}
+
+a3ret a3appBatchSetGolden(const a3byte *comparePath_opt, const a3byte *writePath_opt, const a3ui32 ulpTolerance, const a3f64 absTolerance)
+{
+	a3byte ulp[16], absolute[32];
+	sprintf(ulp, "%u", ulpTolerance);
+	sprintf(absolute, "%.17g", absTolerance);
+	a3appBatchInternalSetVar(A3_APP_GOLDEN_VAR, comparePath_opt ? comparePath_opt : "");
+	a3appBatchInternalSetVar(A3_APP_GOLDEN_WRITE_VAR, writePath_opt ? writePath_opt : "");
+	a3appBatchInternalSetVar(A3_APP_GOLDEN_ULP_VAR, ulp);
+	a3appBatchInternalSetVar(A3_APP_GOLDEN_ABS_VAR, absolute);
+	return 1;
+}
+
+a3ret a3appBatchRun(a3_DemoWindowInterface *demo, const a3_DemoDescriptor *record, const a3ui32 tickCount, const a3i32 winSzX, const a3i32 winSzY, const a3byte *csvPath_opt, a3_BatchResult *result_out_opt)
+{
+	a3_BatchResult result = { 0 };
+	a3f64 t0, dt;
+	a3i32 status;
+	FILE *fp;
+
+	if (demo && !demo->handle && record && tickCount && winSzX > 0 && winSzY > 0)
+	{
+		fp = csvPath_opt ? fopen(csvPath_opt, "w") : 0;
+		if (csvPath_opt && !fp)
+		{
+			fprintf(stderr, "\n A3 ERROR: Failed to open file: %s", csvPath_opt);
+			return 0;
+		}
+
+		// load library and demo; without a window the size is reported
+		//	once, as the window would when it is first shown
+		a3appBatchInternalSetVar(A3_APP_HEADLESS_VAR, "1");
+		a3appSetDummyCallbacks(demo->callbacks);
+		status = a3appLoadCallbacks(demo, record);
+		if (status > 0)
+			demo->data = demo->callbacks->callback_load(0, 0);
+		if (status <= 0 || !demo->data)
+		{
+			fprintf(stderr, "\n A3 ERROR: Failed to load demo: %s", record->name);
+			if (demo->handle)
+				a3appReleaseCallbacks(demo);
+			if (fp)
+				fclose(fp);
+			return 0;
+		}
+		demo->winSzX = winSzX;
+		demo->winSzY = winSzY;
+		demo->callbacks->callback_windowResize(demo->data, winSzX, winSzY);
+
+		// drive idle; only idles that ticked are counted and written
+		if (fp)
+			fprintf(fp, "tick,ms\n");
+		result.minTime = 1.0e30;
+		while (result.ticks < tickCount)
+		{
+			t0 = a3appBatchInternalTime();
+			status = demo->callbacks->callback_idle(demo->data);
+			dt = a3appBatchInternalTime() - t0;
+			if (status > 0)
+			{
+				if (fp)
+					fprintf(fp, "%u,%.6lf\n", result.ticks, dt * 1000.0);
+				result.totalTime += dt;
+				if (dt < result.minTime)
+					result.minTime = dt;
+				if (dt > result.maxTime)
+					result.maxTime = dt;
+				++result.ticks;
+			}
+			else if (status < 0)
+				break;
+		}
+		if (!result.ticks)
+			result.minTime = 0.0;
+
+		// done
+		demo->data = demo->callbacks->callback_unload(demo->data, 0);
+		a3appReleaseCallbacks(demo);
+		if (fp)
+			fclose(fp);
+		if (result_out_opt)
+			*result_out_opt = result;
+		return result.ticks;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
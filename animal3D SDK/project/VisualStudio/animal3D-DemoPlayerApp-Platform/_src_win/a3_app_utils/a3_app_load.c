@@ -27,6 +27,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "a3_app_utils/a3_app_load.h"
 #include "a3_dylib_config_load.h"
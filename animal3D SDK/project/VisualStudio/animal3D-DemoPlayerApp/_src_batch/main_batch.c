@@ -0,0 +1,138 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	main_batch.c
+	Command-line batch runner: runs a demo headless for a fixed number of
+		ticks and writes the time of each tick as CSV to the file given
+		with -csv; for benchmarks and regression runs on machines without
+		a display. The summary goes to the error stream; standard output
+		carries the demo's own messages.
+
+	usage: <runner> [-info <file>] [-demo <name or index>] [-ticks <count>]
+		[-size <width> <height>] [-csv <file>] [-record <file>] [-replay <file>]
+		[-golden <file>] [-golden-write <file>] [-ulp <count>] [-abs <value>]
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+
+#include "a3_app_utils/a3_app_batch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// main
+
+int main(int argc, char **argv)
+{
+	// defaults match the window app
+	const a3byte *infoPath = "../../../../resource/animal3D-data/animal3D-demoinfo.txt";
+	const a3byte *demoName = "0";
+	const a3byte *csvPath = 0;
+	const a3byte *recordPath = 0, *replayPath = 0;
+	const a3byte *goldenPath = 0, *goldenWritePath = 0;
+	a3ui32 ulpTolerance = 4;
+	a3f64 absTolerance = 1.0e-5;
+	a3ui32 tickCount = 600;
+	a3i32 winSzX = 960, winSzY = 540;
+
+	a3_DemoWindowInterface demo = { 0 };
+	a3_BatchResult result = { 0 };
+	a3i32 status, i;
+	a3byte *end;
+
+	// parse options
+	for (i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "-info") && i + 1 < argc)
+			infoPath = argv[++i];
+		else if (!strcmp(argv[i], "-demo") && i + 1 < argc)
+			demoName = argv[++i];
+		else if (!strcmp(argv[i], "-ticks") && i + 1 < argc)
+			tickCount = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-size") && i + 2 < argc)
+		{
+			winSzX = atoi(argv[++i]);
+			winSzY = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "-csv") && i + 1 < argc)
+			csvPath = argv[++i];
+		else if (!strcmp(argv[i], "-record") && i + 1 < argc)
+			recordPath = argv[++i];
+		else if (!strcmp(argv[i], "-replay") && i + 1 < argc)
+			replayPath = argv[++i];
+		else if (!strcmp(argv[i], "-golden") && i + 1 < argc)
+			goldenPath = argv[++i];
+		else if (!strcmp(argv[i], "-golden-write") && i + 1 < argc)
+			goldenWritePath = argv[++i];
+		else if (!strcmp(argv[i], "-ulp") && i + 1 < argc)
+			ulpTolerance = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-abs") && i + 1 < argc)
+			absTolerance = strtod(argv[++i], 0);
+		else
+		{
+			fprintf(stderr, "usage: %s [-info <file>] [-demo <name or index>] [-ticks <count>] [-size <width> <height>] [-csv <file>] [-record <file>] [-replay <file>] [-golden <file>] [-golden-write <file>] [-ulp <count>] [-abs <value>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	// load descriptors and find demo by name, then by index
+	status = a3appLoadDemoInfo(&demo.records, infoPath, 0);
+	if (status <= 0)
+	{
+		fprintf(stderr, "\n A3 ERROR: Failed to load demo info: %s\n", infoPath);
+		return 1;
+	}
+	demo.numRecords = status;
+	for (demo.id = 0; demo.id < (a3i32)demo.numRecords; ++demo.id)
+		if (!strcmp(demo.records[demo.id].name, demoName))
+			break;
+	if (demo.id == (a3i32)demo.numRecords)
+	{
+		demo.id = (a3i32)strtol(demoName, &end, 10);
+		if (*end || demo.id < 0 || demo.id >= (a3i32)demo.numRecords)
+		{
+			fprintf(stderr, "\n A3 ERROR: Unknown demo: %s\n", demoName);
+			a3appReleaseDemoInfo(&demo.records);
+			return 1;
+		}
+	}
+
+	// input is recorded or replayed, and output checked, by the demo itself
+	a3appBatchSetInputRecording(recordPath, replayPath);
+	a3appBatchSetGolden(goldenPath, goldenWritePath, ulpTolerance, absTolerance);
+
+	// run and summarize; the summary goes to the error stream, apart from 
+	//	the demo's messages on standard output
+	status = a3appBatchRun(&demo, demo.records + demo.id, tickCount, winSzX, winSzY, csvPath, &result);
+	if (status > 0)
+		fprintf(stderr, "%s: %u ticks, %.3lf ms total, %.3lf ms mean, %.3lf ms min, %.3lf ms max\n",
+			demo.records[demo.id].name, result.ticks, result.totalTime * 1000.0,
+			result.totalTime * 1000.0 / (a3f64)result.ticks, result.minTime * 1000.0, result.maxTime * 1000.0);
+
+	a3appReleaseDemoInfo(&demo.records);
+	return (status > 0 && result.ticks == tickCount) ? 0 : 1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,256 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	main_bench_fluid.c
+	Fluid pressure solver benchmarks: steps the same plume on a fluid grid
+		once per solver (relaxation sweeps, then multigrid on one thread
+		and on several) and reports time per step and how far the pressure
+		is from solving the projection, as the residual relative to the
+		divergence after each step. Diffusion is off, so that steps are
+		mostly projection. With -sparse, fields are stored in tiles around
+		the plume instead (sizes must be multiples of the tile width), and
+		the memory held is reported. The fluid belongs to the demo plugin;
+		build with its source directory on the include path and its
+		simulation sources.
+
+	usage: <bench> [-size <x> <y> <z>] [-steps <count>]
+		[-iterations <count>] [-cycles <count>] [-threads <count>]
+		[-sparse] [-csv <file>]
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+
+#include "A3_DEMO/_simulation/a3_FluidGrid.h"
+#include "A3_DEMO/_simulation/a3_FluidMultigrid.h"
+#include "A3_DEMO/_simulation/a3_FluidTiles.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if (defined _WINDOWS || defined _WIN32)
+#include <Windows.h>
+#else	// !(defined _WINDOWS || defined _WIN32)
+#include <time.h>
+#endif	// (defined _WINDOWS || defined _WIN32)
+
+
+//-----------------------------------------------------------------------------
+// data
+
+// limits of options
+#define A3_BENCH_SIZE_MAX	512
+
+// timing and accuracy of one solver over all steps
+typedef struct a3_BenchFluidResult
+{
+	a3f64 best, total;
+	a3f64 residual;
+	a3ui32 steps;
+} a3_BenchFluidResult;
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// read high-precision counter, in seconds
+inline a3f64 a3benchInternalTime()
+{
+#if (defined _WINDOWS || defined _WIN32)
+	LARGE_INTEGER t, f;
+	QueryPerformanceCounter(&t);
+	QueryPerformanceFrequency(&f);
+	return (a3f64)t.QuadPart / (a3f64)f.QuadPart;
+#else	// !(defined _WINDOWS || defined _WIN32)
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (a3f64)t.tv_sec + (a3f64)t.tv_nsec * 1.0e-9;
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+// step a swaying plume from rest with the solver set on the grid; every
+//	solver sees the same sources
+void a3benchInternalRun(a3_FluidGrid *grid, const a3ui32 steps, a3_BenchFluidResult *result_out)
+{
+	const a3f32 position[3] = { 0.5f, 0.1f, 0.5f };
+	a3f32 velocity[3];
+	a3f64 t0, dt;
+	a3ui32 n;
+
+	memset(result_out, 0, sizeof(a3_BenchFluidResult));
+	a3fluidGridReset(grid);
+	for (n = 0; n < steps; ++n)
+	{
+		velocity[0] = 0.5f * sinf((a3f32)n * 0.1f);
+		velocity[1] = 2.0f;
+		velocity[2] = 0.5f * cosf((a3f32)n * 0.1f);
+		a3fluidGridAddSource(grid, position, 0.08f, 8.0f, velocity);
+
+		t0 = a3benchInternalTime();
+		a3fluidGridStep(grid, 1.0f / 30.0f);
+		dt = a3benchInternalTime() - t0;
+
+		if (!n || dt < result_out->best)
+			result_out->best = dt;
+		result_out->total += dt;
+		result_out->residual += a3fluidMultigridResidual(grid);
+		++result_out->steps;
+	}
+}
+
+void a3benchInternalReport(FILE *fp, const a3byte *name, const a3ui32 threads, const a3ui32 cells, const a3_BenchFluidResult *result)
+{
+	const a3f64 mean = result->total / (a3f64)result->steps;
+	printf("%-24s %8u %10.3lf %10.3lf %14.0lf %12.3e\n", name, threads, result->best * 1000.0, mean * 1000.0,
+		(a3f64)cells / mean, result->residual / (a3f64)result->steps);
+	if (fp)
+		fprintf(fp, "\"%s\",%u,%u,%.4lf,%.4lf,%.1lf,%.6e\n", name, threads, cells, result->best * 1000.0, mean * 1000.0,
+			(a3f64)cells / mean, result->residual / (a3f64)result->steps);
+}
+
+
+//-----------------------------------------------------------------------------
+// main
+
+int main(int argc, char **argv)
+{
+	const a3byte *csvPath = 0;
+	a3ui32 sizeX = 64, sizeY = 64, sizeZ = 64;
+	a3ui32 steps = 20, iterations = 20, cycles = 2, threads = 4;
+	a3boolean sparse = 0;
+
+	a3_FluidGrid grid[1] = { 0 };
+	a3_FluidTiles tiles[1] = { 0 };
+	a3_FluidMultigrid multigrid[1] = { 0 };
+	a3_BenchFluidResult result[1];
+	a3byte name[32];
+	a3ui32 threadCount[2], cells, n;
+	a3i32 i;
+	FILE *fp = 0;
+
+	// parse options
+	for (i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "-size") && i + 3 < argc)
+		{
+			sizeX = (a3ui32)strtoul(argv[++i], 0, 10);
+			sizeY = (a3ui32)strtoul(argv[++i], 0, 10);
+			sizeZ = (a3ui32)strtoul(argv[++i], 0, 10);
+		}
+		else if (!strcmp(argv[i], "-steps") && i + 1 < argc)
+			steps = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-iterations") && i + 1 < argc)
+			iterations = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-cycles") && i + 1 < argc)
+			cycles = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-threads") && i + 1 < argc)
+			threads = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-sparse"))
+			sparse = 1;
+		else if (!strcmp(argv[i], "-csv") && i + 1 < argc)
+			csvPath = argv[++i];
+		else
+		{
+			printf("usage: %s [-size <x> <y> <z>] [-steps <count>] [-iterations <count>] [-cycles <count>] [-threads <count>] [-sparse] [-csv <file>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!sizeX || sizeX > A3_BENCH_SIZE_MAX || !sizeY || sizeY > A3_BENCH_SIZE_MAX || !sizeZ || sizeZ > A3_BENCH_SIZE_MAX ||
+		!steps || !iterations || !cycles || !threads || threads > a3fluid_multigridThreadMax)
+	{
+		printf("\n A3 ERROR: Sizes must be in [1, %u] (z of 1 for 2D), threads in [1, %u], and steps, iterations and cycles positive.\n",
+			A3_BENCH_SIZE_MAX, a3fluid_multigridThreadMax);
+		return 1;
+	}
+
+	// set up grid and solver; tiles are worked on by as many threads as
+	//	the solver, so the sparse passes outside it scale too
+	if (sparse)
+	{
+		if (a3fluidTilesCreate(tiles, sizeX, sizeY, sizeZ, a3fluid_sparseFieldMax, threads) <= 0 || a3fluidGridCreateSparse(grid, tiles) <= 0)
+		{
+			printf("\n A3 ERROR: Failed to allocate %u x %u x %u sparse fluid grid (sizes must be multiples of %u).\n",
+				sizeX, sizeY, sizeZ, a3fluid_tileWidth);
+			a3fluidTilesRelease(tiles);
+			return 1;
+		}
+	}
+	else if (a3fluidGridCreate(grid, sizeX, sizeY, sizeZ) <= 0)
+	{
+		printf("\n A3 ERROR: Failed to allocate %u x %u x %u fluid grid.\n", sizeX, sizeY, sizeZ);
+		return 1;
+	}
+	cells = sizeX * sizeY * sizeZ;
+	grid->iterations = iterations;
+	if (csvPath)
+	{
+		fp = fopen(csvPath, "w");
+		if (!fp)
+			printf("\n A3 ERROR: Failed to open file: %s\n", csvPath);
+		else
+			fprintf(fp, "solver,threads,cells,best_ms,mean_ms,cells_per_s,residual\n");
+	}
+	printf("fluid benchmarks: %u x %u x %u %s grid, %u steps, %u relaxation sweeps, %u V-cycles\n",
+		sizeX, sizeY, sizeZ, sparse ? "sparse" : "dense", steps, iterations, cycles);
+	printf("%-24s %8s %10s %10s %14s %12s\n", "solver", "threads", "best ms", "mean ms", "cells/s", "residual");
+
+	// relaxation, as without a multigrid solver
+	sprintf(name, "relax %u", iterations);
+	a3benchInternalRun(grid, steps, result);
+	a3benchInternalReport(fp, name, 1, cells, result);
+
+	// multigrid on one thread, then on the requested number
+	sprintf(name, "multigrid %u", cycles);
+	threadCount[0] = 1;
+	threadCount[1] = threads;
+	for (n = 0; n < (threads > 1 ? 2u : 1u); ++n)
+	{
+		if (a3fluidMultigridCreate(multigrid, grid, threadCount[n]) <= 0)
+		{
+			printf("\n A3 ERROR: Failed to allocate multigrid solver.\n");
+			break;
+		}
+		multigrid->cycles = cycles;
+		grid->multigrid = multigrid;
+		a3benchInternalRun(grid, steps, result);
+		a3benchInternalReport(fp, name, threadCount[n], cells, result);
+		grid->multigrid = 0;
+		a3fluidMultigridRelease(multigrid);
+	}
+
+	// pages of tiles are kept once allocated, so the storage held now is
+	//	the most any run needed
+	if (sparse)
+		printf("storage: %.1lf MB in tiles (%u of %u active after the last step), %.1lf MB if dense\n",
+			(a3f64)a3fluidTilesGetMemory(tiles) / 1048576.0, tiles->activeCount, tiles->tileCount,
+			(a3f64)sizeof(a3f32) * a3fluid_fieldMax * (sizeX + 2) * (sizeY + 2) * (sizeZ > 1 ? sizeZ + 2 : 1) / 1048576.0);
+
+	// done
+	if (fp)
+		fclose(fp);
+	a3fluidGridRelease(grid);
+	a3fluidTilesRelease(tiles);
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------
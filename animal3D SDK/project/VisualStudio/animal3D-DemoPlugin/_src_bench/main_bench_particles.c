@@ -0,0 +1,206 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	main_bench_particles.c
+	Particle fluid benchmarks: steps the same dam break (a block of water
+		filling the lower half of one side of the domain) on one thread,
+		then on several, and reports time per step and particles per
+		second. Heights of all particles are summed after the last step,
+		so that runs on different thread counts can be compared; they
+		should match exactly. The fluid belongs to the demo plugin; build
+		with its source directory on the include path and its simulation
+		sources.
+
+	usage: <bench> [-cells <x> <y> <z>] [-steps <count>] [-threads <count>]
+		[-csv <file>]
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+
+#include "A3_DEMO/_simulation/a3_ParticleFluid.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined _WINDOWS || defined _WIN32)
+#include <Windows.h>
+#else	// !(defined _WINDOWS || defined _WIN32)
+#include <time.h>
+#endif	// (defined _WINDOWS || defined _WIN32)
+
+
+//-----------------------------------------------------------------------------
+// data
+
+// limits of options
+#define A3_BENCH_CELLS_MAX	256
+
+// timing of one thread count over all steps
+typedef struct a3_BenchParticleResult
+{
+	a3f64 best, total;
+	a3f64 checksum;
+	a3ui32 steps;
+} a3_BenchParticleResult;
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// read high-precision counter, in seconds
+inline a3f64 a3benchInternalTime()
+{
+#if (defined _WINDOWS || defined _WIN32)
+	LARGE_INTEGER t, f;
+	QueryPerformanceCounter(&t);
+	QueryPerformanceFrequency(&f);
+	return (a3f64)t.QuadPart / (a3f64)f.QuadPart;
+#else	// !(defined _WINDOWS || defined _WIN32)
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (a3f64)t.tv_sec + (a3f64)t.tv_nsec * 1.0e-9;
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+// refill and step the dam break; every run starts from the same particles
+void a3benchInternalRun(a3_ParticleFluid *fluid, const a3ui32 steps, a3_BenchParticleResult *result_out)
+{
+	const a3real boxMin[3] = { 0.0f, 0.0f, 0.0f };
+	const a3real boxMax[3] = {
+		fluid->radius * (a3real)fluid->cellsX * 0.5f,
+		fluid->radius * (a3real)fluid->cellsY * 0.5f,
+		fluid->radius * (a3real)fluid->cellsZ,
+	};
+	a3f64 t0, dt;
+	a3ui32 n;
+
+	memset(result_out, 0, sizeof(a3_BenchParticleResult));
+	a3particleFluidReset(fluid);
+	a3particleFluidAddBox(fluid, boxMin, boxMax);
+	for (n = 0; n < steps; ++n)
+	{
+		t0 = a3benchInternalTime();
+		a3particleFluidStep(fluid, 1.0f / 240.0f);
+		dt = a3benchInternalTime() - t0;
+
+		if (!n || dt < result_out->best)
+			result_out->best = dt;
+		result_out->total += dt;
+		++result_out->steps;
+	}
+	for (n = 0; n < fluid->count; ++n)
+		result_out->checksum += (a3f64)fluid->field[a3particle_positionY][n];
+}
+
+void a3benchInternalReport(FILE *fp, const a3ui32 threads, const a3ui32 particles, const a3_BenchParticleResult *result)
+{
+	const a3f64 mean = result->total / (a3f64)result->steps;
+	printf("%8u %10u %10.3lf %10.3lf %14.0lf %18.9lf\n", threads, particles, result->best * 1000.0, mean * 1000.0,
+		(a3f64)particles / mean, result->checksum);
+	if (fp)
+		fprintf(fp, "%u,%u,%.4lf,%.4lf,%.1lf,%.9lf\n", threads, particles, result->best * 1000.0, mean * 1000.0,
+			(a3f64)particles / mean, result->checksum);
+}
+
+
+//-----------------------------------------------------------------------------
+// main
+
+int main(int argc, char **argv)
+{
+	const a3byte *csvPath = 0;
+	a3ui32 cellsX = 32, cellsY = 32, cellsZ = 32;
+	a3ui32 steps = 20, threads = 4;
+
+	a3_ParticleFluid fluid[1] = { 0 };
+	a3_BenchParticleResult result[1];
+	a3ui32 threadCount[2], capacity, n;
+	a3i32 i;
+	FILE *fp = 0;
+
+	// parse options
+	for (i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "-cells") && i + 3 < argc)
+		{
+			cellsX = (a3ui32)strtoul(argv[++i], 0, 10);
+			cellsY = (a3ui32)strtoul(argv[++i], 0, 10);
+			cellsZ = (a3ui32)strtoul(argv[++i], 0, 10);
+		}
+		else if (!strcmp(argv[i], "-steps") && i + 1 < argc)
+			steps = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-threads") && i + 1 < argc)
+			threads = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-csv") && i + 1 < argc)
+			csvPath = argv[++i];
+		else
+		{
+			printf("usage: %s [-cells <x> <y> <z>] [-steps <count>] [-threads <count>] [-csv <file>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!cellsX || cellsX > A3_BENCH_CELLS_MAX || !cellsY || cellsY > A3_BENCH_CELLS_MAX || !cellsZ || cellsZ > A3_BENCH_CELLS_MAX ||
+		!steps || !threads || threads > a3particle_threadMax)
+	{
+		printf("\n A3 ERROR: Cells must be in [1, %u], threads in [1, %u], and steps positive.\n",
+			A3_BENCH_CELLS_MAX, a3particle_threadMax);
+		return 1;
+	}
+
+	// set up fluid: particles are half a cell apart, filling a quarter of
+	//	the domain
+	capacity = cellsX * cellsY * cellsZ * 2;
+	if (a3particleFluidCreate(fluid, capacity, cellsX, cellsY, cellsZ, 0.1f, 1) <= 0)
+	{
+		printf("\n A3 ERROR: Failed to allocate %u particles in %u x %u x %u cells.\n", capacity, cellsX, cellsY, cellsZ);
+		return 1;
+	}
+	if (csvPath)
+	{
+		fp = fopen(csvPath, "w");
+		if (!fp)
+			printf("\n A3 ERROR: Failed to open file: %s\n", csvPath);
+		else
+			fprintf(fp, "threads,particles,best_ms,mean_ms,particles_per_s,checksum\n");
+	}
+	printf("particle benchmarks: %u x %u x %u cells, %u steps\n", cellsX, cellsY, cellsZ, steps);
+	printf("%8s %10s %10s %10s %14s %18s\n", "threads", "particles", "best ms", "mean ms", "particles/s", "checksum");
+
+	// one thread, then the requested number
+	threadCount[0] = 1;
+	threadCount[1] = threads;
+	for (n = 0; n < (threads > 1 ? 2u : 1u); ++n)
+	{
+		fluid->threadCount = threadCount[n];
+		a3benchInternalRun(fluid, steps, result);
+		a3benchInternalReport(fp, threadCount[n], fluid->count, result);
+	}
+
+	// done
+	if (fp)
+		fclose(fp);
+	a3particleFluidRelease(fluid);
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,202 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	main_test_golden.c
+	Golden file comparison check: writes a golden file of matrix-like
+		values (large, near one and near zero), then compares runs that
+		differ from it: by a few ULP, by a tiny absolute amount near zero
+		(many ULP), by more than both tolerances, and with a different
+		block layout; each must report exactly the expected number of
+		mismatches. The golden file belongs to the demo plugin; build with
+		its source directory on the include path and its golden source.
+		Exits with the number of failed cases.
+
+	usage: <test> [directory]
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+
+#include "A3_DEMO/_a3_demo_utilities/a3_DemoGolden.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+
+
+//-----------------------------------------------------------------------------
+// data
+
+// number of ticks and values per block
+enum a3_TestGoldenCount
+{
+	a3test_tickCount = 8,
+	a3test_valueCount = 16,
+};
+
+// ways a run differs from the golden file
+typedef enum a3_TestGoldenChange
+{
+	a3test_same,			// identical
+	a3test_ulp,				// every value off by one to three ULP
+	a3test_nearZero,		// values near zero off by less than the floor
+	a3test_large,			// one large value off by more than both
+	a3test_layout,			// one block checked under another label
+} a3_TestGoldenChange;
+
+// cases: change, tolerances, expected result of ending the compare
+static const struct {
+	const a3byte *name;
+	a3_TestGoldenChange change;
+	a3ui32 ulpTolerance;
+	a3f64 absTolerance;
+	a3i32 mismatches;
+} a3test_case[] = {
+	{ "same", a3test_same, 0, 0.0, 0 },
+	{ "ulp", a3test_ulp, 4, 0.0, 0 },
+	{ "ulp (no tolerance)", a3test_ulp, 0, 0.0, a3test_tickCount * a3test_valueCount },
+	{ "near zero", a3test_nearZero, 4, 1.0e-5, 0 },
+	{ "near zero (ulp only)", a3test_nearZero, 4, 0.0, a3test_tickCount * 4 },
+	{ "large", a3test_large, 4, 1.0e-5, a3test_tickCount },
+	{ "layout", a3test_layout, 4, 1.0e-5, a3test_valueCount },
+};
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// values of tick: a 4x4 matrix with a large translation, rotation terms
+//	near one and terms that should be zero but are rounding residue
+void a3testInternalValues(a3real *values, const a3ui32 tick)
+{
+	a3ui32 i;
+	for (i = 0; i < a3test_valueCount; ++i)
+	{
+		if (i % 4 == 3)
+			values[i] = (a3real)(1000.0 + 37.0 * tick + i);
+		else if (i % 5 == 0)
+			values[i] = (a3real)(0.75 + 0.01 * tick);
+		else
+			values[i] = (a3real)(1.0e-8 * ((tick * 7 + i) % 11) - 5.5e-8);
+	}
+}
+
+// apply change to values of tick
+void a3testInternalChange(a3real *values, const a3ui32 tick, const a3_TestGoldenChange change)
+{
+	const a3f64 epsilon = sizeof(a3real) == sizeof(a3f32) ? FLT_EPSILON : DBL_EPSILON;
+	a3ui32 i;
+	switch (change)
+	{
+	case a3test_ulp:
+		for (i = 0; i < a3test_valueCount; ++i)
+			values[i] = (a3real)(values[i] * (1.0 + 1.5 * epsilon));
+		break;
+	case a3test_nearZero:
+		for (i = 0; i < a3test_valueCount; i += 4)
+			values[i + 1] = (a3real)(values[i + 1] + 2.0e-6);
+		break;
+	case a3test_large:
+		values[(tick % 4) * 4 + 3] += (a3real)0.5;
+		break;
+	default:
+		break;
+	}
+}
+
+// write golden file; returns number of problems
+a3ui32 a3testInternalWrite(const a3byte *path)
+{
+	a3_DemoGolden golden[1] = { 0 };
+	a3real values[a3test_valueCount];
+	a3ui32 tick, errors = 0;
+
+	errors += (a3demo_beginGoldenWrite(golden, path) != 1);
+	for (tick = 0; tick < a3test_tickCount; ++tick)
+	{
+		a3testInternalValues(values, tick);
+		errors += (a3demo_checkGolden(golden, tick, "matrix", values, a3test_valueCount) != 0);
+	}
+	errors += (a3demo_endGolden(golden) != 0);
+	return errors;
+}
+
+// compare changed run; returns number of problems
+a3ui32 a3testInternalCompare(const a3byte *path, const a3ui32 i)
+{
+	a3_DemoGolden golden[1] = { 0 };
+	a3real values[a3test_valueCount];
+	a3ui32 tick, errors = 0;
+	a3i32 result;
+
+	errors += (a3demo_beginGoldenCompare(golden, path, a3test_case[i].ulpTolerance, a3test_case[i].absTolerance) != a3test_tickCount);
+	for (tick = 0; tick < a3test_tickCount; ++tick)
+	{
+		a3testInternalValues(values, tick);
+		a3testInternalChange(values, tick, a3test_case[i].change);
+
+		// changed layout stops checking, counting the block's values as 
+		//	mismatched; later blocks are not checked
+		result = a3demo_checkGolden(golden, tick, (a3test_case[i].change == a3test_layout && tick == 1) ? "other" : "matrix", values, a3test_valueCount);
+		if (a3test_case[i].change == a3test_layout && tick >= 1)
+			errors += (result != -1);
+		else if (result < 0)
+			++errors;
+	}
+	result = a3demo_endGolden(golden);
+	errors += (result != a3test_case[i].mismatches);
+	printf("%s%-24s %-4s %d mismatches, %u errors\n", a3test_case[i].mismatches ? "\n" : "", a3test_case[i].name, errors ? "FAIL" : "pass", result, errors);
+	return errors;
+}
+
+
+//-----------------------------------------------------------------------------
+// main
+
+int main(int argc, char **argv)
+{
+	const a3ui32 count = sizeof(a3test_case) / sizeof(*a3test_case);
+	const a3byte *dir = argc > 1 ? argv[1] : ".";
+	a3byte path[256];
+	a3ui32 i, errors, failed = 0;
+
+	if (argc > 2)
+	{
+		printf("usage: %s [directory]\n", argv[0]);
+		return -1;
+	}
+	sprintf(path, "%s/a3_golden.bin", dir);
+
+	printf("golden file: comparisons within tolerance\n");
+	errors = a3testInternalWrite(path);
+	printf("%-24s %-4s %u errors\n", "write", errors ? "FAIL" : "pass", errors);
+	failed += (errors != 0);
+	if (!errors)
+		for (i = 0; i < count; ++i)
+			failed += (a3testInternalCompare(path, i) != 0);
+
+	remove(path);
+	printf("%u cases failed\n", failed);
+	return (int)failed;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,413 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	main_bench_loaders.c
+	Loader throughput benchmarks: writes a synthetic model (a wavy grid as 
+		OBJ), its skin weights (Maya XML), its geometry cache and a 
+		hierarchy binary to a directory, then times loading each one, 
+		reporting MB/s of file and vertices (or nodes) per second. 
+		Hierarchies belong to the demo plugin; build with its source 
+		directory on the include path and its hierarchy source.
+
+	usage: <bench> [-dir <directory>] [-grid <quads per side>] 
+		[-joints <count>] [-nodes <count>] [-runs <count>] [-keep] 
+		[-csv <file>]
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+
+#include "animal3D/animal3D.h"
+#include "A3_DEMO/_animation/a3_Hierarchy.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if (defined _WINDOWS || defined _WIN32)
+#include <Windows.h>
+#else	// !(defined _WINDOWS || defined _WIN32)
+#include <time.h>
+#endif	// (defined _WINDOWS || defined _WIN32)
+
+
+//-----------------------------------------------------------------------------
+// data
+
+// limits of options
+#define A3_BENCH_GRID_MAX	2048
+#define A3_BENCH_JOINT_MAX	64
+#define A3_BENCH_NODE_MAX	1048576
+#define A3_BENCH_PATH_MAX	256
+
+// timing of one loader over all runs
+typedef struct a3_BenchLoadResult
+{
+	a3f64 best, total;
+	a3ui32 runs;
+} a3_BenchLoadResult;
+
+static a3byte a3bench_jointNameData[A3_BENCH_JOINT_MAX][16];
+static const a3byte *a3bench_jointName[A3_BENCH_JOINT_MAX];
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// read high-precision counter, in seconds
+inline a3f64 a3benchInternalTime()
+{
+#if (defined _WINDOWS || defined _WIN32)
+	LARGE_INTEGER t, f;
+	QueryPerformanceCounter(&t);
+	QueryPerformanceFrequency(&f);
+	return (a3f64)t.QuadPart / (a3f64)f.QuadPart;
+#else	// !(defined _WINDOWS || defined _WIN32)
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (a3f64)t.tv_sec + (a3f64)t.tv_nsec * 1.0e-9;
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+inline a3ui32 a3benchInternalFileSize(const a3byte *filePath)
+{
+	a3ui32 size = 0;
+	FILE *fp = fopen(filePath, "rb");
+	if (fp)
+	{
+		fseek(fp, 0, SEEK_END);
+		size = (a3ui32)ftell(fp);
+		fclose(fp);
+	}
+	return size;
+}
+
+inline void a3benchInternalAddRun(a3_BenchLoadResult *result, const a3f64 dt)
+{
+	if (!result->runs || dt < result->best)
+		result->best = dt;
+	result->total += dt;
+	++result->runs;
+}
+
+// height of grid at a vertex, so that normals and positions vary
+inline a3f32 a3benchInternalHeight(const a3ui32 x, const a3ui32 z, const a3ui32 grid)
+{
+	return 0.25f * sinf((a3f32)x * 12.0f / (a3f32)grid) * cosf((a3f32)z * 9.0f / (a3f32)grid);
+}
+
+// write grid of quads with positions, texcoords and normals; vertices 
+//	are shared, as exported models do
+a3ui32 a3benchInternalWriteOBJ(const a3byte *filePath, const a3ui32 grid)
+{
+	const a3ui32 side = grid + 1;
+	const a3f32 step = 1.0f / (a3f32)grid;
+	a3ui32 x, z, i;
+	a3f32 h, dx, dz, lenInv;
+	FILE *fp = fopen(filePath, "w");
+	if (!fp)
+		return 0;
+
+	fprintf(fp, "# animal3D loader benchmark grid %u x %u\n", grid, grid);
+	for (z = 0; z < side; ++z)
+		for (x = 0; x < side; ++x)
+			fprintf(fp, "v %.6f %.6f %.6f\n", (a3f32)x * step - 0.5f, a3benchInternalHeight(x, z, grid), (a3f32)z * step - 0.5f);
+	for (z = 0; z < side; ++z)
+		for (x = 0; x < side; ++x)
+			fprintf(fp, "vt %.6f %.6f\n", (a3f32)x * step, (a3f32)z * step);
+	for (z = 0; z < side; ++z)
+		for (x = 0; x < side; ++x)
+		{
+			h = a3benchInternalHeight(x, z, grid);
+			dx = a3benchInternalHeight(x + 1, z, grid) - h;
+			dz = a3benchInternalHeight(x, z + 1, grid) - h;
+			lenInv = 1.0f / sqrtf(dx * dx + step * step + dz * dz);
+			fprintf(fp, "vn %.6f %.6f %.6f\n", -dx * lenInv, step * lenInv, -dz * lenInv);
+		}
+	for (z = 0; z < grid; ++z)
+		for (x = 0; x < grid; ++x)
+		{
+			i = z * side + x + 1;
+			fprintf(fp, "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u\n",
+				i, i, i, i + side, i + side, i + side, i + side + 1, i + side + 1, i + side + 1, i + 1, i + 1, i + 1);
+		}
+	fclose(fp);
+	return (side * side);
+}
+
+// write skin weights in the layout Maya exports: the shape, then one 
+//	weights block per joint listing the vertices it influences; each 
+//	joint influences a band of the grid that overlaps its neighbors
+a3ui32 a3benchInternalWriteSkin(const a3byte *filePath, const a3ui32 grid, const a3ui32 joints)
+{
+	const a3ui32 side = grid + 1;
+	const a3ui32 count = side * side;
+	const a3f32 bandWidth = (a3f32)side / (a3f32)joints;
+	a3ui32 i, j, x, z, begin, end;
+	a3f32 w, d;
+	FILE *fp = fopen(filePath, "w");
+	if (!fp)
+		return 0;
+
+	fprintf(fp, "<?xml version=\"1.0\"?>\n<deformerWeight>\n");
+	fprintf(fp, "  <headerInfo fileName=\"%s\" worldMatrix=\"1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1 \"/>\n", filePath);
+	fprintf(fp, "  <shape name=\"benchShape\" group=\"0\" stride=\"3\" size=\"%u\" max=\"%u\">\n", count, count);
+	for (z = 0, i = 0; z < side; ++z)
+		for (x = 0; x < side; ++x, ++i)
+			fprintf(fp, "    <point index=\"%u\" value=\"%.6f %.6f %.6f\"/>\n", i, (a3f32)x / (a3f32)grid - 0.5f, a3benchInternalHeight(x, z, grid), (a3f32)z / (a3f32)grid - 0.5f);
+	fprintf(fp, "  </shape>\n");
+	for (j = 0; j < joints; ++j)
+	{
+		// band of columns covered by joint, one band width on each side
+		begin = (a3ui32)((a3f32)j * bandWidth);
+		begin = begin > (a3ui32)bandWidth ? begin - (a3ui32)bandWidth : 0;
+		end = (a3ui32)((a3f32)(j + 2) * bandWidth) + 1;
+		end = end < side ? end : side;
+		fprintf(fp, "  <weights deformer=\"skinCluster1\" source=\"%s\" shape=\"benchShape\" layer=\"%u\" defaultValue=\"0.000\" size=\"%u\" max=\"%u\">\n",
+			a3bench_jointName[j], j, (end - begin) * side, count - 1);
+		for (z = 0; z < side; ++z)
+			for (x = begin; x < end; ++x)
+			{
+				d = fabsf(((a3f32)x + 0.5f) / bandWidth - ((a3f32)j + 0.5f));
+				w = d < 2.0f ? 1.0f - 0.5f * d : 0.001f;
+				fprintf(fp, "    <point index=\"%u\" value=\"%.4f\"/>\n", z * side + x, w);
+			}
+		fprintf(fp, "  </weights>\n");
+	}
+	fprintf(fp, "</deformerWeight>\n");
+	fclose(fp);
+	return count;
+}
+
+// write geometry cache of model, as demos do when streaming
+a3ui32 a3benchInternalWriteCache(const a3byte *filePath, const a3byte *objPath)
+{
+	a3_GeometryData geom[1] = { 0 };
+	a3_FileStream fileStream[1] = { 0 };
+	a3ui32 count = 0;
+	if (a3modelLoadOBJ(geom, objPath, a3model_loadNormals_loadTexcoords, 0, 0) > 0)
+	{
+		if (a3fileStreamOpenWrite(fileStream, filePath) > 0)
+		{
+			if (a3fileStreamWriteObject(fileStream, geom, (a3_FileStreamWriteFunc)a3geometrySaveDataBinary) > 0)
+				count = geom->numVertices;
+			a3fileStreamClose(fileStream);
+		}
+		a3geometryReleaseData(geom);
+	}
+	return count;
+}
+
+// write hierarchy binary of a skeleton-like tree: each node's parent is 
+//	a few nodes before it, so branches are short and the tree is deep
+a3ui32 a3benchInternalWriteHierarchy(const a3byte *filePath, const a3ui32 nodes)
+{
+	a3_Hierarchy hierarchy[1] = { 0 };
+	a3_FileStream fileStream[1] = { 0 };
+	a3byte name[a3node_nameSize];
+	a3ui32 i, count = 0;
+	if (a3hierarchyCreate(hierarchy, nodes, 0) > 0)
+	{
+		for (i = 0; i < nodes; ++i)
+		{
+			sprintf(name, "node%u", i);
+			a3hierarchySetNode(hierarchy, i, (a3i32)i - 1 - (a3i32)(i % 3), name);
+		}
+		if (a3fileStreamOpenWrite(fileStream, filePath) > 0)
+		{
+			if (a3fileStreamWriteObject(fileStream, hierarchy, (a3_FileStreamWriteFunc)a3hierarchySaveBinary) > 0)
+				count = nodes;
+			a3fileStreamClose(fileStream);
+		}
+		a3hierarchyRelease(hierarchy);
+	}
+	return count;
+}
+
+void a3benchInternalReport(FILE *fp, const a3byte *name, const a3_BenchLoadResult *result, const a3ui32 fileSize, const a3ui32 itemCount)
+{
+	printf("%-26s %10.3lf %10.3lf %10.2lf %12.0lf\n", name, result->best * 1000.0, result->total * 1000.0 / (a3f64)result->runs,
+		(a3f64)fileSize / (1024.0 * 1024.0) / result->best, (a3f64)itemCount / result->best);
+	if (fp)
+		fprintf(fp, "\"%s\",%u,%u,%.4lf,%.4lf,%.4lf,%.1lf\n", name, fileSize, itemCount, result->best * 1000.0, result->total * 1000.0 / (a3f64)result->runs,
+			(a3f64)fileSize / (1024.0 * 1024.0) / result->best, (a3f64)itemCount / result->best);
+}
+
+
+//-----------------------------------------------------------------------------
+// main
+
+int main(int argc, char **argv)
+{
+	const a3byte *dirPath = "./data/bench";
+	const a3byte *csvPath = 0;
+	a3ui32 grid = 256, joints = 8, nodes = 16384, runs = 5;
+	a3boolean keep = 0;
+
+	a3byte objPath[A3_BENCH_PATH_MAX], skinPath[A3_BENCH_PATH_MAX], cachePath[A3_BENCH_PATH_MAX], hierarchyPath[A3_BENCH_PATH_MAX];
+	a3ui32 objSize, skinSize, cacheSize, hierarchySize, objVertices, cacheVertices;
+	a3_BenchLoadResult objResult = { 0 }, skinResult = { 0 }, cacheResult = { 0 }, hierarchyResult = { 0 };
+	a3_GeometryData geom[1];
+	a3_Hierarchy hierarchy[1];
+	a3_FileStream fileStream[1];
+	a3f64 t0;
+	a3ret status;
+	a3ui32 r;
+	a3i32 i;
+	FILE *fp = 0;
+
+	// parse options
+	for (i = 1; i < argc; ++i)
+	{
+		if (!strcmp(argv[i], "-dir") && i + 1 < argc)
+			dirPath = argv[++i];
+		else if (!strcmp(argv[i], "-grid") && i + 1 < argc)
+			grid = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-joints") && i + 1 < argc)
+			joints = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-nodes") && i + 1 < argc)
+			nodes = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-runs") && i + 1 < argc)
+			runs = (a3ui32)strtoul(argv[++i], 0, 10);
+		else if (!strcmp(argv[i], "-keep"))
+			keep = 1;
+		else if (!strcmp(argv[i], "-csv") && i + 1 < argc)
+			csvPath = argv[++i];
+		else
+		{
+			printf("usage: %s [-dir <directory>] [-grid <quads per side>] [-joints <count>] [-nodes <count>] [-runs <count>] [-keep] [-csv <file>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!grid || grid > A3_BENCH_GRID_MAX || !joints || joints > A3_BENCH_JOINT_MAX || !nodes || nodes > A3_BENCH_NODE_MAX || !runs)
+	{
+		printf("\n A3 ERROR: Grid must be in [1, %u], joints in [1, %u], nodes in [1, %u] and runs positive.\n", A3_BENCH_GRID_MAX, A3_BENCH_JOINT_MAX, A3_BENCH_NODE_MAX);
+		return 1;
+	}
+	for (r = 0; r < joints; ++r)
+	{
+		sprintf(a3bench_jointNameData[r], "joint%u", r);
+		a3bench_jointName[r] = a3bench_jointNameData[r];
+	}
+
+	// write assets
+	a3fileStreamMakeDirectory(dirPath);
+	sprintf(objPath, "%s/bench_grid.obj", dirPath);
+	sprintf(skinPath, "%s/bench_grid_skin.xml", dirPath);
+	sprintf(cachePath, "%s/bench_grid.dat", dirPath);
+	sprintf(hierarchyPath, "%s/bench_hierarchy.dat", dirPath);
+	objVertices = a3benchInternalWriteOBJ(objPath, grid);
+	if (!objVertices || !a3benchInternalWriteSkin(skinPath, grid, joints) || !(cacheVertices = a3benchInternalWriteCache(cachePath, objPath)) || !a3benchInternalWriteHierarchy(hierarchyPath, nodes))
+	{
+		printf("\n A3 ERROR: Failed to write benchmark assets to %s\n", dirPath);
+		return 1;
+	}
+	objSize = a3benchInternalFileSize(objPath);
+	skinSize = a3benchInternalFileSize(skinPath);
+	cacheSize = a3benchInternalFileSize(cachePath);
+	hierarchySize = a3benchInternalFileSize(hierarchyPath);
+	if (csvPath)
+	{
+		fp = fopen(csvPath, "w");
+		if (!fp)
+			printf("\n A3 ERROR: Failed to open file: %s\n", csvPath);
+		else
+			fprintf(fp, "loader,bytes,items,best_ms,mean_ms,mb_per_s,items_per_s\n");
+	}
+
+	// time loads; a failed load ends the benchmark
+	for (r = 0, status = 1; r < runs && status > 0; ++r)
+	{
+		memset(geom, 0, sizeof(geom));
+		t0 = a3benchInternalTime();
+		status = a3modelLoadOBJ(geom, objPath, a3model_loadNormals_loadTexcoords, 0, 0);
+		a3benchInternalAddRun(&objResult, a3benchInternalTime() - t0);
+		a3geometryReleaseData(geom);
+	}
+	for (r = 0; r < runs && status > 0; ++r)
+	{
+		memset(geom, 0, sizeof(geom));
+		t0 = a3benchInternalTime();
+		status = a3modelLoadOBJSkinWeights(geom, objPath, a3model_loadNormals_loadTexcoords, skinPath, a3bench_jointName, joints, 0, 0);
+		a3benchInternalAddRun(&skinResult, a3benchInternalTime() - t0);
+		a3geometryReleaseData(geom);
+	}
+	for (r = 0; r < runs && status > 0; ++r)
+	{
+		memset(geom, 0, sizeof(geom));
+		memset(fileStream, 0, sizeof(fileStream));
+		t0 = a3benchInternalTime();
+		status = a3fileStreamOpenRead(fileStream, cachePath);
+		if (status > 0)
+		{
+			status = a3fileStreamReadObject(fileStream, geom, (a3_FileStreamReadFunc)a3geometryLoadDataBinary);
+			a3fileStreamClose(fileStream);
+		}
+		a3benchInternalAddRun(&cacheResult, a3benchInternalTime() - t0);
+		a3geometryReleaseData(geom);
+	}
+	for (r = 0; r < runs && status > 0; ++r)
+	{
+		memset(hierarchy, 0, sizeof(hierarchy));
+		memset(fileStream, 0, sizeof(fileStream));
+		t0 = a3benchInternalTime();
+		status = a3fileStreamOpenRead(fileStream, hierarchyPath);
+		if (status > 0)
+		{
+			status = a3fileStreamReadObject(fileStream, hierarchy, (a3_FileStreamReadFunc)a3hierarchyLoadBinary);
+			a3fileStreamClose(fileStream);
+		}
+		a3benchInternalAddRun(&hierarchyResult, a3benchInternalTime() - t0);
+		if (hierarchy->nodes)
+			a3hierarchyRelease(hierarchy);
+	}
+
+	// report; skin weights are timed with the model they belong to, so 
+	//	both files count toward its throughput; items are vertices, or 
+	//	nodes for hierarchies
+	if (status > 0)
+	{
+		printf("loader benchmarks: %u x %u grid, %u vertices (%u unique), %u joints, %u nodes, best and mean of %u runs\n",
+			grid, grid, objVertices, cacheVertices, joints, nodes, runs);
+		printf("%-26s %10s %10s %10s %12s\n", "loader", "best ms", "mean ms", "MB/s", "items/s");
+		a3benchInternalReport(fp, "a3modelLoadOBJ", &objResult, objSize, objVertices);
+		a3benchInternalReport(fp, "a3modelLoadOBJSkinWeights", &skinResult, objSize + skinSize, objVertices);
+		a3benchInternalReport(fp, "a3geometryLoadDataBinary", &cacheResult, cacheSize, cacheVertices);
+		a3benchInternalReport(fp, "a3hierarchyLoadBinary", &hierarchyResult, hierarchySize, nodes);
+	}
+	else
+		printf("\n A3 ERROR: Loading benchmark assets failed.\n");
+
+	// done
+	if (fp)
+		fclose(fp);
+	if (!keep)
+	{
+		remove(objPath);
+		remove(skinPath);
+		remove(cachePath);
+		remove(hierarchyPath);
+	}
+	return (status > 0 ? 0 : 1);
+}
+
+
+//-----------------------------------------------------------------------------
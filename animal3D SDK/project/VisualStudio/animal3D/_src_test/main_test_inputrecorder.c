@@ -0,0 +1,273 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	main_test_inputrecorder.c
+	Input record and replay check: drives a small state with scripted
+		key, character key, mouse and controller events while recording,
+		then replays the recording into a fresh state, with live events
+		that replay must ignore, passing the replayed character keys to
+		the same handlers. The state after every tick and at the end must
+		match the recorded run. Also checks that a damaged recording stops
+		replay. Exits with the number of failed cases.
+
+	usage: <test> [directory]
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+
+#include "animal3D/animal3D.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// data
+
+// number of ticks to record
+enum a3_TestInputRecorderCount
+{
+	a3test_tickCount = 400,
+};
+
+// state driven by input, as a demo would be
+typedef struct a3_TestInputState
+{
+	a3_KeyboardInput keyboard[1];
+	a3_MouseInput mouse[1];
+	a3_XboxControllerInput xcontrol[1];
+	a3ui32 mode, presses, holds;
+	a3i32 moveX, moveY, look;
+	a3ui32 hash;
+} a3_TestInputState;
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// fold value into running hash
+void a3testInternalHash(a3_TestInputState *state, const a3ui32 value)
+{
+	state->hash = (state->hash ^ value) * 16777619u;
+}
+
+// character key handlers, used for live and replayed keys
+void a3testInternalKeyCharPress(a3_TestInputState *state, const a3i32 asciiKey)
+{
+	a3keyboardSetStateASCII(state->keyboard, (a3byte)asciiKey);
+	state->mode = (state->mode + (a3ui32)asciiKey) % 7;
+	++state->presses;
+	a3testInternalHash(state, (a3ui32)asciiKey);
+}
+
+void a3testInternalKeyCharHold(a3_TestInputState *state, const a3i32 asciiKey)
+{
+	a3keyboardSetStateASCII(state->keyboard, (a3byte)asciiKey);
+	++state->holds;
+	a3testInternalHash(state, (a3ui32)asciiKey << 8);
+}
+
+// events between two ticks; the same script is used as live input while
+//	replaying, shifted so it differs from the recorded one
+void a3testInternalEvents(a3_TestInputState *state, a3_InputRecorder *recorder_opt, const a3ui32 tick)
+{
+	const a3ui32 r = tick * 2654435761u;
+	const a3byte keyChar = (a3byte)('a' + (r >> 7) % 26);
+
+	if (r % 3 == 0)
+		a3keyboardSetState(state->keyboard, (a3_KeyboardKey)(a3key_A + (r >> 11) % 26), (r >> 5) % 2 ? a3input_down : a3input_up);
+	if (r % 4 == 1)
+	{
+		// live events during replay are ignored, as the demo does
+		if (!recorder_opt || recorder_opt->mode != a3input_recorderReplay)
+		{
+			a3inputRecorderKeyChar(recorder_opt, keyChar, 0);
+			a3testInternalKeyCharPress(state, keyChar);
+		}
+	}
+	if (r % 5 == 2)
+	{
+		if (!recorder_opt || recorder_opt->mode != a3input_recorderReplay)
+		{
+			a3inputRecorderKeyChar(recorder_opt, keyChar, 1);
+			a3testInternalKeyCharHold(state, keyChar);
+			a3inputRecorderKeyChar(recorder_opt, 'Q', 0);
+			a3testInternalKeyCharPress(state, 'Q');
+		}
+	}
+	if (r % 2 == 0)
+		a3mouseSetPosition(state->mouse, (a3i32)((r >> 3) % 960), (a3i32)((r >> 13) % 540));
+	if (r % 7 == 3)
+		a3mouseSetState(state->mouse, (a3_MouseButton)((r >> 9) % 3), (r >> 4) % 2 ? a3input_down : a3input_up);
+	if (r % 9 == 4)
+	{
+		state->xcontrol->ctrl.buttons = (a3ui16)(r >> 16);
+		state->xcontrol->ctrl.lThumbX = (a3i16)(r >> 2);
+		state->xcontrol->connected = 1;
+	}
+}
+
+// update after tick: read input, then age it
+void a3testInternalUpdate(a3_TestInputState *state)
+{
+	state->moveX += a3keyboardGetDifference(state->keyboard, a3key_D, a3key_A);
+	state->moveY += a3keyboardGetDifferenceASCII(state->keyboard, 'w', 's');
+	state->look += a3mouseGetDeltaX(state->mouse) - a3mouseGetDeltaY(state->mouse);
+	state->look += a3mouseIsPressed(state->mouse, a3mouse_left) * 1000;
+	a3testInternalHash(state, (a3ui32)state->moveX);
+	a3testInternalHash(state, (a3ui32)state->moveY);
+	a3testInternalHash(state, (a3ui32)state->look);
+	a3testInternalHash(state, state->xcontrol->ctrl.buttons ^ (a3ui32)state->xcontrol->ctrl.lThumbX);
+	a3keyboardUpdate(state->keyboard);
+	a3mouseUpdate(state->mouse);
+}
+
+// pass replayed character keys to the handlers, in order
+void a3testInternalDispatch(a3_TestInputState *state, const a3_InputRecorder *recorder)
+{
+	a3ui32 i;
+	for (i = 0; i < recorder->keyCharCount; ++i)
+	{
+		if (recorder->keyChar[i] & 0x80)
+			a3testInternalKeyCharHold(state, recorder->keyChar[i] & 0x7F);
+		else
+			a3testInternalKeyCharPress(state, recorder->keyChar[i]);
+	}
+}
+
+// record run; returns number of problems
+a3ui32 a3testInternalRecord(const a3byte *path, a3_TestInputState *state, a3ui32 *hash_out)
+{
+	a3_InputRecorder recorder[1] = { 0 };
+	a3ui32 tick, errors = 0;
+
+	errors += (a3inputRecorderBeginRecord(recorder, path) != 1);
+	for (tick = 0; tick < a3test_tickCount; ++tick)
+	{
+		a3testInternalEvents(state, recorder, tick);
+		errors += (a3inputRecorderTick(recorder, state->keyboard, state->mouse, state->xcontrol) != 1);
+		errors += (recorder->keyCharCount != 0);
+		a3testInternalUpdate(state);
+		hash_out[tick] = state->hash;
+	}
+	errors += (a3inputRecorderEnd(recorder) != a3test_tickCount);
+	return errors;
+}
+
+// replay run against recorded hashes; returns number of problems
+a3ui32 a3testInternalReplay(const a3byte *path, a3_TestInputState *state, const a3ui32 *hash)
+{
+	a3_InputRecorder recorder[1] = { 0 };
+	a3ui32 tick, errors = 0;
+
+	errors += (a3inputRecorderBeginReplay(recorder, path) != a3test_tickCount);
+	for (tick = 0; tick < a3test_tickCount; ++tick)
+	{
+		a3testInternalEvents(state, recorder, tick + 1);
+		errors += (a3inputRecorderTick(recorder, state->keyboard, state->mouse, state->xcontrol) != 1);
+		a3testInternalDispatch(state, recorder);
+		a3testInternalUpdate(state);
+		errors += (state->hash != hash[tick]);
+	}
+
+	// finished replay is idle and sets no keys
+	errors += (a3inputRecorderTick(recorder, state->keyboard, state->mouse, state->xcontrol) != 0);
+	errors += (recorder->mode != a3input_recorderIdle || recorder->keyCharCount != 0);
+	errors += (a3inputRecorderEnd(recorder) != a3test_tickCount);
+	return errors;
+}
+
+// truncated recording must stop replay with an error
+a3ui32 a3testInternalDamaged(const a3byte *path, const a3byte *damagedPath)
+{
+	a3_InputRecorder recorder[1] = { 0 };
+	a3_TestInputState state[1] = { 0 };
+	a3_Stream stream[1] = { 0 }, damaged[1] = { 0 };
+	a3ui32 tick, errors = 0;
+	a3i32 result = 1;
+
+	if (a3streamLoadContents(stream, path, 0) <= 0)
+		return 1;
+	damaged->contents = stream->contents;
+	damaged->length = stream->length * 2 / 3;
+	errors += (a3streamSaveContents(damaged, damagedPath) < 0);
+	a3streamReleaseContents(stream);
+
+	errors += (a3inputRecorderBeginReplay(recorder, damagedPath) != a3test_tickCount);
+	for (tick = 0; tick < a3test_tickCount && result > 0; ++tick)
+		result = a3inputRecorderTick(recorder, state->keyboard, state->mouse, state->xcontrol);
+	errors += (result != -1 || recorder->mode != a3input_recorderIdle);
+	a3inputRecorderEnd(recorder);
+	remove(damagedPath);
+	return errors;
+}
+
+
+//-----------------------------------------------------------------------------
+// main
+
+int main(int argc, char **argv)
+{
+	static a3ui32 hash[a3test_tickCount];
+	const a3byte *dir = argc > 1 ? argv[1] : ".";
+	a3_TestInputState recorded[1] = { 0 }, replayed[1] = { 0 };
+	a3byte path[256], damagedPath[256];
+	a3ui32 errors, failed = 0;
+
+	if (argc > 2)
+	{
+		printf("usage: %s [directory]\n", argv[0]);
+		return -1;
+	}
+	sprintf(path, "%s/a3_inputrecorder.bin", dir);
+	sprintf(damagedPath, "%s/a3_inputrecorder_damaged.bin", dir);
+
+	printf("input recorder: replay reproduces recorded state\n");
+
+	// record
+	errors = a3testInternalRecord(path, recorded, hash);
+	printf("%-24s %-4s %u presses, %u holds, %u errors\n", "record", errors ? "FAIL" : "pass", recorded->presses, recorded->holds, errors);
+	failed += (errors != 0);
+
+	// replay into fresh state; every tick and the end state must match
+	errors = a3testInternalReplay(path, replayed, hash);
+	errors += (replayed->mode != recorded->mode || replayed->presses != recorded->presses || replayed->holds != recorded->holds);
+	errors += (replayed->moveX != recorded->moveX || replayed->moveY != recorded->moveY || replayed->look != recorded->look);
+	errors += (memcmp(replayed->keyboard, recorded->keyboard, sizeof(a3_KeyboardInput)) != 0);
+	errors += (memcmp(replayed->mouse, recorded->mouse, sizeof(a3_MouseInput)) != 0);
+	errors += (memcmp(&replayed->xcontrol->ctrl, &recorded->xcontrol->ctrl, sizeof(recorded->xcontrol->ctrl)) != 0);
+	errors += (replayed->xcontrol->connected != recorded->xcontrol->connected);
+	printf("%-24s %-4s %u presses, %u holds, %u errors\n", "replay", errors ? "FAIL" : "pass", replayed->presses, replayed->holds, errors);
+	failed += (errors != 0);
+
+	// damaged stream
+	errors = a3testInternalDamaged(path, damagedPath);
+	printf("\n%-24s %-4s %u errors\n", "replay (damaged)", errors ? "FAIL" : "pass", errors);
+	failed += (errors != 0);
+
+	remove(path);
+	printf("%u cases failed\n", failed);
+	return (int)failed;
+}
+
+
+//-----------------------------------------------------------------------------
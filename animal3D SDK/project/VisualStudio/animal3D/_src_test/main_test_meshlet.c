@@ -0,0 +1,204 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	main_test_meshlet.c
+	Meshlet partition check: generates procedural shapes with 8, 16 and
+		32-bit indices, partitions each with several limits and checks
+		that every meshlet respects the vertex and triangle limits, that
+		the ranges are contiguous, that local indices stay inside the
+		meshlet and that the triangles, read back in order, are exactly
+		the input triangles (each covered once). Then corrupts one index
+		of each shape past the vertex count and checks that partitioning
+		fails without output. Exits with the number of failed cases.
+
+	usage: <test>
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+
+#include "animal3D/animal3D.h"
+
+#include <stdio.h>
+
+
+//-----------------------------------------------------------------------------
+// data
+
+// limits to partition with; zero selects defaults
+static const a3ui32 a3test_limit[][2] = {
+	{ 0, 0 },
+	{ 3, 1 },
+	{ 16, 8 },
+	{ 32, 64 },
+	{ a3geomMeshlet_verticesMax, a3geomMeshlet_trianglesMax },
+};
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// read index, any size
+a3ui32 a3testInternalLoadIndex(const a3_GeometryData *geom, const a3ui32 i)
+{
+	if (geom->indexFormat->indexSize < 2)
+		return ((const a3ubyte *)geom->indexData)[i];
+	else if (geom->indexFormat->indexSize < 4)
+		return ((const a3ui16 *)geom->indexData)[i];
+	else
+		return ((const a3ui32 *)geom->indexData)[i];
+}
+
+// write index, any size
+void a3testInternalStoreIndex(const a3_GeometryData *geom, const a3ui32 i, const a3ui32 index)
+{
+	if (geom->indexFormat->indexSize < 2)
+		((a3ubyte *)geom->indexData)[i] = (a3ubyte)index;
+	else if (geom->indexFormat->indexSize < 4)
+		((a3ui16 *)geom->indexData)[i] = (a3ui16)index;
+	else
+		((a3ui32 *)geom->indexData)[i] = index;
+}
+
+// check meshlets against geometry; returns number of problems
+a3ui32 a3testInternalCheck(const a3_GeometryMeshletData *meshlets, const a3_GeometryData *geom, const a3ui32 maxVertices, const a3ui32 maxTriangles)
+{
+	const a3_GeometryMeshlet *meshlet;
+	a3ui32 m, t, k, j, local, vertex;
+	a3ui32 vertexOffset = 0, triangleOffset = 0, triangle = 0, errors = 0;
+
+	for (m = 0, meshlet = meshlets->meshlet; m < meshlets->numMeshlets; ++m, ++meshlet)
+	{
+		// limits and contiguous ranges
+		errors += (meshlet->vertexCount < 1 || meshlet->vertexCount > maxVertices);
+		errors += (meshlet->triangleCount < 1 || meshlet->triangleCount > maxTriangles);
+		errors += (meshlet->vertexOffset != vertexOffset);
+		errors += (meshlet->triangleOffset != triangleOffset);
+		vertexOffset += meshlet->vertexCount;
+		triangleOffset += meshlet->triangleCount;
+		if (vertexOffset > meshlets->numVertexIndices || triangleOffset > meshlets->numTriangles)
+			return ++errors;
+
+		// vertices are unique within meshlet
+		for (k = 1; k < meshlet->vertexCount; ++k)
+			for (j = 0; j < k; ++j)
+				errors += (meshlets->vertexIndex[meshlet->vertexOffset + k] == meshlets->vertexIndex[meshlet->vertexOffset + j]);
+
+		// triangles map back to input triangles, in order
+		for (t = 0; t < meshlet->triangleCount; ++t, ++triangle)
+			for (k = 0; k < 3; ++k)
+			{
+				local = meshlets->triangleIndex[(meshlet->triangleOffset + t) * 3 + k];
+				if (local >= meshlet->vertexCount)
+				{
+					++errors;
+					continue;
+				}
+				vertex = meshlets->vertexIndex[meshlet->vertexOffset + local];
+				errors += (triangle * 3 + k >= geom->numIndices || vertex != a3testInternalLoadIndex(geom, triangle * 3 + k));
+			}
+	}
+
+	// every triangle covered
+	errors += (vertexOffset != meshlets->numVertexIndices);
+	errors += (triangleOffset != meshlets->numTriangles);
+	errors += (triangle != geom->numIndices / 3);
+	return errors;
+}
+
+// partition shape with every limit, then corrupt it; returns failed cases
+a3ui32 a3testInternalRun(const a3byte *name, const a3_ProceduralGeometryDescriptor *shape)
+{
+	a3_GeometryData geom[1] = { 0 };
+	a3_GeometryMeshletData meshlets[1] = { 0 };
+	const a3ui32 count = sizeof(a3test_limit) / sizeof(*a3test_limit);
+	a3ui32 i, maxVertices, maxTriangles, errors, failed = 0;
+	a3i32 result;
+
+	if (a3proceduralGenerateGeometryData(geom, shape, 0, 0) <= 0 || !geom->indexData)
+	{
+		printf("%-24s FAIL (could not generate)\n", name);
+		return count + 1;
+	}
+
+	for (i = 0; i < count; ++i)
+	{
+		maxVertices = a3test_limit[i][0] ? a3test_limit[i][0] : a3geomMeshlet_verticesDefault;
+		maxTriangles = a3test_limit[i][1] ? a3test_limit[i][1] : a3geomMeshlet_trianglesDefault;
+		result = a3geometryGenerateMeshlets(meshlets, geom, a3test_limit[i][0], a3test_limit[i][1]);
+		errors = result > 0 ? a3testInternalCheck(meshlets, geom, maxVertices, maxTriangles) : 1;
+		printf("%-24s %2u-bit %3u/%3u  %-4s %6d meshlets, %7u triangles, %u errors\n",
+			name, geom->indexFormat->indexSize * 8, maxVertices, maxTriangles, errors ? "FAIL" : "pass",
+			result, meshlets->numTriangles, errors);
+		failed += (errors != 0);
+		a3geometryReleaseMeshlets(meshlets);
+	}
+
+	// index past the vertex count must be rejected
+	a3testInternalStoreIndex(geom, geom->numIndices / 2, geom->numVertices);
+	result = a3geometryGenerateMeshlets(meshlets, geom, 0, 0);
+	errors = (result != 0 || meshlets->data != 0);
+	printf("%-24s %2u-bit bad index  %-4s returned %d\n",
+		name, geom->indexFormat->indexSize * 8, errors ? "FAIL" : "pass", result);
+	failed += errors;
+	if (meshlets->data)
+		a3geometryReleaseMeshlets(meshlets);
+
+	a3geometryReleaseData(geom);
+	return failed;
+}
+
+
+//-----------------------------------------------------------------------------
+// main
+
+int main(int argc, char **argv)
+{
+	a3_ProceduralGeometryDescriptor shape[4] = { 0 };
+	a3ui32 failed = 0;
+
+	if (argc > 1)
+	{
+		printf("usage: %s\n", argv[0]);
+		return -1;
+	}
+
+	printf("meshlet partition: limits, ranges and coverage\n");
+
+	// small sphere fits in 8-bit indices, larger one needs 16
+	a3proceduralCreateDescriptorSphere(shape + 0, a3geomFlag_vanilla, a3geomAxis_default, 1.0f, 12, 8);
+	failed += a3testInternalRun("sphere 12x8", shape + 0);
+	a3proceduralCreateDescriptorSphere(shape + 1, a3geomFlag_normals, a3geomAxis_default, 1.0f, 64, 48);
+	failed += a3testInternalRun("sphere 64x48", shape + 1);
+
+	// torus with every attribute
+	a3proceduralCreateDescriptorTorus(shape + 2, a3geomFlag_tangents, a3geomAxis_default, 1.0f, 0.25f, 48, 24);
+	failed += a3testInternalRun("torus 48x24", shape + 2);
+
+	// grid with more vertices than 16-bit indices can reach
+	a3proceduralCreateDescriptorPlane(shape + 3, a3geomFlag_vanilla, a3geomAxis_default, 1.0f, 1.0f, 255, 255);
+	failed += a3testInternalRun("plane 255x255", shape + 3);
+
+	printf("%u cases failed\n", failed);
+	return (int)failed;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,273 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	main_test_streamqueue.c
+	Stream queue check: writes a set of files (empty, small, and larger
+		than one read), then reads them all through a stream queue,
+		whole and as objects, with and without callbacks, and compares
+		every result with loading the file directly. On Linux, when the
+		queue uses io_uring, repeats the reads after breaking the ring
+		to check that the queue falls back to normal reads instead of
+		hanging. Exits with the number of failed cases.
+
+	usage: <test> [directory]
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+
+#include "animal3D/animal3D.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif	// __linux__
+
+
+//-----------------------------------------------------------------------------
+// data
+
+// number of files; more than the ring holds at once
+enum a3_TestStreamQueueCount
+{
+	a3test_fileCount = 160,
+	a3test_fileMissing = 3,
+};
+
+// object read from file: byte count and checksum
+typedef struct a3_TestStreamObject
+{
+	a3ui32 length;
+	a3ui32 sum;
+} a3_TestStreamObject;
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// size of each file: empty, small and a few megabytes
+a3ui32 a3testInternalFileSize(const a3ui32 i)
+{
+	return (i % 16 == 0) ? 0 : (i % 16 == 1) ? (3 << 20) + i : (i * 977) % 20000 + 1;
+}
+
+// file path; some files are never written
+void a3testInternalFilePath(a3byte *path_out, const a3byte *dir, const a3ui32 i)
+{
+	sprintf(path_out, "%s/a3_streamqueue_%03u.bin", dir, i);
+}
+
+// write file with contents that depend on its index
+a3boolean a3testInternalWriteFile(const a3byte *path, const a3ui32 i)
+{
+	const a3ui32 size = a3testInternalFileSize(i);
+	a3ui32 j;
+	FILE *fp;
+	if (i % 50 == a3test_fileMissing)
+	{
+		remove(path);
+		return 1;
+	}
+	fp = fopen(path, "wb");
+	if (!fp)
+		return 0;
+	for (j = 0; j < size; ++j)
+		fputc((a3byte)(j * 31 + i), fp);
+	fclose(fp);
+	return 1;
+}
+
+// object read function: counts and sums bytes
+a3i32 a3testInternalReadObject(a3_TestStreamObject *object, const a3_FileStream *fs)
+{
+	a3ubyte buffer[4096];
+	a3ui32 count, j;
+	object->length = object->sum = 0;
+	while ((count = (a3ui32)fread(buffer, 1, sizeof(buffer), fs->stream)) > 0)
+		for (j = 0, object->length += count; j < count; ++j)
+			object->sum = object->sum * 31 + buffer[j];
+	return (a3i32)object->length;
+}
+
+// completion callback: counts calls
+void a3testInternalCallback(a3_StreamRequest *request, a3ui32 *calls)
+{
+	(void)request;
+	++*calls;
+}
+
+#ifdef __linux__
+// replace the queue's io_uring descriptor with one the kernel will not
+//	accept, so the next batch fails hard; returns 0 if not found
+a3boolean a3testInternalBreakRing()
+{
+	a3byte link[64], target[64];
+	struct dirent *entry;
+	a3boolean ret = 0;
+	a3i32 fd, nul;
+	DIR *dir = opendir("/proc/self/fd");
+	if (!dir)
+		return 0;
+	while (!ret && (entry = readdir(dir)))
+	{
+		memset(target, 0, sizeof(target));
+		sprintf(link, "/proc/self/fd/%s", entry->d_name);
+		if (readlink(link, target, sizeof(target) - 1) > 0 && strstr(target, "io_uring"))
+		{
+			fd = atoi(entry->d_name);
+			nul = open("/dev/null", O_RDONLY);
+			ret = (nul >= 0 && dup2(nul, fd) == fd);
+			if (nul >= 0)
+				close(nul);
+		}
+	}
+	closedir(dir);
+	return ret;
+}
+#endif	// __linux__
+
+// read every file through queue and compare; returns number of problems
+a3ui32 a3testInternalRun(a3_StreamQueue *queue, a3byte (*path)[256])
+{
+	a3_StreamRequest *request = (a3_StreamRequest *)calloc(a3test_fileCount * 2, sizeof(a3_StreamRequest));
+	a3_TestStreamObject object[a3test_fileCount] = { 0 }, expect[1];
+	a3_FileStream fs[1] = { 0 };
+	a3_Stream direct[1] = { 0 };
+	a3ui32 i, calls = 0, callbacks = 0, errors = 0;
+	a3i32 result;
+	if (!request)
+		return 1;
+
+	// whole files and objects, every other one with a callback
+	for (i = 0; i < a3test_fileCount; ++i)
+	{
+		callbacks += (i % 2) * 2;
+		errors += a3streamQueueReadContents(queue, request + i, path[i], (i % 2) ? (a3_StreamRequestFunc)a3testInternalCallback : 0, &calls) != 1;
+		errors += a3streamQueueReadObject(queue, request + a3test_fileCount + i, path[i], object + i, (a3_FileStreamReadFunc)a3testInternalReadObject, (i % 2) ? (a3_StreamRequestFunc)a3testInternalCallback : 0, &calls) != 1;
+	}
+	a3streamQueueWait(queue, 0);
+	errors += (calls != callbacks);
+
+	for (i = 0; i < a3test_fileCount; ++i)
+	{
+		// whole file matches direct load
+		errors += !a3streamRequestIsDone(request + i);
+		result = a3streamLoadContents(direct, path[i], 0);
+		errors += (request[i].result != (result > 0 ? result : 0));
+		errors += (request[i].stream->length != direct->length);
+		if (direct->contents && request[i].stream->contents)
+			errors += memcmp(request[i].stream->contents, direct->contents, direct->length + 1) != 0;
+		else
+			errors += (direct->contents != 0 || request[i].stream->contents != 0);
+		a3streamReleaseContents(direct);
+		a3streamReleaseContents(request[i].stream);
+
+		// object matches direct read
+		expect->length = expect->sum = 0;
+		result = 0;
+		if (a3fileStreamOpenRead(fs, path[i]) > 0)
+		{
+			result = a3fileStreamReadObject(fs, expect, (a3_FileStreamReadFunc)a3testInternalReadObject);
+			a3fileStreamClose(fs);
+		}
+		errors += !a3streamRequestIsDone(request + a3test_fileCount + i);
+		errors += (request[a3test_fileCount + i].result != (result > 0 ? result : 0));
+		errors += (object[i].length != expect->length || object[i].sum != expect->sum);
+	}
+	free(request);
+	return errors;
+}
+
+
+//-----------------------------------------------------------------------------
+// main
+
+int main(int argc, char **argv)
+{
+	static a3byte path[a3test_fileCount][256];
+	const a3byte *dir = argc > 1 ? argv[1] : ".";
+	a3_StreamQueue queue[1] = { 0 };
+	a3ui32 i, errors, served, failed = 0;
+	a3boolean ring;
+
+	if (argc > 2)
+	{
+		printf("usage: %s [directory]\n", argv[0]);
+		return -1;
+	}
+
+	printf("stream queue: results match direct loads\n");
+	for (i = 0; i < a3test_fileCount; ++i)
+	{
+		a3testInternalFilePath(path[i], dir, i);
+		if (!a3testInternalWriteFile(path[i], i))
+		{
+			printf("could not write %s\n", path[i]);
+			return -1;
+		}
+	}
+
+	// normal run
+	if (a3streamQueueCreate(queue) <= 0)
+	{
+		printf("could not create queue\n");
+		return -1;
+	}
+	ring = queue->ring;
+	errors = a3testInternalRun(queue, path);
+	printf("%-24s %-4s %u errors\n", ring ? "read (io_uring)" : "read", errors ? "FAIL" : "pass", errors);
+	failed += (errors != 0);
+
+#ifdef __linux__
+	// broken ring must fall back to normal reads and stop using the ring
+	if (ring)
+	{
+		if (a3testInternalBreakRing())
+		{
+			errors = a3testInternalRun(queue, path);
+			errors += (queue->ring != 0);
+			errors += a3testInternalRun(queue, path);
+			printf("%-24s %-4s %u errors\n", "read (ring broken)", errors ? "FAIL" : "pass", errors);
+			failed += (errors != 0);
+		}
+		else
+			printf("%-24s skip (ring descriptor not found)\n", "read (ring broken)");
+	}
+#endif	// __linux__
+
+	// everything submitted was served
+	served = a3streamQueueRelease(queue);
+	errors = (served % (a3test_fileCount * 2) != 0 || served == 0 || queue->internal != 0);
+	printf("%-24s %-4s %u requests served\n", "release", errors ? "FAIL" : "pass", served);
+	failed += (errors != 0);
+
+	for (i = 0; i < a3test_fileCount; ++i)
+		remove(path[i]);
+	printf("%u cases failed\n", failed);
+	return (int)failed;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -24,6 +24,8 @@
 
 #version 450
 
+#include "utilCommon_fs4x.glsl"
+
 layout (location = 0) out vec4 rtFragColor;
 
 void main()
@@ -0,0 +1,48 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	passParticle_transform_instanced_vs4x.glsl
+	Calculate final position of particle instance: each instance is one
+		texel of the particle texture (position and relative density),
+		too many for a uniform block.
+*/
+
+#version 450
+
+layout (location = 0) in vec4 aPosition;
+
+uniform mat4 uMVP;			// model-view-projection of fluid domain
+uniform double uSize;		// radius of particle
+uniform sampler2D uImage00;	// particle position (xyz) and density (w)
+
+flat out int vVertexID;
+flat out int vInstanceID;
+out float vDensity;
+
+void main()
+{
+	int width = textureSize(uImage00, 0).x;
+	vec4 particle = texelFetch(uImage00, ivec2(gl_InstanceID % width, gl_InstanceID / width), 0);
+	gl_Position = uMVP * vec4(aPosition.xyz * float(uSize) + particle.xyz, 1.0);
+
+	vVertexID = gl_VertexID;
+	vInstanceID = gl_InstanceID;
+	vDensity = particle.w;
+}
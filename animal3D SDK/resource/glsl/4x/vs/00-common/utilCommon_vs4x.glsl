@@ -22,3 +22,12 @@
 	Common utilities for vertex shaders.
 */
 
+// decode unit vector packed with octahedral mapping (see a3_GeometryQuantize)
+//	declare in the main shader before use: vec3 a3octDecode(in vec2 e);
+vec3 a3octDecode(in vec2 e)
+{
+	vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-v.z, 0.0);
+	v.xy += mix(vec2(t), vec2(-t), greaterThanEqual(v.xy, vec2(0.0)));
+	return normalize(v);
+}
@@ -27,6 +27,7 @@
 #include "animal3D-A3DG/a3graphics/a3_ShaderProgram.h"
 
 #include "animal3D/a3utility/a3_Stream.h"
+#include "animal3D/a3utility/a3_Thread.h"
 
 #include "GL/glew.h"
 
@@ -81,16 +82,70 @@ void a3shaderProgramInternalReleaseFunc(a3i32 count, a3ui32 *handlePtr)
 }
 
 
+// parallel compiling: -1 until checked, then 1 if supported
+static a3i32 a3shaderParallelCompile = -1;
+
+// check for parallel compiling once; let the driver use as many threads 
+//	as it likes
+static inline a3boolean a3shaderInternalParallelCompile()
+{
+	if (a3shaderParallelCompile < 0)
+	{
+#ifdef GL_KHR_parallel_shader_compile
+		a3shaderParallelCompile = GLEW_KHR_parallel_shader_compile ? 1 : 0;
+		if (a3shaderParallelCompile)
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+#else	// !GL_KHR_parallel_shader_compile
+		a3shaderParallelCompile = 0;
+#endif	// GL_KHR_parallel_shader_compile
+	}
+	return a3shaderParallelCompile;
+}
+
+// check if shader compile or program link is complete without waiting
+static inline a3boolean a3shaderInternalIsComplete(const a3boolean isProgram, const a3ui32 handle)
+{
+	a3i32 status = GL_TRUE;
+#ifdef GL_KHR_parallel_shader_compile
+	if (a3shaderInternalParallelCompile())
+	{
+		if (isProgram)
+			glGetProgramiv(handle, GL_COMPLETION_STATUS_KHR, &status);
+		else
+			glGetShaderiv(handle, GL_COMPLETION_STATUS_KHR, &status);
+	}
+#endif	// GL_KHR_parallel_shader_compile
+	return (status == GL_TRUE);
+}
+
+// wait for shader compile or program link, giving up the thread while the 
+//	driver works instead of blocking inside the status query
+static inline void a3shaderInternalWaitComplete(const a3boolean isProgram, const a3ui32 handle)
+{
+	while (!a3shaderInternalIsComplete(isProgram, handle))
+		a3threadYield();
+}
+
+
 //-----------------------------------------------------------------------------
 
 a3ret a3shaderCreateFromSourceList(a3_Shader *shader_out, const a3byte name_opt[32], const a3_ShaderType type, const a3byte **sourceList, const a3ui32 count)
+{
+	// submit and wait
+	a3i32 result = a3shaderCreateFromSourceListDeferred(shader_out, name_opt, type, sourceList, count);
+	if (result > 0)
+		result = a3shaderFinishCompile(shader_out);
+	return result;
+}
+
+a3ret a3shaderCreateFromSourceListDeferred(a3_Shader *shader_out, const a3byte name_opt[32], const a3_ShaderType type, const a3byte **sourceList, const a3ui32 count)
 {
 	static const a3ui16 internalShaderType[] = { GL_VERTEX_SHADER, GL_TESS_CONTROL_SHADER, GL_TESS_EVALUATION_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER, GL_COMPUTE_SHADER };
 
 	a3_Shader ret = { 0 };
 	a3ui32 handle;
 	a3ui32 newCount, i;
-	a3i32 status, result = 0;
+	a3i32 result = 0;
 	const a3byte **itr, **valid;
 
 	// validate params
@@ -115,35 +170,27 @@ a3ret a3shaderCreateFromSourceList(a3_Shader *shader_out, const a3byte name_opt[
 				// ALGORITHM: 
 				//	- create shader object on GPU
 				//	- send shader source to GPU
-				//	- compile source
-				//	- if compile succeeds, return shader handle
-				//	- else, print error message
+				//	- start compiling source
+				//	- return pending shader handle; status is checked when 
+				//		compile is finished
 
 				// generate handle
 				handle = glCreateShader(internalShaderType[type]);
 				if (handle)
 				{
-					// attach sources, compile
+					// attach sources, compile; with parallel compiling 
+					//	this returns before the compiler is done
+					a3shaderInternalParallelCompile();
 					glShaderSource(handle, newCount, valid, 0);
 					glCompileShader(handle);
-					glGetShaderiv(handle, GL_COMPILE_STATUS, &status);
-					if (status)
-					{
-						// finished
-						a3handleCreateHandle(ret.handle, a3shaderInternalReleaseFunc, name_opt, handle, 0);
-						ret.compiled = result = newCount;
-						ret.type = type;
-						*shader_out = ret;
-						a3shaderReference(shader_out);
-					}
-					else
-					{
-						// failed, get log
-						a3shaderInternalPrintLog(0, 0, handle, name_opt);
-
-						// reset shader and exit 
-						glDeleteShader(handle);
-					}
+
+					// pending
+					a3handleCreateHandle(ret.handle, a3shaderInternalReleaseFunc, name_opt, handle, 0);
+					ret.compiled = -(a3i16)newCount;
+					ret.type = type;
+					*shader_out = ret;
+					a3shaderReference(shader_out);
+					result = newCount;
 				}
 				else
 					printf("\n A3 ERROR (SHDR \'%s\'): \n\t Invalid handle; shader not created.", name_opt);
@@ -155,6 +202,42 @@ a3ret a3shaderCreateFromSourceList(a3_Shader *shader_out, const a3byte name_opt[
 	return -1;
 }
 
+a3ret a3shaderIsCompileDone(const a3_Shader *shader)
+{
+	if (shader && shader->handle->handle)
+		return (shader->compiled >= 0 || a3shaderInternalIsComplete(0, shader->handle->handle));
+	return -1;
+}
+
+a3ret a3shaderFinishCompile(a3_Shader *shader)
+{
+	a3ui32 handle;
+	a3i32 status;
+
+	if (shader && shader->handle->handle && shader->compiled < 0)
+	{
+		// waits if still compiling
+		handle = shader->handle->handle;
+		a3shaderInternalWaitComplete(0, handle);
+		glGetShaderiv(handle, GL_COMPILE_STATUS, &status);
+		if (status)
+		{
+			// finished
+			shader->compiled = -shader->compiled;
+			return shader->compiled;
+		}
+
+		// failed, get log
+		a3shaderInternalPrintLog(0, 0, handle, shader->handle->name);
+
+		// reset shader and exit 
+		a3handleRelease(shader->handle);
+		shader->compiled = shader->attached = 0;
+		return 0;
+	}
+	return -1;
+}
+
 
 //-----------------------------------------------------------------------------
 
@@ -212,7 +295,9 @@ a3ret a3shaderProgramAttachShader(a3_ShaderProgram *program, a3_Shader *shader)
 		sHandle = shader->handle->handle;
 		if (pHandle && sHandle)
 		{
-			// check if already linked
+			// check if already linked; pending link counts once finished
+			if (program->linked < 0)
+				a3shaderProgramFinishLink(program);
 			if (!program->linked)
 			{
 				// first check if shader of this type is already attached
@@ -249,6 +334,8 @@ a3ret a3shaderProgramDetachShaderType(a3_ShaderProgram *program, const a3_Shader
 		pHandle = program->handle->handle;
 		if (pHandle)
 		{
+			if (program->linked < 0)
+				a3shaderProgramFinishLink(program);
 			if (!program->linked)
 			{
 				shaderDetach = program->shadersAttached + type;
@@ -271,35 +358,37 @@ a3ret a3shaderProgramDetachShaderType(a3_ShaderProgram *program, const a3_Shader
 }
 
 a3ret a3shaderProgramLink(a3_ShaderProgram *program)
+{
+	// submit and wait
+	a3i32 result = a3shaderProgramLinkDeferred(program);
+	if (result > 0)
+		result = a3shaderProgramFinishLink(program);
+	return result;
+}
+
+a3ret a3shaderProgramLinkDeferred(a3_ShaderProgram *program)
 {
 	a3ui32 pHandle;
-	a3i32 status;
 
 	if (program)
 	{
 		pHandle = program->handle->handle;
 		if (pHandle)
 		{
-			// not already linked
+			// not already linked or linking
+			if (program->linked < 0)
+				a3shaderProgramFinishLink(program);
 			if (!program->linked)
 			{
 				// ALGORITHM: 
-				//	- link program (consolidate pipeline)
-				//	- if link succeeds, return some indication of success
-				//	- else, print error message
+				//	- start linking program (consolidate pipeline)
+				//	- mark as pending; status is checked when link is finished
 				//	***DO NOT DELETE PROGRAM!!! we may have a contingency plan!
 
+				a3shaderInternalParallelCompile();
 				glLinkProgram(pHandle);
-				glGetProgramiv(pHandle, GL_LINK_STATUS, &status);
-				if (status)
-				{
-					// good
-					program->linked = 1;
-					return 1;
-				}
-
-				// failed, get log
-				a3shaderInternalPrintLog(1, 1, pHandle, program->handle->name);
+				program->linked = -1;
+				return 1;
 			}
 			else
 				printf("\n A3 WARNING (PROG %u \'%s\'): \n\t Program already linked; program not re-linked.", pHandle, program->handle->name);
@@ -311,6 +400,39 @@ a3ret a3shaderProgramLink(a3_ShaderProgram *program)
 	return -1;
 }
 
+a3ret a3shaderProgramIsLinkDone(const a3_ShaderProgram *program)
+{
+	if (program && program->handle->handle)
+		return (program->linked >= 0 || a3shaderInternalIsComplete(1, program->handle->handle));
+	return -1;
+}
+
+a3ret a3shaderProgramFinishLink(a3_ShaderProgram *program)
+{
+	a3ui32 pHandle;
+	a3i32 status;
+
+	if (program && program->handle->handle && program->linked < 0)
+	{
+		// waits if still linking
+		pHandle = program->handle->handle;
+		a3shaderInternalWaitComplete(1, pHandle);
+		glGetProgramiv(pHandle, GL_LINK_STATUS, &status);
+		if (status)
+		{
+			// good
+			program->linked = 1;
+			return 1;
+		}
+
+		// failed, get log; program can be changed and linked again
+		a3shaderInternalPrintLog(1, 1, pHandle, program->handle->name);
+		program->linked = 0;
+		return 0;
+	}
+	return -1;
+}
+
 a3ret a3shaderProgramValidate(a3_ShaderProgram *program)
 {
 	a3ui32 pHandle;
@@ -321,6 +443,10 @@ a3ret a3shaderProgramValidate(a3_ShaderProgram *program)
 		pHandle = program->handle->handle;
 		if (pHandle)
 		{
+			// link must be finished first
+			if (program->linked < 0)
+				a3shaderProgramFinishLink(program);
+
 			// not already validated
 			if (!program->validated)
 			{
@@ -354,7 +480,7 @@ a3ret a3shaderProgramSaveBinary(const a3_ShaderProgram *program, const a3byte *f
 	a3ui32 pHandle;
 	a3ui32 *buff;
 
-	if (program && program->handle && program->linked)
+	if (program && program->handle && program->linked > 0)
 	{
 		pHandle = program->handle->handle;
 		if (pHandle)
@@ -396,7 +522,7 @@ a3ret a3shaderProgramLoadBinary(a3_ShaderProgram *program, const a3byte *filePat
 		if (pHandle)
 		{
 			// load file
-			result = a3streamLoadContents(fs, filePath);
+			result = a3streamMapContents(fs, filePath);
 			if (result > 0)
 			{
 				streamLen = fs->length;
@@ -25,6 +25,10 @@
 */
 
 #include "animal3D-A3DG/a3graphics/a3_Texture.h"
+#include "animal3D/a3utility/a3_Profiler.h"
+#include "animal3D/a3utility/a3_Stream.h"
+#include "animal3D/a3utility/a3_StreamQueue.h"
+#include "animal3D/a3utility/a3_Thread.h"
 
 #include "GL/glew.h"
 
@@ -52,6 +56,25 @@
 #endif	// _A3_UNICODE_UNDEF
 
 
+// image library lock for staged decoding
+#if (defined _WINDOWS || defined _WIN32)
+#include <Windows.h>
+static SRWLOCK a3textureStageLock = SRWLOCK_INIT;
+#define a3textureInternalStageLock()		AcquireSRWLockExclusive(&a3textureStageLock)
+#define a3textureInternalStageUnlock()		ReleaseSRWLockExclusive(&a3textureStageLock)
+#else	// !(defined _WINDOWS || defined _WIN32)
+#include <pthread.h>
+static pthread_mutex_t a3textureStageLock = PTHREAD_MUTEX_INITIALIZER;
+#define a3textureInternalStageLock()		pthread_mutex_lock(&a3textureStageLock)
+#define a3textureInternalStageUnlock()		pthread_mutex_unlock(&a3textureStageLock)
+#endif	// (defined _WINDOWS || defined _WIN32)
+
+
+// compressed texture cache; disabled while format is none
+static a3byte a3textureCompressCacheDir[256];
+static a3_TextureCompressFormat a3textureCompressCacheFormat;
+
+
 //-----------------------------------------------------------------------------
 
 // flip the data and store in dst
@@ -65,6 +88,150 @@ void a3textureInternalHandleReleaseFunc(a3i32 count, a3ui32 *handlePtr)
 }
 
 
+// look up file contents in compressed cache; hash is set whenever the 
+//	cache is enabled so that a miss can be stored after decoding
+static inline a3ret a3textureInternalCompressLookup(a3_TextureCompressed *compressed_out, a3ui64 *hash_out, const a3_Stream *fs)
+{
+	*hash_out = 0;
+	if (a3textureCompressCacheFormat && fs->contents)
+	{
+		*hash_out = a3textureCompressHash(fs->contents, fs->length);
+		return (a3textureCompressLoadCache(compressed_out, a3textureCompressCacheDir, *hash_out, a3textureCompressCacheFormat) > 0);
+	}
+	return 0;
+}
+
+// compress decoded rgba8 image and store it in cache
+static inline a3ret a3textureInternalCompressStore(a3_TextureCompressed *compressed_out, const a3ui64 hash, const a3ui32 width, const a3ui32 height, const void *data)
+{
+	if (a3textureCompressEncode(compressed_out, a3textureCompressCacheFormat, width, height, data, hash) > 0)
+	{
+		a3textureCompressSaveCache(compressed_out, a3textureCompressCacheDir);
+		return 1;
+	}
+	return 0;
+}
+
+
+// staged decode work shared by threads; files are read ahead by the 
+//	stream queue if there is one
+typedef struct a3_TextureStageJob
+{
+	a3_TextureStage *stageList;
+	const a3byte **filePathList;
+	a3_StreamQueue *queue;
+	a3_StreamRequest *requestList;
+	a3ui32 count;
+	volatile a3i32 next;
+} a3_TextureStageJob;
+
+// decode one staged image from file contents, then release contents
+static inline a3ret a3textureInternalStageDecode(a3_TextureStage *stage_out, const a3byte *filePath, a3_Stream *fs)
+{
+	a3_TextureStage ret = { 0 };
+	a3_TextureCompressed compressed[1] = { 0 };
+	a3_ProfileZone zone[1];
+	a3ui32 ilHandle, width, height, channels, bytes, size;
+	a3ui64 hash;
+	ret.filePath = filePath;
+
+	// file was read before locking so reads overlap other decodes
+	if (fs->contents)
+	{
+		// cached blocks need no decoding at all
+		if (a3textureInternalCompressLookup(compressed, &hash, fs))
+		{
+			ret.data = compressed->data;
+			ret.size = compressed->size;
+			ret.width = compressed->width;
+			ret.height = compressed->height;
+			ret.pixelType = a3tex_rgba8;
+			ret.compressFormat = compressed->format;
+			ret.result = 1;
+			a3streamReleaseContents(fs);
+			*stage_out = ret;
+			return ret.result;
+		}
+
+		a3textureInternalStageLock();
+		ilHandle = ilGenImage();
+		if (ilHandle)
+		{
+			ilBindImage(ilHandle);
+			a3profileZoneBegin(zone, "a3textureStageDecodeFileList: decode");
+			if (ilLoadL(ilTypeFromExt(filePath), fs->contents, fs->length))
+			{
+				width = ilGetInteger(IL_IMAGE_WIDTH);
+				height = ilGetInteger(IL_IMAGE_HEIGHT);
+				channels = ilGetInteger(IL_IMAGE_CHANNELS);
+				bytes = channels ? ilGetInteger(IL_IMAGE_BYTES_PER_PIXEL) / channels : 0;
+				if (width && height && channels && bytes)
+				{
+					// same formats as loading directly; 8-bit images 
+					//	to be compressed need alpha
+					channels = channels >= 3 ? channels <= 4 ? channels : 4 : 3;
+					bytes = bytes >= 1 ? bytes <= 2 ? bytes : 2 : 1;
+					channels = hash && bytes == 1 ? 4 : channels;
+					ilConvertImage(channels == 3 ? IL_RGB : IL_RGBA, bytes == 1 ? IL_UNSIGNED_BYTE : IL_UNSIGNED_SHORT);
+
+					// copy out of image library
+					size = width * height * channels * bytes;
+					ret.data = malloc(size);
+					if (ret.data)
+					{
+						memcpy(ret.data, ilGetData(), size);
+						ret.size = size;
+						ret.width = width;
+						ret.height = height;
+						ret.pixelType = channels == 3 ? bytes == 1 ? a3tex_rgb8 : a3tex_rgb16 : bytes == 1 ? a3tex_rgba8 : a3tex_rgba16;
+						ret.result = 1;
+					}
+				}
+			}
+			a3profileZoneEnd(zone);
+			ilDeleteImage(ilHandle);
+		}
+		a3textureInternalStageUnlock();
+		a3streamReleaseContents(fs);
+
+		// compress outside of lock so encoding overlaps other decodes
+		if (ret.result && hash && ret.pixelType == a3tex_rgba8 && a3textureInternalCompressStore(compressed, hash, ret.width, ret.height, ret.data))
+		{
+			free(ret.data);
+			ret.data = compressed->data;
+			ret.size = compressed->size;
+			ret.compressFormat = compressed->format;
+		}
+	}
+	*stage_out = ret;
+	return ret.result;
+}
+
+// decode thread: take next file until none are left
+a3ret a3textureInternalStageThread(a3_TextureStageJob *job)
+{
+	const a3_Stream reset = { 0 };
+	a3_Stream fs[1];
+	a3i32 i, count = 0;
+	while ((i = a3atomicIncrement(&job->next) - 1) < (a3i32)job->count)
+	{
+		// take contents from queue, or read them here
+		if (job->requestList)
+		{
+			a3streamQueueWait(job->queue, job->requestList + i);
+			*fs = *job->requestList[i].stream;
+		}
+		else
+		{
+			*fs = reset;
+			a3streamLoadContents(fs, job->filePathList[i], 0);
+		}
+		count += a3textureInternalStageDecode(job->stageList + i, job->filePathList[i], fs);
+	}
+	return count;
+}
+
+
 //-----------------------------------------------------------------------------
 
 a3ret a3textureCreatePixelFormatDescriptor(a3_TexturePixelFormatDescriptor *pixelFormat_out, const a3_TexturePixelType pixelType)
@@ -88,6 +255,7 @@ a3ret a3textureCreatePixelFormatDescriptor(a3_TexturePixelFormatDescriptor *pixe
 		{ GL_DEPTH_COMPONENT,	GL_DEPTH_COMPONENT24,	GL_UNSIGNED_INT,	1, 4 },
 		{ GL_DEPTH_COMPONENT,	GL_DEPTH_COMPONENT32,	GL_UNSIGNED_INT,	1, 4 },
 		{ GL_DEPTH_STENCIL,		GL_DEPTH24_STENCIL8,	GL_UNSIGNED_INT_24_8,	1, 4 },
+		{ GL_RGBA,	GL_RGBA16F,	GL_HALF_FLOAT,		4, 2 },
 	};
 
 	if (pixelFormat_out)
@@ -119,6 +287,20 @@ a3ret a3textureInitializeImageLibrary()
 	return 0;
 }
 
+a3ret a3textureSetCompressCache(const a3byte *cacheDir_opt, const a3_TextureCompressFormat format)
+{
+	if (cacheDir_opt && *cacheDir_opt && format > a3tex_compressNone && format <= a3tex_compressBC7 && strlen(cacheDir_opt) < sizeof(a3textureCompressCacheDir))
+	{
+		strcpy(a3textureCompressCacheDir, cacheDir_opt);
+		a3fileStreamMakeDirectory(a3textureCompressCacheDir);
+		a3textureCompressCacheFormat = format;
+		return 1;
+	}
+	*a3textureCompressCacheDir = 0;
+	a3textureCompressCacheFormat = a3tex_compressNone;
+	return 0;
+}
+
 a3ret a3textureCreateFromFile(a3_Texture *texture_out, const a3byte name_opt[32], const a3byte *filePath)
 {
 	a3_Texture ret = { 0 };
@@ -134,13 +316,32 @@ a3ret a3textureCreateFromFile(a3_Texture *texture_out, const a3byte name_opt[32]
 			a3ui32 glHandle = 0;
 			a3ui32 ilHandle = 0;
 			a3ui32 width, height, channels, bytes;
+			a3_ProfileZone zone[1];
+			a3_TextureCompressed compressed[1] = { 0 };
+			a3_Stream fs[1] = { 0 };
+			a3ui64 hash = 0;
+
+			// compressed cache: skip decoding if file was seen before
+			if (a3textureCompressCacheFormat && a3streamMapContents(fs, filePath) > 0)
+			{
+				result = a3textureInternalCompressLookup(compressed, &hash, fs);
+				a3streamReleaseContents(fs);
+				if (result)
+				{
+					result = a3textureCreateFromCompressed(texture_out, name_opt, compressed);
+					a3textureCompressRelease(compressed);
+					return result;
+				}
+			}
 
 			// generate IL handle
 			ilHandle = ilGenImage();
 			if (ilHandle)
 			{
 				ilBindImage(ilHandle);
+				a3profileZoneBegin(zone, "a3textureCreateFromFile: decode");
 				result = ilLoadImage(filePath);
+				a3profileZoneEnd(zone);
 				if (result)
 				{
 					result = 0;
@@ -155,6 +356,7 @@ a3ret a3textureCreateFromFile(a3_Texture *texture_out, const a3byte name_opt[32]
 						//	rgb8, rgb16, rgba8 or rgba16
 						channels = channels >= 3 ? channels <= 4 ? channels : 4 : 3;
 						bytes = bytes >= 1 ? bytes <= 2 ? bytes : 2 : 1;
+						channels = hash && bytes == 1 ? 4 : channels;
 
 						// select descriptors and convert image
 						if (channels == 3)
@@ -165,12 +367,22 @@ a3ret a3textureCreateFromFile(a3_Texture *texture_out, const a3byte name_opt[32]
 						convertType = bytes == 1 ? IL_UNSIGNED_BYTE : IL_UNSIGNED_SHORT;
 						ilConvertImage(convertFormat, convertType);
 
+						// compress and store in cache, or upload as-is
+						if (hash && bytes == 1 && a3textureInternalCompressStore(compressed, hash, width, height, ilGetData()))
+						{
+							result = a3textureCreateFromCompressed(texture_out, name_opt, compressed);
+							a3textureCompressRelease(compressed);
+						}
+						else
+							glGenTextures(1, &glHandle);
+
 						// create GL texture with default settings
-						glGenTextures(1, &glHandle);
 						if (glHandle)
 						{
+							a3profileZoneBegin(zone, "a3textureCreateFromFile: upload");
 							glBindTexture(GL_TEXTURE_2D, glHandle);
 							glTexImage2D(GL_TEXTURE_2D, 0, textureFormat, width, height, 0, textureFormatInternal, convertType, ilGetData());
+							a3profileZoneEnd(zone);
 							a3textureDefaultSettings();
 							glBindTexture(GL_TEXTURE_2D, 0);
 
@@ -202,6 +414,150 @@ a3ret a3textureCreateFromFile(a3_Texture *texture_out, const a3byte name_opt[32]
 	return -1;
 }
 
+a3ret a3textureStageDecodeFileList(a3_TextureStage *stageList_out, const a3byte **filePathList, const a3ui32 count, const a3ui32 threadCount)
+{
+	a3_Thread thread[a3tex_stageThreadMax - 1] = { 0 };
+	a3_TextureStageJob job[1] = { 0 };
+	a3_StreamQueue queue[1] = { 0 };
+	a3ui32 i, n, decoded;
+	if (stageList_out && filePathList && count)
+	{
+		a3textureInitializeImageLibrary();
+		job->stageList = stageList_out;
+		job->filePathList = filePathList;
+		job->count = count;
+
+		// queue every read up front so the I/O thread stays ahead of the 
+		//	decoders; without a queue, decoders read their own files
+		job->requestList = (a3_StreamRequest *)calloc(count, sizeof(a3_StreamRequest));
+		if (job->requestList && a3streamQueueCreate(queue) > 0)
+		{
+			job->queue = queue;
+			for (i = 0; i < count; ++i)
+				a3streamQueueReadContents(queue, job->requestList + i, filePathList[i], 0, 0);
+		}
+		else
+		{
+			free(job->requestList);
+			job->requestList = 0;
+		}
+
+		// no point in more threads than files; caller is one of them
+		n = threadCount < count ? threadCount : count;
+		n = n > 1 ? n <= a3tex_stageThreadMax ? n : a3tex_stageThreadMax : 1;
+		for (i = 0; i < n - 1; ++i)
+			a3threadLaunch(thread + i, (a3_threadfunc)a3textureInternalStageThread, job, "animal3D texture decode");
+		a3textureInternalStageThread(job);
+		for (i = 0; i < n - 1; ++i)
+			a3threadWait(thread + i);
+		if (job->requestList)
+		{
+			a3streamQueueRelease(queue);
+			free(job->requestList);
+		}
+
+		// count results
+		for (i = decoded = 0; i < count; ++i)
+			decoded += stageList_out[i].result;
+		return decoded;
+	}
+	return -1;
+}
+
+a3ret a3textureCreateFromStage(a3_Texture *texture_out, const a3byte name_opt[32], const a3_TextureStage *stage)
+{
+	a3_TexturePixelFormatDescriptor pixelFormat[1];
+	a3ret result;
+	a3_ProfileZone zone[1];
+	if (texture_out && stage)
+	{
+		if (!texture_out->handle->handle)
+		{
+			if (stage->result && stage->data && stage->compressFormat)
+			{
+				// upload compressed blocks directly
+				const a3_TextureCompressed compressed = { stage->data, stage->size, stage->width, stage->height, stage->compressFormat, 0 };
+				a3profileZoneBegin(zone, "a3textureCreateFromStage: upload");
+				result = a3textureCreateFromCompressed(texture_out, name_opt, &compressed);
+				a3profileZoneEnd(zone);
+				return result;
+			}
+			else if (stage->result && stage->data)
+			{
+				// allocate, then upload staged data
+				a3textureCreatePixelFormatDescriptor(pixelFormat, stage->pixelType);
+				result = a3textureCreateFromData(texture_out, name_opt, pixelFormat, stage->width, stage->height, 0, 0);
+				if (result > 0)
+				{
+					a3profileZoneBegin(zone, "a3textureCreateFromStage: upload");
+					result = a3textureReplaceData(texture_out, 0, 0, stage->width, stage->height, stage->data, 0);
+					a3profileZoneEnd(zone);
+				}
+				return result;
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+a3ret a3textureCreateFromCompressed(a3_Texture *texture_out, const a3byte name_opt[32], const a3_TextureCompressed *compressed)
+{
+	static const a3ui16 compressFormat[] = { 0, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_COMPRESSED_RG_RGTC2, GL_COMPRESSED_RGBA_BPTC_UNORM, };
+	a3_Texture ret = { 0 };
+	a3ui32 handle;
+	if (texture_out && compressed && compressed->data && compressed->format > a3tex_compressNone && compressed->format <= a3tex_compressBC7)
+	{
+		if (!texture_out->handle->handle)
+		{
+			glGenTextures(1, &handle);
+			if (handle)
+			{
+				// bind texture and fill with blocks
+				glBindTexture(GL_TEXTURE_2D, handle);
+				glCompressedTexImage2D(GL_TEXTURE_2D, 0, compressFormat[compressed->format], compressed->width, compressed->height, 0, compressed->size, compressed->data);
+				a3textureDefaultSettings();
+				glBindTexture(GL_TEXTURE_2D, 0);
+
+				// done, configure output
+				a3handleCreateHandle(ret.handle, a3textureInternalHandleReleaseFunc, name_opt, handle, 1);
+				ret.width = compressed->width;
+				ret.height = compressed->height;
+				ret.channels = compressed->format == a3tex_compressBC5 ? 2 : 4;
+				ret.bytes = 1;
+				ret.internalFormat = compressed->format == a3tex_compressBC5 ? GL_RG : GL_RGBA;
+				ret.internalType = GL_UNSIGNED_BYTE;
+
+				// set output
+				*texture_out = ret;
+				a3textureReference(texture_out);
+				return 1;
+			}
+			else
+				printf("\n A3 ERROR (TEX \'%s\'): \n\t Invalid handle; texture not created.", name_opt);
+			return 0;
+		}
+	}
+	return -1;
+}
+
+a3ret a3textureStageRelease(a3_TextureStage *stage)
+{
+	const a3_TextureStage reset = { 0 };
+	if (stage)
+	{
+		if (stage->data)
+		{
+			free(stage->data);
+			*stage = reset;
+			return 1;
+		}
+		*stage = reset;
+		return 0;
+	}
+	return -1;
+}
+
 a3ret a3textureCreateFromData(a3_Texture *texture_out, const a3byte name_opt[32], const a3_TexturePixelFormatDescriptor *pixelFormat, const a3ui32 width, const a3ui32 height, const void *data_opt, a3boolean dataFlipped)
 {
 	a3_Texture ret = { 0 };
@@ -310,6 +666,38 @@ a3ret a3textureReplaceData(const a3_Texture *texture, const a3ui32 offsetWidth,
 	return -1;
 }
 
+a3ret a3textureReplaceDataLevel(const a3_Texture *texture, const a3ui32 level, const void *data_opt)
+{
+	if (texture)
+	{
+		if (texture->handle->handle)
+		{
+			const a3ui32 width = texture->width >> level, height = texture->height >> level;
+			a3i32 internalFormatBits;
+			if (!level)
+				return a3textureReplaceData(texture, 0, 0, texture->width, texture->height, data_opt, 0);
+			if (width || height)
+			{
+				// allocate level in the same format as the base image
+				glBindTexture(GL_TEXTURE_2D, texture->handle->handle);
+				glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormatBits);
+				glTexImage2D(GL_TEXTURE_2D, level, internalFormatBits, width ? width : 1, height ? height : 1, 0, texture->internalFormat, texture->internalType, data_opt);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level);
+				glBindTexture(GL_TEXTURE_2D, 0);
+
+				// done
+				return 1;
+			}
+			else
+				printf("\n A3 ERROR (TEX %u \'%s\'): \n\t Invalid level for replacing texture data.", texture->handle->handle, texture->handle->name);
+
+			// fail
+			return 0;
+		}
+	}
+	return -1;
+}
+
 a3ret a3textureActivate(const a3_Texture *texture, const a3_TextureUnit unit)
 {
 	// switch unit
@@ -348,10 +736,10 @@ a3ret a3textureDefaultSettings()
 
 a3ret a3textureChangeFilterMode(const a3_TextureFilterOption filterOption)
 {
-	static const a3ui16 filter[] = { GL_NEAREST, GL_LINEAR, };
-	const a3ui16 option = filter[filterOption];
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, option);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, option);
+	static const a3ui16 filterMag[] = { GL_NEAREST, GL_LINEAR, GL_LINEAR, };
+	static const a3ui16 filterMin[] = { GL_NEAREST, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, };
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filterMag[filterOption]);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filterMin[filterOption]);
 	return 1;
 }
 
@@ -40,7 +40,7 @@
 // get attribute internal types
 a3ui16 a3vertexInternalGetType(const a3_VertexAttributeType type)
 {
-	static const a3ui16 internalType[] = { 0, GL_INT, GL_INT, GL_INT, GL_INT, GL_FLOAT, GL_FLOAT, GL_FLOAT, GL_FLOAT, GL_DOUBLE, GL_DOUBLE, GL_DOUBLE, GL_DOUBLE };
+	static const a3ui16 internalType[] = { 0, GL_INT, GL_INT, GL_INT, GL_INT, GL_FLOAT, GL_FLOAT, GL_FLOAT, GL_FLOAT, GL_DOUBLE, GL_DOUBLE, GL_DOUBLE, GL_DOUBLE, GL_HALF_FLOAT, GL_SHORT, GL_UNSIGNED_SHORT, GL_UNSIGNED_BYTE };
 	return internalType[type];
 }
 
@@ -111,6 +111,33 @@ a3ret a3vertexArrayCreateDescriptor(a3_VertexArrayDescriptor *vertexArray_out, c
 								)
 							);
 							break;
+						case GL_HALF_FLOAT:
+							glEnableVertexAttribArray(i);
+							glVertexAttribPointer(i,
+								vertexFormat->attribElements[i],
+								GL_HALF_FLOAT,
+								GL_FALSE,
+								vertexFormat->vertexSize,
+								A3_BUFFER_OFFSET(
+									vertexFormat->attribOffset[i] + vertexBufferOffset
+								)
+							);
+							break;
+						case GL_SHORT:
+						case GL_UNSIGNED_SHORT:
+						case GL_UNSIGNED_BYTE:
+							// packed: normalized to [-1, 1] or [0, 1]
+							glEnableVertexAttribArray(i);
+							glVertexAttribPointer(i,
+								vertexFormat->attribElements[i],
+								vertexFormat->attribType[i],
+								GL_TRUE,
+								vertexFormat->vertexSize,
+								A3_BUFFER_OFFSET(
+									vertexFormat->attribOffset[i] + vertexBufferOffset
+								)
+							);
+							break;
 						case GL_INT:
 							glEnableVertexAttribArray(i);
 							glVertexAttribIPointer(i,
@@ -0,0 +1,675 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_ShaderInclude.c
+	Shader include expansion and source file dependency tracking.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "animal3D-A3DG/a3graphics/a3_ShaderInclude.h"
+#include "animal3D/a3utility/a3_Thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// state of one expansion
+typedef struct a3_ShaderIncludeState
+{
+	a3byte *text;
+	a3ui32 length, capacity;
+	a3byte expanded[a3shader_includeFileMax][a3shader_includePathMax];
+	a3ui32 expandedCount;
+	a3ui32 sourceIndex;
+	a3_ShaderIncludeGraph *graph;
+} a3_ShaderIncludeState;
+
+
+// modification time of file, 0 if it does not exist
+#if (defined _WINDOWS || defined _WIN32)
+inline a3i64 a3shaderIncludeInternalFileTime(const a3byte *filePath)
+{
+	struct _stat64 info;
+	if (_stat64(filePath, &info) == 0)
+		return (a3i64)info.st_mtime;
+	return 0;
+}
+#else	// !(defined _WINDOWS || defined _WIN32)
+inline a3i64 a3shaderIncludeInternalFileTime(const a3byte *filePath)
+{
+	struct stat info;
+	if (stat(filePath, &info) == 0)
+		return (a3i64)info.st_mtim.tv_sec * 1000000000 + (a3i64)info.st_mtim.tv_nsec;
+	return 0;
+}
+#endif	// (defined _WINDOWS || defined _WIN32)
+
+
+// make room for one more element in a growing array
+inline a3i32 a3shaderIncludeInternalReserve(void **data, a3ui32 *capacity, const a3ui32 count, const a3ui32 elementSize)
+{
+	void *resized;
+	a3ui32 newCapacity;
+	if (count < *capacity)
+		return 1;
+	newCapacity = *capacity ? *capacity * 2 : 16;
+	resized = realloc(*data, (size_t)newCapacity * elementSize);
+	if (resized)
+	{
+		*data = resized;
+		*capacity = newCapacity;
+		return 1;
+	}
+	return 0;
+}
+
+
+// clean up path in place: forward slashes only, no '.' or 'dir/..' parts
+void a3shaderIncludeInternalNormalizePath(a3byte *path)
+{
+	a3byte *src, *dst, *seg, *root, *prev;
+	a3ui32 segStart[a3shader_includePathMax / 2];
+	a3ui32 segCount = 0, len;
+
+	for (src = path; *src; ++src)
+		if (*src == '\\')
+			*src = '/';
+
+	// keep root
+	src = dst = path;
+	if (*src == '/')
+		++src, ++dst;
+	root = dst;
+
+	while (*src)
+	{
+		// measure segment
+		for (seg = src, len = 0; seg[len] && seg[len] != '/'; ++len);
+		src = seg + len + (seg[len] == '/');
+		if (len == 0 || (len == 1 && seg[0] == '.'))
+			continue;
+
+		// step out of previous segment unless it also steps out
+		if (len == 2 && seg[0] == '.' && seg[1] == '.' && segCount)
+		{
+			prev = path + segStart[segCount - 1];
+			if (dst - prev != 2 || prev[0] != '.' || prev[1] != '.')
+			{
+				dst = prev - (prev > root);
+				--segCount;
+				continue;
+			}
+		}
+
+		// keep segment; output never passes input, so copy in place
+		if (dst > root)
+			*(dst++) = '/';
+		segStart[segCount++] = (a3ui32)(dst - path);
+		memmove(dst, seg, len);
+		dst += len;
+	}
+	*dst = 0;
+}
+
+
+// path of included file relative to including file
+a3i32 a3shaderIncludeInternalJoinPath(a3byte *path_out, const a3byte *includerPath, const a3byte *name, const a3ui32 nameLength)
+{
+	const a3byte *slash = strrchr(includerPath, '/');
+	const a3ui32 dirLength = (nameLength && (name[0] == '/' || name[0] == '\\' || (nameLength > 1 && name[1] == ':'))) ? 0
+		: slash ? (a3ui32)(slash - includerPath + 1) : 0;
+	if (dirLength + nameLength < a3shader_includePathMax)
+	{
+		memcpy(path_out, includerPath, dirLength);
+		memcpy(path_out + dirLength, name, nameLength);
+		path_out[dirLength + nameLength] = 0;
+		a3shaderIncludeInternalNormalizePath(path_out);
+		return 1;
+	}
+	return 0;
+}
+
+
+// find file in graph or add it; time is updated if the file is being read
+a3i32 a3shaderIncludeInternalRecordFile(a3_ShaderIncludeGraph *graph, const a3byte *filePath, const a3boolean read)
+{
+	a3ui32 i;
+	for (i = 0; i < graph->fileCount; ++i)
+		if (!strcmp(graph->filePath[i], filePath))
+		{
+			if (read)
+				graph->fileTime[i] = a3shaderIncludeInternalFileTime(filePath);
+			return i;
+		}
+
+	// new file: both arrays grow together
+	if (graph->fileCount == graph->fileCapacity)
+	{
+		a3ui32 capacity = graph->fileCapacity;
+		if (!a3shaderIncludeInternalReserve((void **)&graph->filePath, &capacity, graph->fileCount, a3shader_includePathMax))
+			return -1;
+		capacity = graph->fileCapacity;
+		if (!a3shaderIncludeInternalReserve((void **)&graph->fileTime, &capacity, graph->fileCount, sizeof(a3i64)))
+			return -1;
+		graph->fileCapacity = capacity;
+	}
+	strcpy(graph->filePath[i], filePath);
+	graph->fileTime[i] = a3shaderIncludeInternalFileTime(filePath);
+	return graph->fileCount++;
+}
+
+
+// add edge if not already present
+a3i32 a3shaderIncludeInternalAddEdge(a3ui32(**edge)[2], a3ui32 *count, a3ui32 *capacity, const a3ui32 from, const a3ui32 to)
+{
+	a3ui32 i;
+	for (i = 0; i < *count; ++i)
+		if ((*edge)[i][0] == from && (*edge)[i][1] == to)
+			return 1;
+	if (a3shaderIncludeInternalReserve((void **)edge, capacity, *count, sizeof(**edge)))
+	{
+		(*edge)[*count][0] = from;
+		(*edge)[*count][1] = to;
+		++(*count);
+		return 1;
+	}
+	return 0;
+}
+
+
+// remove all edges starting at node
+a3ui32 a3shaderIncludeInternalRemoveEdges(a3ui32(*edge)[2], a3ui32 *count, const a3ui32 from)
+{
+	a3ui32 i, j;
+	for (i = j = 0; i < *count; ++i)
+		if (edge[i][0] != from)
+		{
+			edge[j][0] = edge[i][0];
+			edge[j][1] = edge[i][1];
+			++j;
+		}
+	i = *count - j;
+	*count = j;
+	return i;
+}
+
+
+// append text to expansion
+a3i32 a3shaderIncludeInternalEmit(a3_ShaderIncludeState *state, const a3byte *text, const a3ui32 length)
+{
+	if (state->length + length + 1 > state->capacity)
+	{
+		a3ui32 capacity = state->capacity ? state->capacity : 4096;
+		a3byte *resized;
+		while (state->length + length + 1 > capacity)
+			capacity *= 2;
+		resized = (a3byte *)realloc(state->text, capacity);
+		if (!resized)
+			return 0;
+		state->text = resized;
+		state->capacity = capacity;
+	}
+	memcpy(state->text + state->length, text, length);
+	state->length += length;
+	return 1;
+}
+
+
+// check if text starts with directive
+inline a3boolean a3shaderIncludeInternalIsDirective(const a3byte *text, const a3byte *end, const a3byte *directive)
+{
+	const a3ui32 len = (a3ui32)strlen(directive);
+	return ((a3ui32)(end - text) > len && !strncmp(text, directive, len) &&
+		(text[len] == ' ' || text[len] == '\t' || text[len] == '"'));
+}
+
+
+// track block comments through line; returns whether line ends inside one
+inline a3boolean a3shaderIncludeInternalScanComment(const a3byte *text, const a3byte *end, a3boolean comment)
+{
+	for (; text + 1 < end; ++text)
+		if (comment && text[0] == '*' && text[1] == '/')
+			comment = 0, ++text;
+		else if (!comment && text[0] == '/' && text[1] == '/')
+			break;
+		else if (!comment && text[0] == '/' && text[1] == '*')
+			comment = 1, ++text;
+	return comment;
+}
+
+
+// expand file into state; returns 1 if file and all includes were read
+a3i32 a3shaderIncludeInternalExpand(a3_ShaderIncludeState *state, const a3byte *filePath, const a3ui32 depth)
+{
+	a3_Stream fs[1] = { 0 };
+	a3_ShaderIncludeGraph *const graph = state->graph;
+	const a3byte *line, *next, *end, *name, *nameEnd;
+	a3byte includePath[a3shader_includePathMax], directive[48];
+	a3ui32 lineNumber, i;
+	a3i32 fileIndex = -1, includeIndex, result = 1;
+	a3boolean included, comment = 0, commented;
+
+	// mark as expanded before reading so cycles stop here
+	strcpy(state->expanded[state->expandedCount++], filePath);
+
+	// record file and forget its old includes, they are about to be read again
+	if (graph)
+	{
+		fileIndex = a3shaderIncludeInternalRecordFile(graph, filePath, 1);
+		if (fileIndex >= 0)
+			a3shaderIncludeInternalRemoveEdges(graph->includeEdge, &graph->includeCount, fileIndex);
+	}
+
+	if (a3streamMapContents(fs, filePath) <= 0)
+	{
+		printf("\n A3 ERROR: Could not read shader source \'%s\'.", filePath);
+		return 0;
+	}
+
+	for (line = fs->contents, end = line + fs->length, lineNumber = 1;
+		line < end; line = next, ++lineNumber)
+	{
+		// line includes its terminator
+		for (next = line; next < end && *next != '\n'; ++next);
+		next += (next < end);
+		for (name = line; name < next && (*name == ' ' || *name == '\t'); ++name);
+
+		// directives inside block comments are text
+		commented = comment;
+		comment = a3shaderIncludeInternalScanComment(line, next, comment);
+		if (!commented && a3shaderIncludeInternalIsDirective(name, next, "#include"))
+		{
+			// quoted path
+			for (name += 8; name < next && *name != '"'; ++name);
+			for (nameEnd = name + (name < next); nameEnd < next && *nameEnd != '"'; ++nameEnd);
+			if (name >= next || nameEnd >= next || !a3shaderIncludeInternalJoinPath(includePath, filePath, name + 1, (a3ui32)(nameEnd - name - 1)))
+			{
+				printf("\n A3 ERROR: Malformed include in \'%s\' line %u.", filePath, lineNumber);
+				result = 0;
+				continue;
+			}
+
+			// record edge even if file is missing, so creating it triggers a rebuild
+			if (graph && fileIndex >= 0)
+			{
+				includeIndex = a3shaderIncludeInternalRecordFile(graph, includePath, 0);
+				if (includeIndex >= 0)
+					a3shaderIncludeInternalAddEdge(&graph->includeEdge, &graph->includeCount, &graph->includeCapacity, fileIndex, includeIndex);
+			}
+
+			for (i = 0, included = 0; i < state->expandedCount && !included; ++i)
+				included = !strcmp(state->expanded[i], includePath);
+			if (included)
+				result *= a3shaderIncludeInternalEmit(state, "\n", 1);
+			else if (depth + 1 >= a3shader_includeDepthMax || state->expandedCount >= a3shader_includeFileMax)
+			{
+				printf("\n A3 ERROR: Too many includes expanding \'%s\'.", includePath);
+				result = 0;
+			}
+			else
+			{
+				// source string number must be the one the compiler sees
+				sprintf(directive, "#line 1 %u\n", state->sourceIndex);
+				result *= a3shaderIncludeInternalEmit(state, directive, (a3ui32)strlen(directive));
+				result *= a3shaderIncludeInternalExpand(state, includePath, depth + 1);
+				sprintf(directive, "\n#line %u %u\n", lineNumber + 1, state->sourceIndex);
+				result *= a3shaderIncludeInternalEmit(state, directive, (a3ui32)strlen(directive));
+			}
+		}
+		else if (depth && !commented && a3shaderIncludeInternalIsDirective(name, next, "#version"))
+		{
+			// only the root file may declare a version
+			result *= a3shaderIncludeInternalEmit(state, "//", 2);
+			result *= a3shaderIncludeInternalEmit(state, line, (a3ui32)(next - line));
+		}
+		else
+			result *= a3shaderIncludeInternalEmit(state, line, (a3ui32)(next - line));
+	}
+
+	a3streamReleaseContents(fs);
+	return result;
+}
+
+
+// record dependencies of a source read on its own under target
+void a3shaderIncludeInternalMerge(a3_ShaderIncludeGraph *graph, const a3_ShaderIncludeGraph *source, const a3ui32 target)
+{
+	a3i32 *fileIndex = (a3i32 *)malloc(source->fileCount * sizeof(a3i32) + 1);
+	a3ui32 i;
+	if (!fileIndex)
+		return;
+
+	// files keep the time they were read at; their includes are replaced
+	for (i = 0; i < source->fileCount; ++i)
+	{
+		fileIndex[i] = a3shaderIncludeInternalRecordFile(graph, source->filePath[i], 0);
+		if (fileIndex[i] >= 0)
+		{
+			graph->fileTime[fileIndex[i]] = source->fileTime[i];
+			a3shaderIncludeInternalRemoveEdges(graph->includeEdge, &graph->includeCount, fileIndex[i]);
+		}
+	}
+	for (i = 0; i < source->includeCount; ++i)
+		if (fileIndex[source->includeEdge[i][0]] >= 0 && fileIndex[source->includeEdge[i][1]] >= 0)
+			a3shaderIncludeInternalAddEdge(&graph->includeEdge, &graph->includeCount, &graph->includeCapacity,
+				fileIndex[source->includeEdge[i][0]], fileIndex[source->includeEdge[i][1]]);
+	for (i = 0; i < source->targetEdgeCount; ++i)
+		if (fileIndex[source->targetEdge[i][1]] >= 0)
+			a3shaderIncludeInternalAddEdge(&graph->targetEdge, &graph->targetEdgeCount, &graph->targetEdgeCapacity,
+				target, fileIndex[source->targetEdge[i][1]]);
+	free(fileIndex);
+}
+
+
+// batch worker: claim and expand stages until none are left
+a3ret a3shaderIncludeInternalBatchThread(a3_ShaderIncludeBatch *batch)
+{
+	a3_ShaderIncludeStage *stage;
+	a3i32 i, count = 0;
+	while ((i = a3atomicIncrement(&batch->next) - 1) < (a3i32)batch->count)
+	{
+		stage = batch->stageList + i;
+		stage->result = a3shaderIncludeResolve(stage->source, stage->filePath, stage->sourceIndex, stage->graph->targetCount ? stage->graph : 0, 0);
+		stage->result = stage->result > 0 ? stage->result : 0;
+		count += (stage->result > 0);
+
+		// raise flag last, atomically, so result and source are visible
+		a3atomicIncrement(&stage->done);
+	}
+	return count;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3shaderIncludeGraphCreate(a3_ShaderIncludeGraph *graph_out, const a3ui32 targetCount)
+{
+	a3_ShaderIncludeGraph ret = { 0 };
+	if (graph_out && targetCount)
+	{
+		if (!graph_out->targetCount)
+		{
+			ret.targetCount = targetCount;
+			*graph_out = ret;
+			return targetCount;
+		}
+	}
+	return -1;
+}
+
+
+a3ret a3shaderIncludeGraphClearTarget(a3_ShaderIncludeGraph *graph, const a3ui32 target)
+{
+	if (graph && target < graph->targetCount)
+		return a3shaderIncludeInternalRemoveEdges(graph->targetEdge, &graph->targetEdgeCount, target);
+	return -1;
+}
+
+
+a3ret a3shaderIncludeGraphPoll(a3_ShaderIncludeGraph *graph, a3boolean *targetChanged_out)
+{
+	a3boolean *changed, propagate;
+	a3i64 fileTime;
+	a3ui32 i, count = 0;
+
+	if (graph && graph->targetCount && targetChanged_out)
+	{
+		memset(targetChanged_out, 0, graph->targetCount * sizeof(a3boolean));
+		if (!graph->fileCount)
+			return 0;
+		changed = (a3boolean *)calloc(graph->fileCount, sizeof(a3boolean));
+		if (!changed)
+			return 0;
+
+		// files modified since last read
+		for (i = propagate = 0; i < graph->fileCount; ++i)
+		{
+			fileTime = a3shaderIncludeInternalFileTime(graph->filePath[i]);
+			if (fileTime != graph->fileTime[i])
+			{
+				graph->fileTime[i] = fileTime;
+				changed[i] = propagate = 1;
+			}
+		}
+
+		// includers of changed files are changed too
+		while (propagate)
+			for (i = propagate = 0; i < graph->includeCount; ++i)
+				if (changed[graph->includeEdge[i][1]] && !changed[graph->includeEdge[i][0]])
+					changed[graph->includeEdge[i][0]] = propagate = 1;
+
+		// targets built from changed files
+		for (i = 0; i < graph->targetEdgeCount; ++i)
+			if (changed[graph->targetEdge[i][1]] && !targetChanged_out[graph->targetEdge[i][0]])
+			{
+				targetChanged_out[graph->targetEdge[i][0]] = 1;
+				++count;
+			}
+
+		free(changed);
+		return count;
+	}
+	return -1;
+}
+
+
+a3ret a3shaderIncludeGraphRelease(a3_ShaderIncludeGraph *graph)
+{
+	a3_ShaderIncludeGraph ret = { 0 };
+	if (graph && graph->targetCount)
+	{
+		free(graph->filePath);
+		free(graph->fileTime);
+		free(graph->includeEdge);
+		free(graph->targetEdge);
+		*graph = ret;
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3shaderIncludeResolve(a3_Stream *source_out, const a3byte *filePath, const a3ui32 sourceIndex, a3_ShaderIncludeGraph *graph_opt, const a3ui32 target)
+{
+	a3_ShaderIncludeState *state;
+	a3_Stream ret = { 0 };
+	a3byte rootPath[a3shader_includePathMax];
+	a3i32 result, fileIndex;
+
+	if (source_out && filePath && *filePath && (!graph_opt || target < graph_opt->targetCount))
+	{
+		if (!source_out->contents && strlen(filePath) < a3shader_includePathMax)
+		{
+			state = (a3_ShaderIncludeState *)calloc(1, sizeof(a3_ShaderIncludeState));
+			if (!state)
+				return 0;
+			state->graph = graph_opt;
+			state->sourceIndex = sourceIndex;
+
+			// root file belongs to target
+			strcpy(rootPath, filePath);
+			a3shaderIncludeInternalNormalizePath(rootPath);
+			if (graph_opt)
+			{
+				fileIndex = a3shaderIncludeInternalRecordFile(graph_opt, rootPath, 0);
+				if (fileIndex >= 0)
+					a3shaderIncludeInternalAddEdge(&graph_opt->targetEdge, &graph_opt->targetEdgeCount, &graph_opt->targetEdgeCapacity, target, fileIndex);
+			}
+
+			result = a3shaderIncludeInternalExpand(state, rootPath, 0);
+			if (result && state->length)
+			{
+				state->text[state->length] = 0;
+				ret.contents = ret.ptr = state->text;
+				ret.length = state->length;
+				*source_out = ret;
+				result = ret.length;
+			}
+			else
+			{
+				free(state->text);
+				result = 0;
+			}
+			free(state);
+			return result;
+		}
+	}
+	return -1;
+}
+
+
+a3ret a3shaderCreateFromFileListTracked(a3_Shader *shader_out, const a3byte name_opt[32], const a3_ShaderType type, const a3byte **filePathList, const a3ui32 count, a3_ShaderIncludeGraph *graph_opt, const a3ui32 target)
+{
+	a3ui32 newCount, i;
+	a3i32 result;
+	a3_Stream *fs;
+	a3_Arena scratch[1] = { 0 };
+	const a3byte **itr, **valid;
+
+	if (shader_out && filePathList && count && (!graph_opt || target < graph_opt->targetCount))
+	{
+		// streams and list only live until compiled: scratch arena
+		if (a3arenaCreate(scratch, count * (sizeof(a3_Stream) + sizeof(a3byte *)) + a3allocator_alignment * 2) <= 0)
+			return 0;
+		fs = (a3_Stream *)a3arenaAlloc(scratch, count * sizeof(a3_Stream));
+		valid = (const a3byte **)a3arenaAlloc(scratch, count * sizeof(a3byte *));
+		memset(fs, 0, count * sizeof(a3_Stream));
+
+		// dependencies are recorded again from scratch
+		if (graph_opt)
+			a3shaderIncludeGraphClearTarget(graph_opt, target);
+
+		// check for blank file paths, expand file contents as necessary
+		for (i = newCount = 0, itr = filePathList; i < count; ++i, ++itr)
+		{
+			if (a3shaderIncludeResolve(fs + newCount, *itr, newCount, graph_opt, target) > 0)
+			{
+				valid[newCount] = fs[newCount].contents;
+				++newCount;
+			}
+		}
+
+		// use sources to load shader
+		result = a3shaderCreateFromSourceList(shader_out, name_opt, type, valid, newCount);
+
+		// done
+		for (i = 0; i < newCount; ++i)
+			a3streamReleaseContents(fs + i);
+		a3arenaRelease(scratch);
+		return result;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3shaderIncludeBatchBegin(a3_ShaderIncludeBatch *batch_out, a3_ShaderIncludeStage *stageList_out, const a3byte **filePathList, const a3ui32 *sourceIndexList_opt, const a3ui32 count, const a3boolean track, const a3ui32 threadCount)
+{
+	a3ui32 i, n;
+	if (batch_out && stageList_out && filePathList && count)
+	{
+		if (!batch_out->stageList)
+		{
+			memset(stageList_out, 0, count * sizeof(a3_ShaderIncludeStage));
+			for (i = 0; i < count; ++i)
+			{
+				stageList_out[i].filePath = filePathList[i];
+				stageList_out[i].sourceIndex = sourceIndexList_opt ? sourceIndexList_opt[i] : 0;
+				if (track)
+					a3shaderIncludeGraphCreate(stageList_out[i].graph, 1);
+			}
+			memset(batch_out, 0, sizeof(a3_ShaderIncludeBatch));
+			batch_out->stageList = stageList_out;
+			batch_out->count = count;
+
+			// no point in more threads than files
+			n = threadCount < count ? threadCount : count;
+			n = n > 1 ? n <= a3shader_includeThreadMax ? n : a3shader_includeThreadMax : 1;
+			for (i = 0; i < n; ++i)
+				if (a3threadLaunch(batch_out->thread + i, (a3_threadfunc)a3shaderIncludeInternalBatchThread, batch_out, "animal3D shader include") <= 0)
+					break;
+			batch_out->threadCount = i;
+
+			// no threads: expand everything here so waiting still works
+			if (!i)
+				a3shaderIncludeInternalBatchThread(batch_out);
+			return i;
+		}
+	}
+	return -1;
+}
+
+
+a3ret a3shaderIncludeBatchWait(a3_ShaderIncludeBatch *batch, const a3ui32 index)
+{
+	a3_ShaderIncludeStage *stage;
+	if (batch && batch->stageList && index < batch->count)
+	{
+		stage = batch->stageList + index;
+		while (!stage->done)
+			a3threadYield();
+		return stage->result;
+	}
+	return -1;
+}
+
+
+a3ret a3shaderIncludeBatchEnd(a3_ShaderIncludeBatch *batch, a3_ShaderIncludeGraph *graph_opt, const a3ui32 *targetList_opt)
+{
+	a3_ShaderIncludeStage *stage;
+	a3ui32 i, count = 0;
+	if (batch && batch->stageList && (!graph_opt || targetList_opt))
+	{
+		for (i = 0; i < batch->threadCount; ++i)
+			a3threadWait(batch->thread + i);
+
+		// a target may span several stages: clear all before merging any
+		if (graph_opt)
+			for (i = 0; i < batch->count; ++i)
+				a3shaderIncludeGraphClearTarget(graph_opt, targetList_opt[i]);
+		for (i = 0, stage = batch->stageList; i < batch->count; ++i, ++stage)
+		{
+			count += (stage->result > 0);
+			if (stage->graph->targetCount)
+			{
+				if (graph_opt && targetList_opt[i] < graph_opt->targetCount)
+					a3shaderIncludeInternalMerge(graph_opt, stage->graph, targetList_opt[i]);
+				a3shaderIncludeGraphRelease(stage->graph);
+			}
+			a3streamReleaseContents(stage->source);
+		}
+		memset(batch, 0, sizeof(a3_ShaderIncludeBatch));
+		return count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -25,11 +25,11 @@
 */
 
 #include "animal3D-A3DG/a3graphics/a3_ShaderProgram.h"
-
-#include "animal3D/a3utility/a3_Stream.h"
+#include "animal3D-A3DG/a3graphics/a3_ShaderInclude.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 //-----------------------------------------------------------------------------
@@ -57,40 +57,8 @@ const a3byte *a3shaderInternalGetTypeStr(const a3_ShaderType type)
 
 a3ret a3shaderCreateFromFileList(a3_Shader *shader_out, const a3byte name_opt[32], const a3_ShaderType type, const a3byte **filePathList, const a3ui32 count)
 {
-	a3ui32 newCount, i;
-	a3i32 result;
-	a3_Stream fs[1] = { 0 };
-	const a3byte **itr, **valid;
-
-	if (shader_out && filePathList && count)
-	{
-		// check for blank file paths, decode file contents as necessary
-		valid = (a3byte **)malloc(count * sizeof(a3byte *));
-		for (i = newCount = 0, itr = filePathList; i < count; ++i, ++itr)
-		{
-			if (a3streamLoadContents(fs, *itr) > 0)
-			{
-				valid[newCount++] = fs->contents;
-				fs->contents = 0;
-			}
-		}
-
-		// use sources to load shader
-		result = a3shaderCreateFromSourceList(shader_out, name_opt, type, valid, newCount);
-
-		// release file contents
-		for (i = 0, itr = valid; i < newCount; ++i, ++itr)
-		{
-			fs->contents = *itr;
-			a3streamReleaseContents(fs);
-		}
-
-		// done
-		// release source list
-		free((void *)valid);
-		return result;
-	}
-	return -1;
+	// expand includes without recording dependencies
+	return a3shaderCreateFromFileListTracked(shader_out, name_opt, type, filePathList, count, 0, 0);
 }
 
 
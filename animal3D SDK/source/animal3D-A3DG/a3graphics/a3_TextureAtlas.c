@@ -30,6 +30,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #include "GL/glew.h"
 
@@ -60,6 +61,119 @@ inline void a3textureAtlasInternalCalculateRelativeSetCell(a3_TextureAtlasCell *
 }
 
 
+// skyline segment: run of atlas columns whose free space starts at y
+typedef struct a3_TextureAtlasSkyline
+{
+	a3ui32 x, y, width;
+} a3_TextureAtlasSkyline;
+
+// rectangle to pack, padded
+typedef struct a3_TextureAtlasPackRect
+{
+	a3ui32 width, height, index;
+} a3_TextureAtlasPackRect;
+
+// tallest first, then widest; index keeps the order deterministic
+a3i32 a3textureAtlasInternalPackCompare(const a3_TextureAtlasPackRect *a, const a3_TextureAtlasPackRect *b)
+{
+	return a->height != b->height ? (a->height < b->height ? +1 : -1) : a->width != b->width ? (a->width < b->width ? +1 : -1) : (a->index < b->index ? -1 : +1);
+}
+
+// find lowest position for rectangle on skyline; ties go to the narrowest 
+//	segment to leave wide gaps for later rectangles
+inline a3i32 a3textureAtlasInternalSkylineFit(const a3_TextureAtlasSkyline *skyline, const a3ui32 nodes, const a3ui32 atlasWidth, const a3ui32 maxHeight, const a3ui32 width, const a3ui32 height, a3ui32 *y_out)
+{
+	a3ui32 i, j, y, remain, bestTop = (a3ui32)-1, bestWidth = (a3ui32)-1;
+	a3i32 best = -1;
+	for (i = 0; i < nodes && skyline[i].x + width <= atlasWidth; ++i)
+	{
+		// rectangle rests on the highest segment under it
+		for (j = i, y = 0, remain = width; ; ++j)
+		{
+			y = skyline[j].y > y ? skyline[j].y : y;
+			if (skyline[j].width >= remain)
+				break;
+			remain -= skyline[j].width;
+		}
+		if (y + height <= maxHeight && (y + height < bestTop || (y + height == bestTop && skyline[i].width < bestWidth)))
+		{
+			best = i;
+			bestTop = y + height;
+			bestWidth = skyline[i].width;
+			*y_out = y;
+		}
+	}
+	return best;
+}
+
+// raise skyline where rectangle was placed; returns new node count
+inline a3ui32 a3textureAtlasInternalSkylineInsert(a3_TextureAtlasSkyline *skyline, a3ui32 nodes, const a3ui32 index, const a3ui32 top, const a3ui32 width)
+{
+	a3ui32 i = index + 1, end;
+
+	// new segment
+	memmove(skyline + i, skyline + index, (nodes - index) * sizeof(a3_TextureAtlasSkyline));
+	skyline[index].y = top;
+	skyline[index].width = width;
+	++nodes;
+
+	// segments now covered shrink or disappear
+	end = skyline[index].x + width;
+	while (i < nodes && skyline[i].x < end)
+	{
+		if (skyline[i].x + skyline[i].width <= end)
+		{
+			memmove(skyline + i, skyline + i + 1, (--nodes - i) * sizeof(a3_TextureAtlasSkyline));
+			continue;
+		}
+		skyline[i].width -= end - skyline[i].x;
+		skyline[i].x = end;
+		break;
+	}
+
+	// merge neighbors at the same height
+	for (i = 0; i + 1 < nodes; )
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			memmove(skyline + i + 1, skyline + i + 2, (nodes - i - 2) * sizeof(a3_TextureAtlasSkyline));
+			--nodes;
+		}
+		else
+			++i;
+	return nodes;
+}
+
+// pack all rectangles into given width; returns used height or 0 if full
+inline a3ui32 a3textureAtlasInternalPack(a3i32 *pixelOffsetList_out, a3_TextureAtlasSkyline *skyline, const a3_TextureAtlasPackRect *rectList, const a3ui32 count, const a3ui32 atlasWidth, const a3ui32 maxHeight, const a3ui32 padding)
+{
+	a3ui32 i, y, top, height = 0, nodes = 1;
+	a3i32 node;
+	skyline->x = skyline->y = 0;
+	skyline->width = atlasWidth;
+	for (i = 0; i < count; ++i)
+	{
+		node = a3textureAtlasInternalSkylineFit(skyline, nodes, atlasWidth, maxHeight, rectList[i].width, rectList[i].height, &y);
+		if (node < 0)
+			return 0;
+		pixelOffsetList_out[rectList[i].index * 2 + 0] = (a3i32)(skyline[node].x + padding);
+		pixelOffsetList_out[rectList[i].index * 2 + 1] = (a3i32)(y + padding);
+		top = y + rectList[i].height;
+		height = top > height ? top : height;
+		nodes = a3textureAtlasInternalSkylineInsert(skyline, nodes, node, top, rectList[i].width);
+	}
+	return height;
+}
+
+inline a3ui32 a3textureAtlasInternalNextPowerOfTwo(a3ui32 x)
+{
+	a3ui32 p = 1;
+	while (p < x)
+		p <<= 1;
+	return p;
+}
+
+
 inline a3ui32 a3textureAtlasInternalGetCellCount(a3byte *line, const a3ui32 lineLen, FILE *fp)
 {
 	a3ui32 numCells = 0;
@@ -153,9 +267,13 @@ a3ret a3textureAtlasAllocateCells(a3_TextureAtlas *textureAtlas, const a3ui32 nu
 		{
 			const a3ui32 dataSize = sizeof(a3_TextureAtlasCell) * numCells;
 			textureAtlas->cells = (a3_TextureAtlasCell *)malloc(dataSize);
-			memset(textureAtlas->cells, 0, dataSize);
-			textureAtlas->numCells = numCells;
-			return numCells;
+			if (textureAtlas->cells)
+			{
+				memset(textureAtlas->cells, 0, dataSize);
+				textureAtlas->numCells = numCells;
+				return numCells;
+			}
+			return 0;
 		}
 	}
 	return -1;
@@ -219,6 +337,140 @@ a3ret a3textureAtlasAllocateEvenCells(a3_TextureAtlas *textureAtlas, const a3ui3
 	return -1;
 }
 
+a3ret a3textureAtlasPackLayout(a3i32 *pixelOffsetList_out, a3ui32 *atlasWidth_out, a3ui32 *atlasHeight_out, const a3_TextureAtlasImage *imageList, const a3ui32 count, const a3ui32 maxSize, const a3ui32 padding, const a3boolean powerOfTwo)
+{
+	a3_TextureAtlasPackRect *rectList;
+	a3_TextureAtlasSkyline *skyline;
+	a3i32 *offsetList;
+	a3ui32 i, width, height, minWidth = 0, area = 0, bestWidth = 0, bestHeight = 0;
+	if (pixelOffsetList_out && atlasWidth_out && atlasHeight_out && imageList && count && maxSize)
+	{
+		// scratch: rectangles, skyline (one node more than rectangles) and 
+		//	offsets of the current attempt
+		rectList = (a3_TextureAtlasPackRect *)malloc(count * sizeof(a3_TextureAtlasPackRect) + (count + 1) * sizeof(a3_TextureAtlasSkyline) + count * 2 * sizeof(a3i32));
+		if (!rectList)
+			return 0;
+		skyline = (a3_TextureAtlasSkyline *)(rectList + count);
+		offsetList = (a3i32 *)(skyline + count + 1);
+		for (i = 0; i < count; ++i)
+		{
+			rectList[i].width = imageList[i].width + padding * 2;
+			rectList[i].height = imageList[i].height + padding * 2;
+			rectList[i].index = i;
+			minWidth = rectList[i].width > minWidth ? rectList[i].width : minWidth;
+			area += rectList[i].width * rectList[i].height;
+		}
+		qsort(rectList, count, sizeof(a3_TextureAtlasPackRect), (a3i32(*)(const void *, const void *))a3textureAtlasInternalPackCompare);
+
+		// start near square and widen until the atlas is no longer taller 
+		//	than wide, keeping the smallest that fits
+		width = (a3ui32)ceilf(sqrtf((a3f32)area));
+		width = width > minWidth ? width : minWidth;
+		if (powerOfTwo)
+			width = a3textureAtlasInternalNextPowerOfTwo(width);
+		for (; width <= maxSize; width = powerOfTwo ? width * 2 : width < maxSize && width + width / 8 + 1 > maxSize ? maxSize : width + width / 8 + 1)
+		{
+			height = a3textureAtlasInternalPack(offsetList, skyline, rectList, count, width, maxSize, padding);
+			if (height && powerOfTwo)
+				height = a3textureAtlasInternalNextPowerOfTwo(height);
+			if (height && height <= maxSize && (!bestWidth || width * height < bestWidth * bestHeight))
+			{
+				memcpy(pixelOffsetList_out, offsetList, count * 2 * sizeof(a3i32));
+				bestWidth = width;
+				bestHeight = height;
+			}
+			if (width == maxSize || (height && height <= width))
+				break;
+		}
+		free(rectList);
+
+		// done
+		if (bestWidth)
+		{
+			*atlasWidth_out = bestWidth;
+			*atlasHeight_out = bestHeight;
+			return count;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+a3ret a3textureAtlasPackImages(a3_TextureAtlas *textureAtlas, a3_Texture *texture_out, const a3byte name_opt[32], const a3_TexturePixelFormatDescriptor *pixelFormat, const a3_TextureAtlasImage *imageList, const a3ui32 count, const a3ui32 maxSize, const a3ui32 padding, const a3boolean powerOfTwo)
+{
+	const a3_TextureAtlasImage *image;
+	a3i32 *offsetList, ret = 0;
+	a3ui32 width, height, pixelSz, i, x, y, r;
+	a3byte *data, *dst;
+	const a3byte *src;
+	if (textureAtlas && texture_out && pixelFormat && imageList && count)
+	{
+		if (!textureAtlas->cells && !textureAtlas->texture && !texture_out->handle->handle)
+		{
+			for (i = 0; i < count; ++i)
+				if (!imageList[i].data || !imageList[i].width || !imageList[i].height)
+					return -1;
+
+			offsetList = (a3i32 *)malloc(count * 2 * sizeof(a3i32));
+			if (!offsetList)
+			{
+				printf("\n A3 ERROR: Texture atlas could not allocate layout for %u images.", count);
+				return 0;
+			}
+			if (a3textureAtlasPackLayout(offsetList, &width, &height, imageList, count, maxSize, padding, powerOfTwo) > 0)
+			{
+				// compose: unused space is clear, padding repeats edge pixels
+				pixelSz = pixelFormat->channelsPerPixel * pixelFormat->bytesPerChannel;
+				data = (a3byte *)calloc(width * height, pixelSz);
+				if (data)
+				{
+					for (i = 0, image = imageList; i < count; ++i, ++image)
+					{
+						for (y = 0; y < image->height + padding * 2; ++y)
+						{
+							r = y < padding ? 0 : y - padding < image->height ? y - padding : image->height - 1;
+							src = (const a3byte *)image->data + r * image->width * pixelSz;
+							dst = data + ((offsetList[i * 2 + 1] - padding + y) * width + offsetList[i * 2 + 0] - padding) * pixelSz;
+							for (x = 0; x < padding; ++x, dst += pixelSz)
+								memcpy(dst, src, pixelSz);
+							memcpy(dst, src, image->width * pixelSz);
+							for (x = 0, dst += image->width * pixelSz, src += (image->width - 1) * pixelSz; x < padding; ++x, dst += pixelSz)
+								memcpy(dst, src, pixelSz);
+						}
+					}
+
+					// upload and describe cells
+					if (a3textureCreateFromData(texture_out, name_opt, pixelFormat, width, height, data, 0) > 0)
+					{
+						a3textureAtlasSetTexture(textureAtlas, texture_out);
+						if (a3textureAtlasAllocateCells(textureAtlas, count) > 0)
+						{
+							for (i = 0, image = imageList; i < count; ++i, ++image)
+								a3textureAtlasSetCell(textureAtlas, i, offsetList[i * 2 + 0], offsetList[i * 2 + 1], image->width, image->height, image->localOffset[0], image->localOffset[1]);
+							ret = count;
+						}
+						else
+						{
+							// undo upload so atlas and texture stay unused
+							printf("\n A3 ERROR: Texture atlas could not allocate %u cells.", count);
+							a3textureAtlasSetTexture(textureAtlas, 0);
+							a3textureRelease(texture_out);
+						}
+					}
+					free(data);
+				}
+				else
+					printf("\n A3 ERROR: Texture atlas could not allocate %ux%u image.", width, height);
+			}
+			else
+				printf("\n A3 ERROR: Images do not fit in texture atlas of max size %u.", maxSize);
+			free(offsetList);
+			return ret;
+		}
+	}
+	return -1;
+}
+
 a3ret a3textureAtlasSetCell(const a3_TextureAtlas *textureAtlas, const a3ui32 index, const a3i32 pixelOffsetX, const a3i32 pixelOffsetY, const a3i32 pixelSizeW, const a3i32 pixelSizeH, const a3i32 localOffsetX, const a3i32 localOffsetY)
 {
 	if (textureAtlas)
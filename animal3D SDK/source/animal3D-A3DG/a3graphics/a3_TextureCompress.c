@@ -0,0 +1,480 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_TextureCompress.c
+	Block compression and compressed image cache implementation.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "animal3D-A3DG/a3graphics/a3_TextureCompress.h"
+#include "animal3D/a3/a3types_real.h"
+#include "animal3D/a3utility/a3_Profiler.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// cache file header
+typedef struct a3_TextureCompressHeader
+{
+	a3byte tag[4];
+	a3ui32 format;
+	a3ui32 width, height;
+	a3ui32 size;
+	a3ui32 reserved;
+	a3ui64 hash;
+} a3_TextureCompressHeader;
+
+// block sizes and cache file extensions per format
+static const a3ui32 a3textureCompressBlockSize[] = { 0, 8, 16, 16, 16, };
+static const a3byte *a3textureCompressExt[] = { "", "bc1", "bc3", "bc5", "bc7", };
+static const a3byte a3textureCompressTag[4] = { 'A', '3', 'T', 'C' };
+
+// BC7 4-bit index interpolation weights (out of 64)
+static const a3ui32 a3textureCompressWeightBC7[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64, };
+
+
+// fetch 4x4 block of pixels, repeating last row and column at edges
+inline void a3textureCompressInternalFetch(a3ubyte block[16][4], const a3ubyte *data, const a3ui32 width, const a3ui32 height, const a3ui32 x, const a3ui32 y)
+{
+	a3ui32 i, j, px, py;
+	for (j = 0; j < 4; ++j)
+	{
+		py = y + j < height ? y + j : height - 1;
+		for (i = 0; i < 4; ++i)
+		{
+			px = x + i < width ? x + i : width - 1;
+			memcpy(block[j * 4 + i], data + (py * width + px) * 4, 4);
+		}
+	}
+}
+
+// endpoints on the axis of greatest variance of the first 'channels'
+//	channels, spanning the projection of all pixels
+inline void a3textureCompressInternalEndpoints(a3f32 e0[4], a3f32 e1[4], const a3ubyte block[16][4], const a3ui32 channels)
+{
+	a3f32 mean[4] = { 0 }, cov[4][4] = { 0 }, axis[4], next[4], d[4], t, tMin = 0.0f, tMax = 0.0f, len;
+	a3ui32 i, j, k, n;
+	for (i = 0; i < 16; ++i)
+		for (j = 0; j < channels; ++j)
+			mean[j] += (a3f32)block[i][j] * (1.0f / 16.0f);
+	for (i = 0; i < 16; ++i)
+	{
+		for (j = 0; j < channels; ++j)
+			d[j] = (a3f32)block[i][j] - mean[j];
+		for (j = 0; j < channels; ++j)
+			for (k = 0; k < channels; ++k)
+				cov[j][k] += d[j] * d[k];
+	}
+
+	// power iteration starting from the row of the channel that varies
+	//	most; unlike the diagonal, this is not orthogonal to the axis when
+	//	channels vary in opposite directions
+	for (j = 1, k = 0; j < channels; ++j)
+		k = cov[j][j] > cov[k][k] ? j : k;
+	for (j = 0; j < channels; ++j)
+		axis[j] = cov[k][j];
+	for (n = 0; n < 8; ++n)
+	{
+		for (j = 0, len = 0.0f; j < channels; ++j)
+		{
+			for (k = 0, next[j] = 0.0f; k < channels; ++k)
+				next[j] += cov[j][k] * axis[k];
+			t = next[j] >= 0.0f ? next[j] : -next[j];
+			len = t > len ? t : len;
+		}
+		if (len <= 0.0f)
+			break;
+		for (j = 0, len = 1.0f / len; j < channels; ++j)
+			axis[j] = next[j] * len;
+	}
+	for (j = 0, len = 0.0f; j < channels; ++j)
+		len += axis[j] * axis[j];
+
+	// flat block: both endpoints are the mean
+	if (len > 0.0f)
+	{
+		for (j = 0, len = 1.0f / sqrtf(len); j < channels; ++j)
+			axis[j] *= len;
+		for (i = 0; i < 16; ++i)
+		{
+			for (j = 0, t = 0.0f; j < channels; ++j)
+				t += ((a3f32)block[i][j] - mean[j]) * axis[j];
+			tMin = t < tMin ? t : tMin;
+			tMax = t > tMax ? t : tMax;
+		}
+	}
+	else
+		axis[0] = axis[1] = axis[2] = axis[3] = 0.0f;
+	for (j = 0; j < channels; ++j)
+	{
+		e0[j] = mean[j] + axis[j] * tMin;
+		e1[j] = mean[j] + axis[j] * tMax;
+		e0[j] = e0[j] < 0.0f ? 0.0f : e0[j] > 255.0f ? 255.0f : e0[j];
+		e1[j] = e1[j] < 0.0f ? 0.0f : e1[j] > 255.0f ? 255.0f : e1[j];
+	}
+}
+
+// index of nearest palette entry
+inline a3ui32 a3textureCompressInternalNearest(const a3ubyte pixel[4], const a3i32 palette[][4], const a3ui32 count, const a3ui32 channels)
+{
+	a3i32 d, dist, best = 0x7fffffff;
+	a3ui32 i, j, ret = 0;
+	for (i = 0; i < count; ++i)
+	{
+		for (j = 0, dist = 0; j < channels; ++j)
+		{
+			d = (a3i32)pixel[j] - palette[i][j];
+			dist += d * d;
+		}
+		if (dist < best)
+		{
+			best = dist;
+			ret = i;
+		}
+	}
+	return ret;
+}
+
+// append bits to block, least significant first
+inline void a3textureCompressInternalWriteBits(a3ubyte *dst, a3ui32 *bit, const a3ui32 value, const a3ui32 count)
+{
+	a3ui32 i;
+	for (i = 0; i < count; ++i, ++*bit)
+		if ((value >> i) & 1)
+			dst[*bit >> 3] |= (a3ubyte)(1 << (*bit & 7));
+}
+
+
+// color block (BC1 and color half of BC3), 8 bytes
+inline void a3textureCompressInternalEncodeColor(a3ubyte *dst, const a3ubyte block[16][4])
+{
+	a3f32 e0[4], e1[4];
+	a3i32 palette[4][4];
+	a3ui32 c[2], r, g, b, i, j, indices = 0;
+	a3textureCompressInternalEndpoints(e0, e1, block, 3);
+
+	// 565 endpoints; first must be greater for four-color mode
+	c[0] = ((a3ui32)(e1[0] * 31.0f / 255.0f + 0.5f) << 11) | ((a3ui32)(e1[1] * 63.0f / 255.0f + 0.5f) << 5) | (a3ui32)(e1[2] * 31.0f / 255.0f + 0.5f);
+	c[1] = ((a3ui32)(e0[0] * 31.0f / 255.0f + 0.5f) << 11) | ((a3ui32)(e0[1] * 63.0f / 255.0f + 0.5f) << 5) | (a3ui32)(e0[2] * 31.0f / 255.0f + 0.5f);
+	if (c[0] < c[1])
+	{
+		r = c[0];
+		c[0] = c[1];
+		c[1] = r;
+	}
+	for (i = 0; i < 2; ++i)
+	{
+		r = (c[i] >> 11) & 31;
+		g = (c[i] >> 5) & 63;
+		b = c[i] & 31;
+		palette[i][0] = (r << 3) | (r >> 2);
+		palette[i][1] = (g << 2) | (g >> 4);
+		palette[i][2] = (b << 3) | (b >> 2);
+	}
+	for (j = 0; j < 3; ++j)
+	{
+		palette[2][j] = (palette[0][j] * 2 + palette[1][j]) / 3;
+		palette[3][j] = (palette[0][j] + palette[1][j] * 2) / 3;
+	}
+
+	// equal endpoints select three-color mode: index 0 everywhere
+	if (c[0] != c[1])
+		for (i = 0; i < 16; ++i)
+			indices |= a3textureCompressInternalNearest(block[i], palette, 4, 3) << (i * 2);
+	dst[0] = (a3ubyte)c[0];
+	dst[1] = (a3ubyte)(c[0] >> 8);
+	dst[2] = (a3ubyte)c[1];
+	dst[3] = (a3ubyte)(c[1] >> 8);
+	dst[4] = (a3ubyte)indices;
+	dst[5] = (a3ubyte)(indices >> 8);
+	dst[6] = (a3ubyte)(indices >> 16);
+	dst[7] = (a3ubyte)(indices >> 24);
+}
+
+// single channel block (alpha of BC3, channels of BC5), 8 bytes
+inline void a3textureCompressInternalEncodeChannel(a3ubyte *dst, const a3ubyte block[16][4], const a3ui32 channel)
+{
+	a3i32 palette[8][4], lo = 255, hi = 0;
+	a3ubyte value[4] = { 0 };
+	a3ui32 i, bit = 16;
+	for (i = 0; i < 16; ++i)
+	{
+		lo = block[i][channel] < lo ? block[i][channel] : lo;
+		hi = block[i][channel] > hi ? block[i][channel] : hi;
+	}
+
+	// eight-value mode: first endpoint greater
+	memset(dst, 0, 8);
+	dst[0] = (a3ubyte)hi;
+	dst[1] = (a3ubyte)lo;
+	if (hi != lo)
+	{
+		palette[0][0] = hi;
+		palette[1][0] = lo;
+		for (i = 2; i < 8; ++i)
+			palette[i][0] = ((8 - i) * hi + (i - 1) * lo + 3) / 7;
+		for (i = 0; i < 16; ++i)
+		{
+			value[0] = block[i][channel];
+			a3textureCompressInternalWriteBits(dst, &bit, a3textureCompressInternalNearest(value, palette, 8, 1), 3);
+		}
+	}
+}
+
+// BC7 block using mode 6: one subset, rgba endpoints with 7 bits and a
+//	shared low bit each, 4-bit indices
+static inline void a3textureCompressInternalEncodeBC7(a3ubyte *dst, const a3ubyte block[16][4])
+{
+	a3f32 e[2][4];
+	a3i32 palette[16][4], err[2], d;
+	a3ui32 q[2][4], p[2], index[16], i, j, k, bit = 0, tmp;
+	a3textureCompressInternalEndpoints(e[0], e[1], block, 4);
+
+	// quantize each endpoint with whichever low bit fits it best
+	for (i = 0; i < 2; ++i)
+	{
+		for (k = 0; k < 2; ++k)
+			for (j = 0, err[k] = 0; j < 4; ++j)
+			{
+				tmp = (a3ui32)((e[i][j] - (a3f32)k) * 0.5f + 0.5f);
+				tmp = tmp < 127 ? tmp : 127;
+				d = (a3i32)((tmp << 1) | k) - (a3i32)(e[i][j] + 0.5f);
+				err[k] += d * d;
+			}
+		p[i] = err[1] < err[0];
+		for (j = 0; j < 4; ++j)
+		{
+			tmp = (a3ui32)((e[i][j] - (a3f32)p[i]) * 0.5f + 0.5f);
+			q[i][j] = tmp < 127 ? tmp : 127;
+		}
+	}
+	for (i = 0; i < 16; ++i)
+		for (j = 0; j < 4; ++j)
+			palette[i][j] = (a3i32)(((64 - a3textureCompressWeightBC7[i]) * ((q[0][j] << 1) | p[0]) + a3textureCompressWeightBC7[i] * ((q[1][j] << 1) | p[1]) + 32) >> 6);
+	for (i = 0; i < 16; ++i)
+		index[i] = a3textureCompressInternalNearest(block[i], palette, 16, 4);
+
+	// first index is stored without its top bit: flip if it is set
+	if (index[0] & 8)
+	{
+		for (j = 0; j < 4; ++j)
+		{
+			tmp = q[0][j];
+			q[0][j] = q[1][j];
+			q[1][j] = tmp;
+		}
+		tmp = p[0];
+		p[0] = p[1];
+		p[1] = tmp;
+		for (i = 0; i < 16; ++i)
+			index[i] = 15 - index[i];
+	}
+
+	memset(dst, 0, 16);
+	a3textureCompressInternalWriteBits(dst, &bit, 1 << 6, 7);
+	for (j = 0; j < 4; ++j)
+	{
+		a3textureCompressInternalWriteBits(dst, &bit, q[0][j], 7);
+		a3textureCompressInternalWriteBits(dst, &bit, q[1][j], 7);
+	}
+	a3textureCompressInternalWriteBits(dst, &bit, p[0], 1);
+	a3textureCompressInternalWriteBits(dst, &bit, p[1], 1);
+	a3textureCompressInternalWriteBits(dst, &bit, index[0], 3);
+	for (i = 1; i < 16; ++i)
+		a3textureCompressInternalWriteBits(dst, &bit, index[i], 4);
+}
+
+
+// cache file path
+static inline void a3textureCompressInternalCachePath(a3byte *path, const a3ui32 pathLen, const a3byte *cacheDir, const a3ui64 hash, const a3_TextureCompressFormat format)
+{
+	snprintf(path, pathLen, "%s/%016llx.%s", cacheDir, (unsigned long long)hash, a3textureCompressExt[format]);
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ui64 a3textureCompressHash(const void *data, const a3ui32 size)
+{
+	// FNV-1a
+	const a3ubyte *ptr = (const a3ubyte *)data, *const end = ptr + size;
+	a3ui64 hash = 0xcbf29ce484222325ull;
+	if (data)
+	{
+		while (ptr < end)
+			hash = (hash ^ *(ptr++)) * 0x100000001b3ull;
+		return hash ? hash : 1;
+	}
+	return 0;
+}
+
+
+a3ret a3textureCompressEncode(a3_TextureCompressed *compressed_out, const a3_TextureCompressFormat format, const a3ui32 width, const a3ui32 height, const void *data, const a3ui64 hash)
+{
+	a3_TextureCompressed ret = { 0 };
+	a3_ProfileZone zone[1];
+	a3ubyte block[16][4], *dst;
+	a3ui32 x, y;
+	if (compressed_out && format > a3tex_compressNone && format <= a3tex_compressBC7 && width && height && data)
+	{
+		if (!compressed_out->data)
+		{
+			ret.size = ((width + 3) / 4) * ((height + 3) / 4) * a3textureCompressBlockSize[format];
+			ret.data = dst = (a3ubyte *)malloc(ret.size);
+			if (ret.data)
+			{
+				a3profileZoneBegin(zone, "a3textureCompressEncode");
+				for (y = 0; y < height; y += 4)
+					for (x = 0; x < width; x += 4, dst += a3textureCompressBlockSize[format])
+					{
+						a3textureCompressInternalFetch(block, (const a3ubyte *)data, width, height, x, y);
+						switch (format)
+						{
+						case a3tex_compressBC1:
+							a3textureCompressInternalEncodeColor(dst, block);
+							break;
+						case a3tex_compressBC3:
+							a3textureCompressInternalEncodeChannel(dst, block, 3);
+							a3textureCompressInternalEncodeColor(dst + 8, block);
+							break;
+						case a3tex_compressBC5:
+							a3textureCompressInternalEncodeChannel(dst, block, 0);
+							a3textureCompressInternalEncodeChannel(dst + 8, block, 1);
+							break;
+						default:
+							a3textureCompressInternalEncodeBC7(dst, block);
+							break;
+						}
+					}
+				a3profileZoneEnd(zone);
+
+				ret.width = width;
+				ret.height = height;
+				ret.format = format;
+				ret.hash = hash;
+				*compressed_out = ret;
+				return ret.size;
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+
+a3ret a3textureCompressSaveCache(const a3_TextureCompressed *compressed, const a3byte *cacheDir)
+{
+	a3_TextureCompressHeader header[1] = { 0 };
+	a3byte path[512];
+	FILE *fp;
+	a3ui32 ret = 0;
+	if (compressed && compressed->data && cacheDir && *cacheDir)
+	{
+		a3textureCompressInternalCachePath(path, sizeof(path), cacheDir, compressed->hash, compressed->format);
+		fp = fopen(path, "wb");
+		if (fp)
+		{
+			memcpy(header->tag, a3textureCompressTag, sizeof(header->tag));
+			header->format = compressed->format;
+			header->width = compressed->width;
+			header->height = compressed->height;
+			header->size = compressed->size;
+			header->hash = compressed->hash;
+			ret += (a3ui32)fwrite(header, 1, sizeof(header), fp);
+			ret += (a3ui32)fwrite(compressed->data, 1, compressed->size, fp);
+			fclose(fp);
+
+			// partially written file must not be found later
+			if (ret == sizeof(header) + compressed->size)
+				return ret;
+			remove(path);
+		}
+		else
+			printf("\n A3 Warning: Could not write compressed texture cache file \'%s\'.", path);
+		return 0;
+	}
+	return -1;
+}
+
+a3ret a3textureCompressLoadCache(a3_TextureCompressed *compressed_out, const a3byte *cacheDir, const a3ui64 hash, const a3_TextureCompressFormat format)
+{
+	a3_TextureCompressed ret = { 0 };
+	a3_TextureCompressHeader header[1] = { 0 };
+	a3byte path[512];
+	FILE *fp;
+	if (compressed_out && cacheDir && *cacheDir && format > a3tex_compressNone && format <= a3tex_compressBC7)
+	{
+		if (!compressed_out->data)
+		{
+			a3textureCompressInternalCachePath(path, sizeof(path), cacheDir, hash, format);
+			fp = fopen(path, "rb");
+			if (fp)
+			{
+				// validate header against key and expected size
+				if (fread(header, 1, sizeof(header), fp) == sizeof(header) &&
+					!memcmp(header->tag, a3textureCompressTag, sizeof(header->tag)) &&
+					header->hash == hash && header->format == (a3ui32)format && header->width && header->height &&
+					header->size == ((header->width + 3) / 4) * ((header->height + 3) / 4) * a3textureCompressBlockSize[format])
+				{
+					ret.data = malloc(header->size);
+					if (ret.data && fread(ret.data, 1, header->size, fp) == header->size)
+					{
+						ret.size = header->size;
+						ret.width = header->width;
+						ret.height = header->height;
+						ret.format = format;
+						ret.hash = hash;
+						*compressed_out = ret;
+					}
+					else
+						free(ret.data);
+				}
+				fclose(fp);
+			}
+			return compressed_out->size;
+		}
+	}
+	return -1;
+}
+
+
+a3ret a3textureCompressRelease(a3_TextureCompressed *compressed)
+{
+	const a3_TextureCompressed reset = { 0 };
+	a3ui32 size;
+	if (compressed && compressed->data)
+	{
+		size = compressed->size;
+		free(compressed->data);
+		*compressed = reset;
+		return size;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
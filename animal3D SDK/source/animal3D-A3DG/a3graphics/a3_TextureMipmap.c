@@ -0,0 +1,514 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_TextureMipmap.c
+	CPU mipmap chain generation implementation.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "animal3D-A3DG/a3graphics/a3_TextureMipmap.h"
+#include "animal3D/a3utility/a3_Half.h"
+#include "animal3D/a3utility/a3_Thread.h"
+#include "animal3D/a3utility/a3_Profiler.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+// each pixel is four floats, one register wide
+#if (defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 1) || defined __SSE__)
+#include <xmmintrin.h>
+#define A3_TEXTUREMIPMAP_SSE
+#endif	// SSE
+
+
+//-----------------------------------------------------------------------------
+// internal types
+
+// separable filter: for each output pixel, a fixed number of taps with
+//	source index (clamped to edge) and normalized weight
+typedef struct a3_TextureMipmapKernel
+{
+	a3ui32 *index;
+	a3f32 *weight;
+	a3ui32 taps;
+} a3_TextureMipmapKernel;
+
+// one pass over rows; each thread keeps its own copy
+typedef struct a3_TextureMipmapPass a3_TextureMipmapPass;
+typedef void(*a3_TextureMipmapRowFunc)(const a3_TextureMipmapPass *pass, const a3ui32 row);
+struct a3_TextureMipmapPass
+{
+	// linear images (four floats per pixel)
+	const a3f32 *src;
+	a3f32 *dst;
+	a3ui32 srcWidth, dstWidth;
+	const a3_TextureMipmapKernel *kernel;
+
+	// encoded images
+	const void *encodedSrc;
+	void *encodedDst;
+	a3_TexturePixelType pixelType;
+	a3boolean srgb;
+	const a3f32 *srgbTable;
+};
+
+// whole chain shared by threads; every level's kernels are built before 
+//	threads start, so only the claim counter and barrier change
+typedef struct a3_TextureMipmapJob
+{
+	const a3_TextureMipmapChain *chain;
+	const void *data;
+	a3_TexturePixelType pixelType;
+	a3boolean srgb;
+	const a3f32 *srgbTable;
+
+	// linear levels alternate between two buffers; horizontal pass 
+	//	result is next width, current height
+	a3f32 *level[2], *tmp;
+	a3_TextureMipmapKernel kernelH[a3tex_mipLevelMax], kernelV[a3tex_mipLevelMax];
+
+	volatile a3i32 ticket, started, barrierCount, barrierGeneration;
+} a3_TextureMipmapJob;
+
+// thread arguments
+typedef struct a3_TextureMipmapWorker
+{
+	a3_TextureMipmapJob *job;
+	a3ui32 threadCount;
+} a3_TextureMipmapWorker;
+
+// filter and threading parameters
+enum a3_TextureMipmapInternalParam
+{
+	a3tex_mipRowsPerClaim = 8,			// rows claimed by a thread at once
+	a3tex_mipPixelsPerThread = 16384,	// only use threads for large images
+};
+
+// Kaiser window parameters: radius in output pixels and shape
+#define a3tex_mipKaiserRadius	3.0f
+#define a3tex_mipKaiserAlpha	4.0f
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// sRGB transfer functions
+inline a3f32 a3textureMipmapInternalToLinear(const a3f32 c)
+{
+	return c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+}
+
+inline a3f32 a3textureMipmapInternalToSRGB(const a3f32 l)
+{
+	return l <= 0.0031308f ? l * 12.92f : 1.055f * powf(l, 1.0f / 2.4f) - 0.055f;
+}
+
+// unorm8 with rounding
+inline a3ubyte a3textureMipmapInternalPack8(const a3f32 x)
+{
+	return (a3ubyte)((x <= 0.0f ? 0.0f : x >= 1.0f ? 1.0f : x) * 255.0f + 0.5f);
+}
+
+// zeroth-order modified Bessel function of the first kind (series)
+inline a3f32 a3textureMipmapInternalBesselI0(const a3f32 x)
+{
+	a3f32 sum = 1.0f, term = 1.0f, k;
+	const a3f32 y = x * x * 0.25f;
+	for (k = 1.0f; k < 32.0f && term > sum * 1.0e-8f; k += 1.0f)
+	{
+		term *= y / (k * k);
+		sum += term;
+	}
+	return sum;
+}
+
+// filter functions; x is distance in output pixels
+inline a3f32 a3textureMipmapInternalKaiser(const a3f32 x)
+{
+	const a3f32 t = x / a3tex_mipKaiserRadius, px = 3.14159265358979f * x;
+	const a3f32 sinc = x != 0.0f ? sinf(px) / px : 1.0f;
+	return (t > -1.0f && t < 1.0f) ? sinc * a3textureMipmapInternalBesselI0(a3tex_mipKaiserAlpha * sqrtf(1.0f - t * t)) / a3textureMipmapInternalBesselI0(a3tex_mipKaiserAlpha) : 0.0f;
+}
+
+// build kernel reducing srcSize pixels to dstSize
+inline a3boolean a3textureMipmapInternalCreateKernel(a3_TextureMipmapKernel *kernel, const a3_TextureMipmapFilter filter, const a3ui32 srcSize, const a3ui32 dstSize)
+{
+	const a3f32 scale = (a3f32)srcSize / (a3f32)dstSize;
+	const a3f32 support = (filter == a3tex_mipFilterKaiser ? a3tex_mipKaiserRadius : 0.5f) * scale;
+	a3f32 center, x, w, sum, lo, hi;
+	a3i32 first, j;
+	a3ui32 i, k;
+
+	kernel->taps = (a3ui32)ceilf(support * 2.0f) + 1;
+	kernel->index = (a3ui32 *)malloc(dstSize * kernel->taps * (sizeof(a3ui32) + sizeof(a3f32)));
+	if (!kernel->index)
+		return 0;
+	kernel->weight = (a3f32 *)(kernel->index + dstSize * kernel->taps);
+
+	for (i = 0; i < dstSize; ++i)
+	{
+		// footprint of output pixel in source pixels
+		center = ((a3f32)i + 0.5f) * scale;
+		first = (a3i32)floorf(center - support);
+		for (k = 0, sum = 0.0f; k < kernel->taps; ++k)
+		{
+			j = first + (a3i32)k;
+			if (filter == a3tex_mipFilterKaiser)
+			{
+				x = ((a3f32)j + 0.5f - center) / scale;
+				w = a3textureMipmapInternalKaiser(x);
+			}
+			else
+			{
+				// box: fraction of source pixel covered by footprint
+				lo = (a3f32)j > center - support ? (a3f32)j : center - support;
+				hi = (a3f32)(j + 1) < center + support ? (a3f32)(j + 1) : center + support;
+				w = hi > lo ? hi - lo : 0.0f;
+			}
+			kernel->index[i * kernel->taps + k] = j < 0 ? 0 : j >= (a3i32)srcSize ? srcSize - 1 : (a3ui32)j;
+			kernel->weight[i * kernel->taps + k] = w;
+			sum += w;
+		}
+		for (k = 0; k < kernel->taps; ++k)
+			kernel->weight[i * kernel->taps + k] /= sum;
+	}
+	return 1;
+}
+
+// weighted sum of pixels: dst = sum of weight[k] * src[index[k] * stride]
+inline void a3textureMipmapInternalFilterPixel(a3f32 *dst, const a3f32 *src, const a3ui32 stride, const a3ui32 *index, const a3f32 *weight, const a3ui32 taps)
+{
+	a3ui32 k;
+#ifdef A3_TEXTUREMIPMAP_SSE
+	__m128 sum = _mm_setzero_ps();
+	for (k = 0; k < taps; ++k)
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + index[k] * stride), _mm_set1_ps(weight[k])));
+	_mm_storeu_ps(dst, sum);
+#else	// !A3_TEXTUREMIPMAP_SSE
+	const a3f32 *p;
+	dst[0] = dst[1] = dst[2] = dst[3] = 0.0f;
+	for (k = 0; k < taps; ++k)
+	{
+		p = src + index[k] * stride;
+		dst[0] += p[0] * weight[k];
+		dst[1] += p[1] * weight[k];
+		dst[2] += p[2] * weight[k];
+		dst[3] += p[3] * weight[k];
+	}
+#endif	// A3_TEXTUREMIPMAP_SSE
+}
+
+
+// row functions
+// decode one row of base image to linear
+void a3textureMipmapInternalDecodeRow(const a3_TextureMipmapPass *pass, const a3ui32 row)
+{
+	const a3ui32 n = pass->srcWidth * 4;
+	a3f32 *dst = pass->dst + row * n;
+	a3ui32 i;
+	if (pass->pixelType == a3tex_rgba8)
+	{
+		const a3ubyte *src = (const a3ubyte *)pass->encodedSrc + row * n;
+		for (i = 0; i < n; i += 4)
+		{
+			dst[i + 0] = pass->srgbTable[src[i + 0]];
+			dst[i + 1] = pass->srgbTable[src[i + 1]];
+			dst[i + 2] = pass->srgbTable[src[i + 2]];
+			dst[i + 3] = (a3f32)src[i + 3] / 255.0f;
+		}
+	}
+	else if (pass->pixelType == a3tex_rgba16F)
+	{
+		const a3ui16 *src = (const a3ui16 *)pass->encodedSrc + row * n;
+		for (i = 0; i < n; ++i)
+			dst[i] = a3halfUnpack(src[i]);
+	}
+	else
+		memcpy(dst, (const a3f32 *)pass->encodedSrc + row * n, n * sizeof(a3f32));
+}
+
+// filter one row horizontally: source height, output width
+void a3textureMipmapInternalFilterRowH(const a3_TextureMipmapPass *pass, const a3ui32 row)
+{
+	const a3_TextureMipmapKernel *kernel = pass->kernel;
+	const a3f32 *src = pass->src + row * pass->srcWidth * 4;
+	a3f32 *dst = pass->dst + row * pass->dstWidth * 4;
+	a3ui32 x;
+	for (x = 0; x < pass->dstWidth; ++x, dst += 4)
+		a3textureMipmapInternalFilterPixel(dst, src, 4, kernel->index + x * kernel->taps, kernel->weight + x * kernel->taps, kernel->taps);
+}
+
+// filter one row vertically and encode it into the chain
+void a3textureMipmapInternalFilterRowV(const a3_TextureMipmapPass *pass, const a3ui32 row)
+{
+	const a3_TextureMipmapKernel *kernel = pass->kernel;
+	const a3ui32 *index = kernel->index + row * kernel->taps;
+	const a3f32 *weight = kernel->weight + row * kernel->taps;
+	const a3ui32 n = pass->dstWidth * 4, stride = pass->dstWidth * 4;
+	a3f32 *dst = pass->dst + row * n;
+	a3ui32 x, i;
+	for (x = 0; x < n; x += 4)
+		a3textureMipmapInternalFilterPixel(dst + x, pass->src + x, stride, index, weight, kernel->taps);
+
+	// encode
+	if (pass->pixelType == a3tex_rgba8)
+	{
+		a3ubyte *out = (a3ubyte *)pass->encodedDst + row * n;
+		for (i = 0; i < n; i += 4)
+		{
+			if (pass->srgb)
+			{
+				out[i + 0] = a3textureMipmapInternalPack8(a3textureMipmapInternalToSRGB(dst[i + 0]));
+				out[i + 1] = a3textureMipmapInternalPack8(a3textureMipmapInternalToSRGB(dst[i + 1]));
+				out[i + 2] = a3textureMipmapInternalPack8(a3textureMipmapInternalToSRGB(dst[i + 2]));
+			}
+			else
+			{
+				out[i + 0] = a3textureMipmapInternalPack8(dst[i + 0]);
+				out[i + 1] = a3textureMipmapInternalPack8(dst[i + 1]);
+				out[i + 2] = a3textureMipmapInternalPack8(dst[i + 2]);
+			}
+			out[i + 3] = a3textureMipmapInternalPack8(dst[i + 3]);
+		}
+	}
+	else if (pass->pixelType == a3tex_rgba16F)
+	{
+		a3ui16 *out = (a3ui16 *)pass->encodedDst + row * n;
+		for (i = 0; i < n; ++i)
+			out[i] = a3halfPack(dst[i]);
+	}
+	else
+		memcpy((a3f32 *)pass->encodedDst + row * n, dst, n * sizeof(a3f32));
+}
+
+
+// all threads wait here until the last one arrives
+inline void a3textureMipmapInternalBarrier(a3_TextureMipmapJob *job, const a3ui32 threadCount)
+{
+	const a3i32 generation = job->barrierGeneration;
+	if (threadCount > 1)
+	{
+		if (a3atomicIncrement(&job->barrierCount) == (a3i32)threadCount)
+		{
+			job->barrierCount = 0;
+			a3atomicIncrement(&job->barrierGeneration);
+		}
+		else while (job->barrierGeneration == generation)
+			a3threadYield();
+	}
+}
+
+// claim blocks of rows until none are left, then meet; every thread 
+//	makes one failed claim per pass, so each knows where the tickets of 
+//	the next pass start without resetting the counter; rows are 
+//	independent so the split does not change the result
+inline void a3textureMipmapInternalPass(a3_TextureMipmapJob *job, const a3_TextureMipmapPass *pass, const a3_TextureMipmapRowFunc rowFunc, const a3ui32 rows, a3ui32 *ticket, const a3ui32 threadCount)
+{
+	const a3ui32 blocks = (rows + a3tex_mipRowsPerClaim - 1) / a3tex_mipRowsPerClaim;
+	a3ui32 block, row, end;
+	while ((block = (a3ui32)a3atomicIncrement(&job->ticket) - 1 - *ticket) < blocks)
+	{
+		row = block * a3tex_mipRowsPerClaim;
+		end = row + a3tex_mipRowsPerClaim < rows ? row + a3tex_mipRowsPerClaim : rows;
+		for (; row < end; ++row)
+			rowFunc(pass, row);
+	}
+	*ticket += blocks + threadCount;
+	a3textureMipmapInternalBarrier(job, threadCount);
+}
+
+// thread: decode base level, then filter every level from the one before
+a3ret a3textureMipmapInternalThread(a3_TextureMipmapWorker *worker)
+{
+	a3_TextureMipmapJob *const job = worker->job;
+	const a3_TextureMipmapChain *const chain = job->chain;
+	a3_TextureMipmapPass pass[1] = { 0 };
+	a3ui32 threadCount, i, ticket = 0;
+
+	// wait until the number of threads that launched is known
+	while (!job->started)
+		a3threadYield();
+	threadCount = worker->threadCount;
+
+	pass->pixelType = job->pixelType;
+	pass->srgb = job->srgb;
+	pass->srgbTable = job->srgbTable;
+	pass->encodedSrc = job->data;
+	pass->dst = job->level[0];
+	pass->srcWidth = chain->width[0];
+	a3textureMipmapInternalPass(job, pass, a3textureMipmapInternalDecodeRow, chain->height[0], &ticket, threadCount);
+
+	for (i = 1; i < chain->levels; ++i)
+	{
+		pass->src = job->level[(i - 1) & 1];
+		pass->dst = job->tmp;
+		pass->srcWidth = chain->width[i - 1];
+		pass->dstWidth = chain->width[i];
+		pass->kernel = job->kernelH + i;
+		a3textureMipmapInternalPass(job, pass, a3textureMipmapInternalFilterRowH, chain->height[i - 1], &ticket, threadCount);
+
+		pass->src = job->tmp;
+		pass->dst = job->level[i & 1];
+		pass->kernel = job->kernelV + i;
+		pass->encodedDst = (a3byte *)chain->data + chain->offset[i];
+		a3textureMipmapInternalPass(job, pass, a3textureMipmapInternalFilterRowV, chain->height[i], &ticket, threadCount);
+	}
+	return 0;
+}
+
+// launch helper threads once for the whole chain, then release them all 
+//	with the number that actually started; a thread that fails to launch 
+//	never reaches the barrier, so it must not be counted
+inline void a3textureMipmapInternalRun(a3_TextureMipmapJob *job, const a3ui32 threadCount)
+{
+	a3_Thread thread[a3tex_stageThreadMax - 1] = { 0 };
+	a3_TextureMipmapWorker worker[a3tex_stageThreadMax];
+	a3ui32 i, n;
+	job->ticket = job->started = job->barrierCount = job->barrierGeneration = 0;
+	for (i = 0; i < threadCount; ++i)
+		worker[i].job = job;
+	for (n = 1; n < threadCount; ++n)
+		if (a3threadLaunch(thread + n - 1, (a3_threadfunc)a3textureMipmapInternalThread, worker + n, "animal3D mipmap") <= 0)
+			break;
+	for (i = 0; i < n; ++i)
+		worker[i].threadCount = n;
+	a3atomicIncrement(&job->started);
+	a3textureMipmapInternalThread(worker);
+	for (i = 1; i < n; ++i)
+		a3threadWait(thread + i - 1);
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3textureMipmapGenerate(a3_TextureMipmapChain *chain_out, const a3_TexturePixelType pixelType, const a3ui32 width, const a3ui32 height, const void *data, const a3_TextureMipmapFilter filter, const a3boolean srgb, const a3ui32 threadCount)
+{
+	a3_TextureMipmapChain ret = { 0 };
+	a3_TextureMipmapJob job[1] = { 0 };
+	a3_ProfileZone zone[1];
+	a3f32 srgbTable[256];
+	a3ui32 pixelSize, threads, w, h, i;
+	a3boolean kernels = 1;
+
+	if (chain_out && width && height && data && (pixelType == a3tex_rgba8 || pixelType == a3tex_rgba16F || pixelType == a3tex_rgba32F))
+	{
+		if (!chain_out->data)
+		{
+			// level layout
+			pixelSize = pixelType == a3tex_rgba8 ? 4 : pixelType == a3tex_rgba16F ? 8 : 16;
+			for (w = width, h = height; ret.levels < a3tex_mipLevelMax; w = w > 1 ? w / 2 : 1, h = h > 1 ? h / 2 : 1)
+			{
+				ret.offset[ret.levels] = ret.size;
+				ret.width[ret.levels] = w;
+				ret.height[ret.levels] = h;
+				ret.size += w * h * pixelSize;
+				if (++ret.levels, w == 1 && h == 1)
+					break;
+			}
+			ret.pixelType = pixelType;
+
+			// output, two linear levels and intermediate result of
+			//	horizontal pass (next width, current height)
+			ret.data = malloc(ret.size);
+			job->level[0] = (a3f32 *)malloc(width * height * 4 * sizeof(a3f32));
+			job->level[1] = (a3f32 *)malloc(ret.width[1 % ret.levels] * ret.height[1 % ret.levels] * 4 * sizeof(a3f32));
+			job->tmp = (a3f32 *)malloc(ret.width[1 % ret.levels] * height * 4 * sizeof(a3f32));
+
+			// each level is filtered from the one before it
+			for (i = 1; i < ret.levels && kernels; ++i)
+				kernels = a3textureMipmapInternalCreateKernel(job->kernelH + i, filter, ret.width[i - 1], ret.width[i]) &&
+					a3textureMipmapInternalCreateKernel(job->kernelV + i, filter, ret.height[i - 1], ret.height[i]);
+
+			if (ret.data && job->level[0] && job->level[1] && job->tmp && kernels)
+			{
+				a3profileZoneBegin(zone, "a3textureMipmapGenerate");
+				memcpy(ret.data, data, width * height * pixelSize);
+				for (i = 0; i < 256; ++i)
+					srgbTable[i] = srgb ? a3textureMipmapInternalToLinear((a3f32)i / 255.0f) : (a3f32)i / 255.0f;
+				job->chain = &ret;
+				job->data = data;
+				job->pixelType = pixelType;
+				job->srgb = srgb;
+				job->srgbTable = srgbTable;
+
+				// small images are not worth waking threads for
+				threads = threadCount > 1 ? threadCount <= a3tex_stageThreadMax ? threadCount : a3tex_stageThreadMax : 1;
+				if (threads > width * height / a3tex_mipPixelsPerThread)
+					threads = width * height / a3tex_mipPixelsPerThread;
+				a3textureMipmapInternalRun(job, threads > 1 ? threads : 1);
+				a3profileZoneEnd(zone);
+			}
+			else
+			{
+				free(ret.data);
+				ret.data = 0;
+			}
+			for (i = 1; i < ret.levels; ++i)
+			{
+				free(job->kernelH[i].index);
+				free(job->kernelV[i].index);
+			}
+			free(job->level[0]);
+			free(job->level[1]);
+			free(job->tmp);
+
+			if (ret.data)
+			{
+				*chain_out = ret;
+				return ret.levels;
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+a3ret a3textureMipmapUpload(const a3_Texture *texture, const a3_TextureMipmapChain *chain)
+{
+	a3ui32 i;
+	if (texture && chain && chain->data)
+	{
+		for (i = 0; i < chain->levels; ++i)
+			if (a3textureReplaceDataLevel(texture, i, (const a3byte *)chain->data + chain->offset[i]) <= 0)
+				break;
+		return i;
+	}
+	return -1;
+}
+
+a3ret a3textureMipmapRelease(a3_TextureMipmapChain *chain)
+{
+	const a3_TextureMipmapChain reset = { 0 };
+	a3ui32 levels;
+	if (chain && chain->data)
+	{
+		levels = chain->levels;
+		free(chain->data);
+		*chain = reset;
+		return levels;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
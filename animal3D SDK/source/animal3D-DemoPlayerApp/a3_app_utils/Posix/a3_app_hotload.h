@@ -0,0 +1,116 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_app_hotload.h
+	Interface for demo library hot loading on POSIX platforms: the library
+		is watched for changes (inotify on Linux, file times elsewhere) and
+		each new build is loaded next to the old one before the callback
+		table is swapped.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#if !(defined _WINDOWS || defined _WIN32)
+#ifndef __ANIMAL3D_APP_HOTLOAD_H
+#define __ANIMAL3D_APP_HOTLOAD_H
+
+
+#include "a3_app_utils/a3_app_load.h"
+
+
+//-----------------------------------------------------------------------------
+// structures
+
+// A3: Hot loader for one demo library.
+//	member demo: demo whose library is watched; its callbacks and handle
+//		are kept in sync with the current table
+//	member record: descriptor of library and callbacks to link
+//	member table: callback tables of the current and previous builds
+//	member current: pointer to current table; swapped atomically
+//	member handle: library handle of each table
+//	member libPath: path of watched library
+//	members libTime, libSize: modification time and size of loaded build
+//	member notifyHandle: change notification descriptor; negative if
+//		changes are detected by checking file times
+//	member generation: number of builds loaded
+typedef struct tagA3_HOTLOADINTERFACE
+{
+	a3_DemoWindowInterface *demo;
+	a3_DemoDescriptor record[1];
+	a3_CallbackFunctions table[2];
+	a3_CallbackFunctions *volatile current;
+	void *handle[2];
+	a3byte libPath[256];
+	a3i64 libTime, libSize;
+	a3i32 notifyHandle;
+	a3ui32 generation;
+} a3_HotloadInterface;
+
+
+//-----------------------------------------------------------------------------
+// functions
+
+// A3: Load library and start watching it for changes.
+//	param hotload_out: non-null pointer to unused hot loader
+//	param demo: non-null pointer to demo interface without a library
+//	param record: non-null pointer to descriptor of library
+//	return: number of callbacks loaded if success
+//	return: 0 if fail (library not loaded)
+//	return: -1 if invalid params
+a3ret a3appHotloadCreate(a3_HotloadInterface *hotload_out, a3_DemoWindowInterface *demo, const a3_DemoDescriptor *record);
+
+// A3: Check for a new build of the library and reload it if there is one.
+//	param hotload: non-null pointer to hot loader
+//	return: 1 if reloaded
+//	return: 0 if no change, or new build failed to load (old one is kept)
+//	return: -1 if invalid params
+a3ret a3appHotloadPoll(a3_HotloadInterface *hotload);
+
+// A3: Reload library unconditionally: the new build is loaded and linked,
+//		the demo is unloaded with the old callbacks and loaded with the
+//		new ones (both as a hot build, so persistent data is handed over
+//		instead of recreated), then the tables are swapped. The previous
+//		build stays loaded until the next reload, so a thread still in one
+//		of its callbacks can return safely.
+//	param hotload: non-null pointer to hot loader
+//	return: number of callbacks loaded if success
+//	return: 0 if new build failed to load (old one is kept)
+//	return: -1 if invalid params
+a3ret a3appHotloadReload(a3_HotloadInterface *hotload);
+
+// A3: Get current callback table; safe to call from any thread.
+//	param hotload: non-null pointer to hot loader
+//	return: pointer to current table if success
+//	return: null if invalid params
+a3_CallbackFunctions const *a3appHotloadCallbacks(const a3_HotloadInterface *hotload);
+
+// A3: Stop watching and unload all builds; the demo should be unloaded
+//		first using the current callbacks.
+//	param hotload: non-null pointer to hot loader
+//	return: 1 if success
+//	return: -1 if invalid params
+a3ret a3appHotloadRelease(a3_HotloadInterface *hotload);
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// !__ANIMAL3D_APP_HOTLOAD_H
+#endif	// !(defined _WINDOWS || defined _WIN32)
@@ -0,0 +1,113 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_app_batch.h
+	Interface for running a demo without a window: the demo is loaded
+		headless and its idle callback is driven for a fixed number of
+		ticks, timing each one.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+
+#ifndef __ANIMAL3D_APP_BATCH_H
+#define __ANIMAL3D_APP_BATCH_H
+
+
+#include "a3_app_utils/a3_app_load.h"
+#include "a3types_real.h"
+
+
+//-----------------------------------------------------------------------------
+
+// environment variable that tells a demo there is no graphics context;
+//	demos read it when loaded and skip everything that needs a context
+#define A3_APP_HEADLESS_VAR	"A3_HEADLESS"
+
+// environment variables naming files a demo records input to or replays
+//	input from, starting when it is loaded
+#define A3_APP_INPUT_RECORD_VAR	"A3_INPUT_RECORD"
+#define A3_APP_INPUT_REPLAY_VAR	"A3_INPUT_REPLAY"
+
+// environment variables naming a golden file a demo compares its output 
+//	against or writes, and the tolerances of comparisons in ULP and as an 
+//	absolute difference
+#define A3_APP_GOLDEN_VAR		"A3_GOLDEN"
+#define A3_APP_GOLDEN_WRITE_VAR	"A3_GOLDEN_WRITE"
+#define A3_APP_GOLDEN_ULP_VAR	"A3_GOLDEN_ULP"
+#define A3_APP_GOLDEN_ABS_VAR	"A3_GOLDEN_ABS"
+
+
+// A3: Results of batch run.
+//	member ticks: number of ticks run
+//	members totalTime, minTime, maxTime: time spent in ticking idles (s)
+typedef struct tagA3_BATCHRESULT
+{
+	a3ui32 ticks;
+	a3f64 totalTime, minTime, maxTime;
+} a3_BatchResult;
+
+
+//-----------------------------------------------------------------------------
+// functions
+
+// A3: Set files that demos loaded after this call record input to or
+//		replay input from; replay is used if both are given.
+//	param recordPath_opt: optional path of file to record to; null or
+//		empty to not record
+//	param replayPath_opt: optional path of file to replay; null or empty
+//		to not replay
+//	return: 1 if success
+a3ret a3appBatchSetInputRecording(const a3byte *recordPath_opt, const a3byte *replayPath_opt);
+
+// A3: Set golden file that demos loaded after this call compare their 
+//		output against (failing the run on a mismatch) or write; 
+//		comparing is used if both are given.
+//	param comparePath_opt: optional path of file to compare against; null 
+//		or empty to not compare
+//	param writePath_opt: optional path of file to write; null or empty to 
+//		not write
+//	param ulpTolerance: largest difference of equal values in units in 
+//		the last place
+//	param absTolerance: largest absolute difference of equal values; 
+//		values within either tolerance are equal
+//	return: 1 if success
+a3ret a3appBatchSetGolden(const a3byte *comparePath_opt, const a3byte *writePath_opt, const a3ui32 ulpTolerance, const a3f64 absTolerance);
+
+// A3: Load demo headless, drive its idle callback until it has ticked the
+//		requested number of times (or asks to exit) and unload it; the
+//		time of each ticking idle is written as CSV ("tick,ms").
+//	param demo: non-null pointer to demo interface without a library
+//	param record: non-null pointer to descriptor of demo
+//	param tickCount: non-zero number of ticks to run
+//	param winSzX, winSzY: positive size reported to the demo as its window
+//	param csvPath_opt: optional path of CSV file; not written if null, 
+//		so that standard output only carries the demo's own messages
+//	param result_out_opt: optional pointer to capture summary of run
+//	return: number of ticks run if success
+//	return: 0 if fail (library not loaded or demo failed to load)
+//	return: -1 if invalid params
+a3ret a3appBatchRun(a3_DemoWindowInterface *demo, const a3_DemoDescriptor *record, const a3ui32 tickCount, const a3i32 winSzX, const a3i32 winSzY, const a3byte *csvPath_opt, a3_BatchResult *result_out_opt);
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// !__ANIMAL3D_APP_BATCH_H
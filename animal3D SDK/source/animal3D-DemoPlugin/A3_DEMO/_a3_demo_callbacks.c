@@ -41,6 +41,22 @@
 #include <string.h>
 
 
+// environment variable set by hosts without a graphics context
+#define A3_DEMO_HEADLESS_VAR	"A3_HEADLESS"
+
+// environment variables naming files to record input to or replay it from
+#define A3_DEMO_INPUT_RECORD_VAR	"A3_INPUT_RECORD"
+#define A3_DEMO_INPUT_REPLAY_VAR	"A3_INPUT_REPLAY"
+
+// environment variables naming a golden file to compare the scene update 
+//	against or to write, and the tolerances of comparisons in ULP and as 
+//	an absolute difference
+#define A3_DEMO_GOLDEN_VAR			"A3_GOLDEN"
+#define A3_DEMO_GOLDEN_WRITE_VAR	"A3_GOLDEN_WRITE"
+#define A3_DEMO_GOLDEN_ULP_VAR		"A3_GOLDEN_ULP"
+#define A3_DEMO_GOLDEN_ABS_VAR		"A3_GOLDEN_ABS"
+
+
 //-----------------------------------------------------------------------------
 // callback prototypes
 // NOTE: do not move to header; they should be private to this file
@@ -88,6 +104,10 @@ extern "C"
 void a3demo_input_keyCharPress(a3_DemoState* demoState, a3i32 const asciiKey);
 void a3demo_input_keyCharHold(a3_DemoState* demoState, a3i32 const asciiKey);
 
+// character key handlers, for live and replayed keys (below)
+void a3demo_keyCharPress(a3_DemoState* demoState, a3i32 const asciiKey);
+void a3demo_keyCharHold(a3_DemoState* demoState, a3i32 const asciiKey);
+
 // idle loop
 void a3demo_input(a3_DemoState* demoState, a3f64 const dt);
 void a3demo_update(a3_DemoState* demoState, a3f64 const dt);
@@ -99,8 +119,10 @@ void a3demo_render(a3_DemoState const* demoState, a3f64 const dt);
 // loading
 void a3demo_loadGeometry(a3_DemoState* demoState);
 void a3demo_loadShaders(a3_DemoState* demoState);
+void a3demo_reloadShaders(a3_DemoState* demoState);
 void a3demo_loadTextures(a3_DemoState* demoState);
 void a3demo_loadFramebuffers(a3_DemoState* demoState);
+void a3demo_loadValidateRelease(a3_DemoState* demoState);
 void a3demo_loadValidate(a3_DemoState* demoState);
 
 // unloading
@@ -109,6 +131,7 @@ void a3demo_unloadShaders(a3_DemoState* demoState);
 void a3demo_unloadTextures(a3_DemoState* demoState);
 void a3demo_unloadFramebuffers(a3_DemoState* demoState);
 void a3demo_unloadValidate(a3_DemoState const* demoState);
+void a3demo_unlink(a3_DemoState* demoState);
 
 
 //-----------------------------------------------------------------------------
@@ -125,6 +148,9 @@ void a3postproc_unload(a3_DemoState const* demoState, a3_DemoMode1_PostProc* dem
 void a3intro_unloadValidate(a3_DemoState const* demoState, a3_DemoMode0_Intro* demoMode);
 void a3postproc_unloadValidate(a3_DemoState const* demoState, a3_DemoMode1_PostProc* demoMode);
 
+void a3intro_unlink(a3_DemoState const* demoState, a3_DemoMode0_Intro* demoMode);
+void a3postproc_unlink(a3_DemoState const* demoState, a3_DemoMode1_PostProc* demoMode);
+
 
 //-----------------------------------------------------------------------------
 // miscellaneous functions
@@ -156,32 +182,144 @@ inline void a3demo_releaseText(a3_DemoState* demoState)
 }
 
 
-//-----------------------------------------------------------------------------
+// headless if the host has no graphics context; checked every load since 
+//	it depends on the host, not on the state
+inline a3boolean a3demo_isHeadless()
+{
+	a3byte const* headless = getenv(A3_DEMO_HEADLESS_VAR);
+	return (headless && *headless && *headless != '0');
+}
 
-void a3demo_load(a3_DemoState* demoState)
+
+// start recording or replaying input if the host asked for it; replay 
+//	wins if both are set
+inline void a3demo_initializeInputRecorder(a3_DemoState* demoState)
 {
-	// demo modes
-	demoState->demoModeCallbacksPtr = demoState->demoModeCallbacks + demoState->demoMode;
-	a3intro_load(demoState, demoState->demoMode0);
-	a3postproc_load(demoState, demoState->demoMode1);
+	a3byte const* replayPath = getenv(A3_DEMO_INPUT_REPLAY_VAR);
+	a3byte const* recordPath = getenv(A3_DEMO_INPUT_RECORD_VAR);
+	a3i32 count;
+	if (replayPath && *replayPath)
+	{
+		count = a3inputRecorderBeginReplay(demoState->inputRecorder, replayPath);
+		if (count > 0)
+			printf("\n A3 demo state: replaying %d ticks of input from %s \n", count, replayPath);
+	}
+	else if (recordPath && *recordPath)
+	{
+		if (a3inputRecorderBeginRecord(demoState->inputRecorder, recordPath) > 0)
+			printf("\n A3 demo state: recording input to %s \n", recordPath);
+	}
+}
 
 
-	// geometry
-	a3demo_loadGeometry(demoState);
+// compare the scene update against a golden file or write one if the host 
+//	asked for it; comparing wins if both are set
+inline void a3demo_initializeGolden(a3_DemoState* demoState)
+{
+	a3byte const* comparePath = getenv(A3_DEMO_GOLDEN_VAR);
+	a3byte const* writePath = getenv(A3_DEMO_GOLDEN_WRITE_VAR);
+	a3byte const* ulp = getenv(A3_DEMO_GOLDEN_ULP_VAR);
+	a3byte const* absolute = getenv(A3_DEMO_GOLDEN_ABS_VAR);
+	a3i32 count;
+	if (comparePath && *comparePath)
+	{
+		count = a3demo_beginGoldenCompare(demoState->golden, comparePath, 
+			(ulp && *ulp) ? (a3ui32)strtoul(ulp, 0, 10) : 4, (absolute && *absolute) ? strtod(absolute, 0) : 1.0e-5);
+		if (count > 0)
+			printf("\n A3 demo state: comparing %d blocks of scene output with %s (%u ULP or %g) \n", count, comparePath, demoState->golden->ulpTolerance, demoState->golden->absTolerance);
+		else
+			demoState->exitFlag = 1;
+	}
+	else if (writePath && *writePath)
+	{
+		if (a3demo_beginGoldenWrite(demoState->golden, writePath) > 0)
+			printf("\n A3 demo state: writing scene output to %s \n", writePath);
+	}
+}
+
+// write or compare every matrix of the active scene's objects and 
+//	projectors; a mismatch ends the demo so that the host can report it
+inline void a3demo_checkGoldenScene(a3_DemoState* demoState)
+{
+	a3_DemoGolden* const golden = demoState->golden;
+	a3ui32 const tick = (a3ui32)demoState->timer_display->ticks;
+	a3i32 result = 0;
+	if (golden->writing || golden->stream->contents)
+	{
+		switch (demoState->demoMode)
+		{
+		case demoState_modeIntro:
+			result |= a3demo_checkGolden(golden, tick, "intro.modelMatrixStack", 
+				demoState->demoMode0->modelMatrixStack->modelMat.mm, introMaxCount_sceneObject * sizeof(a3_ModelMatrixStack) / sizeof(a3real));
+			result |= a3demo_checkGolden(golden, tick, "intro.projectorMatrixStack", 
+				demoState->demoMode0->projectorMatrixStack->projectionMat.mm, introMaxCount_projector * sizeof(a3_ProjectorMatrixStack) / sizeof(a3real));
+			break;
+		case demoState_modePostProc:
+			result |= a3demo_checkGolden(golden, tick, "postproc.modelMatrixStack", 
+				demoState->demoMode1->modelMatrixStack->modelMat.mm, postprocMaxCount_sceneObject * sizeof(a3_ModelMatrixStack) / sizeof(a3real));
+			result |= a3demo_checkGolden(golden, tick, "postproc.projectorMatrixStack", 
+				demoState->demoMode1->projectorMatrixStack->projectionMat.mm, postprocMaxCount_projector * sizeof(a3_ProjectorMatrixStack) / sizeof(a3real));
+			break;
+		default:
+			break;
+		}
+#if !(defined A3_REAL_F64 || defined A3_REAL_F128)
+		// fluid fields are always floats, so only checked if reals are too
+		if (demoState->fluid->payload)
+			result |= a3demo_checkGolden(golden, tick, "fluid.density", 
+				demoState->fluid->payload, a3fluidGridGetPayloadCount(demoState->fluid));
+#endif	// !(defined A3_REAL_F64 || defined A3_REAL_F128)
+		if (demoState->particles->count)
+			result |= a3demo_checkGolden(golden, tick, "particles.positionY", 
+				demoState->particles->field[a3particle_positionY], demoState->particles->count);
+		if (result)
+			demoState->exitFlag = 1;
+	}
+}
 
-	// shaders
-	a3demo_loadShaders(demoState);
 
-	// textures
-	a3demo_loadTextures(demoState);
+// fluid simulation and its timer; a smoke-like setup: density fades and 
+//	neither density nor velocity diffuse beyond what advection does
+inline void a3demo_initializeFluid(a3_DemoState* demoState)
+{
+	if (a3fluidGridCreate(demoState->fluid, demoStateFluid_sizeX, demoStateFluid_sizeY, demoStateFluid_sizeZ) > 0)
+	{
+		demoState->fluid->iterations = demoStateFluid_iterations;
+		demoState->fluid->dissipation = 0.25f;
+		if (a3fluidMultigridCreate(demoState->fluidMultigrid, demoState->fluid, demoStateFluid_threads) > 0)
+		{
+			demoState->fluidMultigrid->cycles = demoStateFluid_cycles;
+			demoState->fluid->multigrid = demoState->fluidMultigrid;
+		}
+	}
+	a3timerSet(demoState->timer_fluid, demoStateFluid_rate);
+	a3timerStart(demoState->timer_fluid);
+}
 
 
-	// set flags
+// particle fluid and its timer; a dam break: a block of water against 
+//	one wall of the domain, 10 cm smoothing radius
+inline void a3demo_initializeParticles(a3_DemoState* demoState)
+{
+	a3real const boxMin[3] = { 0.0f, 0.0f, 0.0f };
+	a3real const boxMax[3] = { 0.8f, 0.6f, 1.6f };
+	if (a3particleFluidCreate(demoState->particles, demoStateParticle_capacity,
+		demoStateParticle_cellsX, demoStateParticle_cellsY, demoStateParticle_cellsZ, 0.1f, demoStateParticle_threads) > 0)
+		a3particleFluidAddBox(demoState->particles, boxMin, boxMax);
+	a3timerSet(demoState->timer_particles, demoStateParticle_rate);
+	a3timerStart(demoState->timer_particles);
+}
+
+
+// consistent display flags
+inline void a3demo_initializeFlags(a3_DemoState* demoState)
+{
 	demoState->displayGrid = a3true;
 	demoState->displayWorldAxes = a3true;
 	demoState->displayObjectAxes = a3true;
 	demoState->displayTangentBases = a3false;
 	demoState->displayWireframe = a3false;
+	demoState->displayFluid = a3false;
 	demoState->displaySkybox = a3true;
 	demoState->displayHiddenVolumes = a3true;
 	demoState->updateAnimation = a3true;
@@ -189,6 +327,166 @@ void a3demo_load(a3_DemoState* demoState)
 	demoState->skipIntermediatePasses = a3false;
 }
 
+
+//-----------------------------------------------------------------------------
+// persistent state sections
+
+// sections of the persistent state saved across hot builds
+// fields are matched by name when restoring, so adding, removing or moving 
+//	fields does not lose the rest of a section; change a field's size or 
+//	bump its section's version to have it reset instead
+// pointers that lead into the state are not saved; they are re-linked by 
+//	the validate functions after restoring
+enum a3_DemoState_SectionName
+{
+	demoState_sectionWindow,
+	demoState_sectionText,
+	demoState_sectionInput,
+	demoState_sectionTrig,
+	demoState_sectionTimer,
+	demoState_sectionModes,
+	demoState_sectionFlags,
+	demoState_sectionGeometry,
+	demoState_sectionShaders,
+	demoState_sectionTextures,
+	demoState_sectionFluid,
+	demoState_sectionParticles,
+
+	demoState_section_max
+};
+
+static const a3_SerializerField a3demo_fieldWindow[] = {
+	a3serializerField(a3_DemoState, streaming),
+	a3serializerField(a3_DemoState, windowWidth),
+	a3serializerField(a3_DemoState, windowHeight),
+	a3serializerField(a3_DemoState, windowWidthInv),
+	a3serializerField(a3_DemoState, windowHeightInv),
+	a3serializerField(a3_DemoState, windowAspect),
+	a3serializerField(a3_DemoState, frameWidth),
+	a3serializerField(a3_DemoState, frameHeight),
+	a3serializerField(a3_DemoState, frameWidthInv),
+	a3serializerField(a3_DemoState, frameHeightInv),
+	a3serializerField(a3_DemoState, frameAspect),
+	a3serializerField(a3_DemoState, frameBorder),
+};
+static const a3_SerializerField a3demo_fieldText[] = {
+	a3serializerField(a3_DemoState, textInit),
+	a3serializerField(a3_DemoState, textMode),
+	a3serializerField(a3_DemoState, text),
+};
+static const a3_SerializerField a3demo_fieldInput[] = {
+	a3serializerField(a3_DemoState, mouse),
+	a3serializerField(a3_DemoState, keyboard),
+	a3serializerField(a3_DemoState, xcontrol),
+	a3serializerField(a3_DemoState, inputRecorder),
+	a3serializerField(a3_DemoState, golden),
+};
+static const a3_SerializerField a3demo_fieldTrig[] = {
+	a3serializerField(a3_DemoState, trigTable),
+};
+static const a3_SerializerField a3demo_fieldTimer[] = {
+	a3serializerField(a3_DemoState, t_timer),
+	a3serializerField(a3_DemoState, dt_timer),
+	a3serializerField(a3_DemoState, dt_timer_tot),
+	a3serializerField(a3_DemoState, n_timer),
+	a3serializerField(a3_DemoState, timer),
+	a3serializerField(a3_DemoState, t_shaderPoll),
+};
+static const a3_SerializerField a3demo_fieldModes[] = {
+	a3serializerField(a3_DemoState, demoMode0),
+	a3serializerField(a3_DemoState, demoMode1),
+	a3serializerField(a3_DemoState, demoMode),
+};
+static const a3_SerializerField a3demo_fieldFlags[] = {
+	a3serializerField(a3_DemoState, displayGrid),
+	a3serializerField(a3_DemoState, displaySkybox),
+	a3serializerField(a3_DemoState, displayHiddenVolumes),
+	a3serializerField(a3_DemoState, displayWorldAxes),
+	a3serializerField(a3_DemoState, displayObjectAxes),
+	a3serializerField(a3_DemoState, displayTangentBases),
+	a3serializerField(a3_DemoState, displayWireframe),
+	a3serializerField(a3_DemoState, displayFluid),
+	a3serializerField(a3_DemoState, updateAnimation),
+	a3serializerField(a3_DemoState, stencilTest),
+	a3serializerField(a3_DemoState, skipIntermediatePasses),
+};
+static const a3_SerializerField a3demo_fieldGeometry[] = {
+	a3serializerField(a3_DemoState, drawDataBuffer),
+	a3serializerField(a3_DemoState, vertexArray),
+	a3serializerField(a3_DemoState, drawable),
+	a3serializerField(a3_DemoState, dummyDrawable),
+};
+static const a3_SerializerField a3demo_fieldShaders[] = {
+	a3serializerField(a3_DemoState, shaderProgram),
+	a3serializerField(a3_DemoState, shaderGraph),
+	a3serializerField(a3_DemoState, uniformBuffer),
+};
+static const a3_SerializerField a3demo_fieldTextures[] = {
+	a3serializerField(a3_DemoState, texture),
+};
+static const a3_SerializerField a3demo_fieldFluid[] = {
+	a3serializerField(a3_DemoState, fluid),
+	a3serializerField(a3_DemoState, fluidMultigrid),
+};
+static const a3_SerializerField a3demo_fieldParticles[] = {
+	a3serializerField(a3_DemoState, particles),
+};
+
+#define a3demo_section(name, fieldList)	{ name, 1, fieldList, sizeof(fieldList) / sizeof(*fieldList), 0 }
+static const a3_SerializerSection a3demo_sectionList[demoState_section_max] = {
+	a3demo_section("window", a3demo_fieldWindow),
+	a3demo_section("text", a3demo_fieldText),
+	a3demo_section("input", a3demo_fieldInput),
+	a3demo_section("trig", a3demo_fieldTrig),
+	a3demo_section("timer", a3demo_fieldTimer),
+	a3demo_section("modes", a3demo_fieldModes),
+	a3demo_section("flags", a3demo_fieldFlags),
+	a3demo_section("geometry", a3demo_fieldGeometry),
+	a3demo_section("shaders", a3demo_fieldShaders),
+	a3demo_section("textures", a3demo_fieldTextures),
+	a3demo_section("fluid", a3demo_fieldFluid),
+	a3demo_section("particles", a3demo_fieldParticles),
+};
+#undef a3demo_section
+
+
+//-----------------------------------------------------------------------------
+
+void a3demo_load(a3_DemoState* demoState)
+{
+	a3_ProfileZone zone[1];
+
+	// demo modes
+	demoState->demoModeCallbacksPtr = demoState->demoModeCallbacks + demoState->demoMode;
+	a3intro_load(demoState, demoState->demoMode0);
+	a3postproc_load(demoState, demoState->demoMode1);
+
+
+	// graphics objects are left empty without a context; every graphics 
+	//	utility skips objects that were not created
+	if (!demoState->headless)
+	{
+		// geometry
+		a3profileZoneBegin(zone, "a3demo_loadGeometry");
+		a3demo_loadGeometry(demoState);
+		a3profileZoneEnd(zone);
+
+		// shaders
+		a3profileZoneBegin(zone, "a3demo_loadShaders");
+		a3demo_loadShaders(demoState);
+		a3profileZoneEnd(zone);
+
+		// textures
+		a3profileZoneBegin(zone, "a3demo_loadTextures");
+		a3demo_loadTextures(demoState);
+		a3profileZoneEnd(zone);
+	}
+
+
+	// set flags
+	a3demo_initializeFlags(demoState);
+}
+
 void a3demo_unload(a3_DemoState* demoState)
 {
 	a3demo_unloadGeometry(demoState);
@@ -215,8 +513,150 @@ void a3demoMode_unloadValidate(a3_DemoState* demoState)
 	a3postproc_unloadValidate(demoState, demoState->demoMode1);
 }
 
+void a3demoMode_unlink(a3_DemoState* demoState)
+{
+	a3intro_unlink(demoState, demoState->demoMode0);
+	a3postproc_unlink(demoState, demoState->demoMode1);
+}
+
+// save persistent state for the next build; the returned serializer is 
+//	passed back in place of the state until the next build restores it
+// pointers that the next build re-links are cleared first, so a section 
+//	is only saved again if what it describes changed
+a3_Serializer* a3demo_saveState(a3_DemoState* demoState)
+{
+	a3_Serializer* persist = demoState->persist;
+	a3i32 count;
+
+	a3demo_unlink(demoState);
+	a3demoMode_unlink(demoState);
+
+	// first hot build: create serializer, which is kept from then on
+	if (!persist && (persist = (a3_Serializer*)malloc(sizeof(a3_Serializer))))
+	{
+		memset(persist, 0, sizeof(a3_Serializer));
+		a3serializerCreate(persist);
+	}
+	if (persist)
+	{
+		count = a3serializerSave(persist, demoState, a3demo_sectionList, demoState_section_max);
+		printf("\n A3 demo state: saved %d of %u sections. \n", count, demoState_section_max);
+	}
+	return persist;
+}
+
+// restore persistent state saved by the previous build, whose layout may 
+//	differ from this one; anything that could not be restored is set up 
+//	or loaded again
+// NOTE: graphics objects of sections that were only partly restored are 
+//	released before their section is loaded again
+a3_DemoState* a3demo_restoreState(a3_Serializer* persist, a3ui32 const stateSize, a3ui32 const trigSamplesPerDegree)
+{
+	a3boolean restored[demoState_section_max];
+	a3_DemoState* demoState = (a3_DemoState*)malloc(stateSize);
+	a3i32 count;
+
+	if (!demoState)
+		return 0;
+	memset(demoState, 0, stateSize);
+	count = a3serializerLoad(persist, demoState, a3demo_sectionList, demoState_section_max, restored);
+	demoState->persist = persist;
+	demoState->headless = a3demo_isHeadless();
+	printf("\n A3 demo state: restored %d of %u sections. \n", count, demoState_section_max);
+
+	// fixed objects
+	if (restored[demoState_sectionTrig])
+		a3trigInitSetTables(trigSamplesPerDegree, demoState->trigTable);
+	else
+		a3trigInit(trigSamplesPerDegree, demoState->trigTable);
+	if (!restored[demoState_sectionText])
+	{
+		a3serializerClear(demoState, a3demo_sectionList + demoState_sectionText);
+		if (!demoState->headless)
+		{
+			a3demo_initializeText(demoState);
+			demoState->textInit = a3true;
+		}
+		demoState->textMode = demoState_textControls;
+	}
+	if (!restored[demoState_sectionFlags])
+		a3demo_initializeFlags(demoState);
+	if (!restored[demoState_sectionTimer])
+	{
+		a3serializerClear(demoState, a3demo_sectionList + demoState_sectionTimer);
+		a3timerSet(demoState->timer_display, 30.0);
+		a3timerStart(demoState->timer_display);
+		a3timerSet(demoState->timer_fluid, demoStateFluid_rate);
+		a3timerStart(demoState->timer_fluid);
+		a3timerSet(demoState->timer_particles, demoStateParticle_rate);
+		a3timerStart(demoState->timer_particles);
+	}
+	if (!restored[demoState_sectionFluid])
+	{
+		a3serializerClear(demoState, a3demo_sectionList + demoState_sectionFluid);
+		a3demo_initializeFluid(demoState);
+	}
+	if (!restored[demoState_sectionParticles])
+	{
+		a3serializerClear(demoState, a3demo_sectionList + demoState_sectionParticles);
+		a3demo_initializeParticles(demoState);
+	}
+
+	// release what was restored of assets whose sections were not restored 
+	//	completely; their release callbacks must point into this build first
+	if (!demoState->headless && !(restored[demoState_sectionGeometry] && restored[demoState_sectionShaders] && restored[demoState_sectionTextures]))
+	{
+		a3demo_loadValidateRelease(demoState);
+		if (!restored[demoState_sectionGeometry])
+			a3demo_unloadGeometry(demoState);
+		if (!restored[demoState_sectionShaders])
+			a3demo_unloadShaders(demoState);
+		if (!restored[demoState_sectionTextures])
+			a3demo_unloadTextures(demoState);
+	}
+
+	// then load them again
+	if (!restored[demoState_sectionGeometry])
+	{
+		a3serializerClear(demoState, a3demo_sectionList + demoState_sectionGeometry);
+		if (!demoState->headless)
+			a3demo_loadGeometry(demoState);
+	}
+	if (!restored[demoState_sectionShaders])
+	{
+		a3serializerClear(demoState, a3demo_sectionList + demoState_sectionShaders);
+		if (!demoState->headless)
+			a3demo_loadShaders(demoState);
+	}
+	if (!restored[demoState_sectionTextures])
+	{
+		a3serializerClear(demoState, a3demo_sectionList + demoState_sectionTextures);
+		if (!demoState->headless)
+			a3demo_loadTextures(demoState);
+	}
+	if (!restored[demoState_sectionModes])
+	{
+		a3serializerClear(demoState, a3demo_sectionList + demoState_sectionModes);
+		demoState->demoMode = demoState_modePostProc;
+	}
+
+	// re-link pointers of restored and reloaded objects
+	a3demo_loadValidate(demoState);
+	a3demoMode_loadValidate(demoState);
+
+	// modes set up again use the pointers linked above
+	if (!restored[demoState_sectionModes])
+	{
+		a3intro_load(demoState, demoState->demoMode0);
+		a3postproc_load(demoState, demoState->demoMode1);
+	}
+	return demoState;
+}
+
 void a3demo_idle(a3_DemoState* demoState, a3f64 const dt)
 {
+	a3_ProfileZone zone[1];
+
 	// track updates
 	if (demoState->timer->totalTime > 2.0)
 	{
@@ -233,10 +673,48 @@ void a3demo_idle(a3_DemoState* demoState, a3f64 const dt)
 		demoState->t_timer = demoState->timer_display->totalTime;
 	}
 
+	// rebuild programs whose shader files changed, checked twice per second
+	if (!demoState->headless && demoState->timer_display->totalTime - demoState->t_shaderPoll >= 0.5)
+	{
+		demoState->t_shaderPoll = demoState->timer_display->totalTime;
+		a3profileZoneBegin(zone, "a3demo_reloadShaders");
+		a3demo_reloadShaders(demoState);
+		a3profileZoneEnd(zone);
+	}
+
+	// record or replay input before anything reads it; replayed character
+	//	keys go through the same handlers as live ones
+	if (a3inputRecorderTick(demoState->inputRecorder, demoState->keyboard, demoState->mouse, demoState->xcontrol) > 0 &&
+		demoState->inputRecorder->mode == a3input_recorderReplay)
+	{
+		a3ubyte const* key = demoState->inputRecorder->keyChar;
+		a3ubyte const* const end = key + demoState->inputRecorder->keyCharCount;
+		for (; key < end; ++key)
+		{
+			if (*key & 0x80)
+				a3demo_keyCharHold(demoState, *key & 0x7F);
+			else
+				a3demo_keyCharPress(demoState, *key);
+		}
+	}
+
 	// main idle loop
+	a3profileZoneBegin(zone, "a3demo_input");
 	a3demo_input(demoState, dt);
+	a3profileZoneEnd(zone);
+	a3profileZoneBegin(zone, "a3demo_update");
 	a3demo_update(demoState, dt);
-	a3demo_render(demoState, dt);
+	a3profileZoneEnd(zone);
+	a3demo_checkGoldenScene(demoState);
+	if (!demoState->headless)
+	{
+		a3profileZoneBegin(zone, "a3demo_render");
+		a3demo_render(demoState, dt);
+		a3profileZoneEnd(zone);
+	}
+
+	// write profiled zones from this frame
+	a3profilerFlush();
 
 	// update input (reset wheel)
 	a3mouseSetStateWheel(demoState->mouse, a3mws_neutral);
@@ -252,7 +730,7 @@ void a3demo_idle(a3_DemoState* demoState, a3f64 const dt)
 		if (a3XboxControlIsPressed(demoState->xcontrol, a3xbox_DPAD_down))
 			a3demoCtrlDecLoop(demoState->textMode, demoState_text_max);
 
-		if (a3XboxControlIsPressed(demoState->xcontrol, a3xbox_back))
+		if (a3XboxControlIsPressed(demoState->xcontrol, a3xbox_back) && !demoState->headless)
 		{
 			if (!a3textIsInitialized(demoState->text))
 			{
@@ -266,7 +744,7 @@ void a3demo_idle(a3_DemoState* demoState, a3f64 const dt)
 			}
 		}
 
-		if (a3XboxControlIsPressed(demoState->xcontrol, a3xbox_start))
+		if (a3XboxControlIsPressed(demoState->xcontrol, a3xbox_start) && !demoState->headless)
 		{
 			a3demo_unloadShaders(demoState);
 			a3demo_loadShaders(demoState);
@@ -285,7 +763,13 @@ A3DYLIBSYMBOL a3_DemoState *a3demoCB_load(a3_DemoState *demoState, a3boolean hot
 	a3ui32 const trigSamplesPerDegree = 4;
 	
 	// do any re-allocation tasks
-	if (demoState && hotbuild)
+	// sections saved by the previous build are restored field by field, 
+	//	so the layout of the state may have changed between builds
+	if (demoState && hotbuild && a3serializerCheck(demoState) > 0)
+	{
+		demoState = a3demo_restoreState((a3_Serializer*)demoState, stateSize, trigSamplesPerDegree);
+	}
+	else if (demoState && hotbuild)
 	{
 		// example 1: copy memory directly
 		a3_DemoState *demoState_copy = (a3_DemoState*)malloc(stateSize);
@@ -313,13 +797,17 @@ A3DYLIBSYMBOL a3_DemoState *a3demoCB_load(a3_DemoState *demoState, a3boolean hot
 	{
 		// reset state
 		memset(demoState, 0, stateSize);
+		demoState->headless = a3demo_isHeadless();
 
 		// set up trig table (A3DM)
 		a3trigInit(trigSamplesPerDegree, demoState->trigTable);
 
 		// text
-		a3demo_initializeText(demoState);
-		demoState->textInit = a3true;
+		if (!demoState->headless)
+		{
+			a3demo_initializeText(demoState);
+			demoState->textInit = a3true;
+		}
 		demoState->textMode = demoState_textControls;
 
 		// enable asset streaming between loads
@@ -329,7 +817,12 @@ A3DYLIBSYMBOL a3_DemoState *a3demoCB_load(a3_DemoState *demoState, a3boolean hot
 		a3fileStreamMakeDirectory("./data");
 
 		// set default GL state
-		a3demo_setDefaultGraphicsState();
+		if (!demoState->headless)
+			a3demo_setDefaultGraphicsState();
+
+		// fluids first, their textures are loaded with the others
+		a3demo_initializeFluid(demoState);
+		a3demo_initializeParticles(demoState);
 
 		// demo modes
 		demoState->demoMode = demoState_modePostProc;
@@ -340,6 +833,8 @@ A3DYLIBSYMBOL a3_DemoState *a3demoCB_load(a3_DemoState *demoState, a3boolean hot
 		// e.g. timer, thread, etc.
 		a3timerSet(demoState->timer_display, 30.0);
 		a3timerStart(demoState->timer_display);
+		a3demo_initializeInputRecorder(demoState);
+		a3demo_initializeGolden(demoState);
 	}
 
 	// return persistent state pointer
@@ -351,7 +846,8 @@ A3DYLIBSYMBOL a3_DemoState *a3demoCB_unload(a3_DemoState *demoState, a3boolean h
 {
 	// release things that need releasing always, whether hotbuilding or not
 	// e.g. kill thread
-	// nothing in this example, but then...
+	// finish trace capture, if any
+	a3profilerEndCapture();
 
 	// release persistent state if not hotbuilding
 	// good idea to release in reverse order that things were loaded...
@@ -373,12 +869,38 @@ A3DYLIBSYMBOL a3_DemoState *a3demoCB_unload(a3_DemoState *demoState, a3boolean h
 			a3demo_unloadValidate(demoState);
 
 			// erase other stuff
+			// a recording is saved when it ends
+			a3inputRecorderEnd(demoState->inputRecorder);
+			if (demoState->golden->mismatches)
+				printf("\n A3 demo state: scene output differs from %s (%u values, max %u ULP) \n", 
+					demoState->golden->filePath, demoState->golden->mismatches, demoState->golden->maxUlp);
+			a3demo_endGolden(demoState->golden);
+			a3fluidMultigridRelease(demoState->fluidMultigrid);
+			a3fluidGridRelease(demoState->fluid);
+			a3particleFluidRelease(demoState->particles);
 			a3trigFree();
+			if (demoState->persist)
+			{
+				a3serializerRelease(demoState->persist);
+				free(demoState->persist);
+			}
 
 			// erase persistent state
 			free(demoState);
 			demoState = 0;
 		}
+
+		// save sections of state for the next build and pass those on 
+		//	instead of the state itself (see load above)
+		else
+		{
+			a3_Serializer *persist = a3demo_saveState(demoState);
+			if (persist)
+			{
+				free(demoState);
+				demoState = (a3_DemoState*)persist;
+			}
+		}
 	}
 
 	// return state pointer
@@ -400,14 +922,17 @@ A3DYLIBSYMBOL a3i32 a3demoCB_idle(a3_DemoState *demoState)
 	// perform any idle tasks, such as rendering
 	if (!demoState->exitFlag)
 	{
-		if (a3timerUpdate(demoState->timer_display) > 0)
+		// headless: step exactly one tick per idle, so that runs are 
+		//	repeatable and go as fast as the host drives them
+		if ((demoState->headless ? a3timerStep(demoState->timer_display) : a3timerUpdate(demoState->timer_display)) > 0)
 		{
 			// render timer ticked, update demo state and draw
 			a3f64 const dt = demoState->timer_display->secondsPerTick;
 			a3demo_idle(demoState, dt);
 
 			// render occurred this idle: return +1
-			return +1;
+			// (unless the tick itself asked to exit, e.g. failed a check)
+			return (demoState->exitFlag ? -1 : +1);
 		}
 
 		// nothing happened this idle: return 0
@@ -467,11 +992,14 @@ A3DYLIBSYMBOL void a3demoCB_windowResize(a3_DemoState *demoState, a3i32 newWindo
 
 	// framebuffers should be initialized or re-initialized here 
 	//	since they are likely dependent on the window size
-	a3demo_unloadFramebuffers(demoState);
-	a3demo_loadFramebuffers(demoState);
+	if (!demoState->headless)
+	{
+		a3demo_unloadFramebuffers(demoState);
+		a3demo_loadFramebuffers(demoState);
 
-	// use framebuffer deactivate utility to set viewport
-	a3framebufferDeactivateSetViewport(a3fbo_depthDisable, -frameBorder, -frameBorder, demoState->frameWidth, demoState->frameHeight);
+		// use framebuffer deactivate utility to set viewport
+		a3framebufferDeactivateSetViewport(a3fbo_depthDisable, -frameBorder, -frameBorder, demoState->frameWidth, demoState->frameHeight);
+	}
 
 	// viewing info for projection matrix
 	a3demoMode_loadValidate(demoState);
@@ -500,7 +1028,29 @@ A3DYLIBSYMBOL void a3demoCB_keyRelease(a3_DemoState *demoState, a3i32 virtualKey
 
 // ASCII key is pressed (immediately preceded by "any key" pressed call above)
 // NOTE: there is no release counterpart
+// while input is replayed, live keys are ignored and the recorded ones are
+//	handled by the idle loop instead
 A3DYLIBSYMBOL void a3demoCB_keyCharPress(a3_DemoState *demoState, a3i32 asciiKey)
+{
+	if (demoState->inputRecorder->mode != a3input_recorderReplay)
+	{
+		a3inputRecorderKeyChar(demoState->inputRecorder, asciiKey, a3false);
+		a3demo_keyCharPress(demoState, asciiKey);
+	}
+}
+
+// ASCII key is held
+A3DYLIBSYMBOL void a3demoCB_keyCharHold(a3_DemoState *demoState, a3i32 asciiKey)
+{
+	if (demoState->inputRecorder->mode != a3input_recorderReplay)
+	{
+		a3inputRecorderKeyChar(demoState->inputRecorder, asciiKey, a3true);
+		a3demo_keyCharHold(demoState, asciiKey);
+	}
+}
+
+// handle ASCII key press
+void a3demo_keyCharPress(a3_DemoState* demoState, a3i32 const asciiKey)
 {
 	// persistent state update
 	a3keyboardSetStateASCII(demoState->keyboard, (a3byte)asciiKey);
@@ -538,6 +1088,18 @@ A3DYLIBSYMBOL void a3demoCB_keyCharPress(a3_DemoState *demoState, a3i32 asciiKey
 		a3demo_unloadShaders(demoState);
 		a3demo_loadShaders(demoState);
 		break;
+
+
+		// toggle profiler trace capture
+	case 'R':
+		if (!a3profilerIsCapturing())
+		{
+			if (a3profilerBeginCapture("./data/trace.json") > 0)
+				printf("\n Profiler capture started: './data/trace.json'");
+		}
+		else
+			printf("\n Profiler capture ended: %d zones written", a3profilerEndCapture());
+		break;
 	}
 
 
@@ -545,8 +1107,8 @@ A3DYLIBSYMBOL void a3demoCB_keyCharPress(a3_DemoState *demoState, a3i32 asciiKey
 	a3demo_input_keyCharPress(demoState, asciiKey);
 }
 
-// ASCII key is held
-A3DYLIBSYMBOL void a3demoCB_keyCharHold(a3_DemoState *demoState, a3i32 asciiKey)
+// handle ASCII key hold
+void a3demo_keyCharHold(a3_DemoState* demoState, a3i32 const asciiKey)
 {
 	// persistent state update
 	a3keyboardSetStateASCII(demoState->keyboard, (a3byte)asciiKey);
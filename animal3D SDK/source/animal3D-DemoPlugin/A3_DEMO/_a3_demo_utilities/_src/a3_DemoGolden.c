@@ -0,0 +1,293 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+	
+	a3_DemoGolden.c
+	Golden-output regression check implementations.
+*/
+
+#include "../a3_DemoGolden.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+
+//-----------------------------------------------------------------------------
+
+// golden file header; blocks follow, each a block header and its values
+typedef struct a3_DemoGoldenHeader
+{
+	a3ui32 tag, version, realSize, blocks;
+} a3_DemoGoldenHeader;
+
+// block header: tick it was written on, hash of its label, value count
+typedef struct a3_DemoGoldenBlock
+{
+	a3ui32 tick, labelHash, count;
+} a3_DemoGoldenBlock;
+
+// tag of file ("A3GD")
+#define A3_DEMOGOLDEN_TAG		0x44473341u
+#define A3_DEMOGOLDEN_VERSION	1u
+
+
+//-----------------------------------------------------------------------------
+
+// hash label so that blocks written in a different order are caught
+inline a3ui32 a3demo_goldenHash_internal(a3byte const* label)
+{
+	a3ui32 hash = 2166136261u;
+	while (*label)
+		hash = (hash ^ (a3ubyte)*(label++)) * 16777619u;
+	return hash;
+}
+
+// distance between two floats in units in the last place: bits are mapped 
+//	to integers that are ordered like the values, then subtracted
+inline a3ui32 a3demo_goldenUlp32_internal(a3f32 const a, a3f32 const b)
+{
+	a3i32 ia, ib;
+	a3i64 d;
+	if (a != a || b != b)
+		return (a != a && b != b) ? 0 : 0xFFFFFFFFu;
+	memcpy(&ia, &a, sizeof(ia));
+	memcpy(&ib, &b, sizeof(ib));
+	if (ia < 0)
+		ia = (a3i32)(0x80000000u - (a3ui32)ia);
+	if (ib < 0)
+		ib = (a3i32)(0x80000000u - (a3ui32)ib);
+	d = (a3i64)ia - (a3i64)ib;
+	return (a3ui32)(d < 0 ? -d : d);
+}
+
+inline a3ui32 a3demo_goldenUlp64_internal(a3f64 const a, a3f64 const b)
+{
+	a3i64 ia, ib;
+	a3ui64 d;
+	if (a != a || b != b)
+		return (a != a && b != b) ? 0 : 0xFFFFFFFFu;
+	memcpy(&ia, &a, sizeof(ia));
+	memcpy(&ib, &b, sizeof(ib));
+	if (ia < 0)
+		ia = (a3i64)(0x8000000000000000ull - (a3ui64)ia);
+	if (ib < 0)
+		ib = (a3i64)(0x8000000000000000ull - (a3ui64)ib);
+	d = ia > ib ? (a3ui64)ia - (a3ui64)ib : (a3ui64)ib - (a3ui64)ia;
+	return (d < 0xFFFFFFFFull ? (a3ui32)d : 0xFFFFFFFFu);
+}
+
+inline a3ui32 a3demo_goldenUlp_internal(a3real const a, a3real const b)
+{
+	if (sizeof(a3real) == sizeof(a3f32))
+		return a3demo_goldenUlp32_internal((a3f32)a, (a3f32)b);
+	return a3demo_goldenUlp64_internal((a3f64)a, (a3f64)b);
+}
+
+// make room for count more bytes of golden data
+inline a3boolean a3demo_goldenReserve_internal(a3_DemoGolden* golden, a3ui32 const count)
+{
+	a3ubyte* data;
+	a3ui32 capacity = golden->capacity;
+	if (golden->size + count > capacity)
+	{
+		while (golden->size + count > capacity)
+			capacity *= 2;
+		data = (a3ubyte*)realloc(golden->data, capacity);
+		if (!data)
+			return a3false;
+		golden->data = data;
+		golden->capacity = capacity;
+	}
+	return a3true;
+}
+
+inline a3ret a3demo_writeGolden_internal(a3_DemoGolden* golden, a3_DemoGoldenBlock const* block, a3real const* values)
+{
+	a3ui32 const valueSize = block->count * sizeof(a3real);
+	if (!a3demo_goldenReserve_internal(golden, sizeof(*block) + valueSize))
+	{
+		printf("\n A3 ERROR: Could not allocate golden data; writing stopped.");
+		return -1;
+	}
+	memcpy(golden->data + golden->size, block, sizeof(*block));
+	memcpy(golden->data + golden->size + sizeof(*block), values, valueSize);
+	golden->size += sizeof(*block) + valueSize;
+	++golden->blocks;
+	return 0;
+}
+
+inline a3ret a3demo_compareGolden_internal(a3_DemoGolden* golden, a3_DemoGoldenBlock const* block, a3byte const* label, a3real const* values)
+{
+	a3_Stream* const stream = golden->stream;
+	a3_DemoGoldenBlock stored;
+	a3real expected;
+	a3f64 diff;
+	a3ui32 i, ulp, result = 0;
+
+	// layout must match exactly; if it does not, nothing after it can be 
+	//	compared, so all remaining values count as mismatched
+	if (stream->offset + sizeof(stored) <= stream->length)
+		memcpy(&stored, stream->contents + stream->offset, sizeof(stored));
+	else
+		memset(&stored, 0, sizeof(stored));
+	if (stored.tick != block->tick || stored.labelHash != block->labelHash || stored.count != block->count ||
+		stream->offset + sizeof(stored) + stored.count * sizeof(a3real) > stream->length)
+	{
+		printf("\n A3 ERROR: Golden file %s does not match at tick %u, block \"%s\"; checking stopped.", golden->filePath, block->tick, label);
+		golden->mismatches += block->count;
+		golden->maxUlp = 0xFFFFFFFFu;
+		a3streamReleaseContents(stream);
+		return -1;
+	}
+	stream->offset += sizeof(stored);
+
+	for (i = 0; i < block->count; ++i, stream->offset += sizeof(a3real))
+	{
+		memcpy(&expected, stream->contents + stream->offset, sizeof(a3real));
+		ulp = a3demo_goldenUlp_internal(values[i], expected);
+		if (ulp > golden->maxUlp)
+			golden->maxUlp = ulp;
+
+		// equal if close in ULP, or close in value (near zero, a small 
+		//	difference is many ULP); NaN only equals NaN
+		diff = (a3f64)values[i] - (a3f64)expected;
+		if (ulp > golden->ulpTolerance && !(diff <= golden->absTolerance && -diff <= golden->absTolerance))
+		{
+			if (golden->mismatches < demoGolden_reportMax)
+				printf("\n A3 golden: tick %u, %s[%u] = %.9g, expected %.9g (%u ULP)", 
+					block->tick, label, i, (a3f64)values[i], (a3f64)expected, ulp);
+			++golden->mismatches;
+			++result;
+		}
+	}
+	++golden->blocks;
+	return result;
+}
+
+
+//-----------------------------------------------------------------------------
+
+extern inline a3ret a3demo_beginGoldenCompare(a3_DemoGolden* golden_out, a3byte const* filePath, a3ui32 const ulpTolerance, a3f64 const absTolerance)
+{
+	a3_DemoGoldenHeader header;
+	if (golden_out && filePath && *filePath)
+	{
+		if (!golden_out->data && !golden_out->stream->contents)
+		{
+			memset(golden_out, 0, sizeof(a3_DemoGolden));
+			if (a3streamLoadContents(golden_out->stream, filePath, 0) > 0)
+			{
+				if (golden_out->stream->length >= sizeof(header))
+				{
+					memcpy(&header, golden_out->stream->contents, sizeof(header));
+					if (header.tag == A3_DEMOGOLDEN_TAG && header.version == A3_DEMOGOLDEN_VERSION && header.realSize == sizeof(a3real))
+					{
+						golden_out->stream->offset = sizeof(header);
+						golden_out->ulpTolerance = ulpTolerance;
+						golden_out->absTolerance = absTolerance;
+						strncpy(golden_out->filePath, filePath, demoGolden_pathMax - 1);
+						return header.blocks;
+					}
+				}
+				printf("\n A3 ERROR: Not a golden file of this build: %s", filePath);
+				a3streamReleaseContents(golden_out->stream);
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+extern inline a3ret a3demo_beginGoldenWrite(a3_DemoGolden* golden_out, a3byte const* filePath)
+{
+	a3_DemoGoldenHeader const header = { A3_DEMOGOLDEN_TAG, A3_DEMOGOLDEN_VERSION, sizeof(a3real), 0 };
+	if (golden_out && filePath && *filePath)
+	{
+		if (!golden_out->data && !golden_out->stream->contents)
+		{
+			memset(golden_out, 0, sizeof(a3_DemoGolden));
+			golden_out->data = (a3ubyte*)malloc(65536);
+			if (golden_out->data)
+			{
+				golden_out->capacity = 65536;
+				memcpy(golden_out->data, &header, sizeof(header));
+				golden_out->size = sizeof(header);
+				strncpy(golden_out->filePath, filePath, demoGolden_pathMax - 1);
+				golden_out->writing = a3true;
+				return 1;
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+extern inline a3ret a3demo_checkGolden(a3_DemoGolden* golden, a3ui32 const tick, a3byte const* label, a3real const* values, a3ui32 const count)
+{
+	a3_DemoGoldenBlock block;
+	if (golden && label && values && count)
+	{
+		block.tick = tick;
+		block.labelHash = a3demo_goldenHash_internal(label);
+		block.count = count;
+		if (golden->writing && golden->data)
+			return a3demo_writeGolden_internal(golden, &block, values);
+		if (!golden->writing && golden->stream->contents)
+			return a3demo_compareGolden_internal(golden, &block, label, values);
+	}
+	return -1;
+}
+
+extern inline a3ret a3demo_endGolden(a3_DemoGolden* golden)
+{
+	a3_Stream stream = { 0 };
+	a3ret result = -1;
+	if (golden)
+	{
+		result = golden->mismatches;
+
+		// patch block count into header and save
+		if (golden->data)
+		{
+			memcpy(golden->data + offsetof(a3_DemoGoldenHeader, blocks), &golden->blocks, sizeof(a3ui32));
+			stream.contents = (a3byte const*)golden->data;
+			stream.length = golden->size;
+			if (a3streamSaveContents(&stream, golden->filePath) < 0)
+			{
+				printf("\n A3 ERROR: Could not save golden file: %s", golden->filePath);
+				result = -1;
+			}
+			free(golden->data);
+		}
+		if (golden->stream->contents)
+		{
+			// a shorter run than the one that wrote the file is fine
+			if (golden->stream->offset < golden->stream->length)
+				printf("\n A3 golden: %u blocks compared; rest of %s not reached.", golden->blocks, golden->filePath);
+			a3streamReleaseContents(golden->stream);
+		}
+		memset(golden, 0, sizeof(a3_DemoGolden));
+	}
+	return result;
+}
+
+
+//-----------------------------------------------------------------------------
\ No newline at end of file
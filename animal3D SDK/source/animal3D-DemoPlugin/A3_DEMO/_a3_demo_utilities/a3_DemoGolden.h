@@ -0,0 +1,108 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+	
+	a3_DemoGolden.h
+	Golden-output regression checks: values computed each tick (e.g. the 
+		scene's matrix stacks) are either written to a golden file or 
+		compared against one; values are equal if they are within a 
+		tolerance in units in the last place, or within an absolute 
+		tolerance (needed near zero, where ULP are tiny).
+*/
+
+#ifndef __ANIMAL3D_DEMOGOLDEN_H
+#define __ANIMAL3D_DEMOGOLDEN_H
+
+
+//-----------------------------------------------------------------------------
+// animal3D framework includes
+
+#include "animal3D/animal3D.h"
+#include "animal3D-A3DM/animal3D-A3DM.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+typedef struct a3_DemoGolden							a3_DemoGolden;
+#endif	// __cplusplus
+
+	
+//-----------------------------------------------------------------------------
+
+// golden file limits
+enum a3_DemoGoldenMax
+{
+	demoGolden_pathMax = 256,				// max length of file path
+	demoGolden_reportMax = 16,				// max mismatches printed in full
+};
+
+// golden file writer or checker
+struct a3_DemoGolden
+{
+	a3_Stream stream[1];					// golden file being compared against
+	a3ubyte* data;							// values recorded while writing
+	a3ui32 size, capacity;					// bytes used and allocated in data
+	a3ui32 ulpTolerance;					// max distance of equal values (ULP)
+	a3f64 absTolerance;						// max difference of equal values
+	a3ui32 blocks;							// number of blocks checked or written
+	a3ui32 mismatches;						// number of values out of tolerance
+	a3ui32 maxUlp;							// largest distance found (ULP)
+	a3boolean writing;						// writing (not comparing) flag
+	a3byte filePath[demoGolden_pathMax];	// file to save to when writing ends
+};
+
+
+//-----------------------------------------------------------------------------
+
+// start comparing against existing golden file; values are equal if they 
+//	are within either tolerance; returns number of blocks in file, 0 if 
+//	file could not be read or was written by a build with a different real 
+//	type, -1 if invalid params or golden in-use
+inline a3ret a3demo_beginGoldenCompare(a3_DemoGolden* golden_out, a3byte const* filePath, a3ui32 const ulpTolerance, a3f64 const absTolerance);
+
+// start writing new golden file, saved when ended; returns 1 if success, 
+//	0 if failed to allocate, -1 if invalid params or golden in-use
+inline a3ret a3demo_beginGoldenWrite(a3_DemoGolden* golden_out, a3byte const* filePath);
+
+// write or compare one labeled block of values for the given tick; blocks 
+//	must be checked in the same order as they were written; returns number 
+//	of values out of tolerance (0 if written or all equal), -1 if invalid 
+//	params, golden not in use or block does not match the file's layout 
+//	(checking stops)
+inline a3ret a3demo_checkGolden(a3_DemoGolden* golden, a3ui32 const tick, a3byte const* label, a3real const* values, a3ui32 const count);
+
+// stop writing or comparing; a golden file being written is saved first; 
+//	returns number of values out of tolerance, -1 if invalid param or file 
+//	could not be saved
+inline a3ret a3demo_endGolden(a3_DemoGolden* golden);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOGOLDEN_H
\ No newline at end of file
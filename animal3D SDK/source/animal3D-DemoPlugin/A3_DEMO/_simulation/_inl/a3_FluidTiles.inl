@@ -0,0 +1,78 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework Extended (A3DX)
+	By Daniel S. Buckstein
+
+	a3_FluidTiles.inl
+	Inline definitions for tiled storage; these are used in the inner loops
+		of passes, so only the cell lookup checks its params.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifdef __ANIMAL3D_A3DX_FLUIDTILES_H
+#ifndef __ANIMAL3D_A3DX_FLUIDTILES_INL
+#define __ANIMAL3D_A3DX_FLUIDTILES_INL
+
+
+//-----------------------------------------------------------------------------
+
+// A3: Get field of tile in slot: cells of x, then y, then z.
+A3_INLINE a3f32 *a3fluidTilesGetData(const a3_FluidTiles *tiles, const a3ui32 slot, const a3ui32 field)
+{
+	return (tiles->page[slot / a3fluid_tilePageSize] +
+		((slot % a3fluid_tilePageSize) * tiles->fieldCount + tiles->map[field]) * tiles->cellsPerTile);
+}
+
+// A3: Get cell origin of active tile.
+A3_INLINE void a3fluidTilesGetOrigin(const a3_FluidTiles *tiles, const a3ui32 index, a3ui32 origin_out[3])
+{
+	const a3ui32 tile = tiles->active[index];
+	origin_out[0] = tile % tiles->tilesX * a3fluid_tileWidth;
+	origin_out[1] = tile / tiles->tilesX % tiles->tilesY * a3fluid_tileWidth;
+	origin_out[2] = tile / (tiles->tilesX * tiles->tilesY) * tiles->tileDepth;
+}
+
+// A3: Get color of active tile: tiles sharing a face differ.
+A3_INLINE a3ui32 a3fluidTilesGetColor(const a3_FluidTiles *tiles, const a3ui32 index)
+{
+	const a3ui32 tile = tiles->active[index];
+	return ((tile % tiles->tilesX + tile / tiles->tilesX % tiles->tilesY + tile / (tiles->tilesX * tiles->tilesY)) & 1);
+}
+
+// A3: Get value of field in cell; cells of empty tiles and cells outside
+//		the domain read as background.
+A3_INLINE a3f32 a3fluidTilesGetCell(const a3_FluidTiles *tiles, const a3ui32 field, const a3ui32 x, const a3ui32 y, const a3ui32 z)
+{
+	a3i32 slot;
+	if (x < tiles->sizeX && y < tiles->sizeY && z < tiles->sizeZ)
+	{
+		slot = tiles->slot[x / a3fluid_tileWidth + tiles->tilesX * (y / a3fluid_tileWidth + tiles->tilesY * (z / tiles->tileDepth))];
+		if (slot >= 0)
+			return a3fluidTilesGetData(tiles, slot, field)[x % a3fluid_tileWidth +
+				a3fluid_tileWidth * (y % a3fluid_tileWidth + a3fluid_tileWidth * (z % tiles->tileDepth))];
+	}
+	return tiles->background[field];
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+#endif	// !__ANIMAL3D_A3DX_FLUIDTILES_INL
+#endif	// __ANIMAL3D_A3DX_FLUIDTILES_H
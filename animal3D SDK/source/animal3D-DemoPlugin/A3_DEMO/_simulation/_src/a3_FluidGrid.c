@@ -0,0 +1,844 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework Extended (A3DX)
+	By Daniel S. Buckstein
+
+	a3_FluidGrid.c
+	Fluid grid implementation, after Stam's "Real-Time Fluid Dynamics for
+		Games": cells are centered on integer coordinates, interior cells
+		run from 1 to size on each axis and the border mirrors them so
+		that the walls are solid.
+		Sparse grids run the same passes tile by tile: each tile is
+		gathered with its border into a block laid out like a grid of one
+		tile, so the stencils are the same as the dense ones. Relaxation
+		sweeps tiles of one color at a time (tiles sharing a face differ),
+		so that no tile reads a border that is being written. Cells
+		outside active tiles read as zero, which makes the edge of the
+		band open air (zero pressure) rather than a wall.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "../a3_FluidGrid.h"
+#include "../a3_FluidMultigrid.h"
+#include "../a3_FluidTiles.h"
+
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+// wall conditions: scalars are copied to the border, while the velocity
+//	component across a wall is negated so that none flows through it
+enum a3_FluidGridBound
+{
+	a3fluid_boundScalar,
+	a3fluid_boundX,
+	a3fluid_boundY,
+	a3fluid_boundZ,
+};
+
+
+// 2D grids have no border slices, so that the first slice is the interior
+inline a3ui32 a3fluidInternalIs3D(const a3_FluidGrid *grid)
+{
+	return (grid->sizeZ > 1);
+}
+
+inline a3ui32 a3fluidInternalIndex(const a3_FluidGrid *grid, const a3ui32 x, const a3ui32 y, const a3ui32 z)
+{
+	return (x + y * grid->strideY + z * grid->strideZ);
+}
+
+// cell size of unit domain
+inline a3f32 a3fluidInternalCellSize(const a3_FluidGrid *grid)
+{
+	a3ui32 size = grid->sizeX > grid->sizeY ? grid->sizeX : grid->sizeY;
+	size = size > grid->sizeZ ? size : grid->sizeZ;
+	return (1.0f / (a3f32)size);
+}
+
+inline void a3fluidInternalSwap(a3_FluidGrid *grid, const a3_FluidGridField a, const a3_FluidGridField b)
+{
+	a3f32 *const tmp = grid->field[a];
+	grid->field[a] = grid->field[b];
+	grid->field[b] = tmp;
+}
+
+inline void a3fluidInternalAddSource(const a3_FluidGrid *grid, a3f32 *x, const a3f32 *s, const a3f32 dt)
+{
+	a3ui32 i;
+	for (i = 0; i < grid->count; ++i)
+		x[i] += dt * s[i];
+}
+
+inline void a3fluidInternalSetBounds(const a3_FluidGrid *grid, a3f32 *x, const enum a3_FluidGridBound b)
+{
+	const a3ui32 nx = grid->sizeX, ny = grid->sizeY, nz = grid->sizeZ;
+	const a3ui32 slices = a3fluidInternalIs3D(grid) ? nz + 2 : 1;
+	const a3ui32 sy = grid->strideY, sz = grid->strideZ;
+	a3f32 s;
+	a3ui32 i, j, k, c;
+
+	// faces are set one axis after another, so edges and corners take
+	//	values of faces set before them
+	s = (b == a3fluid_boundX) ? -1.0f : 1.0f;
+	for (k = 0; k < slices; ++k)
+		for (j = 0, c = k * sz; j < ny + 2; ++j, c += sy)
+		{
+			x[c] = s * x[c + 1];
+			x[c + nx + 1] = s * x[c + nx];
+		}
+	s = (b == a3fluid_boundY) ? -1.0f : 1.0f;
+	for (k = 0; k < slices; ++k)
+		for (i = 0, c = k * sz; i < nx + 2; ++i, ++c)
+		{
+			x[c] = s * x[c + sy];
+			x[c + (ny + 1) * sy] = s * x[c + ny * sy];
+		}
+	if (a3fluidInternalIs3D(grid))
+	{
+		s = (b == a3fluid_boundZ) ? -1.0f : 1.0f;
+		for (c = 0; c < sz; ++c)
+		{
+			x[c] = s * x[c + sz];
+			x[c + (nz + 1) * sz] = s * x[c + nz * sz];
+		}
+	}
+}
+
+// relax x = (x0 + a * sum of neighbors of x) / c by Gauss-Seidel sweeps
+inline void a3fluidInternalLinearSolve(const a3_FluidGrid *grid, a3f32 *x, const a3f32 *x0, const a3f32 a, const a3f32 c, const enum a3_FluidGridBound b)
+{
+	const a3ui32 is3D = a3fluidInternalIs3D(grid);
+	const a3ui32 z0 = is3D, z1 = z0 + grid->sizeZ;
+	const a3ui32 sy = grid->strideY, sz = is3D ? grid->strideZ : 0;
+	const a3f32 zw = is3D ? 1.0f : 0.0f, cInv = 1.0f / c;
+	a3ui32 n, i, j, k, p;
+
+	for (n = 0; n < grid->iterations; ++n)
+	{
+		for (k = z0; k < z1; ++k)
+			for (j = 1; j <= grid->sizeY; ++j)
+				for (i = 1, p = a3fluidInternalIndex(grid, 1, j, k); i <= grid->sizeX; ++i, ++p)
+					x[p] = (x0[p] + a * (x[p - 1] + x[p + 1] + x[p - sy] + x[p + sy] + zw * (x[p - sz] + x[p + sz]))) * cInv;
+		a3fluidInternalSetBounds(grid, x, b);
+	}
+}
+
+inline void a3fluidInternalDiffuse(const a3_FluidGrid *grid, a3f32 *x, const a3f32 *x0, const a3f32 rate, const a3f32 dt, const enum a3_FluidGridBound b)
+{
+	const a3f32 h = a3fluidInternalCellSize(grid);
+	const a3f32 a = dt * rate / (h * h);
+	const a3f32 neighbors = a3fluidInternalIs3D(grid) ? 6.0f : 4.0f;
+	if (a > 0.0f)
+		a3fluidInternalLinearSolve(grid, x, x0, a, 1.0f + neighbors * a, b);
+	else
+		memcpy(x, x0, sizeof(a3f32) * grid->count);
+}
+
+// trace each cell back along velocity and sample the previous field there
+inline void a3fluidInternalAdvect(const a3_FluidGrid *grid, a3f32 *d, const a3f32 *d0, const a3f32 *u, const a3f32 *v, const a3f32 *w, const a3f32 dt, const enum a3_FluidGridBound b)
+{
+	const a3ui32 is3D = a3fluidInternalIs3D(grid);
+	const a3ui32 z0 = is3D, z1 = z0 + grid->sizeZ;
+	const a3ui32 sy = grid->strideY, sz = grid->strideZ;
+	const a3f32 dt0 = dt / a3fluidInternalCellSize(grid);
+	const a3f32 xMax = (a3f32)grid->sizeX + 0.5f, yMax = (a3f32)grid->sizeY + 0.5f, zMax = (a3f32)grid->sizeZ + 0.5f;
+	a3f32 x, y, z, s1, t1, r1;
+	a3ui32 i, j, k, p, q;
+
+	for (k = z0; k < z1; ++k)
+		for (j = 1; j <= grid->sizeY; ++j)
+			for (i = 1, p = a3fluidInternalIndex(grid, 1, j, k); i <= grid->sizeX; ++i, ++p)
+			{
+				x = (a3f32)i - dt0 * u[p];
+				y = (a3f32)j - dt0 * v[p];
+				x = x < 0.5f ? 0.5f : x > xMax ? xMax : x;
+				y = y < 0.5f ? 0.5f : y > yMax ? yMax : y;
+				s1 = x - (a3f32)(a3ui32)x;
+				t1 = y - (a3f32)(a3ui32)y;
+				q = a3fluidInternalIndex(grid, (a3ui32)x, (a3ui32)y, 0);
+				if (is3D)
+				{
+					z = (a3f32)k - dt0 * w[p];
+					z = z < 0.5f ? 0.5f : z > zMax ? zMax : z;
+					r1 = z - (a3f32)(a3ui32)z;
+					q += (a3ui32)z * sz;
+					d[p] = (1.0f - r1) * (
+						(1.0f - s1) * ((1.0f - t1) * d0[q] + t1 * d0[q + sy]) +
+						s1 * ((1.0f - t1) * d0[q + 1] + t1 * d0[q + 1 + sy])) + r1 * (
+						(1.0f - s1) * ((1.0f - t1) * d0[q + sz] + t1 * d0[q + sy + sz]) +
+						s1 * ((1.0f - t1) * d0[q + 1 + sz] + t1 * d0[q + 1 + sy + sz]));
+				}
+				else
+				{
+					d[p] =
+						(1.0f - s1) * ((1.0f - t1) * d0[q] + t1 * d0[q + sy]) +
+						s1 * ((1.0f - t1) * d0[q + 1] + t1 * d0[q + 1 + sy]);
+				}
+			}
+	a3fluidInternalSetBounds(grid, d, b);
+}
+
+// solve for pressure whose gradient removes divergence from velocity,
+//	then remove it
+inline void a3fluidInternalProject(a3_FluidGrid *grid)
+{
+	a3f32 *const u = grid->field[a3fluid_velocityX], *const v = grid->field[a3fluid_velocityY], *const w = grid->field[a3fluid_velocityZ];
+	a3f32 *const p = grid->field[a3fluid_pressure], *const div = grid->field[a3fluid_divergence];
+	const a3ui32 is3D = a3fluidInternalIs3D(grid);
+	const a3ui32 z0 = is3D, z1 = z0 + grid->sizeZ;
+	const a3ui32 sy = grid->strideY, sz = is3D ? grid->strideZ : 0;
+	const a3f32 zw = is3D ? 1.0f : 0.0f;
+	const a3f32 h = a3fluidInternalCellSize(grid), hHalf = 0.5f * h, hHalfInv = 0.5f / h;
+	a3ui32 i, j, k, c;
+
+	for (k = z0; k < z1; ++k)
+		for (j = 1; j <= grid->sizeY; ++j)
+			for (i = 1, c = a3fluidInternalIndex(grid, 1, j, k); i <= grid->sizeX; ++i, ++c)
+			{
+				div[c] = -hHalf * (u[c + 1] - u[c - 1] + v[c + sy] - v[c - sy] + zw * (w[c + sz] - w[c - sz]));
+				p[c] = 0.0f;
+			}
+	a3fluidInternalSetBounds(grid, div, a3fluid_boundScalar);
+	a3fluidInternalSetBounds(grid, p, a3fluid_boundScalar);
+	if (grid->multigrid)
+		a3fluidMultigridSolve(grid->multigrid, grid);
+	else
+		a3fluidInternalLinearSolve(grid, p, div, 1.0f, is3D ? 6.0f : 4.0f, a3fluid_boundScalar);
+
+	for (k = z0; k < z1; ++k)
+		for (j = 1; j <= grid->sizeY; ++j)
+			for (i = 1, c = a3fluidInternalIndex(grid, 1, j, k); i <= grid->sizeX; ++i, ++c)
+			{
+				u[c] -= hHalfInv * (p[c + 1] - p[c - 1]);
+				v[c] -= hHalfInv * (p[c + sy] - p[c - sy]);
+				w[c] -= zw * hHalfInv * (p[c + sz] - p[c - sz]);
+			}
+	a3fluidInternalSetBounds(grid, u, a3fluid_boundX);
+	a3fluidInternalSetBounds(grid, v, a3fluid_boundY);
+	a3fluidInternalSetBounds(grid, w, a3fluid_boundZ);
+}
+
+inline void a3fluidInternalStepVelocity(a3_FluidGrid *grid, const a3f32 dt)
+{
+	a3ui32 n;
+
+	// add sources, then diffuse from the result into velocity
+	for (n = 0; n < 3; ++n)
+	{
+		a3fluidInternalAddSource(grid, grid->field[a3fluid_velocityX + n], grid->field[a3fluid_velocityXSource + n], dt);
+		a3fluidInternalSwap(grid, a3fluid_velocityX + n, a3fluid_velocityXSource + n);
+		a3fluidInternalDiffuse(grid, grid->field[a3fluid_velocityX + n], grid->field[a3fluid_velocityXSource + n], grid->viscosity, dt, a3fluid_boundX + n);
+	}
+	a3fluidInternalProject(grid);
+
+	// move velocity along itself and project again
+	for (n = 0; n < 3; ++n)
+		a3fluidInternalSwap(grid, a3fluid_velocityX + n, a3fluid_velocityXSource + n);
+	for (n = 0; n < 3; ++n)
+		a3fluidInternalAdvect(grid, grid->field[a3fluid_velocityX + n], grid->field[a3fluid_velocityXSource + n],
+			grid->field[a3fluid_velocityXSource], grid->field[a3fluid_velocityYSource], grid->field[a3fluid_velocityZSource], dt, a3fluid_boundX + n);
+	a3fluidInternalProject(grid);
+}
+
+inline void a3fluidInternalStepDensity(a3_FluidGrid *grid, const a3f32 dt)
+{
+	a3f32 *d;
+	a3f32 fade;
+	a3ui32 i;
+
+	a3fluidInternalAddSource(grid, grid->field[a3fluid_density], grid->field[a3fluid_densitySource], dt);
+	a3fluidInternalSwap(grid, a3fluid_density, a3fluid_densitySource);
+	a3fluidInternalDiffuse(grid, grid->field[a3fluid_density], grid->field[a3fluid_densitySource], grid->diffusion, dt, a3fluid_boundScalar);
+	a3fluidInternalSwap(grid, a3fluid_density, a3fluid_densitySource);
+	a3fluidInternalAdvect(grid, grid->field[a3fluid_density], grid->field[a3fluid_densitySource],
+		grid->field[a3fluid_velocityX], grid->field[a3fluid_velocityY], grid->field[a3fluid_velocityZ], dt, a3fluid_boundScalar);
+
+	// fade
+	if (grid->dissipation > 0.0f)
+	{
+		d = grid->field[a3fluid_density];
+		fade = 1.0f / (1.0f + dt * grid->dissipation);
+		for (i = 0; i < grid->count; ++i)
+			d[i] *= fade;
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+
+// fields that keep tiles of sparse grids active: density and all sources;
+//	projection spreads velocity through the whole domain, so it is only
+//	carried inside the band
+#define a3fluid_sparseBandMask	((1 << a3fluid_density) | (1 << a3fluid_densitySource) | \
+	(1 << a3fluid_velocityXSource) | (1 << a3fluid_velocityYSource) | (1 << a3fluid_velocityZSource))
+
+
+// arguments of a pass over the active tiles of a sparse grid
+typedef struct a3_FluidGridTilePass
+{
+	const a3_FluidGrid *grid;
+	a3ui32 x, x0;				// fields written and read
+	a3ui32 u;					// first velocity component to trace along
+	enum a3_FluidGridBound b;
+	a3f32 a, cInv, dt;
+} a3_FluidGridTilePass;
+
+
+inline a3f32 *a3fluidInternalTileData(const a3_FluidTiles *tiles, const a3ui32 index, const a3ui32 field)
+{
+	return a3fluidTilesGetData(tiles, tiles->slot[tiles->active[index]], field);
+}
+
+// cell of sparse field on the bordered grid, 0 to size + 1 on each axis
+//	(z is 0 in 2D); the border mirrors the interior like
+//	a3fluidInternalSetBounds does
+inline a3f32 a3fluidInternalSparseCell(const a3_FluidTiles *tiles, const a3ui32 field, const enum a3_FluidGridBound b, a3ui32 x, a3ui32 y, a3ui32 z)
+{
+	a3f32 s = 1.0f;
+	if (x < 1 || x > tiles->sizeX)
+	{
+		x = x < 1 ? 1 : tiles->sizeX;
+		s = (b == a3fluid_boundX) ? -s : s;
+	}
+	if (y < 1 || y > tiles->sizeY)
+	{
+		y = y < 1 ? 1 : tiles->sizeY;
+		s = (b == a3fluid_boundY) ? -s : s;
+	}
+	if (tiles->sizeZ > 1)
+	{
+		if (z < 1 || z > tiles->sizeZ)
+		{
+			z = z < 1 ? 1 : tiles->sizeZ;
+			s = (b == a3fluid_boundZ) ? -s : s;
+		}
+		--z;
+	}
+	return s * a3fluidTilesGetCell(tiles, field, x - 1, y - 1, z);
+}
+
+inline void a3fluidInternalAddSourceTile(const a3_FluidTiles *tiles, const a3ui32 index, const a3_FluidGridTilePass *pass)
+{
+	a3f32 *const x = a3fluidInternalTileData(tiles, index, pass->x);
+	const a3f32 *const s = a3fluidInternalTileData(tiles, index, pass->x0);
+	a3ui32 c;
+	for (c = 0; c < tiles->cellsPerTile; ++c)
+		x[c] += pass->dt * s[c];
+}
+
+inline void a3fluidInternalCopyTile(const a3_FluidTiles *tiles, const a3ui32 index, const a3_FluidGridTilePass *pass)
+{
+	memcpy(a3fluidInternalTileData(tiles, index, pass->x), a3fluidInternalTileData(tiles, index, pass->x0), sizeof(a3f32) * tiles->cellsPerTile);
+}
+
+inline void a3fluidInternalClearTile(const a3_FluidTiles *tiles, const a3ui32 index, const a3_FluidGridTilePass *pass)
+{
+	a3ui32 n;
+	(void)pass;
+	for (n = a3fluid_densitySource; n <= a3fluid_velocityZSource; ++n)
+		memset(a3fluidInternalTileData(tiles, index, n), 0, sizeof(a3f32) * tiles->cellsPerTile);
+}
+
+inline void a3fluidInternalFadeTile(const a3_FluidTiles *tiles, const a3ui32 index, const a3_FluidGridTilePass *pass)
+{
+	a3f32 *const d = a3fluidInternalTileData(tiles, index, a3fluid_density);
+	a3ui32 c;
+	for (c = 0; c < tiles->cellsPerTile; ++c)
+		d[c] *= pass->a;
+}
+
+// one Gauss-Seidel sweep over a tile, as a3fluidInternalLinearSolve
+inline void a3fluidInternalLinearSolveTile(const a3_FluidTiles *tiles, const a3ui32 index, const a3_FluidGridTilePass *pass)
+{
+	const a3ui32 is3D = tiles->sizeZ > 1, k1 = is3D + tiles->tileDepth;
+	const a3ui32 sy = a3fluid_tileBlockWidth, sz = is3D ? sy * sy : 0;
+	const a3f32 zw = is3D ? 1.0f : 0.0f, a = pass->a, cInv = pass->cInv;
+	const a3f32 *const x0 = a3fluidInternalTileData(tiles, index, pass->x0);
+	a3f32 x[a3fluid_tileBlockCount];
+	a3ui32 i, j, k, p, c;
+
+	a3fluidTilesGather(tiles, index, pass->x, (a3_FluidTilesBound)pass->b, x);
+	for (k = is3D, c = 0; k < k1; ++k)
+		for (j = 1; j <= a3fluid_tileWidth; ++j)
+			for (i = 1, p = 1 + j * sy + k * sy * sy; i <= a3fluid_tileWidth; ++i, ++p, ++c)
+				x[p] = (x0[c] + a * (x[p - 1] + x[p + 1] + x[p - sy] + x[p + sy] + zw * (x[p - sz] + x[p + sz]))) * cInv;
+	a3fluidTilesScatter(tiles, index, pass->x, x);
+}
+
+// trace each cell of a tile back, as a3fluidInternalAdvect; the previous
+//	field is sampled anywhere in the domain, so it is looked up cell by cell
+inline void a3fluidInternalAdvectTile(const a3_FluidTiles *tiles, const a3ui32 index, const a3_FluidGridTilePass *pass)
+{
+	const a3ui32 is3D = tiles->sizeZ > 1, f = pass->x0;
+	const enum a3_FluidGridBound b = pass->b;
+	const a3f32 *const u = a3fluidInternalTileData(tiles, index, pass->u);
+	const a3f32 *const v = a3fluidInternalTileData(tiles, index, pass->u + 1);
+	const a3f32 *const w = a3fluidInternalTileData(tiles, index, pass->u + 2);
+	a3f32 *const d = a3fluidInternalTileData(tiles, index, pass->x);
+	const a3f32 dt0 = pass->dt / a3fluidInternalCellSize(pass->grid);
+	const a3f32 xMax = (a3f32)tiles->sizeX + 0.5f, yMax = (a3f32)tiles->sizeY + 0.5f, zMax = (a3f32)tiles->sizeZ + 0.5f;
+	a3f32 x, y, z, s1, t1, r1, d0, d1;
+	a3ui32 origin[3], i, j, k, c, qx, qy, qz;
+
+	a3fluidTilesGetOrigin(tiles, index, origin);
+	for (k = 0, c = 0; k < tiles->tileDepth; ++k)
+		for (j = 1; j <= a3fluid_tileWidth; ++j)
+			for (i = 1; i <= a3fluid_tileWidth; ++i, ++c)
+			{
+				x = (a3f32)(origin[0] + i) - dt0 * u[c];
+				y = (a3f32)(origin[1] + j) - dt0 * v[c];
+				x = x < 0.5f ? 0.5f : x > xMax ? xMax : x;
+				y = y < 0.5f ? 0.5f : y > yMax ? yMax : y;
+				qx = (a3ui32)x;
+				qy = (a3ui32)y;
+				s1 = x - (a3f32)qx;
+				t1 = y - (a3f32)qy;
+				qz = 0;
+				r1 = 0.0f;
+				if (is3D)
+				{
+					z = (a3f32)(origin[2] + k + 1) - dt0 * w[c];
+					z = z < 0.5f ? 0.5f : z > zMax ? zMax : z;
+					qz = (a3ui32)z;
+					r1 = z - (a3f32)qz;
+				}
+				d0 =
+					(1.0f - s1) * ((1.0f - t1) * a3fluidInternalSparseCell(tiles, f, b, qx, qy, qz) + t1 * a3fluidInternalSparseCell(tiles, f, b, qx, qy + 1, qz)) +
+					s1 * ((1.0f - t1) * a3fluidInternalSparseCell(tiles, f, b, qx + 1, qy, qz) + t1 * a3fluidInternalSparseCell(tiles, f, b, qx + 1, qy + 1, qz));
+				if (is3D)
+				{
+					d1 =
+						(1.0f - s1) * ((1.0f - t1) * a3fluidInternalSparseCell(tiles, f, b, qx, qy, qz + 1) + t1 * a3fluidInternalSparseCell(tiles, f, b, qx, qy + 1, qz + 1)) +
+						s1 * ((1.0f - t1) * a3fluidInternalSparseCell(tiles, f, b, qx + 1, qy, qz + 1) + t1 * a3fluidInternalSparseCell(tiles, f, b, qx + 1, qy + 1, qz + 1));
+					d[c] = (1.0f - r1) * d0 + r1 * d1;
+				}
+				else
+					d[c] = d0;
+			}
+}
+
+// divergence of a tile and pressure cleared, as a3fluidInternalProject
+inline void a3fluidInternalDivergenceTile(const a3_FluidTiles *tiles, const a3ui32 index, const a3_FluidGridTilePass *pass)
+{
+	const a3ui32 is3D = tiles->sizeZ > 1, k1 = is3D + tiles->tileDepth;
+	const a3ui32 sy = a3fluid_tileBlockWidth, sz = is3D ? sy * sy : 0;
+	const a3f32 zw = is3D ? 1.0f : 0.0f, hHalf = 0.5f * a3fluidInternalCellSize(pass->grid);
+	a3f32 *const div = a3fluidInternalTileData(tiles, index, a3fluid_divergence);
+	a3f32 u[a3fluid_tileBlockCount], v[a3fluid_tileBlockCount], w[a3fluid_tileBlockCount];
+	a3ui32 i, j, k, p, c;
+
+	a3fluidTilesGather(tiles, index, a3fluid_velocityX, a3fluid_tileBoundX, u);
+	a3fluidTilesGather(tiles, index, a3fluid_velocityY, a3fluid_tileBoundY, v);
+	a3fluidTilesGather(tiles, index, a3fluid_velocityZ, a3fluid_tileBoundZ, w);
+	for (k = is3D, c = 0; k < k1; ++k)
+		for (j = 1; j <= a3fluid_tileWidth; ++j)
+			for (i = 1, p = 1 + j * sy + k * sy * sy; i <= a3fluid_tileWidth; ++i, ++p, ++c)
+				div[c] = -hHalf * (u[p + 1] - u[p - 1] + v[p + sy] - v[p - sy] + zw * (w[p + sz] - w[p - sz]));
+	memset(a3fluidInternalTileData(tiles, index, a3fluid_pressure), 0, sizeof(a3f32) * tiles->cellsPerTile);
+}
+
+// remove pressure gradient from velocity of a tile
+inline void a3fluidInternalGradientTile(const a3_FluidTiles *tiles, const a3ui32 index, const a3_FluidGridTilePass *pass)
+{
+	const a3ui32 is3D = tiles->sizeZ > 1, k1 = is3D + tiles->tileDepth;
+	const a3ui32 sy = a3fluid_tileBlockWidth, sz = is3D ? sy * sy : 0;
+	const a3f32 zw = is3D ? 1.0f : 0.0f, hHalfInv = 0.5f / a3fluidInternalCellSize(pass->grid);
+	a3f32 *const u = a3fluidInternalTileData(tiles, index, a3fluid_velocityX);
+	a3f32 *const v = a3fluidInternalTileData(tiles, index, a3fluid_velocityY);
+	a3f32 *const w = a3fluidInternalTileData(tiles, index, a3fluid_velocityZ);
+	a3f32 p[a3fluid_tileBlockCount];
+	a3ui32 i, j, k, q, c;
+
+	a3fluidTilesGather(tiles, index, a3fluid_pressure, a3fluid_tileBoundScalar, p);
+	for (k = is3D, c = 0; k < k1; ++k)
+		for (j = 1; j <= a3fluid_tileWidth; ++j)
+			for (i = 1, q = 1 + j * sy + k * sy * sy; i <= a3fluid_tileWidth; ++i, ++q, ++c)
+			{
+				u[c] -= hHalfInv * (p[q + 1] - p[q - 1]);
+				v[c] -= hHalfInv * (p[q + sy] - p[q - sy]);
+				w[c] -= zw * hHalfInv * (p[q + sz] - p[q - sz]);
+			}
+}
+
+inline void a3fluidInternalSparsePass(const a3_FluidGrid *grid, const a3_FluidGridTilePass *pass, const a3_FluidTilesKernel kernel, const a3i32 color)
+{
+	a3fluidTilesForEach(grid->tiles, kernel, (void *)pass, color);
+}
+
+inline void a3fluidInternalSparseLinearSolve(const a3_FluidGrid *grid, const a3ui32 x, const a3ui32 x0, const a3f32 a, const a3f32 c, const enum a3_FluidGridBound b)
+{
+	const a3_FluidGridTilePass pass = { grid, x, x0, 0, b, a, 1.0f / c, 0.0f };
+	const a3_FluidTilesPass list[2] = {
+		{ (a3_FluidTilesKernel)a3fluidInternalLinearSolveTile, (void *)&pass, 0 },
+		{ (a3_FluidTilesKernel)a3fluidInternalLinearSolveTile, (void *)&pass, 1 },
+	};
+
+	// every sweep of both colors on one launch of the threads
+	a3fluidTilesForEachList(grid->tiles, list, 2, grid->iterations);
+}
+
+inline void a3fluidInternalSparseDiffuse(const a3_FluidGrid *grid, const a3ui32 x, const a3ui32 x0, const a3f32 rate, const a3f32 dt, const enum a3_FluidGridBound b)
+{
+	const a3f32 h = a3fluidInternalCellSize(grid);
+	const a3f32 a = dt * rate / (h * h);
+	const a3f32 neighbors = a3fluidInternalIs3D(grid) ? 6.0f : 4.0f;
+	const a3_FluidGridTilePass pass = { grid, x, x0, 0, b, 0.0f, 0.0f, 0.0f };
+	if (a > 0.0f)
+		a3fluidInternalSparseLinearSolve(grid, x, x0, a, 1.0f + neighbors * a, b);
+	else
+		a3fluidInternalSparsePass(grid, &pass, (a3_FluidTilesKernel)a3fluidInternalCopyTile, -1);
+}
+
+inline void a3fluidInternalSparseAdvect(const a3_FluidGrid *grid, const a3ui32 d, const a3ui32 d0, const a3ui32 u, const a3f32 dt, const enum a3_FluidGridBound b)
+{
+	const a3_FluidGridTilePass pass = { grid, d, d0, u, b, 0.0f, 0.0f, dt };
+	a3fluidInternalSparsePass(grid, &pass, (a3_FluidTilesKernel)a3fluidInternalAdvectTile, -1);
+}
+
+// advect all velocity components on one launch of the threads
+inline void a3fluidInternalSparseAdvectVelocity(const a3_FluidGrid *grid, const a3f32 dt)
+{
+	a3_FluidGridTilePass pass[3] = { 0 };
+	a3_FluidTilesPass list[3];
+	a3ui32 n;
+	for (n = 0; n < 3; ++n)
+	{
+		pass[n].grid = grid;
+		pass[n].x = a3fluid_velocityX + n;
+		pass[n].x0 = a3fluid_velocityXSource + n;
+		pass[n].u = a3fluid_velocityXSource;
+		pass[n].b = a3fluid_boundX + n;
+		pass[n].dt = dt;
+		list[n].kernel = (a3_FluidTilesKernel)a3fluidInternalAdvectTile;
+		list[n].arg = pass + n;
+		list[n].color = -1;
+	}
+	a3fluidTilesForEachList(grid->tiles, list, 3, 1);
+}
+
+inline void a3fluidInternalSparseProject(a3_FluidGrid *grid)
+{
+	a3_FluidGridTilePass pass = { 0 };
+	pass.grid = grid;
+	a3fluidInternalSparsePass(grid, &pass, (a3_FluidTilesKernel)a3fluidInternalDivergenceTile, -1);
+	if (grid->multigrid)
+		a3fluidMultigridSolve(grid->multigrid, grid);
+	else
+		a3fluidInternalSparseLinearSolve(grid, a3fluid_pressure, a3fluid_divergence, 1.0f, a3fluidInternalIs3D(grid) ? 6.0f : 4.0f, a3fluid_boundScalar);
+	a3fluidInternalSparsePass(grid, &pass, (a3_FluidTilesKernel)a3fluidInternalGradientTile, -1);
+}
+
+inline void a3fluidInternalSparseStep(a3_FluidGrid *grid, const a3f32 dt)
+{
+	a3_FluidGridTilePass pass = { 0 };
+	a3ui32 n;
+	pass.grid = grid;
+
+	// fit the band around density and new sources; it reaches a tile past
+	//	them, so density does not move out of it in one step
+	a3fluidTilesUpdateBand(grid->tiles, a3fluid_sparseBandMask);
+
+	// velocity, as a3fluidInternalStepVelocity
+	for (n = 0; n < 3; ++n)
+	{
+		pass.x = a3fluid_velocityX + n;
+		pass.x0 = a3fluid_velocityXSource + n;
+		pass.dt = dt;
+		a3fluidInternalSparsePass(grid, &pass, (a3_FluidTilesKernel)a3fluidInternalAddSourceTile, -1);
+		a3fluidTilesSwap(grid->tiles, a3fluid_velocityX + n, a3fluid_velocityXSource + n);
+		a3fluidInternalSparseDiffuse(grid, a3fluid_velocityX + n, a3fluid_velocityXSource + n, grid->viscosity, dt, a3fluid_boundX + n);
+	}
+	a3fluidInternalSparseProject(grid);
+	for (n = 0; n < 3; ++n)
+		a3fluidTilesSwap(grid->tiles, a3fluid_velocityX + n, a3fluid_velocityXSource + n);
+	a3fluidInternalSparseAdvectVelocity(grid, dt);
+	a3fluidInternalSparseProject(grid);
+
+	// density, as a3fluidInternalStepDensity
+	pass.x = a3fluid_density;
+	pass.x0 = a3fluid_densitySource;
+	a3fluidInternalSparsePass(grid, &pass, (a3_FluidTilesKernel)a3fluidInternalAddSourceTile, -1);
+	a3fluidTilesSwap(grid->tiles, a3fluid_density, a3fluid_densitySource);
+	a3fluidInternalSparseDiffuse(grid, a3fluid_density, a3fluid_densitySource, grid->diffusion, dt, a3fluid_boundScalar);
+	a3fluidTilesSwap(grid->tiles, a3fluid_density, a3fluid_densitySource);
+	a3fluidInternalSparseAdvect(grid, a3fluid_density, a3fluid_densitySource, a3fluid_velocityX, dt, a3fluid_boundScalar);
+	if (grid->dissipation > 0.0f)
+	{
+		pass.a = 1.0f / (1.0f + dt * grid->dissipation);
+		a3fluidInternalSparsePass(grid, &pass, (a3_FluidTilesKernel)a3fluidInternalFadeTile, -1);
+	}
+
+	// sources were used as scratch space
+	a3fluidInternalSparsePass(grid, &pass, (a3_FluidTilesKernel)a3fluidInternalClearTile, -1);
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3fluidGridCreate(a3_FluidGrid *grid_out, const a3ui32 sizeX, const a3ui32 sizeY, const a3ui32 sizeZ)
+{
+	a3ui32 slices, fieldSize, n;
+	a3f32 *data;
+	if (grid_out && sizeX && sizeY && sizeZ)
+	{
+		if (!grid_out->field[0] && !grid_out->tiles)
+		{
+			// one block for all fields, then the payload
+			slices = sizeZ > 1 ? sizeZ + 2 : 1;
+			fieldSize = (sizeX + 2) * (sizeY + 2) * slices;
+			data = (a3f32 *)malloc(sizeof(a3f32) * (fieldSize * a3fluid_fieldMax + sizeX * sizeY * sizeZ));
+			if (data)
+			{
+				memset(data, 0, sizeof(a3f32) * (fieldSize * a3fluid_fieldMax + sizeX * sizeY * sizeZ));
+				for (n = 0; n < a3fluid_fieldMax; ++n)
+					grid_out->field[n] = data + n * fieldSize;
+				grid_out->payload = data + a3fluid_fieldMax * fieldSize;
+				grid_out->multigrid = 0;
+				grid_out->tiles = 0;
+				grid_out->sizeX = sizeX;
+				grid_out->sizeY = sizeY;
+				grid_out->sizeZ = sizeZ;
+				grid_out->strideY = sizeX + 2;
+				grid_out->strideZ = (sizeX + 2) * (sizeY + 2);
+				grid_out->count = fieldSize;
+				grid_out->viscosity = 0.0f;
+				grid_out->diffusion = 0.0f;
+				grid_out->dissipation = 0.0f;
+				grid_out->iterations = 20;
+				grid_out->steps = 0;
+				return (sizeX * sizeY * sizeZ);
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+a3ret a3fluidGridCreateSparse(a3_FluidGrid *grid_out, a3_FluidTiles *tiles)
+{
+	a3ui32 n;
+	if (grid_out && tiles && tiles->data && tiles->fieldCount >= a3fluid_sparseFieldMax)
+	{
+		if (!grid_out->field[0] && !grid_out->tiles)
+		{
+			// empty tiles are at rest, so everything is
+			memset(grid_out, 0, sizeof(a3_FluidGrid));
+			for (n = 0; n < a3fluid_sparseFieldMax; ++n)
+				tiles->background[n] = 0.0f;
+			a3fluidTilesReset(tiles);
+			grid_out->tiles = tiles;
+			grid_out->sizeX = tiles->sizeX;
+			grid_out->sizeY = tiles->sizeY;
+			grid_out->sizeZ = tiles->sizeZ;
+			grid_out->iterations = 20;
+			return (tiles->sizeX * tiles->sizeY * tiles->sizeZ);
+		}
+	}
+	return -1;
+}
+
+a3ret a3fluidGridReset(a3_FluidGrid *grid)
+{
+	a3ui32 n;
+	if (grid && grid->field[0])
+	{
+		for (n = 0; n < a3fluid_fieldMax; ++n)
+			memset(grid->field[n], 0, sizeof(a3f32) * grid->count);
+		grid->steps = 0;
+		return 1;
+	}
+	else if (grid && grid->tiles)
+	{
+		a3fluidTilesReset(grid->tiles);
+		grid->steps = 0;
+		return 1;
+	}
+	return -1;
+}
+
+a3ret a3fluidGridAddSource(a3_FluidGrid *grid, const a3f32 position[3], const a3f32 radius, const a3f32 density, const a3f32 velocity_opt[3])
+{
+	const a3ui32 is3D = grid ? a3fluidInternalIs3D(grid) : 0;
+	a3f32 h, r, cx, cy, cz, dx, dy, dz, d2, r2Inv, weight;
+	a3f32 *d, *u, *v, *w;
+	a3i32 x0, x1, y0, y1, z0, z1, x, y, z, slot;
+	a3ui32 c, tile, ret = 0;
+	if (grid && (grid->field[0] || grid->tiles) && position && radius > 0.0f)
+	{
+		// center and radius in cells; interior cell i is centered at i
+		h = a3fluidInternalCellSize(grid);
+		r = radius / h;
+		r2Inv = 1.0f / (r * r);
+		cx = position[0] / h + 0.5f;
+		cy = position[1] / h + 0.5f;
+		cz = is3D ? position[2] / h + 0.5f : 0.0f;
+		x0 = (a3i32)(cx - r);
+		x1 = (a3i32)(cx + r) + 1;
+		y0 = (a3i32)(cy - r);
+		y1 = (a3i32)(cy + r) + 1;
+		z0 = is3D ? (a3i32)(cz - r) : 0;
+		z1 = is3D ? (a3i32)(cz + r) + 1 : 0;
+		x0 = x0 < 1 ? 1 : x0;
+		y0 = y0 < 1 ? 1 : y0;
+		z0 = z0 < 1 && is3D ? 1 : z0;
+		x1 = x1 > (a3i32)grid->sizeX ? (a3i32)grid->sizeX : x1;
+		y1 = y1 > (a3i32)grid->sizeY ? (a3i32)grid->sizeY : y1;
+		z1 = z1 > (a3i32)grid->sizeZ && is3D ? (a3i32)grid->sizeZ : z1;
+
+		for (z = z0; z <= z1; ++z)
+			for (y = y0; y <= y1; ++y)
+				for (x = x0; x <= x1; ++x)
+				{
+					dx = (a3f32)x - cx;
+					dy = (a3f32)y - cy;
+					dz = (a3f32)z - cz;
+					d2 = (dx * dx + dy * dy + dz * dz) * r2Inv;
+					if (d2 < 1.0f)
+					{
+						weight = 1.0f - d2;
+						if (grid->tiles)
+						{
+							// sources activate the tiles they touch
+							tile = (x - 1) / a3fluid_tileWidth + grid->tiles->tilesX * ((y - 1) / a3fluid_tileWidth +
+								grid->tiles->tilesY * (is3D ? (z - 1) / a3fluid_tileWidth : 0));
+							slot = a3fluidTilesActivate(grid->tiles, tile);
+							if (slot < 0)
+								continue;
+							d = a3fluidTilesGetData(grid->tiles, slot, a3fluid_densitySource);
+							u = a3fluidTilesGetData(grid->tiles, slot, a3fluid_velocityXSource);
+							v = a3fluidTilesGetData(grid->tiles, slot, a3fluid_velocityYSource);
+							w = a3fluidTilesGetData(grid->tiles, slot, a3fluid_velocityZSource);
+							c = (x - 1) % a3fluid_tileWidth + a3fluid_tileWidth * ((y - 1) % a3fluid_tileWidth +
+								a3fluid_tileWidth * (is3D ? (z - 1) % a3fluid_tileWidth : 0));
+						}
+						else
+						{
+							d = grid->field[a3fluid_densitySource];
+							u = grid->field[a3fluid_velocityXSource];
+							v = grid->field[a3fluid_velocityYSource];
+							w = grid->field[a3fluid_velocityZSource];
+							c = a3fluidInternalIndex(grid, x, y, z);
+						}
+						d[c] += weight * density;
+						if (velocity_opt)
+						{
+							u[c] += weight * velocity_opt[0];
+							v[c] += weight * velocity_opt[1];
+							if (is3D)
+								w[c] += weight * velocity_opt[2];
+						}
+						++ret;
+					}
+				}
+		return ret;
+	}
+	return -1;
+}
+
+a3ret a3fluidGridStep(a3_FluidGrid *grid, const a3f32 dt)
+{
+	a3ui32 n;
+	if (grid && grid->tiles && dt > 0.0f)
+	{
+		a3fluidInternalSparseStep(grid, dt);
+		return ++grid->steps;
+	}
+	else if (grid && grid->field[0] && dt > 0.0f)
+	{
+		a3fluidInternalStepVelocity(grid, dt);
+		a3fluidInternalStepDensity(grid, dt);
+
+		// sources were used as scratch space; clear for the next step
+		for (n = a3fluid_densitySource; n <= a3fluid_velocityZSource; ++n)
+			memset(grid->field[n], 0, sizeof(a3f32) * grid->count);
+		return ++grid->steps;
+	}
+	return -1;
+}
+
+const a3f32 *a3fluidGridUpdatePayload(a3_FluidGrid *grid)
+{
+	const a3f32 *d;
+	a3f32 *payload;
+	a3ui32 origin[3], n, j, k, z0;
+	if (grid && grid->tiles)
+	{
+		// large sparse domains may never be packed, so the payload is only
+		//	allocated once asked for; empty tiles hold no density
+		if (!grid->payload)
+			grid->payload = (a3f32 *)malloc(sizeof(a3f32) * grid->sizeX * grid->sizeY * grid->sizeZ);
+		if (grid->payload)
+		{
+			memset(grid->payload, 0, sizeof(a3f32) * grid->sizeX * grid->sizeY * grid->sizeZ);
+			for (n = 0; n < grid->tiles->activeCount; ++n)
+			{
+				d = a3fluidInternalTileData(grid->tiles, n, a3fluid_density);
+				a3fluidTilesGetOrigin(grid->tiles, n, origin);
+				for (k = 0; k < grid->tiles->tileDepth; ++k)
+					for (j = 0; j < a3fluid_tileWidth; ++j, d += a3fluid_tileWidth)
+						memcpy(grid->payload + origin[0] + grid->sizeX * (origin[1] + j + grid->sizeY * (origin[2] + k)), d, sizeof(a3f32) * a3fluid_tileWidth);
+			}
+		}
+		return grid->payload;
+	}
+	else if (grid && grid->field[0])
+	{
+		d = grid->field[a3fluid_density];
+		payload = grid->payload;
+		z0 = a3fluidInternalIs3D(grid);
+		for (k = 0; k < grid->sizeZ; ++k)
+			for (j = 1; j <= grid->sizeY; ++j, payload += grid->sizeX)
+				memcpy(payload, d + a3fluidInternalIndex(grid, 1, j, k + z0), sizeof(a3f32) * grid->sizeX);
+		return grid->payload;
+	}
+	return 0;
+}
+
+a3ret a3fluidGridGetPayloadCount(const a3_FluidGrid *grid)
+{
+	if (grid && (grid->field[0] || grid->tiles))
+		return (grid->sizeX * grid->sizeY * grid->sizeZ);
+	return -1;
+}
+
+a3ret a3fluidGridRelease(a3_FluidGrid *grid)
+{
+	if (grid && grid->tiles)
+	{
+		free(grid->payload);
+		memset(grid, 0, sizeof(a3_FluidGrid));
+		return 1;
+	}
+	else if (grid && grid->field[0])
+	{
+		// fields may have been swapped since they were allocated, but the
+		//	payload still ends their block
+		free(grid->payload - a3fluid_fieldMax * grid->count);
+		memset(grid, 0, sizeof(a3_FluidGrid));
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
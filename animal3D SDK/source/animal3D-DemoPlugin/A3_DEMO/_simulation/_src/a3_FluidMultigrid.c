@@ -0,0 +1,991 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework Extended (A3DX)
+	By Daniel S. Buckstein
+
+	a3_FluidMultigrid.c
+	Multigrid implementation: the pressure equation of the fluid grid,
+		(neighbors * x - sum of neighbors of x) = b with mirrored borders,
+		is smoothed on each level, its residual is averaged into the next
+		level and the error solved there is interpolated back (trilinear
+		between cell centers). Coarse cells are twice as wide, so restricted
+		residuals are scaled by four to keep the same unit stencil.
+		Odd axes are halved rounding up, the last coarse cell reaching
+		half a cell past the wall.
+		All threads run the whole solve in step, meeting at a barrier after
+		each phase; each phase only writes the slab of the thread, and
+		only reads other slabs once they are done.
+		Sparse levels run the same phases over active tiles, which threads
+		claim one at a time; each tile is gathered with its border, and
+		smoothing visits tiles of one color at a time so that no border is
+		written while it is read. Cells outside active tiles are zero, as
+		they are open air; only a fully active grid has mirrored borders
+		all around and needs the mean removed on the coarsest level.
+		Coarse tiles are whole wherever any of their children is active,
+		so they also store a mask of cells whose children are all active;
+		the others are held at zero, keeping the edge of the air inside
+		the one of the finer level (otherwise the coarse correction
+		overshoots, and cycles diverge on large domains).
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "../a3_FluidMultigrid.h"
+#include "../a3_FluidTiles.h"
+#include "animal3D/a3utility/a3_Thread.h"
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+
+// default settings
+enum a3_FluidMultigridSetting
+{
+	a3fluid_multigridPreSmooth = 2,
+	a3fluid_multigridPostSmooth = 2,
+	a3fluid_multigridCoarseSweeps = 32,
+	a3fluid_multigridCycles = 4,
+	a3fluid_multigridSizeMin = 4,		// levels with fewer cells on an axis are not halved again
+};
+
+
+// range of cells owned by one thread: slices in 3D, rows of the only
+//	slice in 2D
+typedef struct a3_FluidMultigridSlab
+{
+	a3ui32 k0, k1, j0, j1;
+} a3_FluidMultigridSlab;
+
+// thread arguments
+typedef struct a3_FluidMultigridWorker
+{
+	a3_FluidMultigrid *multigrid;
+	a3ui32 index, threadCount;
+} a3_FluidMultigridWorker;
+
+
+inline a3ui32 a3fluidMultigridInternalIs3D(const a3_FluidMultigridLevel *level)
+{
+	return (level->sizeZ > 1);
+}
+
+inline void a3fluidMultigridInternalSetLevel(a3_FluidMultigridLevel *level, const a3ui32 sizeX, const a3ui32 sizeY, const a3ui32 sizeZ)
+{
+	level->sizeX = sizeX;
+	level->sizeY = sizeY;
+	level->sizeZ = sizeZ;
+	level->strideY = sizeX + 2;
+	level->strideZ = (sizeX + 2) * (sizeY + 2);
+	level->count = level->strideZ * (sizeZ > 1 ? sizeZ + 2 : 1);
+}
+
+inline void a3fluidMultigridInternalGetSlab(const a3_FluidMultigridLevel *level, const a3ui32 index, const a3ui32 threadCount, a3_FluidMultigridSlab *slab_out)
+{
+	const a3ui32 is3D = a3fluidMultigridInternalIs3D(level);
+	const a3ui32 rows = is3D ? level->sizeZ : level->sizeY;
+	const a3ui32 s0 = 1 + rows * index / threadCount, s1 = 1 + rows * (index + 1) / threadCount;
+	slab_out->k0 = is3D ? s0 : 0;
+	slab_out->k1 = is3D ? s1 : 1;
+	slab_out->j0 = is3D ? 1 : s0;
+	slab_out->j1 = is3D ? level->sizeY + 1 : s1;
+}
+
+// all threads wait here until the last one arrives
+inline void a3fluidMultigridInternalBarrier(a3_FluidMultigrid *multigrid, const a3ui32 threadCount)
+{
+	const a3i32 generation = multigrid->barrierGeneration;
+	if (threadCount > 1)
+	{
+		if (a3atomicIncrement(&multigrid->barrierCount) == (a3i32)threadCount)
+		{
+			multigrid->barrierCount = 0;
+			a3atomicIncrement(&multigrid->barrierGeneration);
+		}
+		else while (multigrid->barrierGeneration == generation)
+			a3threadYield();
+	}
+}
+
+// threads wait here until the number of threads that launched is known
+inline a3ui32 a3fluidMultigridInternalStart(a3_FluidMultigridWorker *worker)
+{
+	while (!worker->multigrid->started)
+		a3threadYield();
+	return worker->threadCount;
+}
+
+// launch helper threads, then release them all with the number that 
+//	actually started; a thread that fails to launch never reaches the 
+//	barrier, so it must not be counted
+inline a3ui32 a3fluidMultigridInternalLaunch(a3_FluidMultigrid *multigrid, a3_Thread *thread, a3_FluidMultigridWorker *worker, const a3ui32 threadCount, a3_threadfunc func)
+{
+	a3ui32 i, n;
+	multigrid->started = 0;
+	multigrid->barrierCount = 0;
+	multigrid->barrierGeneration = 0;
+	for (i = 0; i < threadCount; ++i)
+	{
+		worker[i].multigrid = multigrid;
+		worker[i].index = i;
+	}
+	for (n = 1; n < threadCount; ++n)
+		if (a3threadLaunch(thread + n - 1, func, worker + n, "animal3D multigrid") <= 0)
+			break;
+	for (i = 0; i < n; ++i)
+		worker[i].threadCount = n;
+	a3atomicIncrement(&multigrid->started);
+	return n;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// mirror border of a slab like a3fluidInternalSetBounds does for scalars;
+//	borders only depend on cells of the same slab, so they are set by its
+//	owner right after writing it
+void a3fluidMultigridInternalSetBoundsSlab(const a3_FluidMultigridLevel *level, a3f32 *x, const a3_FluidMultigridSlab *slab)
+{
+	const a3ui32 nx = level->sizeX, ny = level->sizeY, nz = level->sizeZ;
+	const a3ui32 sy = level->strideY, sz = level->strideZ;
+	a3ui32 i, j, k, c;
+
+	// empty slabs of threads left without work on coarse levels own nothing
+	if (slab->j0 == slab->j1)
+		return;
+	for (k = slab->k0; k < slab->k1; ++k)
+	{
+		for (j = slab->j0, c = j * sy + k * sz; j < slab->j1; ++j, c += sy)
+		{
+			x[c] = x[c + 1];
+			x[c + nx + 1] = x[c + nx];
+		}
+		if (slab->j0 == 1)
+			for (i = 0, c = k * sz; i < nx + 2; ++i, ++c)
+				x[c] = x[c + sy];
+		if (slab->j1 == ny + 1)
+			for (i = 0, c = (ny + 1) * sy + k * sz; i < nx + 2; ++i, ++c)
+				x[c] = x[c - sy];
+	}
+	if (a3fluidMultigridInternalIs3D(level))
+	{
+		if (slab->k0 == 1 && slab->k1 > 1)
+			memcpy(x, x + sz, sizeof(a3f32) * sz);
+		if (slab->k1 == nz + 1 && slab->k0 <= nz)
+			memcpy(x + (nz + 1) * sz, x + nz * sz, sizeof(a3f32) * sz);
+	}
+}
+
+// relax cells of one color, (i + j + k) even or odd, whose neighbors are
+//	all of the other color
+void a3fluidMultigridInternalSmoothSlab(const a3_FluidMultigridLevel *level, const a3_FluidMultigridSlab *slab, const a3ui32 color)
+{
+	a3f32 *const x = level->x;
+	const a3f32 *const b = level->b;
+	const a3ui32 is3D = a3fluidMultigridInternalIs3D(level);
+	const a3ui32 nx = level->sizeX, sy = level->strideY, sz = is3D ? level->strideZ : 0;
+	const a3f32 zw = is3D ? 1.0f : 0.0f, cInv = is3D ? (1.0f / 6.0f) : 0.25f;
+	a3ui32 i, j, k, p;
+
+	for (k = slab->k0; k < slab->k1; ++k)
+		for (j = slab->j0; j < slab->j1; ++j)
+			for (i = 1 + ((1 + j + k + color) & 1), p = i + j * sy + k * level->strideZ; i <= nx; i += 2, p += 2)
+				x[p] = (b[p] + x[p - 1] + x[p + 1] + x[p - sy] + x[p + sy] + zw * (x[p - sz] + x[p + sz])) * cInv;
+	a3fluidMultigridInternalSetBoundsSlab(level, x, slab);
+}
+
+// residual b - A x of a slab, stored if r is given; squared norms of the
+//	residual and of b are accumulated
+void a3fluidMultigridInternalResidualSlab(const a3_FluidMultigridLevel *level, const a3f32 *x, const a3f32 *b, a3f32 *r_opt, const a3_FluidMultigridSlab *slab, a3f64 norm_out[2])
+{
+	const a3ui32 is3D = a3fluidMultigridInternalIs3D(level);
+	const a3ui32 nx = level->sizeX, sy = level->strideY, sz = is3D ? level->strideZ : 0;
+	const a3f32 zw = is3D ? 1.0f : 0.0f, c = is3D ? 6.0f : 4.0f;
+	a3f64 rr = 0.0, bb = 0.0;
+	a3f32 res;
+	a3ui32 i, j, k, p;
+
+	for (k = slab->k0; k < slab->k1; ++k)
+		for (j = slab->j0; j < slab->j1; ++j)
+			for (i = 1, p = 1 + j * sy + k * level->strideZ; i <= nx; ++i, ++p)
+			{
+				res = b[p] + x[p - 1] + x[p + 1] + x[p - sy] + x[p + sy] + zw * (x[p - sz] + x[p + sz]) - c * x[p];
+				if (r_opt)
+					r_opt[p] = res;
+				rr += (a3f64)res * (a3f64)res;
+				bb += (a3f64)b[p] * (a3f64)b[p];
+			}
+	norm_out[0] = rr;
+	norm_out[1] = bb;
+}
+
+// average residual of the children of each coarse cell in a slab into its
+//	right-hand side and clear its error; the last cell on an odd axis has
+//	only one child on that axis, and the missing one counts as zero so that
+//	the sum of the right-hand side is kept (it must stay zero for pressure
+//	with mirrored borders to have a solution)
+void a3fluidMultigridInternalRestrictSlab(const a3_FluidMultigridLevel *fine, const a3_FluidMultigridLevel *coarse, const a3_FluidMultigridSlab *slab)
+{
+	const a3f32 *const r = fine->r;
+	a3f32 *const b = coarse->b, *const x = coarse->x;
+	const a3ui32 is3D = a3fluidMultigridInternalIs3D(fine);
+	const a3ui32 sy = fine->strideY, sz = fine->strideZ;
+	const a3f32 scale = is3D ? (4.0f / 8.0f) : (4.0f / 4.0f);
+	a3ui32 i, j, k, p, q, ni, nj, nk, c0, c1, c2, c;
+	a3f32 sum;
+
+	for (k = slab->k0; k < slab->k1; ++k)
+	{
+		nk = is3D && 2 * k <= fine->sizeZ ? 2 : 1;
+		for (j = slab->j0; j < slab->j1; ++j)
+		{
+			nj = 2 * j <= fine->sizeY ? 2 : 1;
+			for (i = 1, p = 1 + j * coarse->strideY + k * coarse->strideZ; i <= coarse->sizeX; ++i, ++p)
+			{
+				ni = 2 * i <= fine->sizeX ? 2 : 1;
+				q = (2 * i - 1) + (2 * j - 1) * sy + (is3D ? (2 * k - 1) * sz : 0);
+				for (c2 = 0, sum = 0.0f; c2 < nk; ++c2)
+					for (c1 = 0; c1 < nj; ++c1)
+						for (c0 = 0, c = q + c1 * sy + c2 * sz; c0 < ni; ++c0, ++c)
+							sum += r[c];
+				b[p] = sum * scale;
+				x[p] = 0.0f;
+			}
+		}
+	}
+	a3fluidMultigridInternalSetBoundsSlab(coarse, x, slab);
+}
+
+// add error interpolated from the coarse level to each cell of a slab:
+//	a fine cell sits a quarter of a coarse cell from the center of its
+//	parent, toward one neighbor on each axis, so the parent weighs 3/4
+//	and the neighbor 1/4 per axis
+void a3fluidMultigridInternalProlongSlab(const a3_FluidMultigridLevel *fine, const a3_FluidMultigridLevel *coarse, const a3_FluidMultigridSlab *slab)
+{
+	const a3f32 *const e = coarse->x;
+	a3f32 *const x = fine->x;
+	const a3ui32 is3D = a3fluidMultigridInternalIs3D(fine);
+	const a3ui32 sy = coarse->strideY, sz = coarse->strideZ;
+	a3ui32 i, j, k, p, q;
+	a3i32 di, dj, dk;
+	a3f32 ex0, ex1;
+
+	for (k = slab->k0; k < slab->k1; ++k)
+	{
+		dk = (k & 1) ? -(a3i32)sz : (a3i32)sz;
+		for (j = slab->j0; j < slab->j1; ++j)
+		{
+			dj = (j & 1) ? -(a3i32)sy : (a3i32)sy;
+			for (i = 1, p = 1 + j * fine->strideY + k * fine->strideZ; i <= fine->sizeX; ++i, ++p)
+			{
+				di = (i & 1) ? -1 : 1;
+				q = ((i + 1) >> 1) + ((j + 1) >> 1) * sy + (is3D ? ((k + 1) >> 1) * sz : 0);
+				ex0 = 0.75f * (0.75f * e[q] + 0.25f * e[q + di]) + 0.25f * (0.75f * e[q + dj] + 0.25f * e[q + dj + di]);
+				if (is3D)
+				{
+					q += dk;
+					ex1 = 0.75f * (0.75f * e[q] + 0.25f * e[q + di]) + 0.25f * (0.75f * e[q + dj] + 0.25f * e[q + dj + di]);
+					x[p] += 0.75f * ex0 + 0.25f * ex1;
+				}
+				else
+					x[p] += ex0;
+			}
+		}
+	}
+	a3fluidMultigridInternalSetBoundsSlab(fine, x, slab);
+}
+
+// the coarsest level is tiny and solved by one thread; the mean of its
+//	right-hand side is removed first, as pressure with mirrored borders
+//	is only defined up to a constant
+void a3fluidMultigridInternalSolveCoarsest(const a3_FluidMultigrid *multigrid, const a3_FluidMultigridLevel *level)
+{
+	const a3ui32 is3D = a3fluidMultigridInternalIs3D(level);
+	a3_FluidMultigridSlab slab[1];
+	a3f32 *const b = level->b;
+	a3f32 mean = 0.0f;
+	a3ui32 n, i, j, k, p;
+
+	a3fluidMultigridInternalGetSlab(level, 0, 1, slab);
+	for (k = slab->k0; k < slab->k1; ++k)
+		for (j = 1; j <= level->sizeY; ++j)
+			for (i = 1, p = 1 + j * level->strideY + k * level->strideZ; i <= level->sizeX; ++i, ++p)
+				mean += b[p];
+	mean /= (a3f32)(level->sizeX * level->sizeY * (is3D ? level->sizeZ : 1));
+	for (k = slab->k0; k < slab->k1; ++k)
+		for (j = 1; j <= level->sizeY; ++j)
+			for (i = 1, p = 1 + j * level->strideY + k * level->strideZ; i <= level->sizeX; ++i, ++p)
+				b[p] -= mean;
+
+	for (n = 0; n < multigrid->coarseSweeps; ++n)
+	{
+		a3fluidMultigridInternalSmoothSlab(level, slab, 0);
+		a3fluidMultigridInternalSmoothSlab(level, slab, 1);
+	}
+}
+
+inline void a3fluidMultigridInternalSmooth(a3_FluidMultigrid *multigrid, const a3_FluidMultigridLevel *level, const a3_FluidMultigridSlab *slab, const a3ui32 sweeps, const a3ui32 threadCount)
+{
+	a3ui32 n;
+	for (n = 0; n < sweeps; ++n)
+	{
+		a3fluidMultigridInternalSmoothSlab(level, slab, 0);
+		a3fluidMultigridInternalBarrier(multigrid, threadCount);
+		a3fluidMultigridInternalSmoothSlab(level, slab, 1);
+		a3fluidMultigridInternalBarrier(multigrid, threadCount);
+	}
+}
+
+// relative residual of the finest level, summed in a fixed order so that
+//	the result does not depend on timing
+inline a3f32 a3fluidMultigridInternalMeasure(a3_FluidMultigrid *multigrid, const a3ui32 index, const a3ui32 threadCount)
+{
+	const a3_FluidMultigridLevel *const level = multigrid->level;
+	a3_FluidMultigridSlab slab[1];
+	a3f64 rr = 0.0, bb = 0.0;
+	a3ui32 n;
+
+	a3fluidMultigridInternalGetSlab(level, index, threadCount, slab);
+	a3fluidMultigridInternalResidualSlab(level, level->x, level->b, 0, slab, multigrid->partial[index]);
+	a3fluidMultigridInternalBarrier(multigrid, threadCount);
+	for (n = 0; n < threadCount; ++n)
+	{
+		rr += multigrid->partial[n][0];
+		bb += multigrid->partial[n][1];
+	}
+	a3fluidMultigridInternalBarrier(multigrid, threadCount);
+	return (a3f32)(bb > 0.0 ? sqrt(rr / bb) : sqrt(rr));
+}
+
+// thread: run every cycle on the slabs of this thread
+a3ret a3fluidMultigridInternalThread(a3_FluidMultigridWorker *worker)
+{
+	a3_FluidMultigrid *const multigrid = worker->multigrid;
+	const a3ui32 index = worker->index, threadCount = a3fluidMultigridInternalStart(worker);
+	const a3ui32 last = multigrid->levelCount - 1;
+	a3_FluidMultigridSlab slab[a3fluid_multigridLevelMax];
+	a3ui32 n, l;
+	a3f32 residual = 0.0f;
+
+	for (l = 0; l <= last; ++l)
+		a3fluidMultigridInternalGetSlab(multigrid->level + l, index, threadCount, slab + l);
+
+	for (n = 0; ; ++n)
+	{
+		if (multigrid->tolerance > 0.0f)
+		{
+			residual = a3fluidMultigridInternalMeasure(multigrid, index, threadCount);
+			if (residual <= multigrid->tolerance)
+				break;
+		}
+		if (n == multigrid->cycles)
+			break;
+
+		// down: smooth, then restrict residual
+		for (l = 0; l < last; ++l)
+		{
+			a3fluidMultigridInternalSmooth(multigrid, multigrid->level + l, slab + l, multigrid->preSmooth, threadCount);
+			a3fluidMultigridInternalResidualSlab(multigrid->level + l, multigrid->level[l].x, multigrid->level[l].b, multigrid->level[l].r, slab + l, multigrid->partial[index]);
+			a3fluidMultigridInternalBarrier(multigrid, threadCount);
+			a3fluidMultigridInternalRestrictSlab(multigrid->level + l, multigrid->level + l + 1, slab + l + 1);
+			a3fluidMultigridInternalBarrier(multigrid, threadCount);
+		}
+
+		// bottom
+		if (index == 0)
+			a3fluidMultigridInternalSolveCoarsest(multigrid, multigrid->level + last);
+		a3fluidMultigridInternalBarrier(multigrid, threadCount);
+
+		// up: correct, then smooth
+		for (l = last; l > 0; --l)
+		{
+			a3fluidMultigridInternalProlongSlab(multigrid->level + l - 1, multigrid->level + l, slab + l - 1);
+			a3fluidMultigridInternalBarrier(multigrid, threadCount);
+			a3fluidMultigridInternalSmooth(multigrid, multigrid->level + l - 1, slab + l - 1, multigrid->postSmooth, threadCount);
+		}
+	}
+
+	if (index == 0)
+	{
+		multigrid->residual = residual;
+		multigrid->cyclesRun = n;
+	}
+	return n;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// arrays of a sparse level, indexing tileField; coarse levels also store
+//	the mask, one over cells whose children are all active and zero elsewhere
+enum a3_FluidMultigridArray
+{
+	a3fluid_multigridX,
+	a3fluid_multigridB,
+	a3fluid_multigridR,
+	a3fluid_multigridMask,
+};
+
+
+// pass over one active tile of a sparse level
+typedef void(*a3_FluidMultigridTileKernel)(a3_FluidMultigrid *multigrid, const a3ui32 l, const a3ui32 index);
+
+
+inline a3f32 *a3fluidMultigridInternalTileData(const a3_FluidMultigridLevel *level, const a3ui32 index, const enum a3_FluidMultigridArray array)
+{
+	return a3fluidTilesGetData(level->tiles, level->tiles->slot[level->tiles->active[index]], level->tileField[array]);
+}
+
+// mask of a coarse tile; every cell of the finest level is active
+inline const a3f32 *a3fluidMultigridInternalTileMask(const a3_FluidMultigridLevel *level, const a3ui32 l, const a3ui32 index)
+{
+	return l ? a3fluidTilesGetData(level->tiles, level->tiles->slot[level->tiles->active[index]], a3fluid_multigridMask) : 0;
+}
+
+// relax both colors of a tile in turn, as a3fluidMultigridInternalSmoothSlab
+void a3fluidMultigridInternalSmoothTile(a3_FluidMultigrid *multigrid, const a3ui32 l, const a3ui32 index)
+{
+	const a3_FluidMultigridLevel *const level = multigrid->level + l;
+	const a3ui32 is3D = a3fluidMultigridInternalIs3D(level), k1 = is3D + level->tiles->tileDepth;
+	const a3ui32 w = a3fluid_tileWidth, sy = a3fluid_tileBlockWidth, sz = is3D ? sy * sy : 0;
+	const a3f32 zw = is3D ? 1.0f : 0.0f, cInv = is3D ? (1.0f / 6.0f) : 0.25f;
+	const a3f32 *const b = a3fluidMultigridInternalTileData(level, index, a3fluid_multigridB);
+	const a3f32 *const mask = a3fluidMultigridInternalTileMask(level, l, index);
+	a3f32 x[a3fluid_tileBlockCount];
+	a3ui32 color, i, j, k, p, c;
+
+	// tiles start on even cells, so colors match those of the whole level
+	a3fluidTilesGather(level->tiles, index, level->tileField[a3fluid_multigridX], a3fluid_tileBoundScalar, x);
+	for (color = 0; color < 2; ++color)
+		for (k = is3D; k < k1; ++k)
+			for (j = 1; j <= w; ++j)
+				for (i = 1 + ((1 + j + k + color) & 1), p = i + j * sy + k * sy * sy, c = (i - 1) + w * (j - 1 + w * (k - is3D)); i <= w; i += 2, p += 2, c += 2)
+					x[p] = (b[c] + x[p - 1] + x[p + 1] + x[p - sy] + x[p + sy] + zw * (x[p - sz] + x[p + sz])) * (mask ? mask[c] * cInv : cInv);
+	a3fluidTilesScatter(level->tiles, index, level->tileField[a3fluid_multigridX], x);
+}
+
+// residual of a tile, as a3fluidMultigridInternalResidualSlab
+inline void a3fluidMultigridInternalResidualTileBlock(const a3_FluidMultigridLevel *level, const a3f32 *mask, const a3ui32 index, const a3ui32 store, a3f64 norm_out[2])
+{
+	const a3ui32 is3D = a3fluidMultigridInternalIs3D(level), k1 = is3D + level->tiles->tileDepth;
+	const a3ui32 w = a3fluid_tileWidth, sy = a3fluid_tileBlockWidth, sz = is3D ? sy * sy : 0;
+	const a3f32 zw = is3D ? 1.0f : 0.0f, cx = is3D ? 6.0f : 4.0f;
+	const a3f32 *const b = a3fluidMultigridInternalTileData(level, index, a3fluid_multigridB);
+	a3f32 *const r = a3fluidMultigridInternalTileData(level, index, a3fluid_multigridR);
+	a3f32 x[a3fluid_tileBlockCount];
+	a3f64 rr = 0.0, bb = 0.0;
+	a3f32 res;
+	a3ui32 i, j, k, p, c;
+
+	a3fluidTilesGather(level->tiles, index, level->tileField[a3fluid_multigridX], a3fluid_tileBoundScalar, x);
+	for (k = is3D, c = 0; k < k1; ++k)
+		for (j = 1; j <= w; ++j)
+			for (i = 1, p = 1 + j * sy + k * sy * sy; i <= w; ++i, ++p, ++c)
+			{
+				res = b[c] + x[p - 1] + x[p + 1] + x[p - sy] + x[p + sy] + zw * (x[p - sz] + x[p + sz]) - cx * x[p];
+				res = mask ? mask[c] * res : res;
+				if (store)
+					r[c] = res;
+				rr += (a3f64)res * (a3f64)res;
+				bb += (a3f64)b[c] * (a3f64)b[c];
+			}
+	norm_out[0] = rr;
+	norm_out[1] = bb;
+}
+
+// norms of the finest level are kept for measuring
+void a3fluidMultigridInternalResidualTile(a3_FluidMultigrid *multigrid, const a3ui32 l, const a3ui32 index)
+{
+	a3f64 norm[2];
+	a3fluidMultigridInternalResidualTileBlock(multigrid->level + l, a3fluidMultigridInternalTileMask(multigrid->level + l, l, index), index, 1,
+		l ? norm : multigrid->tileNorm + 2 * index);
+}
+
+void a3fluidMultigridInternalMeasureTile(a3_FluidMultigrid *multigrid, const a3ui32 l, const a3ui32 index)
+{
+	a3fluidMultigridInternalResidualTileBlock(multigrid->level + l, 0, index, 0, multigrid->tileNorm + 2 * index);
+}
+
+// sum residual of the children of each cell of a coarse tile into its
+//	right-hand side and clear its error, as
+//	a3fluidMultigridInternalRestrictSlab; axes of halved sparse levels span
+//	an even number of tiles, so every coarse cell has all its children,
+//	though those in empty tiles are zero; the mask is found on the way
+void a3fluidMultigridInternalRestrictTile(a3_FluidMultigrid *multigrid, const a3ui32 l, const a3ui32 index)
+{
+	const a3_FluidMultigridLevel *const fine = multigrid->level + l - 1, *const coarse = multigrid->level + l;
+	const a3_FluidTiles *const tiles = fine->tiles;
+	const a3ui32 is3D = a3fluidMultigridInternalIs3D(coarse), depth = coarse->tiles->tileDepth;
+	const a3ui32 w = a3fluid_tileWidth, h = a3fluid_tileWidth / 2;
+	const a3f32 scale = is3D ? (4.0f / 8.0f) : (4.0f / 4.0f);
+	a3f32 *const b = a3fluidMultigridInternalTileData(coarse, index, a3fluid_multigridB);
+	a3f32 *const mask = (a3f32 *)a3fluidMultigridInternalTileMask(coarse, l, index);
+	const a3f32 *child[8], *childMask[8], *r, *m;
+	a3ui32 origin[3], i, j, k, c, q, tile, c0, c1, c2;
+	a3i32 slot;
+	a3f32 sum;
+
+	// the 2x2x2 (2x2 in 2D) fine tiles under this one
+	a3fluidTilesGetOrigin(coarse->tiles, index, origin);
+	for (c2 = 0; c2 < (is3D ? 2u : 1u); ++c2)
+		for (c1 = 0; c1 < 2; ++c1)
+			for (c0 = 0; c0 < 2; ++c0)
+			{
+				tile = (origin[0] / h + c0) + tiles->tilesX * ((origin[1] / h + c1) + tiles->tilesY * (is3D ? origin[2] / h + c2 : 0));
+				slot = tiles->slot[tile];
+				child[c0 + 2 * (c1 + 2 * c2)] = slot >= 0 ? a3fluidTilesGetData(tiles, slot, fine->tileField[a3fluid_multigridR]) : 0;
+				childMask[c0 + 2 * (c1 + 2 * c2)] = slot >= 0 && l > 1 ? a3fluidTilesGetData(tiles, slot, a3fluid_multigridMask) : 0;
+			}
+
+	for (k = 0, c = 0; k < depth; ++k)
+		for (j = 0; j < w; ++j)
+			for (i = 0; i < w; ++i, ++c)
+			{
+				r = child[i / h + 2 * (j / h + 2 * (k / h))];
+				m = childMask[i / h + 2 * (j / h + 2 * (k / h))];
+				sum = 0.0f;
+				mask[c] = 0.0f;
+				if (r)
+				{
+					q = (2 * i) % w + w * ((2 * j) % w + w * ((2 * k) % w));
+					sum = r[q] + r[q + 1] + r[q + w] + r[q + w + 1];
+					if (is3D)
+						sum += r[q + w * w] + r[q + w * w + 1] + r[q + w * w + w] + r[q + w * w + w + 1];
+
+					// all cells of active tiles on the finest level are active
+					mask[c] = 1.0f;
+					if (m)
+						mask[c] = m[q] * m[q + 1] * m[q + w] * m[q + w + 1] *
+							(is3D ? m[q + w * w] * m[q + w * w + 1] * m[q + w * w + w] * m[q + w * w + w + 1] : 1.0f);
+				}
+				b[c] = sum * scale;
+			}
+	memset(a3fluidMultigridInternalTileData(coarse, index, a3fluid_multigridX), 0, sizeof(a3f32) * coarse->tiles->cellsPerTile);
+}
+
+// add error interpolated from the coarse level to each cell of a fine tile,
+//	as a3fluidMultigridInternalProlongSlab; the parents of the tile and
+//	their neighbors are gathered first
+void a3fluidMultigridInternalProlongTile(a3_FluidMultigrid *multigrid, const a3ui32 l, const a3ui32 index)
+{
+	const a3_FluidMultigridLevel *const fine = multigrid->level + l, *const coarse = multigrid->level + l + 1;
+	const a3ui32 is3D = a3fluidMultigridInternalIs3D(fine), k1 = is3D + fine->tiles->tileDepth;
+	const a3ui32 w = a3fluid_tileWidth, n = a3fluid_tileWidth / 2 + 2, sy = n, sz = n * n;
+	a3f32 *const x = a3fluidMultigridInternalTileData(fine, index, a3fluid_multigridX);
+	const a3f32 *const mask = a3fluidMultigridInternalTileMask(fine, l, index);
+	a3f32 e[(a3fluid_tileWidth / 2 + 2) * (a3fluid_tileWidth / 2 + 2) * (a3fluid_tileWidth / 2 + 2)];
+	a3ui32 origin[3], i, j, k, c, q;
+	a3i32 di, dj, dk;
+	a3f32 ex0, ex1;
+
+	// the box starts a cell before the first parent, so parents are
+	//	numbered from one as on a whole level
+	a3fluidTilesGetOrigin(fine->tiles, index, origin);
+	a3fluidTilesGatherBox(coarse->tiles, coarse->tileField[a3fluid_multigridX], a3fluid_tileBoundScalar,
+		(a3i32)origin[0] / 2 - 1, (a3i32)origin[1] / 2 - 1, is3D ? (a3i32)origin[2] / 2 - 1 : 0, n, n, is3D ? n : 1, e);
+	for (k = is3D, c = 0; k < k1; ++k)
+	{
+		dk = (k & 1) ? -(a3i32)sz : (a3i32)sz;
+		for (j = 1; j <= w; ++j)
+		{
+			dj = (j & 1) ? -(a3i32)sy : (a3i32)sy;
+			for (i = 1; i <= w; ++i, ++c)
+			{
+				di = (i & 1) ? -1 : 1;
+				q = ((i + 1) >> 1) + ((j + 1) >> 1) * sy + (is3D ? ((k + 1) >> 1) * sz : 0);
+				ex0 = 0.75f * (0.75f * e[q] + 0.25f * e[q + di]) + 0.25f * (0.75f * e[q + dj] + 0.25f * e[q + dj + di]);
+				if (is3D)
+				{
+					q += dk;
+					ex1 = 0.75f * (0.75f * e[q] + 0.25f * e[q + di]) + 0.25f * (0.75f * e[q + dj] + 0.25f * e[q + dj + di]);
+					ex0 = 0.75f * ex0 + 0.25f * ex1;
+				}
+				x[c] += mask ? mask[c] * ex0 : ex0;
+			}
+		}
+	}
+}
+
+// run a pass over the active tiles of a level on all threads, then meet;
+//	every thread runs the same phases and makes one failed claim per phase,
+//	so each knows where the tickets of this phase start without resetting
+//	the counter
+inline void a3fluidMultigridInternalTilePhase(a3_FluidMultigrid *multigrid, const a3ui32 l, const a3_FluidMultigridTileKernel kernel, const a3i32 color, a3ui32 *ticket, const a3ui32 threadCount)
+{
+	const a3_FluidTiles *const tiles = multigrid->level[l].tiles;
+	const a3ui32 count = tiles->activeCount;
+	a3ui32 index;
+	while ((index = (a3ui32)a3atomicIncrement(&multigrid->ticket) - 1 - *ticket) < count)
+		if (color < 0 || a3fluidTilesGetColor(tiles, index) == (a3ui32)color)
+			kernel(multigrid, l, index);
+	*ticket += count + threadCount;
+	a3fluidMultigridInternalBarrier(multigrid, threadCount);
+}
+
+inline void a3fluidMultigridInternalTileSmooth(a3_FluidMultigrid *multigrid, const a3ui32 l, const a3ui32 sweeps, a3ui32 *ticket, const a3ui32 threadCount)
+{
+	a3ui32 n;
+	for (n = 0; n < sweeps; ++n)
+	{
+		a3fluidMultigridInternalTilePhase(multigrid, l, a3fluidMultigridInternalSmoothTile, 0, ticket, threadCount);
+		a3fluidMultigridInternalTilePhase(multigrid, l, a3fluidMultigridInternalSmoothTile, 1, ticket, threadCount);
+	}
+}
+
+// relative residual of the finest sparse level, summed in tile order
+inline a3f32 a3fluidMultigridInternalTileMeasure(a3_FluidMultigrid *multigrid, a3ui32 *ticket, const a3ui32 threadCount)
+{
+	const a3ui32 count = multigrid->level->tiles->activeCount;
+	a3f64 rr = 0.0, bb = 0.0;
+	a3ui32 n;
+
+	a3fluidMultigridInternalTilePhase(multigrid, 0, a3fluidMultigridInternalMeasureTile, -1, ticket, threadCount);
+	for (n = 0; n < count; ++n)
+	{
+		rr += multigrid->tileNorm[2 * n + 0];
+		bb += multigrid->tileNorm[2 * n + 1];
+	}
+	a3fluidMultigridInternalBarrier(multigrid, threadCount);
+	return (a3f32)(bb > 0.0 ? sqrt(rr / bb) : sqrt(rr));
+}
+
+// the coarsest sparse level may still be several tiles, so all threads
+//	sweep it; the mean is only removed if no cell borders open air
+inline void a3fluidMultigridInternalTileSolveCoarsest(a3_FluidMultigrid *multigrid, const a3ui32 index, a3ui32 *ticket, const a3ui32 threadCount)
+{
+	const a3ui32 last = multigrid->levelCount - 1;
+	const a3_FluidMultigridLevel *const level = multigrid->level + last;
+	const a3_FluidTiles *const tiles = level->tiles;
+	a3f32 mean = 0.0f, *b;
+	a3ui32 n, c;
+
+	if (multigrid->level->tiles->activeCount == multigrid->level->tiles->tileCount)
+	{
+		if (index == 0)
+		{
+			for (n = 0; n < tiles->activeCount; ++n)
+				for (c = 0, b = a3fluidMultigridInternalTileData(level, n, a3fluid_multigridB); c < tiles->cellsPerTile; ++c)
+					mean += b[c];
+			mean /= (a3f32)(tiles->activeCount * tiles->cellsPerTile);
+			for (n = 0; n < tiles->activeCount; ++n)
+				for (c = 0, b = a3fluidMultigridInternalTileData(level, n, a3fluid_multigridB); c < tiles->cellsPerTile; ++c)
+					b[c] -= mean;
+		}
+		a3fluidMultigridInternalBarrier(multigrid, threadCount);
+	}
+	a3fluidMultigridInternalTileSmooth(multigrid, last, multigrid->coarseSweeps, ticket, threadCount);
+}
+
+// thread: run every cycle on tiles claimed by this thread
+a3ret a3fluidMultigridInternalTileThread(a3_FluidMultigridWorker *worker)
+{
+	a3_FluidMultigrid *const multigrid = worker->multigrid;
+	const a3ui32 index = worker->index, threadCount = a3fluidMultigridInternalStart(worker);
+	const a3ui32 last = multigrid->levelCount - 1;
+	a3ui32 n, l, ticket = 0;
+	a3f32 residual = 0.0f;
+
+	for (n = 0; ; ++n)
+	{
+		if (multigrid->tolerance > 0.0f)
+		{
+			residual = a3fluidMultigridInternalTileMeasure(multigrid, &ticket, threadCount);
+			if (residual <= multigrid->tolerance)
+				break;
+		}
+		if (n == multigrid->cycles)
+			break;
+
+		// down: smooth, then restrict residual
+		for (l = 0; l < last; ++l)
+		{
+			a3fluidMultigridInternalTileSmooth(multigrid, l, multigrid->preSmooth, &ticket, threadCount);
+			a3fluidMultigridInternalTilePhase(multigrid, l, a3fluidMultigridInternalResidualTile, -1, &ticket, threadCount);
+			a3fluidMultigridInternalTilePhase(multigrid, l + 1, a3fluidMultigridInternalRestrictTile, -1, &ticket, threadCount);
+		}
+
+		// bottom
+		a3fluidMultigridInternalTileSolveCoarsest(multigrid, index, &ticket, threadCount);
+
+		// up: correct, then smooth
+		for (l = last; l > 0; --l)
+		{
+			a3fluidMultigridInternalTilePhase(multigrid, l - 1, a3fluidMultigridInternalProlongTile, -1, &ticket, threadCount);
+			a3fluidMultigridInternalTileSmooth(multigrid, l - 1, multigrid->postSmooth, &ticket, threadCount);
+		}
+	}
+
+	if (index == 0)
+	{
+		multigrid->residual = residual;
+		multigrid->cyclesRun = n;
+	}
+	return n;
+}
+
+// activate each coarse tile over any active tile of the level above it
+void a3fluidMultigridInternalFitTiles(const a3_FluidTiles *fine, a3_FluidTiles *coarse)
+{
+	const a3ui32 is3D = coarse->tileDepth > 1;
+	a3ui32 tile, tx, ty, tz, c0, c1, c2, active;
+	for (tile = 0; tile < coarse->tileCount; ++tile)
+	{
+		tx = tile % coarse->tilesX * 2;
+		ty = tile / coarse->tilesX % coarse->tilesY * 2;
+		tz = is3D ? tile / (coarse->tilesX * coarse->tilesY) * 2 : 0;
+		for (c2 = 0, active = 0; c2 < (is3D ? 2u : 1u) && !active; ++c2)
+			for (c1 = 0; c1 < 2 && !active; ++c1)
+				for (c0 = 0; c0 < 2 && !active; ++c0)
+					active = fine->slot[(tx + c0) + fine->tilesX * ((ty + c1) + fine->tilesY * (tz + c2))] >= 0;
+		if (active)
+			a3fluidTilesActivate(coarse, tile);
+		else
+			a3fluidTilesDeactivate(coarse, tile);
+	}
+	a3fluidTilesUpdate(coarse);
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3fluidMultigridInternalCreateSparse(a3_FluidMultigrid *multigrid_out, const a3_FluidGrid *grid)
+{
+	const a3ui32 w2 = 2 * a3fluid_tileWidth;
+	a3_FluidMultigridLevel *level = multigrid_out->level;
+	a3ui32 levelCount, n;
+	a3f64 *data;
+
+	// halve while every axis (not z in 2D) spans an even number of tiles,
+	//	so that each coarse tile covers whole tiles
+	a3fluidMultigridInternalSetLevel(level, grid->sizeX, grid->sizeY, grid->sizeZ);
+	level->tiles = grid->tiles;
+	level->tileField[a3fluid_multigridX] = a3fluid_pressure;
+	level->tileField[a3fluid_multigridB] = a3fluid_divergence;
+	level->tileField[a3fluid_multigridR] = a3fluid_residual;
+	for (levelCount = 1; levelCount < a3fluid_multigridLevelMax; ++levelCount, ++level)
+	{
+		if (level->sizeX % w2 || level->sizeY % w2 || (a3fluidMultigridInternalIs3D(level) && level->sizeZ % w2))
+			break;
+		a3fluidMultigridInternalSetLevel(level + 1, level->sizeX / 2, level->sizeY / 2,
+			a3fluidMultigridInternalIs3D(level) ? level->sizeZ / 2 : 1);
+	}
+
+	// one block: norms of each tile of the finest level, then storage of
+	//	each coarse level
+	data = (a3f64 *)malloc(sizeof(a3f64) * 2 * grid->tiles->tileCount + sizeof(a3_FluidTiles) * (levelCount - 1));
+	if (data)
+	{
+		memset(data, 0, sizeof(a3f64) * 2 * grid->tiles->tileCount + sizeof(a3_FluidTiles) * (levelCount - 1));
+		multigrid_out->data = (a3f32 *)data;
+		multigrid_out->tileNorm = data;
+		level = multigrid_out->level;
+		for (n = 1, ++level; n < levelCount; ++n, ++level)
+		{
+			level->tiles = (a3_FluidTiles *)(data + 2 * grid->tiles->tileCount) + n - 1;
+			level->tileField[a3fluid_multigridX] = a3fluid_multigridX;
+			level->tileField[a3fluid_multigridB] = a3fluid_multigridB;
+			level->tileField[a3fluid_multigridR] = a3fluid_multigridR;
+			if (a3fluidTilesCreate(level->tiles, level->sizeX, level->sizeY, level->sizeZ, 4, 1) <= 0)
+			{
+				while (--n)
+					a3fluidTilesRelease((--level)->tiles);
+				free(data);
+				memset(multigrid_out, 0, sizeof(a3_FluidMultigrid));
+				return 0;
+			}
+		}
+		multigrid_out->levelCount = levelCount;
+		return levelCount;
+	}
+	memset(multigrid_out, 0, sizeof(a3_FluidMultigrid));
+	return 0;
+}
+
+a3ret a3fluidMultigridCreate(a3_FluidMultigrid *multigrid_out, const a3_FluidGrid *grid, const a3ui32 threadCount)
+{
+	a3_FluidMultigridLevel *level;
+	a3ui32 levelCount, total, n;
+	a3f32 *data;
+	if (multigrid_out && grid && grid->tiles)
+	{
+		if (!multigrid_out->data)
+		{
+			memset(multigrid_out, 0, sizeof(a3_FluidMultigrid));
+			levelCount = a3fluidMultigridInternalCreateSparse(multigrid_out, grid);
+			if (levelCount)
+			{
+				multigrid_out->threadCount = threadCount > 1 ? threadCount <= a3fluid_multigridThreadMax ? threadCount : a3fluid_multigridThreadMax : 1;
+				multigrid_out->preSmooth = a3fluid_multigridPreSmooth;
+				multigrid_out->postSmooth = a3fluid_multigridPostSmooth;
+				multigrid_out->coarseSweeps = a3fluid_multigridCoarseSweeps;
+				multigrid_out->cycles = a3fluid_multigridCycles;
+				multigrid_out->tolerance = 0.0f;
+			}
+			return levelCount;
+		}
+	}
+	else if (multigrid_out && grid && grid->field[0])
+	{
+		if (!multigrid_out->data)
+		{
+			// halve each axis (not z in 2D) while all are large enough
+			memset(multigrid_out, 0, sizeof(a3_FluidMultigrid));
+			level = multigrid_out->level;
+			a3fluidMultigridInternalSetLevel(level, grid->sizeX, grid->sizeY, grid->sizeZ);
+			total = level->count;
+			for (levelCount = 1; levelCount < a3fluid_multigridLevelMax; ++levelCount, ++level)
+			{
+				if (level->sizeX < a3fluid_multigridSizeMin || level->sizeY < a3fluid_multigridSizeMin ||
+					(a3fluidMultigridInternalIs3D(level) && level->sizeZ < a3fluid_multigridSizeMin))
+					break;
+				a3fluidMultigridInternalSetLevel(level + 1, (level->sizeX + 1) / 2, (level->sizeY + 1) / 2,
+					a3fluidMultigridInternalIs3D(level) ? (level->sizeZ + 1) / 2 : 1);
+				total += 3 * level[1].count;
+			}
+
+			// one block: residual of the finest level, then all arrays of
+			//	each coarse level
+			data = (a3f32 *)malloc(sizeof(a3f32) * total);
+			if (data)
+			{
+				memset(data, 0, sizeof(a3f32) * total);
+				multigrid_out->data = data;
+				level = multigrid_out->level;
+				level->r = data;
+				data += level->count;
+				for (n = 1, ++level; n < levelCount; ++n, ++level)
+				{
+					level->x = data;
+					level->b = data + level->count;
+					level->r = data + 2 * level->count;
+					data += 3 * level->count;
+				}
+				multigrid_out->levelCount = levelCount;
+				multigrid_out->threadCount = threadCount > 1 ? threadCount <= a3fluid_multigridThreadMax ? threadCount : a3fluid_multigridThreadMax : 1;
+				multigrid_out->preSmooth = a3fluid_multigridPreSmooth;
+				multigrid_out->postSmooth = a3fluid_multigridPostSmooth;
+				multigrid_out->coarseSweeps = a3fluid_multigridCoarseSweeps;
+				multigrid_out->cycles = a3fluid_multigridCycles;
+				multigrid_out->tolerance = 0.0f;
+				return levelCount;
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+a3ret a3fluidMultigridSolve(a3_FluidMultigrid *multigrid, a3_FluidGrid *grid)
+{
+	a3_Thread thread[a3fluid_multigridThreadMax - 1] = { 0 };
+	a3_FluidMultigridWorker worker[a3fluid_multigridThreadMax];
+	a3ui32 threadCount, rows, i;
+	if (multigrid && multigrid->data && multigrid->level->tiles && grid && grid->tiles &&
+		grid->sizeX == multigrid->level->sizeX && grid->sizeY == multigrid->level->sizeY && grid->sizeZ == multigrid->level->sizeZ)
+	{
+		// fit coarse levels under the active tiles of the grid
+		multigrid->level->tiles = grid->tiles;
+		a3fluidTilesUpdate(grid->tiles);
+		for (i = 1; i < multigrid->levelCount; ++i)
+			a3fluidMultigridInternalFitTiles(multigrid->level[i - 1].tiles, multigrid->level[i].tiles);
+
+		// no more threads than tiles of the finest level
+		threadCount = multigrid->threadCount < grid->tiles->activeCount ? multigrid->threadCount : grid->tiles->activeCount;
+		multigrid->ticket = 0;
+		multigrid->residual = 0.0f;
+		multigrid->cyclesRun = 0;
+		if (threadCount)
+		{
+			threadCount = a3fluidMultigridInternalLaunch(multigrid, thread, worker, threadCount, (a3_threadfunc)a3fluidMultigridInternalTileThread);
+			a3fluidMultigridInternalTileThread(worker);
+		}
+		for (i = 1; i < threadCount; ++i)
+			a3threadWait(thread + i - 1);
+		return multigrid->cyclesRun;
+	}
+	else if (multigrid && multigrid->data && !multigrid->level->tiles && grid && grid->field[0] &&
+		grid->sizeX == multigrid->level->sizeX && grid->sizeY == multigrid->level->sizeY && grid->sizeZ == multigrid->level->sizeZ)
+	{
+		// fields of the grid are swapped between steps, so bind them now
+		multigrid->level->x = grid->field[a3fluid_pressure];
+		multigrid->level->b = grid->field[a3fluid_divergence];
+
+		// no more threads than slabs of the finest level
+		rows = a3fluidMultigridInternalIs3D(multigrid->level) ? grid->sizeZ : grid->sizeY;
+		threadCount = multigrid->threadCount < rows ? multigrid->threadCount : rows;
+		threadCount = a3fluidMultigridInternalLaunch(multigrid, thread, worker, threadCount, (a3_threadfunc)a3fluidMultigridInternalThread);
+		a3fluidMultigridInternalThread(worker);
+		for (i = 1; i < threadCount; ++i)
+			a3threadWait(thread + i - 1);
+		return multigrid->cyclesRun;
+	}
+	return -1;
+}
+
+a3f32 a3fluidMultigridResidual(const a3_FluidGrid *grid)
+{
+	a3_FluidMultigridLevel level[1];
+	a3_FluidMultigridSlab slab[1];
+	a3f64 norm[2], rr = 0.0, bb = 0.0;
+	a3ui32 n;
+	if (grid && grid->tiles)
+	{
+		a3fluidMultigridInternalSetLevel(level, grid->sizeX, grid->sizeY, grid->sizeZ);
+		level->tiles = grid->tiles;
+		level->tileField[a3fluid_multigridX] = a3fluid_pressure;
+		level->tileField[a3fluid_multigridB] = a3fluid_divergence;
+		level->tileField[a3fluid_multigridR] = a3fluid_residual;
+		for (n = 0; n < grid->tiles->activeCount; ++n)
+		{
+			a3fluidMultigridInternalResidualTileBlock(level, 0, n, 0, norm);
+			rr += norm[0];
+			bb += norm[1];
+		}
+		return (a3f32)(bb > 0.0 ? sqrt(rr / bb) : sqrt(rr));
+	}
+	else if (grid && grid->field[0])
+	{
+		a3fluidMultigridInternalSetLevel(level, grid->sizeX, grid->sizeY, grid->sizeZ);
+		a3fluidMultigridInternalGetSlab(level, 0, 1, slab);
+		a3fluidMultigridInternalResidualSlab(level, grid->field[a3fluid_pressure], grid->field[a3fluid_divergence], 0, slab, norm);
+		return (a3f32)(norm[1] > 0.0 ? sqrt(norm[0] / norm[1]) : sqrt(norm[0]));
+	}
+	return -1.0f;
+}
+
+a3ret a3fluidMultigridRelease(a3_FluidMultigrid *multigrid)
+{
+	a3ui32 n;
+	if (multigrid && multigrid->data)
+	{
+		// storage of coarse sparse levels lives in the block
+		if (multigrid->level->tiles)
+			for (n = 1; n < multigrid->levelCount; ++n)
+				a3fluidTilesRelease(multigrid->level[n].tiles);
+		free(multigrid->data);
+		memset(multigrid, 0, sizeof(a3_FluidMultigrid));
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,569 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework Extended (A3DX)
+	By Daniel S. Buckstein
+
+	a3_FluidTiles.c
+	Tiled storage implementation: the directory is dense, as it only costs
+		one entry per tile (a 512^3 domain has 262144 tiles), and the
+		active list is rebuilt from it in order, so that passes and band
+		updates do not depend on the order tiles were activated in.
+		Threads claim active tiles one at a time; a tile is enough work
+		to be worth the claim. A list of passes runs on one launch of the
+		threads, which meet at a barrier after each pass (as in the
+		multigrid solver), so that short passes repeated many times (e.g.
+		relaxation sweeps) do not pay for starting threads every time.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "../a3_FluidTiles.h"
+#include "animal3D/a3utility/a3_Thread.h"
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+
+// default settings
+#define a3fluid_tilesThreshold	1.0e-3f
+
+enum a3_FluidTilesSetting
+{
+	a3fluid_tilesBand = 1,
+};
+
+// flags of tiles while updating the band
+enum a3_FluidTilesMark
+{
+	a3fluid_tileOccupied = 1,
+	a3fluid_tileKept = 2,
+};
+
+
+// work shared by all threads of a list of passes; tiles are claimed with
+//	tickets, and threads meet at the barrier after each pass
+typedef struct a3_FluidTilesJob
+{
+	const a3_FluidTiles *tiles;
+	const a3_FluidTilesPass *pass;
+	a3ui32 passCount, repeat;
+	volatile a3i32 next;
+	volatile a3i32 started, barrierCount, barrierGeneration;
+} a3_FluidTilesJob;
+
+// thread arguments
+typedef struct a3_FluidTilesWorker
+{
+	a3_FluidTilesJob *job;
+	a3ui32 threadCount;
+} a3_FluidTilesWorker;
+
+
+inline a3ui32 a3fluidTilesInternalIs3D(const a3_FluidTiles *tiles)
+{
+	return (tiles->tileDepth > 1);
+}
+
+inline a3ui32 a3fluidTilesInternalPageSize(const a3_FluidTiles *tiles)
+{
+	return (sizeof(a3f32) * a3fluid_tilePageSize * tiles->fieldCount * tiles->cellsPerTile);
+}
+
+inline a3ui32 a3fluidTilesInternalPageMax(const a3ui32 tileCount)
+{
+	return ((tileCount + a3fluid_tilePageSize - 1) / a3fluid_tilePageSize);
+}
+
+// directory and lists: page pointers, slot, active, six neighbors and
+//	free slot of each tile, then a byte of flags
+inline a3ui32 a3fluidTilesInternalDataSize(const a3ui32 tileCount)
+{
+	return (sizeof(a3f32 *) * a3fluidTilesInternalPageMax(tileCount) + (sizeof(a3i32) * 9 + sizeof(a3ubyte)) * tileCount);
+}
+
+// fill one face of the border of a block: border cells p0 + a * dpA + b * dpB
+//	take neighbor cells n0 + a * dnA + b * dnB, background if it is empty,
+//	or mirror the cell one step inward at a wall
+inline void a3fluidTilesInternalGatherFace(const a3_FluidTiles *tiles, const a3i32 neighbor, const a3ui32 field, const a3f32 sign, a3f32 *block,
+	const a3ui32 countA, const a3ui32 countB, const a3ui32 p0, const a3ui32 dpA, const a3ui32 dpB, const a3i32 inward, const a3ui32 n0, const a3ui32 dnA, const a3ui32 dnB)
+{
+	const a3f32 *src, background = tiles->background[field];
+	a3ui32 a, b, p;
+	if (neighbor >= 0)
+	{
+		src = a3fluidTilesGetData(tiles, neighbor, field) + n0;
+		for (b = 0; b < countB; ++b)
+			for (a = 0, p = p0 + b * dpB; a < countA; ++a, p += dpA)
+				block[p] = src[a * dnA + b * dnB];
+	}
+	else if (neighbor == a3fluid_tileWall)
+	{
+		for (b = 0; b < countB; ++b)
+			for (a = 0, p = p0 + b * dpB; a < countA; ++a, p += dpA)
+				block[p] = sign * block[p + inward];
+	}
+	else
+	{
+		for (b = 0; b < countB; ++b)
+			for (a = 0, p = p0 + b * dpB; a < countA; ++a, p += dpA)
+				block[p] = background;
+	}
+}
+
+// occupancy of one tile: any field in the mask away from background
+void a3fluidTilesInternalOccupied(const a3_FluidTiles *tiles, const a3ui32 index, a3ui32 *fieldMask)
+{
+	const a3ui32 tile = tiles->active[index];
+	const a3f32 *src;
+	a3f32 background;
+	a3ui32 f, c;
+	for (f = 0; f < tiles->fieldCount; ++f)
+		if (*fieldMask & (1 << f))
+		{
+			src = a3fluidTilesGetData(tiles, tiles->slot[tile], f);
+			background = tiles->background[f];
+			for (c = 0; c < tiles->cellsPerTile; ++c)
+				if (fabsf(src[c] - background) > tiles->threshold)
+				{
+					// each thread only flags its own tile
+					tiles->mark[tile] |= a3fluid_tileOccupied;
+					return;
+				}
+		}
+}
+
+// all threads wait here until the last one arrives
+inline void a3fluidTilesInternalBarrier(a3_FluidTilesJob *job, const a3ui32 threadCount)
+{
+	const a3i32 generation = job->barrierGeneration;
+	if (threadCount > 1)
+	{
+		if (a3atomicIncrement(&job->barrierCount) == (a3i32)threadCount)
+		{
+			job->barrierCount = 0;
+			a3atomicIncrement(&job->barrierGeneration);
+		}
+		else while (job->barrierGeneration == generation)
+			a3threadYield();
+	}
+}
+
+// thread: run every pass of the list; every thread makes one failed claim
+//	per pass, so each knows where the tickets of a pass start without
+//	resetting the counter
+a3ret a3fluidTilesInternalThread(a3_FluidTilesWorker *worker)
+{
+	a3_FluidTilesJob *const job = worker->job;
+	const a3_FluidTiles *const tiles = job->tiles;
+	const a3_FluidTilesPass *pass;
+	a3ui32 threadCount, ticket = 0, index, n, p;
+	while (!job->started)
+		a3threadYield();
+	threadCount = worker->threadCount;
+	for (n = 0; n < job->repeat; ++n)
+		for (p = 0, pass = job->pass; p < job->passCount; ++p, ++pass)
+		{
+			while ((index = (a3ui32)a3atomicIncrement(&job->next) - 1 - ticket) < tiles->activeCount)
+				if (pass->color < 0 || a3fluidTilesGetColor(tiles, index) == (a3ui32)pass->color)
+					pass->kernel(tiles, index, pass->arg);
+			ticket += tiles->activeCount + threadCount;
+			a3fluidTilesInternalBarrier(job, threadCount);
+		}
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3fluidTilesCreate(a3_FluidTiles *tiles_out, const a3ui32 sizeX, const a3ui32 sizeY, const a3ui32 sizeZ, const a3ui32 fieldCount, const a3ui32 threadCount)
+{
+	a3ui32 tileCount, pageMax, n;
+	a3ubyte *data;
+	if (tiles_out && sizeX && sizeY && sizeZ && fieldCount && fieldCount <= a3fluid_tilesFieldMax &&
+		!(sizeX % a3fluid_tileWidth) && !(sizeY % a3fluid_tileWidth) && (sizeZ == 1 || !(sizeZ % a3fluid_tileWidth)))
+	{
+		if (!tiles_out->data)
+		{
+			tileCount = (sizeX / a3fluid_tileWidth) * (sizeY / a3fluid_tileWidth) * (sizeZ > 1 ? sizeZ / a3fluid_tileWidth : 1);
+			pageMax = a3fluidTilesInternalPageMax(tileCount);
+			data = (a3ubyte *)malloc(a3fluidTilesInternalDataSize(tileCount));
+			if (data)
+			{
+				memset(tiles_out, 0, sizeof(a3_FluidTiles));
+				memset(data, 0, a3fluidTilesInternalDataSize(tileCount));
+				tiles_out->data = data;
+				tiles_out->page = (a3f32 **)data;
+				tiles_out->slot = (a3i32 *)(tiles_out->page + pageMax);
+				tiles_out->active = (a3ui32 *)(tiles_out->slot + tileCount);
+				tiles_out->neighbor = (a3i32 *)(tiles_out->active + tileCount);
+				tiles_out->freeSlot = (a3ui32 *)(tiles_out->neighbor + 6 * tileCount);
+				tiles_out->mark = (a3ubyte *)(tiles_out->freeSlot + tileCount);
+				for (n = 0; n < tileCount; ++n)
+					tiles_out->slot[n] = -1;
+				for (n = 0; n < a3fluid_tilesFieldMax; ++n)
+					tiles_out->map[n] = n;
+				tiles_out->sizeX = sizeX;
+				tiles_out->sizeY = sizeY;
+				tiles_out->sizeZ = sizeZ;
+				tiles_out->tilesX = sizeX / a3fluid_tileWidth;
+				tiles_out->tilesY = sizeY / a3fluid_tileWidth;
+				tiles_out->tilesZ = sizeZ > 1 ? sizeZ / a3fluid_tileWidth : 1;
+				tiles_out->tileCount = tileCount;
+				tiles_out->tileDepth = sizeZ > 1 ? a3fluid_tileWidth : 1;
+				tiles_out->cellsPerTile = a3fluid_tileWidth * a3fluid_tileWidth * tiles_out->tileDepth;
+				tiles_out->fieldCount = fieldCount;
+				tiles_out->threadCount = threadCount > 1 ? threadCount <= a3fluid_tilesThreadMax ? threadCount : a3fluid_tilesThreadMax : 1;
+				tiles_out->threshold = a3fluid_tilesThreshold;
+				tiles_out->band = a3fluid_tilesBand;
+				return tileCount;
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+a3ret a3fluidTilesReset(a3_FluidTiles *tiles)
+{
+	a3ui32 n;
+	if (tiles && tiles->data)
+	{
+		for (n = 0; n < tiles->tileCount; ++n)
+			tiles->slot[n] = -1;
+		memset(tiles->mark, 0, tiles->tileCount);
+		tiles->slotCount = tiles->freeCount = tiles->activeCount = 0;
+		return 1;
+	}
+	return -1;
+}
+
+a3i32 a3fluidTilesActivate(a3_FluidTiles *tiles, const a3ui32 tile)
+{
+	a3ui32 slot, page, f, c;
+	a3f32 *dst;
+	if (tiles && tiles->data && tile < tiles->tileCount)
+	{
+		if (tiles->slot[tile] >= 0)
+			return tiles->slot[tile];
+
+		// reuse a released slot, or take the next one, allocating its
+		//	page if it starts a new one
+		if (tiles->freeCount)
+			slot = tiles->freeSlot[--tiles->freeCount];
+		else
+		{
+			slot = tiles->slotCount;
+			page = slot / a3fluid_tilePageSize;
+			if (!tiles->page[page])
+			{
+				tiles->page[page] = (a3f32 *)malloc(a3fluidTilesInternalPageSize(tiles));
+				if (!tiles->page[page])
+					return -1;
+				++tiles->pageCount;
+			}
+			++tiles->slotCount;
+		}
+		for (f = 0; f < tiles->fieldCount; ++f)
+		{
+			dst = a3fluidTilesGetData(tiles, slot, f);
+			if (tiles->background[f] == 0.0f)
+				memset(dst, 0, sizeof(a3f32) * tiles->cellsPerTile);
+			else for (c = 0; c < tiles->cellsPerTile; ++c)
+				dst[c] = tiles->background[f];
+		}
+		tiles->slot[tile] = slot;
+		return slot;
+	}
+	return -1;
+}
+
+a3ret a3fluidTilesDeactivate(a3_FluidTiles *tiles, const a3ui32 tile)
+{
+	if (tiles && tiles->data && tile < tiles->tileCount)
+	{
+		if (tiles->slot[tile] >= 0)
+		{
+			tiles->freeSlot[tiles->freeCount++] = tiles->slot[tile];
+			tiles->slot[tile] = -1;
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+a3ret a3fluidTilesUpdate(a3_FluidTiles *tiles)
+{
+	const a3i32 wall = a3fluid_tileWall;
+	a3ui32 n, tile, tx, ty, tz, sy, sz;
+	a3i32 *neighbor;
+	if (tiles && tiles->data)
+	{
+		sy = tiles->tilesX;
+		sz = tiles->tilesX * tiles->tilesY;
+		tiles->activeCount = 0;
+		for (tile = 0; tile < tiles->tileCount; ++tile)
+			if (tiles->slot[tile] >= 0)
+				tiles->active[tiles->activeCount++] = tile;
+		for (n = 0, neighbor = tiles->neighbor; n < tiles->activeCount; ++n, neighbor += 6)
+		{
+			tile = tiles->active[n];
+			tx = tile % tiles->tilesX;
+			ty = tile / sy % tiles->tilesY;
+			tz = tile / sz;
+			neighbor[0] = tx > 0 ? tiles->slot[tile - 1] : wall;
+			neighbor[1] = tx + 1 < tiles->tilesX ? tiles->slot[tile + 1] : wall;
+			neighbor[2] = ty > 0 ? tiles->slot[tile - sy] : wall;
+			neighbor[3] = ty + 1 < tiles->tilesY ? tiles->slot[tile + sy] : wall;
+			neighbor[4] = tz > 0 ? tiles->slot[tile - sz] : wall;
+			neighbor[5] = tz + 1 < tiles->tilesZ ? tiles->slot[tile + sz] : wall;
+		}
+		return tiles->activeCount;
+	}
+	return -1;
+}
+
+a3ret a3fluidTilesUpdateBand(a3_FluidTiles *tiles, const a3ui32 fieldMask)
+{
+	a3ui32 fieldMaskCopy = fieldMask;
+	a3ui32 tile, tx, ty, tz, x, y, z, x0, x1, y0, y1, z0, z1;
+	const a3ui32 sy = tiles ? tiles->tilesX : 0, sz = tiles ? tiles->tilesX * tiles->tilesY : 0;
+	if (tiles && tiles->data)
+	{
+		// flag occupied tiles, then keep everything within the band of them
+		a3fluidTilesUpdate(tiles);
+		a3fluidTilesForEach(tiles, (a3_FluidTilesKernel)a3fluidTilesInternalOccupied, &fieldMaskCopy, -1);
+		for (tile = 0; tile < tiles->tileCount; ++tile)
+			if (tiles->mark[tile] & a3fluid_tileOccupied)
+			{
+				tx = tile % tiles->tilesX;
+				ty = tile / sy % tiles->tilesY;
+				tz = tile / sz;
+				x0 = tx > tiles->band ? tx - tiles->band : 0;
+				y0 = ty > tiles->band ? ty - tiles->band : 0;
+				z0 = tz > tiles->band ? tz - tiles->band : 0;
+				x1 = tx + tiles->band < tiles->tilesX ? tx + tiles->band : tiles->tilesX - 1;
+				y1 = ty + tiles->band < tiles->tilesY ? ty + tiles->band : tiles->tilesY - 1;
+				z1 = tz + tiles->band < tiles->tilesZ ? tz + tiles->band : tiles->tilesZ - 1;
+				for (z = z0; z <= z1; ++z)
+					for (y = y0; y <= y1; ++y)
+						for (x = x0; x <= x1; ++x)
+							tiles->mark[x + y * sy + z * sz] |= a3fluid_tileKept;
+			}
+
+		// tiles that fail to allocate stay empty
+		for (tile = 0; tile < tiles->tileCount; ++tile)
+		{
+			if (tiles->mark[tile] & a3fluid_tileKept)
+				a3fluidTilesActivate(tiles, tile);
+			else
+				a3fluidTilesDeactivate(tiles, tile);
+			tiles->mark[tile] = 0;
+		}
+		return a3fluidTilesUpdate(tiles);
+	}
+	return -1;
+}
+
+a3ret a3fluidTilesSwap(a3_FluidTiles *tiles, const a3ui32 fieldA, const a3ui32 fieldB)
+{
+	a3ui32 tmp;
+	if (tiles && tiles->data && fieldA < tiles->fieldCount && fieldB < tiles->fieldCount)
+	{
+		tmp = tiles->map[fieldA];
+		tiles->map[fieldA] = tiles->map[fieldB];
+		tiles->map[fieldB] = tmp;
+		return 1;
+	}
+	return -1;
+}
+
+a3ret a3fluidTilesGather(const a3_FluidTiles *tiles, const a3ui32 index, const a3ui32 field, const a3_FluidTilesBound bound, a3f32 *block_out)
+{
+	const a3ui32 w = a3fluid_tileWidth, sy = a3fluid_tileBlockWidth, sz = sy * sy;
+	a3ui32 k0, k1, depth, j, k, c;
+	const a3i32 *neighbor;
+	const a3f32 *src;
+	if (tiles && tiles->data && index < tiles->activeCount && field < tiles->fieldCount && block_out)
+	{
+		k0 = a3fluidTilesInternalIs3D(tiles);
+		depth = tiles->tileDepth;
+		k1 = k0 + depth;
+		neighbor = tiles->neighbor + 6 * index;
+
+		// interior rows, then faces
+		src = a3fluidTilesGetData(tiles, tiles->slot[tiles->active[index]], field);
+		for (k = k0, c = 0; k < k1; ++k)
+			for (j = 1; j <= w; ++j, c += w)
+				memcpy(block_out + 1 + j * sy + k * sz, src + c, sizeof(a3f32) * w);
+		a3fluidTilesInternalGatherFace(tiles, neighbor[0], field, bound == a3fluid_tileBoundX ? -1.0f : 1.0f, block_out,
+			w, depth, sy + k0 * sz, sy, sz, +1, w - 1, w, w * w);
+		a3fluidTilesInternalGatherFace(tiles, neighbor[1], field, bound == a3fluid_tileBoundX ? -1.0f : 1.0f, block_out,
+			w, depth, (w + 1) + sy + k0 * sz, sy, sz, -1, 0, w, w * w);
+		a3fluidTilesInternalGatherFace(tiles, neighbor[2], field, bound == a3fluid_tileBoundY ? -1.0f : 1.0f, block_out,
+			w, depth, 1 + k0 * sz, 1, sz, +(a3i32)sy, w * (w - 1), 1, w * w);
+		a3fluidTilesInternalGatherFace(tiles, neighbor[3], field, bound == a3fluid_tileBoundY ? -1.0f : 1.0f, block_out,
+			w, depth, 1 + (w + 1) * sy + k0 * sz, 1, sz, -(a3i32)sy, 0, 1, w * w);
+		if (k0)
+		{
+			a3fluidTilesInternalGatherFace(tiles, neighbor[4], field, bound == a3fluid_tileBoundZ ? -1.0f : 1.0f, block_out,
+				w, w, 1 + sy, 1, sy, +(a3i32)sz, w * w * (w - 1), 1, w);
+			a3fluidTilesInternalGatherFace(tiles, neighbor[5], field, bound == a3fluid_tileBoundZ ? -1.0f : 1.0f, block_out,
+				w, w, 1 + sy + (w + 1) * sz, 1, sy, -(a3i32)sz, 0, 1, w);
+		}
+		return 1;
+	}
+	return -1;
+}
+
+a3ret a3fluidTilesScatter(const a3_FluidTiles *tiles, const a3ui32 index, const a3ui32 field, const a3f32 *block)
+{
+	const a3ui32 w = a3fluid_tileWidth, sy = a3fluid_tileBlockWidth, sz = sy * sy;
+	a3ui32 k0, k1, j, k, c;
+	a3f32 *dst;
+	if (tiles && tiles->data && index < tiles->activeCount && field < tiles->fieldCount && block)
+	{
+		k0 = a3fluidTilesInternalIs3D(tiles);
+		k1 = k0 + tiles->tileDepth;
+		dst = a3fluidTilesGetData(tiles, tiles->slot[tiles->active[index]], field);
+		for (k = k0, c = 0; k < k1; ++k)
+			for (j = 1; j <= w; ++j, c += w)
+				memcpy(dst + c, block + 1 + j * sy + k * sz, sizeof(a3f32) * w);
+		return 1;
+	}
+	return -1;
+}
+
+a3ret a3fluidTilesGatherBox(const a3_FluidTiles *tiles, const a3ui32 field, const a3_FluidTilesBound bound,
+	const a3i32 x0, const a3i32 y0, const a3i32 z0, const a3ui32 width, const a3ui32 height, const a3ui32 depth, a3f32 *box_out)
+{
+	const a3f32 sx = bound == a3fluid_tileBoundX ? -1.0f : 1.0f, sy = bound == a3fluid_tileBoundY ? -1.0f : 1.0f, sz = bound == a3fluid_tileBoundZ ? -1.0f : 1.0f;
+	a3i32 x, y, z, cx, cy, cz;
+	a3f32 s, syz;
+	if (tiles && tiles->data && field < tiles->fieldCount && box_out &&
+		x0 >= -1 && y0 >= -1 && x0 + (a3i32)width <= (a3i32)tiles->sizeX + 1 && y0 + (a3i32)height <= (a3i32)tiles->sizeY + 1 &&
+		(a3fluidTilesInternalIs3D(tiles) ? z0 >= -1 && z0 + (a3i32)depth <= (a3i32)tiles->sizeZ + 1 : !z0 && depth == 1))
+	{
+		// cells past a wall mirror the one inside it, so corners take the
+		//	sign of every wall they are past
+		for (z = z0; z < z0 + (a3i32)depth; ++z)
+			for (y = y0; y < y0 + (a3i32)height; ++y)
+			{
+				cz = z < 0 ? 0 : z < (a3i32)tiles->sizeZ ? z : (a3i32)tiles->sizeZ - 1;
+				cy = y < 0 ? 0 : y < (a3i32)tiles->sizeY ? y : (a3i32)tiles->sizeY - 1;
+				syz = (cz != z ? sz : 1.0f) * (cy != y ? sy : 1.0f);
+				for (x = x0; x < x0 + (a3i32)width; ++x)
+				{
+					cx = x < 0 ? 0 : x < (a3i32)tiles->sizeX ? x : (a3i32)tiles->sizeX - 1;
+					s = cx != x ? sx * syz : syz;
+					*(box_out++) = s * a3fluidTilesGetCell(tiles, field, cx, cy, cz);
+				}
+			}
+		return (width * height * depth);
+	}
+	return -1;
+}
+
+a3ret a3fluidTilesForEach(a3_FluidTiles *tiles, const a3_FluidTilesKernel kernel, void *arg, const a3i32 color)
+{
+	a3_FluidTilesPass pass[1];
+	pass->kernel = kernel;
+	pass->arg = arg;
+	pass->color = color;
+	return a3fluidTilesForEachList(tiles, pass, 1, 1);
+}
+
+a3ret a3fluidTilesForEachList(a3_FluidTiles *tiles, const a3_FluidTilesPass *pass, const a3ui32 passCount, const a3ui32 repeat)
+{
+	a3_Thread thread[a3fluid_tilesThreadMax - 1] = { 0 };
+	a3_FluidTilesWorker worker[a3fluid_tilesThreadMax];
+	a3_FluidTilesJob job[1];
+	a3ui32 threadCount, colorCount[2] = { 0 }, count, n;
+	if (tiles && tiles->data && pass && passCount)
+	{
+		for (n = 0; n < passCount; ++n)
+			if (!pass[n].kernel)
+				return -1;
+
+		// tiles visited by the list
+		for (n = 0; n < tiles->activeCount; ++n)
+			++colorCount[a3fluidTilesGetColor(tiles, n)];
+		for (n = count = 0; n < passCount; ++n)
+			count += pass[n].color < 0 ? tiles->activeCount : colorCount[pass[n].color != 0];
+		count *= repeat;
+
+		// no more threads than tiles; launch helpers, then release them
+		//	all with the number that actually started, since a thread that
+		//	fails to launch never reaches the barrier
+		threadCount = tiles->threadCount < tiles->activeCount ? tiles->threadCount : tiles->activeCount;
+		if (count)
+		{
+			job->tiles = tiles;
+			job->pass = pass;
+			job->passCount = passCount;
+			job->repeat = repeat;
+			job->next = 0;
+			job->started = 0;
+			job->barrierCount = 0;
+			job->barrierGeneration = 0;
+			for (n = 0; n < threadCount; ++n)
+				worker[n].job = job;
+			for (n = 1; n < threadCount; ++n)
+				if (a3threadLaunch(thread + n - 1, (a3_threadfunc)a3fluidTilesInternalThread, worker + n, "animal3D tiles") <= 0)
+					break;
+			threadCount = n;
+			for (n = 0; n < threadCount; ++n)
+				worker[n].threadCount = threadCount;
+			a3atomicIncrement(&job->started);
+			a3fluidTilesInternalThread(worker);
+			for (n = 1; n < threadCount; ++n)
+				a3threadWait(thread + n - 1);
+		}
+		return count;
+	}
+	return -1;
+}
+
+a3ui64 a3fluidTilesGetMemory(const a3_FluidTiles *tiles)
+{
+	if (tiles && tiles->data)
+		return ((a3ui64)a3fluidTilesInternalDataSize(tiles->tileCount) + (a3ui64)a3fluidTilesInternalPageSize(tiles) * (a3ui64)tiles->pageCount);
+	return 0;
+}
+
+a3ret a3fluidTilesRelease(a3_FluidTiles *tiles)
+{
+	a3ui32 n;
+	if (tiles && tiles->data)
+	{
+		// pages are allocated in order
+		for (n = 0; n < tiles->pageCount; ++n)
+			free(tiles->page[n]);
+		free(tiles->data);
+		memset(tiles, 0, sizeof(a3_FluidTiles));
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
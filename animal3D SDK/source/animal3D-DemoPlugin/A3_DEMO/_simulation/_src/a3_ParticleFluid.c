@@ -0,0 +1,618 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework Extended (A3DX)
+	By Daniel S. Buckstein
+
+	a3_ParticleFluid.c
+	Particle fluid implementation, after Muller et al.'s "Particle-Based
+		Fluid Simulation for Interactive Applications": density uses the
+		poly6 kernel, pressure the gradient of the spiky kernel and
+		viscosity the Laplacian of the viscosity kernel. Pressure is never
+		negative, so that the surface does not clump.
+		The cells of a row are consecutive, as are their particles once
+		sorted, so the 27 cells around a cell are 9 runs of particles.
+		Sorting has two levels: each thread counts its share of the
+		particles per block of cells and places them in block order,
+		then threads claim blocks and sort their particles by cell; both
+		keep the previous order within a cell, so the result is the same
+		for any number of threads.
+		Threads claim blocks of cells in turn; each only writes the
+		particles of its cells, so results do not depend on the number of
+		threads either. One set of threads runs every phase of a step,
+		meeting at a barrier after each.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "../a3_ParticleFluid.h"
+#include "animal3D/a3/a3macros.h"
+#include "animal3D/a3utility/a3_Thread.h"
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+
+// default settings, water in meters
+#define a3particle_restDensity			1000.0f
+#define a3particle_stiffness			100.0f
+#define a3particle_viscosity			8.0f
+#define a3particle_gravity				9.81f
+#define a3particle_restitution			0.25f
+
+enum a3_ParticleFluidSetting
+{
+	a3particle_cellsPerBlock = 64,			// cells claimed by a thread at once
+	a3particle_particlesPerThread = 4096,	// fewer per thread are not worth waking it for
+};
+
+
+typedef struct a3_ParticleFluidJob a3_ParticleFluidJob;
+
+// pass over the particles of a range of cells
+typedef void(*a3_ParticleFluidPass)(const a3_ParticleFluidJob *job, const a3ui32 c0, const a3ui32 c1);
+
+// work shared by all threads of a step; blocks are claimed with tickets, 
+//	and threads meet at the barrier after each phase
+struct a3_ParticleFluidJob
+{
+	a3_ParticleFluid *fluid;
+	a3real dt;
+	a3real poly6, spiky, laplacian;
+	a3ui32 blockCount;
+	volatile a3i32 next;
+	volatile a3i32 started, barrierCount, barrierGeneration;
+};
+
+// thread arguments
+typedef struct a3_ParticleFluidWorker
+{
+	a3_ParticleFluidJob *job;
+	a3ui32 index, threadCount;
+} a3_ParticleFluidWorker;
+
+// runs of particles in the cells around a cell
+typedef struct a3_ParticleFluidNeighbors
+{
+	a3ui32 run[9][2];
+	a3ui32 runCount;
+} a3_ParticleFluidNeighbors;
+
+
+inline a3ui32 a3particleInternalCell(const a3_ParticleFluid *fluid, const a3real invRadius, const a3ui32 i)
+{
+	a3ui32 cx = (a3ui32)(fluid->field[a3particle_positionX][i] * invRadius);
+	a3ui32 cy = (a3ui32)(fluid->field[a3particle_positionY][i] * invRadius);
+	a3ui32 cz = (a3ui32)(fluid->field[a3particle_positionZ][i] * invRadius);
+	cx = cx < fluid->cellsX ? cx : fluid->cellsX - 1;
+	cy = cy < fluid->cellsY ? cy : fluid->cellsY - 1;
+	cz = cz < fluid->cellsZ ? cz : fluid->cellsZ - 1;
+	return (cx + fluid->cellsX * (cy + fluid->cellsY * cz));
+}
+
+inline void a3particleInternalGetNeighbors(const a3_ParticleFluid *fluid, const a3ui32 c, a3_ParticleFluidNeighbors *neighbors_out)
+{
+	const a3ui32 cx = c % fluid->cellsX, cy = (c / fluid->cellsX) % fluid->cellsY, cz = c / (fluid->cellsX * fluid->cellsY);
+	const a3ui32 x0 = cx ? cx - 1 : cx, x1 = cx + 1 < fluid->cellsX ? cx + 1 : cx;
+	const a3ui32 y0 = cy ? cy - 1 : cy, y1 = cy + 1 < fluid->cellsY ? cy + 1 : cy;
+	const a3ui32 z0 = cz ? cz - 1 : cz, z1 = cz + 1 < fluid->cellsZ ? cz + 1 : cz;
+	a3ui32 y, z, row;
+	neighbors_out->runCount = 0;
+	for (z = z0; z <= z1; ++z)
+		for (y = y0; y <= y1; ++y)
+		{
+			row = fluid->cellsX * (y + fluid->cellsY * z);
+			neighbors_out->run[neighbors_out->runCount][0] = fluid->cellStart[row + x0];
+			neighbors_out->run[neighbors_out->runCount][1] = fluid->cellStart[row + x1 + 1];
+			++neighbors_out->runCount;
+		}
+}
+
+// share of particles counted and placed by one thread
+inline void a3particleInternalGetShare(const a3_ParticleFluid *fluid, const a3ui32 index, const a3ui32 threadCount, a3ui32 *i0_out, a3ui32 *i1_out)
+{
+	*i0_out = (a3ui32)((a3ui64)fluid->count * index / threadCount);
+	*i1_out = (a3ui32)((a3ui64)fluid->count * (index + 1) / threadCount);
+}
+
+// sort, first level: find cell of each particle of share and count them 
+//	per block in the histogram of this thread
+inline void a3particleInternalSortCount(const a3_ParticleFluidJob *job, const a3ui32 index, const a3ui32 threadCount)
+{
+	a3_ParticleFluid *const fluid = job->fluid;
+	const a3real invRadius = a3real_one / fluid->radius;
+	a3ui32 *const histogram = fluid->histogram + index * job->blockCount, *const cellOf = fluid->cellOf;
+	a3ui32 i, i0, i1;
+	a3particleInternalGetShare(fluid, index, threadCount, &i0, &i1);
+	memset(histogram, 0, sizeof(a3ui32) * job->blockCount);
+	for (i = i0; i < i1; ++i)
+	{
+		cellOf[i] = a3particleInternalCell(fluid, invRadius, i);
+		++histogram[cellOf[i] / a3particle_cellsPerBlock];
+	}
+}
+
+// sort, first level: sum counts in block order, then thread order within 
+//	each block, so that each histogram holds where its thread places the 
+//	particles of each block; the first cell of each block starts it
+inline void a3particleInternalSortSum(const a3_ParticleFluidJob *job, const a3ui32 threadCount)
+{
+	a3_ParticleFluid *const fluid = job->fluid;
+	a3ui32 *histogram;
+	a3ui32 b, t, n, sum;
+	for (b = 0, sum = 0; b < job->blockCount; ++b)
+	{
+		fluid->cellStart[b * a3particle_cellsPerBlock] = sum;
+		for (t = 0, histogram = fluid->histogram + b; t < threadCount; ++t, histogram += job->blockCount)
+		{
+			n = *histogram;
+			*histogram = sum;
+			sum += n;
+		}
+	}
+	fluid->cellStart[fluid->cellCount] = sum;
+}
+
+// sort, first level: place particles of share in block order
+inline void a3particleInternalSortPlace(const a3_ParticleFluidJob *job, const a3ui32 index, const a3ui32 threadCount)
+{
+	a3_ParticleFluid *const fluid = job->fluid;
+	a3ui32 *const histogram = fluid->histogram + index * job->blockCount, *const order = fluid->order;
+	const a3ui32 *const cellOf = fluid->cellOf;
+	a3ui32 i, i0, i1;
+	a3particleInternalGetShare(fluid, index, threadCount, &i0, &i1);
+	for (i = i0; i < i1; ++i)
+		order[histogram[cellOf[i] / a3particle_cellsPerBlock]++] = i;
+}
+
+// sort, second level: count the particles of each cell of a block, start 
+//	each cell after the previous one and copy state in cell order; the 
+//	first cell already starts the block, and the next block's first cell 
+//	ends it, so neither is written
+void a3particleInternalSortPass(const a3_ParticleFluidJob *job, const a3ui32 c0, const a3ui32 c1)
+{
+	a3_ParticleFluid *const fluid = job->fluid;
+	a3ui32 *const cellStart = fluid->cellStart;
+	const a3ui32 *const cellOf = fluid->cellOf, *const order = fluid->order;
+	const a3ui32 k0 = cellStart[c0], k1 = cellStart[c1];
+	a3ui32 next[a3particle_cellsPerBlock] = { 0 };
+	a3ui32 c, k, i, f, n, sum;
+	for (k = k0; k < k1; ++k)
+		++next[cellOf[order[k]] - c0];
+	for (c = c0, sum = k0; c < c1; ++c)
+	{
+		n = next[c - c0];
+		next[c - c0] = sum;
+		sum += n;
+		if (c + 1 < c1)
+			cellStart[c + 1] = sum;
+	}
+	for (k = k0; k < k1; ++k)
+	{
+		i = order[k];
+		n = next[cellOf[i] - c0]++;
+		for (f = 0; f < a3particle_stateMax; ++f)
+			fluid->sorted[f][n] = fluid->field[f][i];
+	}
+}
+
+void a3particleInternalDensityPass(const a3_ParticleFluidJob *job, const a3ui32 c0, const a3ui32 c1)
+{
+	a3_ParticleFluid *const fluid = job->fluid;
+	const a3real *const px = fluid->field[a3particle_positionX], *const py = fluid->field[a3particle_positionY], *const pz = fluid->field[a3particle_positionZ];
+	a3real *const density = fluid->field[a3particle_density], *const pressure = fluid->field[a3particle_pressure];
+	const a3real h2 = fluid->radius * fluid->radius, scale = fluid->mass * job->poly6;
+	a3_ParticleFluidNeighbors neighbors[1];
+	a3real sum, dx, dy, dz, q;
+	a3ui32 c, i, j, n;
+	for (c = c0; c < c1; ++c)
+	{
+		if (fluid->cellStart[c] == fluid->cellStart[c + 1])
+			continue;
+		a3particleInternalGetNeighbors(fluid, c, neighbors);
+		for (i = fluid->cellStart[c]; i < fluid->cellStart[c + 1]; ++i)
+		{
+			sum = a3real_zero;
+			for (n = 0; n < neighbors->runCount; ++n)
+				for (j = neighbors->run[n][0]; j < neighbors->run[n][1]; ++j)
+				{
+					dx = px[i] - px[j];
+					dy = py[i] - py[j];
+					dz = pz[i] - pz[j];
+					q = h2 - (dx * dx + dy * dy + dz * dz);
+					if (q > a3real_zero)
+						sum += q * q * q;
+				}
+			density[i] = scale * sum;
+			q = fluid->stiffness * (density[i] - fluid->restDensity);
+			pressure[i] = q > a3real_zero ? q : a3real_zero;
+		}
+	}
+}
+
+void a3particleInternalForcePass(const a3_ParticleFluidJob *job, const a3ui32 c0, const a3ui32 c1)
+{
+	a3_ParticleFluid *const fluid = job->fluid;
+	const a3real *const px = fluid->field[a3particle_positionX], *const py = fluid->field[a3particle_positionY], *const pz = fluid->field[a3particle_positionZ];
+	const a3real *const vx = fluid->field[a3particle_velocityX], *const vy = fluid->field[a3particle_velocityY], *const vz = fluid->field[a3particle_velocityZ];
+	const a3real *const density = fluid->field[a3particle_density], *const pressure = fluid->field[a3particle_pressure];
+	a3real *const ax = fluid->field[a3particle_accelerationX], *const ay = fluid->field[a3particle_accelerationY], *const az = fluid->field[a3particle_accelerationZ];
+	const a3real h = fluid->radius, h2 = h * h;
+	a3_ParticleFluidNeighbors neighbors[1];
+	a3real sx, sy, sz, dx, dy, dz, r2, r, q, fp, fv;
+	a3ui32 c, i, j, n;
+	for (c = c0; c < c1; ++c)
+	{
+		if (fluid->cellStart[c] == fluid->cellStart[c + 1])
+			continue;
+		a3particleInternalGetNeighbors(fluid, c, neighbors);
+		for (i = fluid->cellStart[c]; i < fluid->cellStart[c + 1]; ++i)
+		{
+			sx = sy = sz = a3real_zero;
+			for (n = 0; n < neighbors->runCount; ++n)
+				for (j = neighbors->run[n][0]; j < neighbors->run[n][1]; ++j)
+				{
+					dx = px[i] - px[j];
+					dy = py[i] - py[j];
+					dz = pz[i] - pz[j];
+					r2 = dx * dx + dy * dy + dz * dz;
+					if (r2 < h2 && r2 > a3real_zero)
+					{
+						// pressure pushes along the separation, viscosity
+						//	pulls toward the velocity of the neighbor
+						r = (a3real)sqrt(r2);
+						q = h - r;
+						fp = job->spiky * q * q * (pressure[i] + pressure[j]) * a3real_half / (density[j] * r);
+						fv = job->laplacian * q * fluid->viscosity / density[j];
+						sx += fp * dx + fv * (vx[j] - vx[i]);
+						sy += fp * dy + fv * (vy[j] - vy[i]);
+						sz += fp * dz + fv * (vz[j] - vz[i]);
+					}
+				}
+			q = fluid->mass / density[i];
+			ax[i] = q * sx;
+			ay[i] = q * sy - fluid->gravity;
+			az[i] = q * sz;
+		}
+	}
+}
+
+// symplectic Euler, then bounce off the walls of the domain
+void a3particleInternalMovePass(const a3_ParticleFluidJob *job, const a3ui32 c0, const a3ui32 c1)
+{
+	a3_ParticleFluid *const fluid = job->fluid;
+	const a3real dt = job->dt, wall = fluid->radius * 0.01f;
+	const a3real wallMax[3] = {
+		fluid->radius * (a3real)fluid->cellsX - wall,
+		fluid->radius * (a3real)fluid->cellsY - wall,
+		fluid->radius * (a3real)fluid->cellsZ - wall,
+	};
+	const a3ui32 i0 = fluid->cellStart[c0], i1 = fluid->cellStart[c1];
+	a3real *p, *v;
+	const a3real *a;
+	a3ui32 axis, i;
+	for (axis = 0; axis < 3; ++axis)
+	{
+		p = fluid->field[a3particle_positionX + axis];
+		v = fluid->field[a3particle_velocityX + axis];
+		a = fluid->field[a3particle_accelerationX + axis];
+		for (i = i0; i < i1; ++i)
+		{
+			v[i] += a[i] * dt;
+			p[i] += v[i] * dt;
+			if (p[i] < wall)
+			{
+				p[i] = wall;
+				if (v[i] < a3real_zero)
+					v[i] *= -fluid->restitution;
+			}
+			else if (p[i] > wallMax[axis])
+			{
+				p[i] = wallMax[axis];
+				if (v[i] > a3real_zero)
+					v[i] *= -fluid->restitution;
+			}
+		}
+	}
+}
+
+// all threads wait here until the last one arrives
+inline void a3particleInternalBarrier(a3_ParticleFluidJob *job, const a3ui32 threadCount)
+{
+	const a3i32 generation = job->barrierGeneration;
+	if (threadCount > 1)
+	{
+		if (a3atomicIncrement(&job->barrierCount) == (a3i32)threadCount)
+		{
+			job->barrierCount = 0;
+			a3atomicIncrement(&job->barrierGeneration);
+		}
+		else while (job->barrierGeneration == generation)
+			a3threadYield();
+	}
+}
+
+// run a pass over all cells on all threads, then meet; every thread makes 
+//	one failed claim per phase, so each knows where the tickets of this 
+//	phase start without resetting the counter
+inline void a3particleInternalPhase(a3_ParticleFluidJob *job, const a3_ParticleFluidPass pass, a3ui32 *ticket, const a3ui32 threadCount)
+{
+	const a3ui32 cellCount = job->fluid->cellCount;
+	a3ui32 block, c0, c1;
+	while ((block = (a3ui32)a3atomicIncrement(&job->next) - 1 - *ticket) < job->blockCount)
+	{
+		c0 = block * a3particle_cellsPerBlock;
+		c1 = c0 + a3particle_cellsPerBlock < cellCount ? c0 + a3particle_cellsPerBlock : cellCount;
+		pass(job, c0, c1);
+	}
+	*ticket += job->blockCount + threadCount;
+	a3particleInternalBarrier(job, threadCount);
+}
+
+// thread: run every phase of a step
+a3ret a3particleInternalThread(a3_ParticleFluidWorker *worker)
+{
+	a3_ParticleFluidJob *const job = worker->job;
+	a3_ParticleFluid *const fluid = job->fluid;
+	const a3ui32 index = worker->index;
+	a3ui32 threadCount, ticket = 0, f;
+	a3real *tmp;
+	while (!job->started)
+		a3threadYield();
+	threadCount = worker->threadCount;
+
+	// sort: count, sum, place in block order, then sort blocks by cell 
+	//	into the sorted state and swap it in
+	a3particleInternalSortCount(job, index, threadCount);
+	a3particleInternalBarrier(job, threadCount);
+	if (index == 0)
+		a3particleInternalSortSum(job, threadCount);
+	a3particleInternalBarrier(job, threadCount);
+	a3particleInternalSortPlace(job, index, threadCount);
+	a3particleInternalBarrier(job, threadCount);
+	a3particleInternalPhase(job, a3particleInternalSortPass, &ticket, threadCount);
+	if (index == 0)
+		for (f = 0; f < a3particle_stateMax; ++f)
+		{
+			tmp = fluid->field[f];
+			fluid->field[f] = fluid->sorted[f];
+			fluid->sorted[f] = tmp;
+		}
+	a3particleInternalBarrier(job, threadCount);
+
+	// simulate
+	a3particleInternalPhase(job, a3particleInternalDensityPass, &ticket, threadCount);
+	a3particleInternalPhase(job, a3particleInternalForcePass, &ticket, threadCount);
+	a3particleInternalPhase(job, a3particleInternalMovePass, &ticket, threadCount);
+	return 0;
+}
+
+// run a step on as many threads as are worth it; helpers are launched, 
+//	then released with the number that actually started, since a thread 
+//	that fails to launch never reaches the barrier
+inline void a3particleInternalRun(a3_ParticleFluidJob *job)
+{
+	a3_Thread thread[a3particle_threadMax - 1] = { 0 };
+	a3_ParticleFluidWorker worker[a3particle_threadMax];
+	a3ui32 threadCount = job->fluid->count / a3particle_particlesPerThread + 1, i, n;
+	threadCount = threadCount < job->fluid->threadCount ? threadCount : job->fluid->threadCount;
+	threadCount = threadCount < job->blockCount ? threadCount : job->blockCount;
+	job->next = 0;
+	job->started = 0;
+	job->barrierCount = 0;
+	job->barrierGeneration = 0;
+	for (i = 0; i < threadCount; ++i)
+	{
+		worker[i].job = job;
+		worker[i].index = i;
+	}
+	for (n = 1; n < threadCount; ++n)
+		if (a3threadLaunch(thread + n - 1, (a3_threadfunc)a3particleInternalThread, worker + n, "animal3D particles") <= 0)
+			break;
+	for (i = 0; i < n; ++i)
+		worker[i].threadCount = n;
+	a3atomicIncrement(&job->started);
+	a3particleInternalThread(worker);
+	for (i = 1; i < n; ++i)
+		a3threadWait(thread + i - 1);
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3particleFluidCreate(a3_ParticleFluid *fluid_out, const a3ui32 capacity, const a3ui32 cellsX, const a3ui32 cellsY, const a3ui32 cellsZ, const a3real radius, const a3ui32 threadCount)
+{
+	const a3ui32 cellCount = cellsX * cellsY * cellsZ;
+	const a3ui32 blockCount = (cellCount + a3particle_cellsPerBlock - 1) / a3particle_cellsPerBlock;
+	const a3ui32 rows = (capacity + a3particle_payloadWidth - 1) / a3particle_payloadWidth;
+	a3real *data, h2, dx, dy, dz, q, sum;
+	a3ui32 f;
+	a3i32 x, y, z;
+	if (fluid_out && capacity && cellsX && cellsY && cellsZ && radius > a3real_zero)
+	{
+		if (!fluid_out->data)
+		{
+			// one block: each field and sorted state, then the cells, cell
+			//	of each particle, order of particles, histograms of every 
+			//	thread and payload
+			data = (a3real *)malloc(sizeof(a3real) * capacity * (a3particle_fieldMax + a3particle_stateMax) +
+				sizeof(a3ui32) * (cellCount + 1 + capacity * 2 + blockCount * a3particle_threadMax) + sizeof(a3f32) * 4 * a3particle_payloadWidth * rows);
+			if (data)
+			{
+				memset(fluid_out, 0, sizeof(a3_ParticleFluid));
+				fluid_out->data = data;
+				for (f = 0; f < a3particle_fieldMax; ++f, data += capacity)
+					fluid_out->field[f] = data;
+				for (f = 0; f < a3particle_stateMax; ++f, data += capacity)
+					fluid_out->sorted[f] = data;
+				fluid_out->cellStart = (a3ui32 *)data;
+				fluid_out->cellOf = fluid_out->cellStart + cellCount + 1;
+				fluid_out->order = fluid_out->cellOf + capacity;
+				fluid_out->histogram = fluid_out->order + capacity;
+				fluid_out->payload = (a3f32 *)(fluid_out->histogram + blockCount * a3particle_threadMax);
+				memset(fluid_out->payload, 0, sizeof(a3f32) * 4 * a3particle_payloadWidth * rows);
+				memset(fluid_out->cellStart, 0, sizeof(a3ui32) * (cellCount + 1));
+
+				fluid_out->capacity = capacity;
+				fluid_out->cellsX = cellsX;
+				fluid_out->cellsY = cellsY;
+				fluid_out->cellsZ = cellsZ;
+				fluid_out->cellCount = cellCount;
+				fluid_out->radius = radius;
+				fluid_out->restDensity = a3particle_restDensity;
+				fluid_out->stiffness = a3particle_stiffness;
+				fluid_out->viscosity = a3particle_viscosity;
+				fluid_out->gravity = a3particle_gravity;
+				fluid_out->restitution = a3particle_restitution;
+				fluid_out->threadCount = threadCount > 1 ? threadCount <= a3particle_threadMax ? threadCount : a3particle_threadMax : 1;
+
+				// mass such that particles filling a box, half a radius
+				//	apart, are at rest density
+				h2 = radius * radius;
+				for (z = -2, sum = a3real_zero; z <= 2; ++z)
+					for (y = -2; y <= 2; ++y)
+						for (x = -2; x <= 2; ++x)
+						{
+							dx = (a3real)x * radius * a3real_half;
+							dy = (a3real)y * radius * a3real_half;
+							dz = (a3real)z * radius * a3real_half;
+							q = h2 - (dx * dx + dy * dy + dz * dz);
+							if (q > a3real_zero)
+								sum += q * q * q;
+						}
+				fluid_out->mass = fluid_out->restDensity * (a3real)(64.0 * a3real_pi) * h2 * h2 * h2 * h2 * radius / ((a3real)315.0 * sum);
+				return capacity;
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+a3ret a3particleFluidReset(a3_ParticleFluid *fluid)
+{
+	if (fluid && fluid->data)
+	{
+		fluid->count = 0;
+		fluid->steps = 0;
+		memset(fluid->cellStart, 0, sizeof(a3ui32) * (fluid->cellCount + 1));
+		return 1;
+	}
+	return -1;
+}
+
+a3ret a3particleFluidAddBox(a3_ParticleFluid *fluid, const a3real boxMin[3], const a3real boxMax[3])
+{
+	const a3real size[3] = {
+		fluid ? fluid->radius * (a3real)fluid->cellsX : a3real_zero,
+		fluid ? fluid->radius * (a3real)fluid->cellsY : a3real_zero,
+		fluid ? fluid->radius * (a3real)fluid->cellsZ : a3real_zero,
+	};
+	a3real lo[3], hi[3], p[3], spacing, jitter;
+	a3ui32 count0, axis, f;
+	if (fluid && fluid->data && boxMin && boxMax)
+	{
+		spacing = fluid->radius * a3real_half;
+		for (axis = 0; axis < 3; ++axis)
+		{
+			lo[axis] = boxMin[axis] > a3real_zero ? boxMin[axis] : a3real_zero;
+			hi[axis] = boxMax[axis] < size[axis] ? boxMax[axis] : size[axis];
+		}
+
+		// lattice centered in each spacing; a slight offset per particle
+		//	keeps columns from stacking perfectly
+		count0 = fluid->count;
+		for (p[2] = lo[2] + spacing * a3real_half; p[2] < hi[2]; p[2] += spacing)
+			for (p[1] = lo[1] + spacing * a3real_half; p[1] < hi[1]; p[1] += spacing)
+				for (p[0] = lo[0] + spacing * a3real_half; p[0] < hi[0] && fluid->count < fluid->capacity; p[0] += spacing)
+				{
+					jitter = spacing * 0.01f * (a3real)((a3i32)(fluid->count * 7919u % 17u) - 8);
+					fluid->field[a3particle_positionX][fluid->count] = p[0] + jitter;
+					fluid->field[a3particle_positionY][fluid->count] = p[1];
+					fluid->field[a3particle_positionZ][fluid->count] = p[2] - jitter;
+					for (f = a3particle_velocityX; f < a3particle_fieldMax; ++f)
+						fluid->field[f][fluid->count] = a3real_zero;
+					++fluid->count;
+				}
+		return (fluid->count - count0);
+	}
+	return -1;
+}
+
+a3ret a3particleFluidStep(a3_ParticleFluid *fluid, const a3real dt)
+{
+	a3_ParticleFluidJob job[1];
+	a3real h3;
+	if (fluid && fluid->data && dt > a3real_zero)
+	{
+		h3 = fluid->radius * fluid->radius * fluid->radius;
+		job->fluid = fluid;
+		job->dt = dt;
+		job->poly6 = (a3real)315.0 / ((a3real)(64.0 * a3real_pi) * h3 * h3 * h3);
+		job->spiky = (a3real)45.0 / ((a3real)a3real_pi * h3 * h3);
+		job->laplacian = job->spiky;
+		job->blockCount = (fluid->cellCount + a3particle_cellsPerBlock - 1) / a3particle_cellsPerBlock;
+		a3particleInternalRun(job);
+		return (++fluid->steps);
+	}
+	return -1;
+}
+
+const a3f32 *a3particleFluidUpdatePayload(a3_ParticleFluid *fluid)
+{
+	a3f32 *texel;
+	a3real invRestDensity;
+	a3ui32 i;
+	if (fluid && fluid->data)
+	{
+		invRestDensity = a3real_one / fluid->restDensity;
+		for (i = 0, texel = fluid->payload; i < fluid->count; ++i, texel += 4)
+		{
+			texel[0] = (a3f32)fluid->field[a3particle_positionX][i];
+			texel[1] = (a3f32)fluid->field[a3particle_positionY][i];
+			texel[2] = (a3f32)fluid->field[a3particle_positionZ][i];
+			texel[3] = (a3f32)(fluid->field[a3particle_density][i] * invRestDensity);
+		}
+		return fluid->payload;
+	}
+	return 0;
+}
+
+a3ret a3particleFluidGetPayloadHeight(const a3_ParticleFluid *fluid)
+{
+	if (fluid && fluid->data)
+		return ((fluid->capacity + a3particle_payloadWidth - 1) / a3particle_payloadWidth);
+	return -1;
+}
+
+a3ret a3particleFluidRelease(a3_ParticleFluid *fluid)
+{
+	if (fluid && fluid->data)
+	{
+		free(fluid->data);
+		memset(fluid, 0, sizeof(a3_ParticleFluid));
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,187 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework Extended (A3DX)
+	By Daniel S. Buckstein
+
+	a3_FluidGrid.h
+	Grid-based "stable fluids" solver on the CPU: density is carried by a
+		velocity field that is advected semi-Lagrangian, diffused and made
+		divergence-free by a pressure projection every step. Grids with a
+		depth of one cell are solved in 2D. Each field is a separate array
+		of floats (structure of arrays) with a border of one cell, or is
+		stored sparsely in tiles near the fluid (see a3_FluidTiles.h) for
+		large domains that are mostly empty.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_A3DX_FLUIDGRID_H
+#define __ANIMAL3D_A3DX_FLUIDGRID_H
+
+
+#include "animal3D/a3/a3types_integer.h"
+#include "animal3D/a3/a3types_real.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+typedef struct a3_FluidGrid				a3_FluidGrid;
+typedef enum a3_FluidGridField			a3_FluidGridField;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+// A3: Fields of fluid grid, each stored as its own array.
+enum a3_FluidGridField
+{
+	a3fluid_density,				// density carried by the fluid
+	a3fluid_velocityX,				// velocity components
+	a3fluid_velocityY,
+	a3fluid_velocityZ,
+	a3fluid_densitySource,			// density added over the next step
+	a3fluid_velocityXSource,		// velocity added over the next step
+	a3fluid_velocityYSource,
+	a3fluid_velocityZSource,
+	a3fluid_pressure,				// pressure solved by the projection
+	a3fluid_divergence,				// divergence of velocity before projection
+
+	a3fluid_fieldMax,
+	a3fluid_residual = a3fluid_fieldMax,	// residual of pressure, only stored in tiles (dense multigrid solvers own theirs)
+
+	a3fluid_sparseFieldMax
+};
+
+
+// A3: Fluid grid.
+//	member field: array of each field (see above); sources are used as
+//		scratch space during a step and cleared after it; null if sparse
+//	member multigrid: optional multigrid solver for pressure (see
+//		a3_FluidMultigrid.h); owned by the caller
+//	member tiles: sparse storage of all fields if the grid is sparse, null
+//		if dense; owned by the caller
+//	member payload: interior density packed without the border, with its
+//		slices stacked (see payload functions below); allocated when
+//		first updated if sparse
+//	members sizeX, sizeY, sizeZ: number of interior cells on each axis
+//	members strideY, strideZ: distance between neighbors on each axis in
+//		field arrays
+//	member count: number of cells in field arrays, including the border
+//	member viscosity: diffusion rate of velocity
+//	member diffusion: diffusion rate of density
+//	member dissipation: rate at which density fades
+//	member iterations: relaxation sweeps used to solve diffusion, and
+//		pressure unless a multigrid solver is attached
+//	member steps: number of steps taken
+struct a3_FluidGrid
+{
+	a3f32 *field[a3fluid_fieldMax];
+	struct a3_FluidMultigrid *multigrid;
+	struct a3_FluidTiles *tiles;
+	a3f32 *payload;
+	a3ui32 sizeX, sizeY, sizeZ;
+	a3ui32 strideY, strideZ, count;
+	a3f32 viscosity, diffusion, dissipation;
+	a3ui32 iterations;
+	a3ui32 steps;
+};
+
+
+//-----------------------------------------------------------------------------
+
+// A3: Allocate fluid grid at rest; the domain is a unit square or cube
+//		along its longest axis.
+//	param grid_out: non-null pointer to unused grid
+//	params sizeX, sizeY, sizeZ: non-zero number of cells on each axis;
+//		pass 1 for sizeZ to solve in 2D
+//	return: number of interior cells if success
+//	return: 0 if failed to allocate
+//	return: -1 if invalid params or grid in-use
+a3ret a3fluidGridCreate(a3_FluidGrid *grid_out, const a3ui32 sizeX, const a3ui32 sizeY, const a3ui32 sizeZ);
+
+// A3: Initialize sparse fluid grid at rest, storing its fields in tiles;
+//		only tiles around density and velocity are active, and the band
+//		is refit every step. Cells outside active tiles are open air: no
+//		density, no velocity and no pressure.
+//	param grid_out: non-null pointer to unused grid
+//	param tiles: non-null pointer to initialized storage with at least
+//		a3fluid_sparseFieldMax fields, sized like the domain
+//	return: number of cells in domain if success
+//	return: -1 if invalid params or grid in-use
+a3ret a3fluidGridCreateSparse(a3_FluidGrid *grid_out, struct a3_FluidTiles *tiles);
+
+// A3: Set fluid back to rest without changing settings.
+//	param grid: non-null pointer to initialized grid
+//	return: 1 if success
+//	return: -1 if invalid param
+a3ret a3fluidGridReset(a3_FluidGrid *grid);
+
+// A3: Add density and velocity over the next step in a ball around a
+//		point; strongest at the center and fading to none at its radius.
+//	param grid: non-null pointer to initialized grid
+//	param position: non-null position of center in the unit domain [0, 1]
+//		(z is ignored in 2D)
+//	param radius: positive radius of ball in the unit domain
+//	param density: rate of density to add at center
+//	param velocity_opt: optional rate of velocity to add at center
+//	return: number of cells touched if success
+//	return: -1 if invalid params
+a3ret a3fluidGridAddSource(a3_FluidGrid *grid, const a3f32 position[3], const a3f32 radius, const a3f32 density, const a3f32 velocity_opt[3]);
+
+// A3: Advance fluid by one step; sources added since the last step are
+//		applied and cleared.
+//	param grid: non-null pointer to initialized grid
+//	param dt: positive time step
+//	return: number of steps taken so far if success
+//	return: -1 if invalid params
+a3ret a3fluidGridStep(a3_FluidGrid *grid, const a3f32 dt);
+
+// A3: Pack interior density into the payload: rows of sizeX values,
+//		sizeY rows per slice and sizeZ slices one after another. This is
+//		the data of a single-channel float texture of width sizeX and
+//		height sizeY * sizeZ, ready for a3textureReplaceData, and the
+//		result to read in headless runs.
+//	param grid: non-null pointer to initialized grid
+//	return: pointer to payload if success
+//	return: null if invalid param or failed to allocate
+const a3f32 *a3fluidGridUpdatePayload(a3_FluidGrid *grid);
+
+// A3: Get payload size.
+//	param grid: non-null pointer to initialized grid
+//	return: number of values in payload if success
+//	return: -1 if invalid param
+a3ret a3fluidGridGetPayloadCount(const a3_FluidGrid *grid);
+
+// A3: Release fluid grid; tiles of a sparse grid are left to the caller.
+//	param grid: non-null pointer to initialized grid
+//	return: 1 if success
+//	return: -1 if invalid param
+a3ret a3fluidGridRelease(a3_FluidGrid *grid);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_A3DX_FLUIDGRID_H
@@ -0,0 +1,169 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework Extended (A3DX)
+	By Daniel S. Buckstein
+
+	a3_FluidMultigrid.h
+	Geometric multigrid solver for the pressure of a fluid grid: V-cycles
+		of red-black Gauss-Seidel smoothing on a hierarchy of grids, each
+		half the size of the one above it, converge in a few cycles with
+		work proportional to the number of cells. Each thread owns a slab
+		of slices (rows in 2D) on every level; on sparse grids, threads
+		share the active tiles of each level instead.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_A3DX_FLUIDMULTIGRID_H
+#define __ANIMAL3D_A3DX_FLUIDMULTIGRID_H
+
+
+#include "a3_FluidGrid.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+typedef struct a3_FluidMultigridLevel	a3_FluidMultigridLevel;
+typedef struct a3_FluidMultigrid		a3_FluidMultigrid;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+// A3: Limits of multigrid solver.
+enum a3_FluidMultigridLimit
+{
+	a3fluid_multigridLevelMax = 12,		// levels in hierarchy
+	a3fluid_multigridThreadMax = 16,	// threads working on a solve
+};
+
+
+// A3: Level of multigrid hierarchy, laid out like the fluid grid (border
+//		of one cell; no border slices in 2D).
+//	member x: solution; pressure on the finest level, error on the others
+//	member b: right-hand side; divergence on the finest level, restricted
+//		residual on the others
+//	member r: residual of the level
+//	member tiles: sparse storage of x, b and r if the level is sparse, in
+//		which case the arrays are null; the finest level uses the tiles
+//		of the fluid grid
+//	member tileField: fields of x, b and r in sparse storage
+//	members sizeX, sizeY, sizeZ: number of interior cells on each axis
+//	members strideY, strideZ: distance between neighbors on each axis
+//	member count: number of cells in each array, including the border
+struct a3_FluidMultigridLevel
+{
+	a3f32 *x, *b, *r;
+	struct a3_FluidTiles *tiles;
+	a3ui32 tileField[3];
+	a3ui32 sizeX, sizeY, sizeZ;
+	a3ui32 strideY, strideZ, count;
+};
+
+
+// A3: Multigrid solver.
+//	member level: hierarchy, finest first; arrays of the finest level
+//		other than the residual belong to the fluid grid and are bound
+//		when solving
+//	member data: block holding all arrays owned by the solver; for sparse
+//		grids, the tiled storage of coarse levels and tileNorm
+//	member tileNorm: squared norms of the residual and divergence of each
+//		active tile of the finest sparse level, summed in order
+//	member levelCount: number of levels in hierarchy
+//	member threadCount: number of threads working on a solve
+//	members preSmooth, postSmooth: red-black sweeps before restricting and
+//		after prolonging on each level
+//	member coarseSweeps: red-black sweeps solving the coarsest level
+//	member cycles: most V-cycles run per solve
+//	member tolerance: stop early once the residual relative to the
+//		divergence falls below this; zero to always run all cycles,
+//		skipping the extra residual pass each cycle
+//	member residual: residual relative to the divergence after the last
+//		solve; only measured if tolerance is positive
+//	member cyclesRun: V-cycles run by the last solve
+//	members started, barrierCount, barrierGeneration, partial, ticket: 
+//		shared by threads during a solve
+struct a3_FluidMultigrid
+{
+	a3_FluidMultigridLevel level[a3fluid_multigridLevelMax];
+	a3f32 *data;
+	a3f64 *tileNorm;
+	a3ui32 levelCount;
+	a3ui32 threadCount;
+	a3ui32 preSmooth, postSmooth, coarseSweeps;
+	a3ui32 cycles;
+	a3f32 tolerance;
+	a3f32 residual;
+	a3ui32 cyclesRun;
+	volatile a3i32 started, barrierCount, barrierGeneration;
+	a3f64 partial[a3fluid_multigridThreadMax][2];
+	volatile a3i32 ticket;
+};
+
+
+//-----------------------------------------------------------------------------
+
+// A3: Allocate multigrid hierarchy for grids the size of a fluid grid;
+//		levels are halved until an axis has fewer than four cells. Levels
+//		of sparse grids are tiled too, and are halved while every axis
+//		spans an even number of tiles; coarse tiles are active wherever
+//		the tiles they cover are.
+//	param multigrid_out: non-null pointer to unused solver
+//	param grid: non-null pointer to initialized grid to take size from
+//	param threadCount: number of threads working on a solve; clamped to
+//		[1, a3fluid_multigridThreadMax]
+//	return: number of levels if success
+//	return: 0 if failed to allocate
+//	return: -1 if invalid params or solver in-use
+a3ret a3fluidMultigridCreate(a3_FluidMultigrid *multigrid_out, const a3_FluidGrid *grid, const a3ui32 threadCount);
+
+// A3: Solve for pressure of fluid grid from its divergence, starting from
+//		its current pressure; borders of both must be set. The pressure
+//		border is set when done. Sparse grids must be solved by a solver
+//		created for a sparse grid of the same size, and vice versa.
+//	param multigrid: non-null pointer to initialized solver
+//	param grid: non-null pointer to initialized grid of the same size
+//	return: number of V-cycles run if success
+//	return: -1 if invalid params
+a3ret a3fluidMultigridSolve(a3_FluidMultigrid *multigrid, a3_FluidGrid *grid);
+
+// A3: Measure residual of pressure of fluid grid relative to its
+//		divergence, for comparing solvers.
+//	param grid: non-null pointer to initialized grid
+//	return: relative residual (L2 norm) if success
+//	return: negative if invalid param
+a3f32 a3fluidMultigridResidual(const a3_FluidGrid *grid);
+
+// A3: Release multigrid solver.
+//	param multigrid: non-null pointer to initialized solver
+//	return: 1 if success
+//	return: -1 if invalid param
+a3ret a3fluidMultigridRelease(a3_FluidMultigrid *multigrid);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_A3DX_FLUIDMULTIGRID_H
@@ -0,0 +1,302 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework Extended (A3DX)
+	By Daniel S. Buckstein
+
+	a3_FluidTiles.h
+	Sparse tiled storage for fields of large grids: the domain is split
+		into tiles of 8x8x8 cells (8x8 in 2D) and only tiles near the
+		fluid hold data, so that most of a big domain, empty air, costs
+		one directory entry per tile. A dense directory over all tiles
+		points to slots, and slots live in pages of tiles allocated as
+		needed and reused once released. Passes run over the list of
+		active tiles on several threads. Each tile can be gathered with a
+		border of one cell from its neighbors into a block laid out like a
+		grid of one tile (see a3_FluidGrid.h), so that stencils written
+		for dense grids work on it unchanged.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_A3DX_FLUIDTILES_H
+#define __ANIMAL3D_A3DX_FLUIDTILES_H
+
+
+#include "animal3D/a3/a3types_integer.h"
+#include "animal3D/a3/a3types_real.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+typedef struct a3_FluidTiles			a3_FluidTiles;
+typedef struct a3_FluidTilesPass		a3_FluidTilesPass;
+typedef enum a3_FluidTilesBound			a3_FluidTilesBound;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+// A3: Limits of tiled storage.
+enum a3_FluidTilesLimit
+{
+	a3fluid_tileWidth = 8,				// cells on each axis of a tile (one slice in 2D)
+	a3fluid_tileBlockWidth = 10,		// cells on each axis of a gathered block, border included
+	a3fluid_tileBlockCount = 1000,		// cells in a gathered block (first 100 used in 2D)
+	a3fluid_tilePageSize = 64,			// tiles allocated at once
+	a3fluid_tilesFieldMax = 16,			// fields stored in each tile
+	a3fluid_tilesThreadMax = 16,		// threads working on active tiles
+};
+
+
+// A3: Conditions at walls of the domain when gathering a block: values
+//		are mirrored, and the component of a vector across the wall is
+//		negated so that none flows through it (as a3_FluidGrid does).
+enum a3_FluidTilesBound
+{
+	a3fluid_tileBoundScalar,
+	a3fluid_tileBoundX,
+	a3fluid_tileBoundY,
+	a3fluid_tileBoundZ,
+};
+
+
+// A3: Face neighbor of active tile that is outside the domain; empty
+//		neighbors are -1 and active neighbors hold their slot.
+#define a3fluid_tileWall	(-2)
+
+
+// A3: Tiled storage.
+//	member page: pages of tiles, allocated as slots are first needed; the
+//		fields of a tile are stored one after another
+//	member slot: dense directory of slot of each tile of the domain, or
+//		-1 if the tile is empty
+//	member active: tile index of each active tile, in directory order
+//	member neighbor: slots of the face neighbors of each active tile, six
+//		per tile (-x, +x, -y, +y, -z, +z); -1 if empty, a3fluid_tileWall
+//		if past a wall
+//	member freeSlot: stack of slots released for reuse
+//	member mark: flags of each tile, used to update the band
+//	member data: block holding directory and lists
+//	member map: storage of each field in a tile; fields are swapped by
+//		swapping their storage
+//	member background: value of each field in empty tiles
+//	members sizeX, sizeY, sizeZ: number of cells on each axis
+//	members tilesX, tilesY, tilesZ: number of tiles on each axis
+//	member tileCount: number of tiles in domain
+//	member tileDepth: cells on z axis of each tile; one in 2D
+//	member cellsPerTile: cells in each field of a tile
+//	member fieldCount: fields stored in each tile
+//	member pageCount: number of pages allocated
+//	member slotCount: slots handed out so far, released or not
+//	member freeCount: number of released slots
+//	member activeCount: number of active tiles
+//	member threadCount: number of threads working on active tiles
+//	member threshold: tiles whose fields stay within this of background
+//		are unoccupied when updating the band
+//	member band: tiles kept around occupied ones when updating the band
+struct a3_FluidTiles
+{
+	a3f32 **page;
+	a3i32 *slot;
+	a3ui32 *active;
+	a3i32 *neighbor;
+	a3ui32 *freeSlot;
+	a3ubyte *mark;
+	void *data;
+	a3ui32 map[a3fluid_tilesFieldMax];
+	a3f32 background[a3fluid_tilesFieldMax];
+	a3ui32 sizeX, sizeY, sizeZ;
+	a3ui32 tilesX, tilesY, tilesZ, tileCount;
+	a3ui32 tileDepth, cellsPerTile;
+	a3ui32 fieldCount;
+	a3ui32 pageCount, slotCount, freeCount;
+	a3ui32 activeCount;
+	a3ui32 threadCount;
+	a3f32 threshold;
+	a3ui32 band;
+};
+
+
+// A3: Pass over one active tile, run by a3fluidTilesForEach; it may write
+//		its own tile, and read tiles that no pass running with it writes.
+//	param tiles: storage
+//	param index: index of tile in active list
+//	param arg: argument given to a3fluidTilesForEach
+typedef void(*a3_FluidTilesKernel)(const a3_FluidTiles *tiles, const a3ui32 index, void *arg);
+
+
+// A3: Pass of a list run by a3fluidTilesForEachList.
+//	member kernel: non-null pass run on each tile
+//	member arg: argument given to kernel
+//	member color: 0 or 1 to only visit tiles of that color, negative to
+//		visit all (see a3fluidTilesForEach)
+struct a3_FluidTilesPass
+{
+	a3_FluidTilesKernel kernel;
+	void *arg;
+	a3i32 color;
+};
+
+
+//-----------------------------------------------------------------------------
+
+// A3: Allocate empty tiled storage; no tile holds data until activated.
+//	param tiles_out: non-null pointer to unused storage
+//	params sizeX, sizeY, sizeZ: number of cells on each axis, multiples of
+//		the tile width; pass 1 for sizeZ to store 2D fields
+//	param fieldCount: number of fields in [1, a3fluid_tilesFieldMax]
+//	param threadCount: number of threads working on active tiles; clamped
+//		to [1, a3fluid_tilesThreadMax]
+//	return: number of tiles in domain if success
+//	return: 0 if failed to allocate
+//	return: -1 if invalid params or storage in-use
+a3ret a3fluidTilesCreate(a3_FluidTiles *tiles_out, const a3ui32 sizeX, const a3ui32 sizeY, const a3ui32 sizeZ, const a3ui32 fieldCount, const a3ui32 threadCount);
+
+// A3: Empty all tiles; pages are kept for reuse.
+//	param tiles: non-null pointer to initialized storage
+//	return: 1 if success
+//	return: -1 if invalid param
+a3ret a3fluidTilesReset(a3_FluidTiles *tiles);
+
+// A3: Activate tile, filling its fields with background if it was
+//		empty; the active list is stale until updated.
+//	param tiles: non-null pointer to initialized storage
+//	param tile: index of tile in directory
+//	return: slot of tile if success
+//	return: -1 if invalid params or failed to allocate
+a3i32 a3fluidTilesActivate(a3_FluidTiles *tiles, const a3ui32 tile);
+
+// A3: Empty tile, releasing its slot; the active list is stale until
+//		updated.
+//	param tiles: non-null pointer to initialized storage
+//	param tile: index of tile in directory
+//	return: 1 if tile was released
+//	return: 0 if tile was already empty
+//	return: -1 if invalid params
+a3ret a3fluidTilesDeactivate(a3_FluidTiles *tiles, const a3ui32 tile);
+
+// A3: Rebuild active list and neighbors from the directory.
+//	param tiles: non-null pointer to initialized storage
+//	return: number of active tiles if success
+//	return: -1 if invalid param
+a3ret a3fluidTilesUpdate(a3_FluidTiles *tiles);
+
+// A3: Fit active tiles to the narrow band around the fields: tiles where
+//		any of the given fields is further than the threshold from
+//		background are occupied, tiles within the band of an occupied tile
+//		are activated and all others are emptied; the active list is then
+//		updated.
+//	param tiles: non-null pointer to initialized storage
+//	param fieldMask: bit for each field to test
+//	return: number of active tiles if success
+//	return: -1 if invalid params
+a3ret a3fluidTilesUpdateBand(a3_FluidTiles *tiles, const a3ui32 fieldMask);
+
+// A3: Swap storage of two fields in all tiles.
+//	param tiles: non-null pointer to initialized storage
+//	params fieldA, fieldB: fields to swap
+//	return: 1 if success
+//	return: -1 if invalid params
+a3ret a3fluidTilesSwap(a3_FluidTiles *tiles, const a3ui32 fieldA, const a3ui32 fieldB);
+
+// A3: Gather field of active tile and a border of one cell around it
+//		into a block laid out like a grid of one tile: interior cells are
+//		1 to tile width on each axis (x, then y, then z; 2D blocks have no
+//		border slices), empty neighbors read as background and walls
+//		mirror the tile. Edges and corners of the border are not set.
+//	param tiles: non-null pointer to initialized storage
+//	param index: index of tile in active list
+//	param field: field to gather
+//	param bound: wall condition of field
+//	param block_out: non-null array of a3fluid_tileBlockCount values
+//	return: 1 if success
+//	return: -1 if invalid params
+a3ret a3fluidTilesGather(const a3_FluidTiles *tiles, const a3ui32 index, const a3ui32 field, const a3_FluidTilesBound bound, a3f32 *block_out);
+
+// A3: Store interior of block gathered from active tile back in field.
+//	param tiles: non-null pointer to initialized storage
+//	param index: index of tile in active list
+//	param field: field to store
+//	param block: non-null block laid out as gathered
+//	return: 1 if success
+//	return: -1 if invalid params
+a3ret a3fluidTilesScatter(const a3_FluidTiles *tiles, const a3ui32 index, const a3ui32 field, const a3f32 *block);
+
+// A3: Gather field in any box of cells, which may reach one cell past
+//		each wall; rows of width values, height rows per slice.
+//	param tiles: non-null pointer to initialized storage
+//	param field: field to gather
+//	param bound: wall condition of field
+//	params x0, y0, z0: first cell of box
+//	params width, height, depth: cells of box on each axis
+//	param box_out: non-null array of width * height * depth values
+//	return: number of cells gathered if success
+//	return: -1 if invalid params
+a3ret a3fluidTilesGatherBox(const a3_FluidTiles *tiles, const a3ui32 field, const a3_FluidTilesBound bound,
+	const a3i32 x0, const a3i32 y0, const a3i32 z0, const a3ui32 width, const a3ui32 height, const a3ui32 depth, a3f32 *box_out);
+
+// A3: Run pass over active tiles on all threads of storage; threads take
+//		tiles one at a time until none are left. To run several passes
+//		in a row, use a3fluidTilesForEachList below.
+//	param tiles: non-null pointer to initialized storage
+//	param kernel: non-null pass run on each tile
+//	param arg: argument given to kernel
+//	param color: 0 or 1 to only visit tiles of that color (tiles sharing
+//		a face have different colors), negative to visit all
+//	return: number of tiles visited if success
+//	return: -1 if invalid params
+a3ret a3fluidTilesForEach(a3_FluidTiles *tiles, const a3_FluidTilesKernel kernel, void *arg, const a3i32 color);
+
+// A3: Run passes over active tiles in order, the whole list repeated, on
+//		one launch of the threads of storage; threads meet after each
+//		pass, so every pass sees the results of the ones before it.
+//	param tiles: non-null pointer to initialized storage
+//	param pass: non-null array of passes
+//	param passCount: non-zero number of passes
+//	param repeat: number of times to run the list
+//	return: number of tiles visited by all passes if success
+//	return: -1 if invalid params
+a3ret a3fluidTilesForEachList(a3_FluidTiles *tiles, const a3_FluidTilesPass *pass, const a3ui32 passCount, const a3ui32 repeat);
+
+// A3: Get memory held by storage.
+//	param tiles: non-null pointer to initialized storage
+//	return: number of bytes allocated if success
+//	return: 0 if invalid param
+a3ui64 a3fluidTilesGetMemory(const a3_FluidTiles *tiles);
+
+// A3: Release tiled storage.
+//	param tiles: non-null pointer to initialized storage
+//	return: 1 if success
+//	return: -1 if invalid param
+a3ret a3fluidTilesRelease(a3_FluidTiles *tiles);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#include "_inl/a3_FluidTiles.inl"
+
+
+#endif	// !__ANIMAL3D_A3DX_FLUIDTILES_H
@@ -0,0 +1,195 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework Extended (A3DX)
+	By Daniel S. Buckstein
+
+	a3_ParticleFluid.h
+	Particle fluid on the CPU by smoothed-particle hydrodynamics (SPH):
+		each particle carries mass, and density, pressure and viscosity
+		are sums over neighbors within the smoothing radius. Neighbors are
+		found with a uniform grid of cells as wide as that radius; every
+		step the particles are sorted by cell (counting sort), so that the
+		neighbors of a cell are a few runs of consecutive particles. Each
+		field is a separate array of reals (structure of arrays).
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#ifndef __ANIMAL3D_A3DX_PARTICLEFLUID_H
+#define __ANIMAL3D_A3DX_PARTICLEFLUID_H
+
+
+#include "animal3D/a3/a3types_integer.h"
+#include "animal3D/a3/a3types_real.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+typedef struct a3_ParticleFluid			a3_ParticleFluid;
+typedef enum a3_ParticleFluidField		a3_ParticleFluidField;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+// A3: Limits of particle fluid.
+enum a3_ParticleFluidLimit
+{
+	a3particle_threadMax = 16,			// threads working on a step
+	a3particle_payloadWidth = 1024,		// texels per row of payload
+};
+
+
+// A3: Fields of particle fluid, each stored as its own array; position
+//		and velocity are the state of a particle, the others are found
+//		from it every step.
+enum a3_ParticleFluidField
+{
+	a3particle_positionX,
+	a3particle_positionY,
+	a3particle_positionZ,
+	a3particle_velocityX,
+	a3particle_velocityY,
+	a3particle_velocityZ,
+	a3particle_stateMax,
+
+	a3particle_accelerationX = a3particle_stateMax,
+	a3particle_accelerationY,
+	a3particle_accelerationZ,
+	a3particle_density,
+	a3particle_pressure,
+
+	a3particle_fieldMax
+};
+
+
+// A3: Particle fluid.
+//	member field: array of each field (see above), in cell order after a
+//		step
+//	member sorted: arrays that state is sorted into, then swapped with
+//	member cellStart: index of first particle of each cell, and one past
+//		the last particle
+//	member cellOf: cell of each particle, before sorting
+//	member order: particles in order of block of cells, while sorting
+//	member histogram: number of particles in each block of cells counted 
+//		by each thread while sorting, then where that thread places them
+//	member payload: position and density of each particle (see payload
+//		functions below)
+//	member data: block holding all of the above
+//	members count, capacity: number of particles and most particles
+//	members cellsX, cellsY, cellsZ, cellCount: number of cells on each
+//		axis and in total; the domain spans this many smoothing radii
+//	member radius: smoothing radius and width of cells
+//	member mass: mass of each particle
+//	member restDensity: density the fluid settles to
+//	member stiffness: pressure per density above rest
+//	member viscosity: strength of viscosity
+//	member gravity: acceleration due to gravity, along -y
+//	member restitution: fraction of speed kept bouncing off walls
+//	member threadCount: number of threads working on a step
+//	member steps: number of steps taken
+struct a3_ParticleFluid
+{
+	a3real *field[a3particle_fieldMax];
+	a3real *sorted[a3particle_stateMax];
+	a3ui32 *cellStart, *cellOf;
+	a3ui32 *order, *histogram;
+	a3f32 *payload;
+	void *data;
+	a3ui32 count, capacity;
+	a3ui32 cellsX, cellsY, cellsZ, cellCount;
+	a3real radius, mass;
+	a3real restDensity, stiffness, viscosity;
+	a3real gravity, restitution;
+	a3ui32 threadCount;
+	a3ui32 steps;
+};
+
+
+//-----------------------------------------------------------------------------
+
+// A3: Allocate particle fluid without particles; settings are those of
+//		water, in meters.
+//	param fluid_out: non-null pointer to unused fluid
+//	param capacity: non-zero most particles
+//	params cellsX, cellsY, cellsZ: non-zero number of cells on each axis
+//	param radius: positive smoothing radius
+//	param threadCount: number of threads working on a step; clamped to
+//		[1, a3particle_threadMax]
+//	return: capacity if success
+//	return: 0 if failed to allocate
+//	return: -1 if invalid params or fluid in-use
+a3ret a3particleFluidCreate(a3_ParticleFluid *fluid_out, const a3ui32 capacity, const a3ui32 cellsX, const a3ui32 cellsY, const a3ui32 cellsZ, const a3real radius, const a3ui32 threadCount);
+
+// A3: Remove all particles without changing settings.
+//	param fluid: non-null pointer to initialized fluid
+//	return: 1 if success
+//	return: -1 if invalid param
+a3ret a3particleFluidReset(a3_ParticleFluid *fluid);
+
+// A3: Fill a box with particles at rest, half a radius apart, so that
+//		they start near rest density.
+//	param fluid: non-null pointer to initialized fluid
+//	param boxMin, boxMax: non-null corners of box in the domain; clamped
+//		to the domain
+//	return: number of particles added if success (stops at capacity)
+//	return: -1 if invalid params
+a3ret a3particleFluidAddBox(a3_ParticleFluid *fluid, const a3real boxMin[3], const a3real boxMax[3]);
+
+// A3: Advance fluid by one step: sort particles by cell, then find
+//		density and pressure, then acceleration, then move.
+//	param fluid: non-null pointer to initialized fluid
+//	param dt: positive time step
+//	return: number of steps taken so far if success
+//	return: -1 if invalid params
+a3ret a3particleFluidStep(a3_ParticleFluid *fluid, const a3real dt);
+
+// A3: Pack position and density relative to rest of each particle into
+//		the payload: four floats per particle, a3particle_payloadWidth
+//		particles per row. This is the data of a four-channel float
+//		texture, ready for a3textureReplaceData; particle i is the texel
+//		at (i % width, i / width).
+//	param fluid: non-null pointer to initialized fluid
+//	return: pointer to payload if success
+//	return: null if invalid param
+const a3f32 *a3particleFluidUpdatePayload(a3_ParticleFluid *fluid);
+
+// A3: Get number of rows in payload, enough for capacity.
+//	param fluid: non-null pointer to initialized fluid
+//	return: number of rows if success
+//	return: -1 if invalid param
+a3ret a3particleFluidGetPayloadHeight(const a3_ParticleFluid *fluid);
+
+// A3: Release particle fluid.
+//	param fluid: non-null pointer to initialized fluid
+//	return: 1 if success
+//	return: -1 if invalid param
+a3ret a3particleFluidRelease(a3_ParticleFluid *fluid);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_A3DX_PARTICLEFLUID_H
@@ -49,4 +49,27 @@ void a3intro_unloadValidate(a3_DemoState const* demoState, a3_DemoMode0_Intro* d
 }
 
 
+// clear pointers set by load validation, so a saved copy of the mode 
+//	does not depend on where it was in memory
+void a3intro_unlink(a3_DemoState const* demoState, a3_DemoMode0_Intro* demoMode)
+{
+	a3_SceneObjectComponent* currentObj = demoMode->sceneObject,
+		* const endObj = currentObj + introMaxCount_sceneObject;
+	a3_ProjectorComponent* currentProj = demoMode->projector,
+		* const endProj = currentProj + introMaxCount_projector;
+
+	for (; currentObj < endObj; ++currentObj)
+	{
+		currentObj->dataPtr = 0;
+		currentObj->modelMatrixStackPtr = 0;
+	}
+	for (; currentProj < endProj; ++currentProj)
+	{
+		currentProj->dataPtr = 0;
+		currentProj->projectorMatrixStackPtr = 0;
+		currentProj->sceneObjectPtr = 0;
+	}
+}
+
+
 //-----------------------------------------------------------------------------
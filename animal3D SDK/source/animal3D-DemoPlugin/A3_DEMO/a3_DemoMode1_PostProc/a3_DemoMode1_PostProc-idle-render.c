@@ -380,6 +380,32 @@ void a3postproc_render(a3_DemoState const* demoState, a3_DemoMode1_PostProc cons
 		a3vertexDrawableActivateAndRender(drawable[j]);
 	}
 
+	// particle fluid: one small sphere per particle, placed by its texel;
+	//	the simulation is y-up, so its domain is turned to stand on the
+	//	ground and scaled up to be seen in the scene
+	if (demoState->particles->count)
+	{
+		a3real const particleScale = 4.0f;
+		a3f64 const particleSize = (a3f64)(demoState->particles->radius * a3real_quarter);
+		modelMat = a3mat4_identity;
+		modelMat.m[0][0] = particleScale;
+		modelMat.m[1][1] = a3real_zero;
+		modelMat.m[1][2] = particleScale;
+		modelMat.m[2][1] = -particleScale;
+		modelMat.m[2][2] = a3real_zero;
+		modelMat.m[3][0] = -a3real_half * particleScale * demoState->particles->radius * (a3real)demoState->particles->cellsX;
+		modelMat.m[3][1] = a3real_half * particleScale * demoState->particles->radius * (a3real)demoState->particles->cellsZ;
+		a3real4x4Product(modelViewProjectionMat.m, viewProjectionMat.m, modelMat.m);
+
+		currentDemoProgram = demoState->prog_drawParticle_instanced;
+		a3shaderProgramActivate(currentDemoProgram->program);
+		a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelViewProjectionMat.mm);
+		a3shaderUniformSendDouble(a3unif_single, currentDemoProgram->uSize, 1, &particleSize);
+		a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uColor, 1, sky);
+		a3textureActivate(demoState->tex_particles, a3tex_unit00);
+		a3vertexDrawableActivateAndRenderInstanced(demoState->draw_particle, demoState->particles->count);
+	}
+
 	// stop using stencil
 	if (demoState->stencilTest)
 		glDisable(GL_STENCIL_TEST);
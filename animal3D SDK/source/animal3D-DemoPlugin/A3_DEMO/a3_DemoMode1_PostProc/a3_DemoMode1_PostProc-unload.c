@@ -49,4 +49,34 @@ void a3postproc_unloadValidate(a3_DemoState const* demoState, a3_DemoMode1_PostP
 }
 
 
+// clear pointers set by load validation, so a saved copy of the mode 
+//	does not depend on where it was in memory
+void a3postproc_unlink(a3_DemoState const* demoState, a3_DemoMode1_PostProc* demoMode)
+{
+	a3_SceneObjectComponent* currentObj = demoMode->sceneObject,
+		* const endObj = currentObj + postprocMaxCount_sceneObject;
+	a3_ProjectorComponent* currentProj = demoMode->projector,
+		* const endProj = currentProj + postprocMaxCount_projector;
+	a3_PointLightComponent* currentLight = demoMode->pointLight,
+		* const endLight = currentLight + postprocMaxCount_pointLight;
+
+	for (; currentObj < endObj; ++currentObj)
+	{
+		currentObj->dataPtr = 0;
+		currentObj->modelMatrixStackPtr = 0;
+	}
+	for (; currentProj < endProj; ++currentProj)
+	{
+		currentProj->dataPtr = 0;
+		currentProj->projectorMatrixStackPtr = 0;
+		currentProj->sceneObjectPtr = 0;
+	}
+	for (; currentLight < endLight; ++currentLight)
+	{
+		currentLight->dataPtr = 0;
+		currentLight->sceneObjectPtr = 0;
+	}
+}
+
+
 //-----------------------------------------------------------------------------
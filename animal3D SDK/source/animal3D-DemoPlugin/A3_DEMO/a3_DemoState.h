@@ -40,8 +40,12 @@
 //-----------------------------------------------------------------------------
 // other demo includes
 
+#include "_a3_demo_utilities/a3_DemoGolden.h"
 #include "_a3_demo_utilities/a3_DemoSceneObject.h"
 #include "_a3_demo_utilities/a3_DemoShaderProgram.h"
+#include "_simulation/a3_FluidGrid.h"
+#include "_simulation/a3_FluidMultigrid.h"
+#include "_simulation/a3_ParticleFluid.h"
 
 #include "a3_DemoMode0_Intro.h"
 #include "a3_DemoMode1_PostProc.h"
@@ -90,12 +94,13 @@ enum a3_DemoState_TextDisplayName
 //	more than enough memory to hold extra objects
 enum a3_DemoState_ObjectMaxCount
 {
-	demoStateMaxCount_timer = 1,
+	demoStateMaxCount_timer = 3,
 
 	demoStateMaxCount_drawDataBuffer = 1,
 	demoStateMaxCount_vertexArray = 4,
 	demoStateMaxCount_drawable = 16,
 
+	demoStateMaxCount_shader = 32,
 	demoStateMaxCount_shaderProgram = 32,
 	demoStateMaxCount_uniformBuffer = 8,
 
@@ -104,6 +109,31 @@ enum a3_DemoState_ObjectMaxCount
 	demoStateMaxCount_framebuffer = 16,
 };
 
+
+// fluid simulation settings
+enum a3_DemoState_FluidSetting
+{
+	demoStateFluid_sizeX = 32,			// cells on each axis
+	demoStateFluid_sizeY = 32,
+	demoStateFluid_sizeZ = 32,
+	demoStateFluid_rate = 30,			// steps per second
+	demoStateFluid_iterations = 20,		// relaxation sweeps per diffusion solve
+	demoStateFluid_cycles = 2,			// multigrid V-cycles per pressure solve
+	demoStateFluid_threads = 4,			// threads per pressure solve
+};
+
+// particle fluid settings; cells are one smoothing radius wide
+enum a3_DemoState_ParticleSetting
+{
+	demoStateParticle_cellsX = 16,		// cells on each axis
+	demoStateParticle_cellsY = 16,
+	demoStateParticle_cellsZ = 16,
+	demoStateParticle_capacity = 16384,	// most particles
+	demoStateParticle_rate = 60,		// frames per second
+	demoStateParticle_substeps = 4,		// steps per frame
+	demoStateParticle_threads = 4,		// threads per step
+};
+
 	
 //-----------------------------------------------------------------------------
 
@@ -133,6 +163,10 @@ struct a3_DemoState
 	// asset streaming between loads enabled (careful!)
 	a3boolean streaming;
 
+	// no graphics context (e.g. batch runner): graphics objects are not 
+	//	created, nothing is drawn and the display timer steps once per idle
+	a3boolean headless;
+
 	// window and full-frame dimensions
 	a3ui32 windowWidth, windowHeight;
 	a3real windowWidthInv, windowHeightInv, windowAspect;
@@ -154,6 +188,20 @@ struct a3_DemoState
 	a3_KeyboardInput keyboard[1];
 	a3_XboxControllerInput xcontrol[4];
 
+	// input record/replay of the first controller, keyboard and mouse
+	a3_InputRecorder inputRecorder[1];
+
+	// golden output of the scene update, written or compared every tick
+	a3_DemoGolden golden[1];
+
+	// fluid simulation, stepped by its own fixed-rate timer, and its
+	//	pressure solver
+	a3_FluidGrid fluid[1];
+	a3_FluidMultigrid fluidMultigrid[1];
+
+	// particle fluid, stepped by its own fixed-rate timer
+	a3_ParticleFluid particles[1];
+
 	// pointer to fast trig table
 	a3f32 trigTable[4096 * 4];
 
@@ -161,6 +209,10 @@ struct a3_DemoState
 	a3f64 t_timer, dt_timer, dt_timer_tot;
 	a3i64 n_timer;
 
+	// sections of this state saved across hot builds; kept between builds 
+	//	so that sections that did not change are not saved again
+	a3_Serializer *persist;
+
 
 	//-------------------------------------------------------------------------
 	// scene variables and objects
@@ -177,6 +229,7 @@ struct a3_DemoState
 	a3boolean displayGrid, displaySkybox, displayHiddenVolumes;
 	a3boolean displayWorldAxes, displayObjectAxes;
 	a3boolean displayTangentBases, displayWireframe;
+	a3boolean displayFluid;
 	a3boolean updateAnimation;
 	a3boolean stencilTest;
 	a3boolean skipIntermediatePasses;
@@ -194,7 +247,9 @@ struct a3_DemoState
 		a3_Timer timer[demoStateMaxCount_timer];
 		struct {
 			a3_Timer
-				timer_display[1];						// render FPS timer
+				timer_display[1],						// render FPS timer
+				timer_fluid[1],							// fluid step timer
+				timer_particles[1];						// particle fluid frame timer
 		};
 	};
 
@@ -227,7 +282,8 @@ struct a3_DemoState
 		struct {
 			a3_VertexDrawable
 				draw_grid[1],								// wireframe ground plane to emphasize scaling
-				draw_axes[1];								// coordinate axes at the center of the world
+				draw_axes[1],								// coordinate axes at the center of the world
+				draw_particle[1];							// low-detail unit sphere drawn for each particle
 			a3_VertexDrawable
 				draw_unit_box[1],							// unit box (width = height = depth = 1)
 				draw_unit_sphere[1],						// unit sphere (radius = 1)
@@ -264,6 +320,8 @@ struct a3_DemoState
 			a3_DemoStateShaderProgram
 				prog_drawTangentBasis_instanced[1],			// draw vertex/face tangent bases and wireframe with instancing
 				prog_drawTangentBasis[1];					// draw vertex/face tangent bases and wireframe
+			a3_DemoStateShaderProgram
+				prog_drawParticle_instanced[1];				// draw uniform color sphere at each particle, instanced
 			a3_DemoStateShaderProgram
 				prog_postBright[1],							// post-processing bright pass (e.g. luminance)
 				prog_postBlur[1],							// post-processing blur pass (e.g. Gaussian)
@@ -273,6 +331,11 @@ struct a3_DemoState
 		};
 	};
 
+	// source files each shader was built from, polled to rebuild programs 
+	//	when their files change
+	a3_ShaderIncludeGraph shaderGraph[1];
+	a3f64 t_shaderPoll;
+
 	// uniform buffers
 	union {
 		a3_UniformBuffer uniformBuffer[demoStateMaxCount_uniformBuffer];
@@ -307,6 +370,9 @@ struct a3_DemoState
 				tex_ramp_sm[1],
 				tex_testsprite[1],
 				tex_checker[1];
+			a3_Texture
+				tex_fluid[1],							// fluid density, slices stacked
+				tex_particles[1];						// particle position and density
 		};
 	};
 
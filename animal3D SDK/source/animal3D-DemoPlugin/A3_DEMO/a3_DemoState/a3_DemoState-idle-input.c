@@ -153,6 +153,9 @@ void a3demo_input_keyCharPress(a3_DemoState* demoState, a3i32 const asciiKey)
 		// toggle wireframe overlay
 		a3demoCtrlCaseToggle(demoState->displayWireframe, 'F');
 
+		// toggle fluid density overlay
+		a3demoCtrlCaseToggle(demoState->displayFluid, 'f');
+
 		// update animation
 		a3demoCtrlCaseToggle(demoState->updateAnimation, 'm');
 
@@ -82,6 +82,8 @@ void a3demo_render_controls_global(a3_DemoState const* demoState,
 			"Toggle text display:        't' (toggle) | 'T' (alloc/dealloc) ");
 		a3textDraw(text, textAlign, textOffset += textOffsetDelta, textDepth, col.r, col.g, col.b, col.a,
 			"Reload all shader programs: 'P' ****CHECK CONSOLE FOR ERRORS!**** ");
+		a3textDraw(text, textAlign, textOffset += textOffsetDelta, textDepth, col.r, col.g, col.b, col.a,
+			"Toggle profiler capture:    'R' (writes './data/trace.json') ");
 	}
 }
 
@@ -140,7 +142,7 @@ void a3demo_render_controls_gen(a3_DemoState const* demoState,
 	a3textDraw(text, textAlign, textOffset += textOffsetDelta, textDepth, col.r, col.g, col.b, col.a,
 		"WORLD AXES (toggle 'x') %s | OBJECT AXES ('z') %s", boolText[demoState->displayWorldAxes], boolText[demoState->displayObjectAxes]);
 	a3textDraw(text, textAlign, textOffset += textOffsetDelta, textDepth, col.r, col.g, col.b, col.a,
-		"TANGENT BASES ('B') %s | WIREFRAME ('F') %s", boolText[demoState->displayTangentBases], boolText[demoState->displayWireframe]);
+		"TANGENT BASES ('B') %s | WIREFRAME ('F') %s | FLUID ('f') %s", boolText[demoState->displayTangentBases], boolText[demoState->displayWireframe], boolText[demoState->displayFluid]);
 	a3textDraw(text, textAlign, textOffset += textOffsetDelta, textDepth, col.r, col.g, col.b, col.a,
 		"ANIMATION (toggle 'm') %s", boolText[demoState->updateAnimation]);
 	a3textDraw(text, textAlign, textOffset += textOffsetDelta, textDepth, col.r, col.g, col.b, col.a,
@@ -212,6 +214,34 @@ void a3demo_render(a3_DemoState* demoState, a3f64 const dt)
 	a3textureDeactivate(a3tex_unit00);
 
 
+	// fluid density overlay: middle slice of the grid in the corner
+	if (demoState->displayFluid && a3fluidGridGetPayloadCount(demoState->fluid) > 0)
+	{
+		a3_DemoStateShaderProgram const* currentDemoProgram = demoState->prog_drawTexture;
+		a3mat4 modelMat = a3mat4_identity, atlasMat = a3mat4_identity;
+
+		// unit plane moved to the lower right quarter of the window
+		modelMat.m30 = +a3real_half;
+		modelMat.m31 = -a3real_half;
+
+		// slices are stacked vertically, so select one row of the atlas
+		atlasMat.m11 = a3recip((a3real)demoState->fluid->sizeZ);
+		atlasMat.m31 = (a3real)(demoState->fluid->sizeZ / 2) * atlasMat.m11;
+
+		a3vertexDrawableActivate(demoState->draw_unit_plane_z);
+		a3shaderProgramActivate(currentDemoProgram->program);
+		a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelMat.mm);
+		a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uAtlas, 1, atlasMat.mm);
+		a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uColor, 1, a3vec4_one.v);
+		a3textureActivate(demoState->tex_fluid, a3tex_unit00);
+		a3vertexDrawableRenderActive();
+
+		a3vertexDrawableDeactivate();
+		a3shaderProgramDeactivate();
+		a3textureDeactivate(a3tex_unit00);
+	}
+
+
 	// text
 	if (demoState->textInit)
 	{
@@ -97,6 +97,58 @@ void a3demo_update_pointLight(a3_PointLightComponent const* pointLightArray,
 }
 
 
+void a3demo_update_fluid(a3_FluidGrid* fluid, a3_Timer* timer_fluid,
+	a3_Texture const* texture_fluid, a3boolean const display, a3boolean const headless)
+{
+	// emitter near the floor, blowing up and swaying side to side
+	a3f32 const position[3] = { 0.5f, 0.1f, 0.5f };
+	a3f32 velocity[3] = { 0.0f, 2.0f, 0.0f };
+	a3f32 const* payload;
+
+	// fixed steps on the fluid's own timer; headless steps once per 
+	//	update like the display timer, so that runs repeat exactly
+	if ((headless ? a3timerStep(timer_fluid) : a3timerUpdate(timer_fluid)) > 0)
+	{
+		velocity[0] = 0.5f * (a3f32)a3sind((a3real)(timer_fluid->ticks * 2 % 360));
+		velocity[2] = 0.5f * (a3f32)a3cosd((a3real)(timer_fluid->ticks * 3 % 360));
+		a3fluidGridAddSource(fluid, position, 0.08f, 8.0f, velocity);
+		if (a3fluidGridStep(fluid, (a3f32)timer_fluid->secondsPerTick) > 0)
+		{
+			// density as CPU array, checked when headless, and texture 
+			//	with slices stacked, only uploaded while it is displayed
+			if (headless)
+				a3fluidGridUpdatePayload(fluid);
+			else if (display)
+			{
+				payload = a3fluidGridUpdatePayload(fluid);
+				a3textureReplaceData(texture_fluid, 0, 0, fluid->sizeX, fluid->sizeY * fluid->sizeZ, payload, a3false);
+			}
+		}
+	}
+}
+
+void a3demo_update_particles(a3_ParticleFluid* particles, a3_Timer* timer_particles,
+	a3_Texture const* texture_particles, a3boolean const headless)
+{
+	a3real const dt = (a3real)(timer_particles->secondsPerTick / (a3f64)demoStateParticle_substeps);
+	a3f32 const* payload;
+	a3ui32 i;
+
+	// a few short steps per frame keep stiff pressure stable
+	if ((headless ? a3timerStep(timer_particles) : a3timerUpdate(timer_particles)) > 0 && particles->count)
+	{
+		for (i = 0; i < demoStateParticle_substeps; ++i)
+			a3particleFluidStep(particles, dt);
+
+		// only rows holding particles are uploaded
+		payload = a3particleFluidUpdatePayload(particles);
+		if (!headless)
+			a3textureReplaceData(texture_particles, 0, 0, a3particle_payloadWidth,
+				(particles->count + a3particle_payloadWidth - 1) / a3particle_payloadWidth, payload, a3false);
+	}
+}
+
+
 //-----------------------------------------------------------------------------
 // UPDATE
 
@@ -109,6 +161,12 @@ void a3demo_update(a3_DemoState *demoState, a3f64 const dt)
 		demoState->demoModeCallbacksPtr->handleUpdate(demoState,
 			demoState->demoModeCallbacksPtr->demoMode, dt);
 	}
+
+	// simulation
+	a3demo_update_fluid(demoState->fluid, demoState->timer_fluid,
+		demoState->tex_fluid, demoState->displayFluid, demoState->headless);
+	a3demo_update_particles(demoState->particles, demoState->timer_particles,
+		demoState->tex_particles, demoState->headless);
 }
 
 
@@ -66,6 +66,7 @@
 #define A3_DEMO_GLSL	A3_DEMO_RES_DIR"glsl/"
 #define A3_DEMO_TEX		A3_DEMO_RES_DIR"tex/"
 #define A3_DEMO_OBJ		A3_DEMO_RES_DIR"obj/"
+#define A3_DEMO_TEX_CACHE	A3_DEMO_TEX"_cache/"
 
 // define resource subdirectories
 #define A3_DEMO_VS		A3_DEMO_GLSL"4x/vs/"
@@ -184,8 +185,12 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 	a3_FileStream fileStream[1] = { 0 };
 	const a3byte *const geometryStream = "./data/gpro_base_geom.dat";
 
+	// all geometry data is temporary (uploaded then released): one arena
+	a3_Arena geometryArena[1] = { 0 };
+	a3_Allocator *const geometryAllocator = a3arenaCreate(geometryArena, 4 * 1024 * 1024) > 0 ? geometryArena->allocator : 0;
+
 	// geometry data
-	a3_GeometryData displayShapesData[2] = { 0 };
+	a3_GeometryData displayShapesData[3] = { 0 };
 	a3_GeometryData proceduralShapesData[7] = { 0 };
 	a3_GeometryData loadedModelsData[1] = { 0 };
 	const a3ui32 displayShapesCount = a3demoArrayLen(displayShapesData);
@@ -205,15 +210,24 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 
 		// static display objects
 		for (i = 0; i < displayShapesCount; ++i)
+		{
+			displayShapesData[i].allocator = geometryAllocator;
 			a3fileStreamReadObject(fileStream, displayShapesData + i, (a3_FileStreamReadFunc)a3geometryLoadDataBinary);
+		}
 
 		// procedurally-generated objects
 		for (i = 0; i < proceduralShapesCount; ++i)
+		{
+			proceduralShapesData[i].allocator = geometryAllocator;
 			a3fileStreamReadObject(fileStream, proceduralShapesData + i, (a3_FileStreamReadFunc)a3geometryLoadDataBinary);
+		}
 
 		// loaded model objects
 		for (i = 0; i < loadedModelsCount; ++i)
+		{
+			loadedModelsData[i].allocator = geometryAllocator;
 			a3fileStreamReadObject(fileStream, loadedModelsData + i, (a3_FileStreamReadFunc)a3geometryLoadDataBinary);
+		}
 
 		// done
 		a3fileStreamClose(fileStream);
@@ -225,16 +239,17 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 		a3_ProceduralGeometryDescriptor displayShapes[a3demoArrayLen(displayShapesData)] = { a3geomShape_none };
 		a3_ProceduralGeometryDescriptor proceduralShapes[a3demoArrayLen(proceduralShapesData)] = { a3geomShape_none };
 		const a3_DemoStateLoadedModel loadedShapes[a3demoArrayLen(loadedModelsData)] = {
-			{ A3_DEMO_OBJ"teapot/teapot.obj", downscale20x_y2z_x2y.mm, a3model_calculateVertexTangents },
+			{ A3_DEMO_OBJ"teapot/teapot.obj", downscale20x_y2z_x2y.mm, a3model_calculateVertexTangents | a3model_optimizeVertexCache },
 		};
 
 		// static scene procedural objects
-		//	(axes, grid)
+		//	(axes, grid, particle)
 		a3proceduralCreateDescriptorAxes(displayShapes + 0, a3geomFlag_wireframe, 0.0f, 1);
 		a3proceduralCreateDescriptorPlane(displayShapes + 1, a3geomFlag_wireframe, a3geomAxis_default, 20.0f, 20.0f, 20, 20);
+		a3proceduralCreateDescriptorSphere(displayShapes + 2, a3geomFlag_vanilla, a3geomAxis_default, 1.0f, 8, 6);
 		for (i = 0; i < displayShapesCount; ++i)
 		{
-			a3proceduralGenerateGeometryData(displayShapesData + i, displayShapes + i, 0);
+			a3proceduralGenerateGeometryData(displayShapesData + i, displayShapes + i, 0, geometryAllocator);
 			a3fileStreamWriteObject(fileStream, displayShapesData + i, (a3_FileStreamWriteFunc)a3geometrySaveDataBinary);
 		}
 
@@ -248,14 +263,14 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 		a3proceduralCreateDescriptorCone(proceduralShapes + 6, a3geomFlag_texcoords_normals, a3geomAxis_x, 1.0f, 1.0, 32, 1, 1);
 		for (i = 0; i < proceduralShapesCount; ++i)
 		{
-			a3proceduralGenerateGeometryData(proceduralShapesData + i, proceduralShapes + i, 0);
+			a3proceduralGenerateGeometryDataOptimized(proceduralShapesData + i, proceduralShapes + i, 0, 0, geometryAllocator);
 			a3fileStreamWriteObject(fileStream, proceduralShapesData + i, (a3_FileStreamWriteFunc)a3geometrySaveDataBinary);
 		}
 
 		// objects loaded from mesh files
 		for (i = 0; i < loadedModelsCount; ++i)
 		{
-			a3modelLoadOBJ(loadedModelsData + i, loadedShapes[i].modelFilePath, loadedShapes[i].flag, loadedShapes[i].transform);
+			a3modelLoadOBJ(loadedModelsData + i, loadedShapes[i].modelFilePath, loadedShapes[i].flag, loadedShapes[i].transform, geometryAllocator);
 			a3fileStreamWriteObject(fileStream, loadedModelsData + i, (a3_FileStreamWriteFunc)a3geometrySaveDataBinary);
 		}
 
@@ -318,6 +333,8 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 	a3geometryGenerateVertexArray(vao, "vao:pos", displayShapesData + 1, vbo_ibo, sharedVertexStorage);
 	currentDrawable = demoState->draw_grid;
 	sharedVertexStorage += a3geometryGenerateDrawable(currentDrawable, displayShapesData + 1, vao, vbo_ibo, sceneCommonIndexFormat, 0, 0);
+	currentDrawable = demoState->draw_particle;
+	sharedVertexStorage += a3geometryGenerateDrawable(currentDrawable, displayShapesData + 2, vao, vbo_ibo, sceneCommonIndexFormat, 0, 0);
 
 	// models
 	vao = demoState->vao_position_normal_texcoord;
@@ -350,6 +367,7 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 		a3geometryReleaseData(proceduralShapesData + i);
 	for (i = 0; i < loadedModelsCount; ++i)
 		a3geometryReleaseData(loadedModelsData + i);
+	a3arenaRelease(geometryArena);
 
 
 	// dummy
@@ -357,8 +375,9 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 }
 
 
-// utility to load shaders
-void a3demo_loadShaders(a3_DemoState *demoState)
+// utility to load shaders; if changed flags are provided, only programs 
+//	using a changed shader are rebuilt, otherwise everything is loaded
+void a3demo_loadShaders_internal(a3_DemoState *demoState, a3boolean const *shaderChanged_opt)
 {
 	// structure to help with shader management
 	typedef struct a3_TAG_DEMOSTATESHADER {
@@ -370,10 +389,30 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 		const a3byte* filePath[8];	// max number of source files per shader
 	} a3_DemoStateShader;
 
+	// structure to help with program management
+	typedef struct a3_TAG_DEMOSTATEPROGRAM {
+		a3_DemoStateShaderProgram *demoProg;
+		a3byte programName[32];
+		a3_DemoStateShader *shaderPtr[4];	// max number of shaders per program
+	} a3_DemoStateProgram;
+
 	// direct to demo programs
 	a3_DemoStateShaderProgram *currentDemoProg;
+	a3_DemoStateProgram *programPtr;
+	a3boolean shaderNeeded[demoStateMaxCount_shader] = { 0 };
+	a3boolean programRebuild[demoStateMaxCount_shaderProgram] = { 0 };
 	a3i32 flag;
-	a3ui32 i;
+	a3ui32 i, j, rebuildCount;
+
+#ifndef A3_USER_ENABLE_SHADER_DECODING
+	// batch of files being loaded on worker threads, one stage for every 
+	//	source file of every shader
+	a3_ShaderIncludeBatch batch[1] = { 0 };
+	a3_ShaderIncludeStage stageList[demoStateMaxCount_shader * 8];
+	const a3byte *stagePath[demoStateMaxCount_shader * 8], *sourceList[8];
+	a3ui32 stageTarget[demoStateMaxCount_shader * 8], stageSource[demoStateMaxCount_shader * 8], stageFirst[demoStateMaxCount_shader];
+	a3ui32 stageCount;
+#endif	// !A3_USER_ENABLE_SHADER_DECODING
 
 	// maximum uniform buffer size
 	const a3ui32 uBlockSzMax = a3shaderUniformBlockMaxSize();
@@ -415,7 +454,8 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 				passTexcoord_transform_vs[1],
 				passTangentBasis_transform_vs[1],
 				passTexcoord_transform_instanced_vs[1],
-				passTangentBasis_transform_instanced_vs[1];
+				passTangentBasis_transform_instanced_vs[1],
+				passParticle_transform_instanced_vs[1];
 			// 01-pipeline
 			a3_DemoStateShader
 				passTangentBasis_shadowCoord_transform_vs[1],
@@ -460,6 +500,7 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 			{ { { 0 },	"shdr-vs:pass-tb-trans",			a3shader_vertex  ,	1,{ A3_DEMO_VS"00-common/passTangentBasis_transform_vs4x.glsl" } } },
 			{ { { 0 },	"shdr-vs:pass-tex-trans-inst",		a3shader_vertex  ,	1,{ A3_DEMO_VS"00-common/passTexcoord_transform_instanced_vs4x.glsl" } } },
 			{ { { 0 },	"shdr-vs:pass-tb-trans-inst",		a3shader_vertex  ,	1,{ A3_DEMO_VS"00-common/passTangentBasis_transform_instanced_vs4x.glsl" } } },
+			{ { { 0 },	"shdr-vs:pass-particle-trans-inst",	a3shader_vertex  ,	1,{ A3_DEMO_VS"00-common/passParticle_transform_instanced_vs4x.glsl" } } },
 			// 01-pipeline
 			{ { { 0 },	"shdr-vs:pass-tb-sc-trans",			a3shader_vertex  ,	1,{ A3_DEMO_VS"01-pipeline/passTangentBasis_shadowCoord_transform_vs4x.glsl" } } }, // ****DECODE
 			{ { { 0 },	"shdr-vs:pass-tb-sc-trans-inst",	a3shader_vertex  ,	1,{ A3_DEMO_VS"01-pipeline/passTangentBasis_shadowCoord_transform_instanced_vs4x.glsl" } } },
@@ -475,10 +516,16 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 			{ { { 0 },	"shdr-fs:draw-col-attr",			a3shader_fragment,	1,{ A3_DEMO_FS"drawColorAttrib_fs4x.glsl" } } },
 			// 00-common
 			{ { { 0 },	"shdr-fs:draw-tex",					a3shader_fragment,	1,{ A3_DEMO_FS"00-common/drawTexture_fs4x.glsl" } } },
+#ifndef A3_USER_ENABLE_SHADER_DECODING
+			// common utilities are included by the shader itself
+			{ { { 0 },	"shdr-fs:draw-Lambert",				a3shader_fragment,	1,{ A3_DEMO_FS"00-common/drawLambert_fs4x.glsl" } } },
+			{ { { 0 },	"shdr-fs:draw-Phong",				a3shader_fragment,	1,{ A3_DEMO_FS"00-common/drawPhong_fs4x.glsl" } } },
+#else	// A3_USER_ENABLE_SHADER_DECODING
 			{ { { 0 },	"shdr-fs:draw-Lambert",				a3shader_fragment,	2,{ A3_DEMO_FS"00-common/drawLambert_fs4x.glsl",
 																					A3_DEMO_FS"00-common/utilCommon_fs4x.glsl",} } },
 			{ { { 0 },	"shdr-fs:draw-Phong",				a3shader_fragment,	2,{ A3_DEMO_FS"00-common/drawPhong_fs4x.glsl",
 																					A3_DEMO_FS"00-common/utilCommon_fs4x.glsl",} } },
+#endif	// !A3_USER_ENABLE_SHADER_DECODING
 			// 01-pipeline
 			{ { { 0 },	"shdr-fs:post-bright",				a3shader_fragment,	1,{ A3_DEMO_FS"01-pipeline/postBright_fs4x.glsl" } } }, // ****DECODE
 			{ { { 0 },	"shdr-fs:post-blur",				a3shader_fragment,	1,{ A3_DEMO_FS"01-pipeline/postBlur_fs4x.glsl" } } }, // ****DECODE
@@ -491,129 +538,139 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 	const a3ui32 numUniqueShaders = sizeof(shaderList) / sizeof(a3_DemoStateShader);
 
 
+	// list of all programs and the shaders attached to each
+	// shaders are referenced from the list above, so that programs using 
+	//	a shader whose files changed can be found and rebuilt
+	a3_DemoStateProgram programList[] = {
+		// base programs: 
+		{ demoState->prog_transform,					"prog:transform",				{ shaderList.passthru_transform_vs } },
+		{ demoState->prog_transform_instanced,			"prog:transform-inst",			{ shaderList.passthru_transform_instanced_vs } },
+		{ demoState->prog_drawColorUnif,				"prog:draw-col-unif",			{ shaderList.passthru_transform_vs, shaderList.drawColorUnif_fs } },
+		{ demoState->prog_drawColorAttrib,				"prog:draw-col-attr",			{ shaderList.passColor_transform_vs, shaderList.drawColorAttrib_fs } },
+		{ demoState->prog_drawColorUnif_instanced,		"prog:draw-col-unif-inst",		{ shaderList.passthru_transform_instanced_vs, shaderList.drawColorUnif_fs } },
+		{ demoState->prog_drawColorAttrib_instanced,	"prog:draw-col-attr-inst",		{ shaderList.passColor_transform_instanced_vs, shaderList.drawColorAttrib_fs } },
+
+		// 00-common programs: 
+		{ demoState->prog_drawTexture,					"prog:draw-tex",				{ shaderList.passTexcoord_transform_vs, shaderList.drawTexture_fs } },
+		{ demoState->prog_drawTexture_instanced,		"prog:draw-tex-inst",			{ shaderList.passTexcoord_transform_instanced_vs, shaderList.drawTexture_fs } },
+		{ demoState->prog_drawLambert,					"prog:draw-Lambert",			{ shaderList.passTangentBasis_transform_vs, shaderList.drawLambert_fs } },
+		{ demoState->prog_drawLambert_instanced,		"prog:draw-Lambert-inst",		{ shaderList.passTangentBasis_transform_instanced_vs, shaderList.drawLambert_fs } },
+		{ demoState->prog_drawPhong,					"prog:draw-Phong",				{ shaderList.passTangentBasis_transform_vs, shaderList.drawPhong_fs } },
+		{ demoState->prog_drawPhong_instanced,			"prog:draw-Phong-inst",			{ shaderList.passTangentBasis_transform_instanced_vs, shaderList.drawPhong_fs } },
+		{ demoState->prog_drawTangentBasis,				"prog:draw-tb",					{ shaderList.passTangentBasis_transform_vs, shaderList.drawTangentBasis_gs, shaderList.drawColorAttrib_fs } },
+		{ demoState->prog_drawTangentBasis_instanced,	"prog:draw-tb-inst",			{ shaderList.passTangentBasis_transform_instanced_vs, shaderList.drawTangentBasis_gs, shaderList.drawColorAttrib_fs } },
+		{ demoState->prog_drawParticle_instanced,		"prog:draw-particle-inst",		{ shaderList.passParticle_transform_instanced_vs, shaderList.drawColorUnif_fs } },
+
+		// 01-pipeline programs: 
+		{ demoState->prog_drawPhong_shadow,				"prog:draw-Phong-shadow",		{ shaderList.passTangentBasis_shadowCoord_transform_vs, shaderList.drawPhong_shadow_fs } },
+		{ demoState->prog_drawPhong_shadow_instanced,	"prog:draw-Phong-shadow-inst",	{ shaderList.passTangentBasis_shadowCoord_transform_instanced_vs, shaderList.drawPhong_shadow_fs } },
+		{ demoState->prog_postBright,					"prog:post-bright",				{ shaderList.passTexcoord_transform_vs, shaderList.postBright_fs } },
+		{ demoState->prog_postBlur,						"prog:post-blur",				{ shaderList.passTexcoord_transform_vs, shaderList.postBlur_fs } },
+		{ demoState->prog_postBlend,					"prog:post-blend",				{ shaderList.passTexcoord_transform_vs, shaderList.postBlend_fs } },
+	};
+	const a3ui32 numPrograms = sizeof(programList) / sizeof(a3_DemoStateProgram);
+
+
+	// decide what to build: 
+	//	- everything on first load
+	//	- otherwise, programs attaching a changed shader, along with all 
+	//		of their shaders (shader objects do not outlive linking)
+	for (i = rebuildCount = 0, programPtr = programList; i < numPrograms; ++i, ++programPtr)
+	{
+		for (j = 0; !programRebuild[i] && j < 4 && programPtr->shaderPtr[j]; ++j)
+			programRebuild[i] = !shaderChanged_opt || shaderChanged_opt[programPtr->shaderPtr[j] - shaderListPtr];
+		for (j = 0; programRebuild[i] && j < 4 && programPtr->shaderPtr[j]; ++j)
+			shaderNeeded[programPtr->shaderPtr[j] - shaderListPtr] = a3true;
+		rebuildCount += programRebuild[i];
+	}
+	if (!rebuildCount)
+		return;
+
+
 	printf("\n\n---------------- LOAD SHADERS STARTED  ---------------- \n");
 
 
 	// load unique shaders: 
-	//	- load file contents
-	//	- create and compile shader object
+	//	- load file contents, expanding includes and recording their 
+	//		files as dependencies of the shader; all files are expanded 
+	//		on worker threads up front
+	//	- create and start compiling each shader object as soon as its 
+	//		files are ready, overlapping compilation with file loading
 	//	- release file contents
+	//	- wait for compilation to finish
+	if (!shaderChanged_opt)
+		a3shaderIncludeGraphCreate(demoState->shaderGraph, demoStateMaxCount_shader);
+#ifndef A3_USER_ENABLE_SHADER_DECODING
+	for (i = stageCount = 0; i < numUniqueShaders; ++i)
+	{
+		shaderPtr = shaderListPtr + i;
+		stageFirst[i] = stageCount;
+		if (shaderNeeded[i])
+			for (j = 0; j < shaderPtr->srcCount; ++j, ++stageCount)
+			{
+				stagePath[stageCount] = shaderPtr->filePath[j];
+				stageSource[stageCount] = j;
+				stageTarget[stageCount] = i;
+			}
+	}
+	a3shaderIncludeBatchBegin(batch, stageList, stagePath, stageSource, stageCount, a3true, a3shader_includeThreadMax);
 	for (i = 0; i < numUniqueShaders; ++i)
 	{
+		if (!shaderNeeded[i])
+			continue;
 		shaderPtr = shaderListPtr + i;
+		for (j = 0; j < shaderPtr->srcCount; ++j)
+		{
+			a3shaderIncludeBatchWait(batch, stageFirst[i] + j);
+			sourceList[j] = stageList[stageFirst[i] + j].source->contents;
+		}
+		a3shaderCreateFromSourceListDeferred(shaderPtr->shader,
+			shaderPtr->shaderName, shaderPtr->shaderType,
+			sourceList, shaderPtr->srcCount);
+	}
+	a3shaderIncludeBatchEnd(batch, demoState->shaderGraph, stageTarget);
+#endif	// !A3_USER_ENABLE_SHADER_DECODING
+	for (i = 0; i < numUniqueShaders; ++i)
+	{
+		if (!shaderNeeded[i])
+			continue;
+		shaderPtr = shaderListPtr + i;
+#ifndef A3_USER_ENABLE_SHADER_DECODING
+		flag = a3shaderFinishCompile(shaderPtr->shader);
+#else	// A3_USER_ENABLE_SHADER_DECODING
 		flag = a3shaderCreateFromFileList(shaderPtr->shader,
 			shaderPtr->shaderName, shaderPtr->shaderType,
 			shaderPtr->filePath, shaderPtr->srcCount);
-		if (flag == 0)
-			printf("\n ^^^^ SHADER %u '%s' FAILED TO COMPILE \n\n", i, shaderPtr->shader->handle->name);
+#endif	// !A3_USER_ENABLE_SHADER_DECODING
+		if (flag <= 0)
+		{
+			printf("\n ^^^^ SHADER %u '%s' FAILED TO COMPILE \n\n", i, shaderPtr->shaderName);
+
+			// when reloading, keep the old programs using it
+			if (shaderChanged_opt)
+				for (j = 0, programPtr = programList; j < numPrograms; ++j, ++programPtr)
+					if (programPtr->shaderPtr[0] == shaderPtr || programPtr->shaderPtr[1] == shaderPtr ||
+						programPtr->shaderPtr[2] == shaderPtr || programPtr->shaderPtr[3] == shaderPtr)
+						programRebuild[j] = a3false;
+		}
 	}
 
 
 	// setup programs: 
+	//	- release old program object if rebuilding
 	//	- create program object
 	//	- attach shader objects
-
-	// base programs: 
-	// transform-only program
-	currentDemoProg = demoState->prog_transform;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:transform");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passthru_transform_vs->shader);
-	// transform-only program with instancing
-	currentDemoProg = demoState->prog_transform_instanced;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:transform-inst");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passthru_transform_instanced_vs->shader);
-	// uniform color program
-	currentDemoProg = demoState->prog_drawColorUnif;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-col-unif");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passthru_transform_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawColorUnif_fs->shader);
-	// color attrib program
-	currentDemoProg = demoState->prog_drawColorAttrib;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-col-attr");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passColor_transform_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawColorAttrib_fs->shader);
-	// uniform color program with instancing
-	currentDemoProg = demoState->prog_drawColorUnif_instanced;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-col-unif-inst");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passthru_transform_instanced_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawColorUnif_fs->shader);
-	// color attrib program with instancing
-	currentDemoProg = demoState->prog_drawColorAttrib_instanced;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-col-attr-inst");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passColor_transform_instanced_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawColorAttrib_fs->shader);
-
-	// 00-common programs: 
-	// texturing
-	currentDemoProg = demoState->prog_drawTexture;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-tex");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passTexcoord_transform_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawTexture_fs->shader);
-	// texturing with instancing
-	currentDemoProg = demoState->prog_drawTexture_instanced;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-tex-inst");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passTexcoord_transform_instanced_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawTexture_fs->shader);
-	// Lambert
-	currentDemoProg = demoState->prog_drawLambert;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-Lambert");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passTangentBasis_transform_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawLambert_fs->shader);
-	// Lambert with instancing
-	currentDemoProg = demoState->prog_drawLambert_instanced;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-Lambert-inst");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passTangentBasis_transform_instanced_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawLambert_fs->shader);
-	// Phong
-	currentDemoProg = demoState->prog_drawPhong;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-Phong");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passTangentBasis_transform_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawPhong_fs->shader);
-	// Phong with instancing
-	currentDemoProg = demoState->prog_drawPhong_instanced;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-Phong-inst");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passTangentBasis_transform_instanced_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawPhong_fs->shader);
-
-	// tangent basis
-	currentDemoProg = demoState->prog_drawTangentBasis;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-tb");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passTangentBasis_transform_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawTangentBasis_gs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawColorAttrib_fs->shader);
-	// tangent basis with instancing
-	currentDemoProg = demoState->prog_drawTangentBasis_instanced;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-tb-inst");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passTangentBasis_transform_instanced_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawTangentBasis_gs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawColorAttrib_fs->shader);
-
-	// 01-pipeline programs: 
-	// Phong shading with shadow mapping
-	currentDemoProg = demoState->prog_drawPhong_shadow;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-Phong-shadow");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passTangentBasis_shadowCoord_transform_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawPhong_shadow_fs->shader);
-	// Phong shading with shadow mapping, instanced
-	currentDemoProg = demoState->prog_drawPhong_shadow_instanced;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:draw-Phong-shadow-inst");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passTangentBasis_shadowCoord_transform_instanced_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawPhong_shadow_fs->shader);
-	// bright pass
-	currentDemoProg = demoState->prog_postBright;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:post-bright");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passTexcoord_transform_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.postBright_fs->shader);
-	// blurring
-	currentDemoProg = demoState->prog_postBlur;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:post-blur");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passTexcoord_transform_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.postBlur_fs->shader);
-	// blending
-	currentDemoProg = demoState->prog_postBlend;
-	a3shaderProgramCreate(currentDemoProg->program, "prog:post-blend");
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passTexcoord_transform_vs->shader);
-	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.postBlend_fs->shader);
+	for (i = 0, programPtr = programList; i < numPrograms; ++i, ++programPtr)
+	{
+		if (!programRebuild[i])
+			continue;
+		currentDemoProg = programPtr->demoProg;
+		if (shaderChanged_opt)
+			a3shaderProgramRelease(currentDemoProg->program);
+		a3shaderProgramCreate(currentDemoProg->program, programPtr->programName);
+		for (j = 0; j < 4 && programPtr->shaderPtr[j]; ++j)
+			a3shaderProgramAttachShader(currentDemoProg->program, programPtr->shaderPtr[j]->shader);
+	}
 
 
 	// activate a primitive for validation
@@ -622,16 +679,22 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 	a3vertexDrawableActivate(demoState->draw_axes);
 
 	// link and validate all programs
-	for (i = 0; i < demoStateMaxCount_shaderProgram; ++i)
+	// start all links first so the driver may link them in parallel
+	for (i = 0, programPtr = programList; i < numPrograms; ++i, ++programPtr)
+		if (programRebuild[i])
+			a3shaderProgramLinkDeferred(programPtr->demoProg->program);
+	for (i = 0, programPtr = programList; i < numPrograms; ++i, ++programPtr)
 	{
-		currentDemoProg = demoState->shaderProgram + i;
-		flag = a3shaderProgramLink(currentDemoProg->program);
+		if (!programRebuild[i])
+			continue;
+		currentDemoProg = programPtr->demoProg;
+		flag = a3shaderProgramFinishLink(currentDemoProg->program);
 		if (flag == 0)
-			printf("\n ^^^^ PROGRAM %u '%s' FAILED TO LINK \n\n", i, currentDemoProg->program->handle->name);
+			printf("\n ^^^^ PROGRAM %u '%s' FAILED TO LINK \n\n", (a3ui32)(currentDemoProg - demoState->shaderProgram), currentDemoProg->program->handle->name);
 
 		flag = a3shaderProgramValidate(currentDemoProg->program);
 		if (flag == 0)
-			printf("\n ^^^^ PROGRAM %u '%s' FAILED TO VALIDATE \n\n", i, currentDemoProg->program->handle->name);
+			printf("\n ^^^^ PROGRAM %u '%s' FAILED TO VALIDATE \n\n", (a3ui32)(currentDemoProg - demoState->shaderProgram), currentDemoProg->program->handle->name);
 	}
 
 	// if linking fails, contingency plan goes here
@@ -647,10 +710,13 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 	// get uniform and uniform block locations and set default values for all 
 	//	programs that have a uniform that will either never change or is
 	//	consistent for all programs
-	for (i = 0; i < demoStateMaxCount_shaderProgram; ++i)
+	for (i = 0, programPtr = programList; i < numPrograms; ++i, ++programPtr)
 	{
+		if (!programRebuild[i])
+			continue;
+
 		// activate program
-		currentDemoProg = demoState->shaderProgram + i;
+		currentDemoProg = programPtr->demoProg;
 		a3shaderProgramActivate(currentDemoProg->program);
 
 		// common VS
@@ -702,23 +768,20 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 		// lighting and shading uniform blocks
 		a3demo_setUniformDefaultBlock(currentDemoProg, ubMaterial, demoProg_blockMaterial);
 		a3demo_setUniformDefaultBlock(currentDemoProg, ubLight, demoProg_blockLight);
-	}
-
 
-	// additional pre-configuration for some programs whose uniforms will not change
-	// e.g. post-processing effects must transform unit FSQ to true FSQ
-	for (currentDemoProg = demoState->prog_postBright;
-		currentDemoProg <= demoState->prog_postBlend;
-		++currentDemoProg)
-	{
-		a3shaderProgramActivate(currentDemoProg->program);
-		a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProg->uMVP, 1, fsq.mm);
+		// additional pre-configuration for some programs whose uniforms will not change
+		// e.g. post-processing effects must transform unit FSQ to true FSQ
+		if (currentDemoProg >= demoState->prog_postBright && currentDemoProg <= demoState->prog_postBlend)
+			a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProg->uMVP, 1, fsq.mm);
 	}
 
 
 	// allocate uniform buffers
-	a3bufferCreate(demoState->ubo_light, "ubo:light", a3buffer_uniform, a3index_countMaxShort, 0);
-	a3bufferCreate(demoState->ubo_transform, "ubo:transform", a3buffer_uniform, a3index_countMaxShort, 0);
+	if (!shaderChanged_opt)
+	{
+		a3bufferCreate(demoState->ubo_light, "ubo:light", a3buffer_uniform, a3index_countMaxShort, 0);
+		a3bufferCreate(demoState->ubo_transform, "ubo:transform", a3buffer_uniform, a3index_countMaxShort, 0);
+	}
 
 
 	printf("\n\n---------------- LOAD SHADERS FINISHED ---------------- \n");
@@ -729,11 +792,28 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 }
 
 
+// utility to load shaders
+void a3demo_loadShaders(a3_DemoState *demoState)
+{
+	a3demo_loadShaders_internal(demoState, 0);
+}
+
+
+// utility to rebuild programs whose shader files changed since loading
+void a3demo_reloadShaders(a3_DemoState *demoState)
+{
+	a3boolean shaderChanged[demoStateMaxCount_shader];
+	if (a3shaderIncludeGraphPoll(demoState->shaderGraph, shaderChanged) > 0)
+		a3demo_loadShaders_internal(demoState, shaderChanged);
+}
+
+
 // utility to load textures
 void a3demo_loadTextures(a3_DemoState* demoState)
 {	
 	// indexing
 	a3_Texture* tex;
+	a3_TexturePixelFormatDescriptor pixelFormat[1];
 	a3ui32 i;
 
 	// structure for texture loading
@@ -792,12 +872,23 @@ void a3demo_loadTextures(a3_DemoState* demoState)
 	};
 	const a3ui32 numTextures = sizeof(textureList) / sizeof(a3_DemoStateTexture);
 	a3_DemoStateTexture* const textureListPtr = (a3_DemoStateTexture*)(&textureList), * texturePtr;
+	a3_TextureStage textureStage[sizeof(textureList) / sizeof(a3_DemoStateTexture)];
+	const a3byte* texturePath[sizeof(textureList) / sizeof(a3_DemoStateTexture)];
 
-	// load all textures
+	// block compress images once and reuse cached blocks on later runs
+	a3textureSetCompressCache(A3_DEMO_TEX_CACHE, a3tex_compressBC7);
+
+	// decode all images on worker threads
+	for (i = 0; i < numTextures; ++i)
+		texturePath[i] = textureListPtr[i].filePath;
+	a3textureStageDecodeFileList(textureStage, texturePath, numTextures, a3tex_stageThreadMax);
+
+	// upload all textures
 	for (i = 0; i < numTextures; ++i)
 	{
 		texturePtr = textureListPtr + i;
-		a3textureCreateFromFile(texturePtr->texture, texturePtr->textureName, texturePtr->filePath);
+		a3textureCreateFromStage(texturePtr->texture, texturePtr->textureName, textureStage + i);
+		a3textureStageRelease(textureStage + i);
 		a3textureActivate(texturePtr->texture, a3tex_unit00);
 		a3textureDefaultSettings();
 	}
@@ -826,6 +917,32 @@ void a3demo_loadTextures(a3_DemoState* demoState)
 		a3textureChangeRepeatMode(a3tex_repeatClamp, a3tex_repeatClamp); // clamp both axes
 	}
 
+	// fluid density: one float channel, slices of the grid stacked 
+	//	vertically; replaced every fluid step while shown
+	if (a3fluidGridGetPayloadCount(demoState->fluid) > 0)
+	{
+		a3textureCreatePixelFormatDescriptor(pixelFormat, a3tex_r32F);
+		a3textureCreateFromData(demoState->tex_fluid, "tex:fluid", pixelFormat,
+			demoState->fluid->sizeX, demoState->fluid->sizeY * demoState->fluid->sizeZ,
+			a3fluidGridUpdatePayload(demoState->fluid), a3false);
+		a3textureActivate(demoState->tex_fluid, a3tex_unit00);
+		a3textureChangeFilterMode(a3tex_filterLinear); // linear pixel blending
+		a3textureChangeRepeatMode(a3tex_repeatClamp, a3tex_repeatClamp); // clamp both axes
+	}
+
+	// particle fluid: position and density of each particle, one texel
+	//	each, fetched by the instance drawing it; replaced every step
+	if (a3particleFluidGetPayloadHeight(demoState->particles) > 0)
+	{
+		a3textureCreatePixelFormatDescriptor(pixelFormat, a3tex_rgba32F);
+		a3textureCreateFromData(demoState->tex_particles, "tex:particles", pixelFormat,
+			a3particle_payloadWidth, a3particleFluidGetPayloadHeight(demoState->particles),
+			a3particleFluidUpdatePayload(demoState->particles), a3false);
+		a3textureActivate(demoState->tex_particles, a3tex_unit00);
+		a3textureChangeFilterMode(a3tex_filterNearest); // texels are data, never blended
+		a3textureChangeRepeatMode(a3tex_repeatClamp, a3tex_repeatClamp); // clamp both axes
+	}
+
 
 	// done
 	a3textureDeactivate(a3tex_unit00);
@@ -917,7 +1034,7 @@ inline void a3_refreshDrawable_internal(a3_VertexDrawable *drawable, a3_VertexAr
 //	reloaded, old function pointers are out of scope!
 // could reload everything, but that would mean rebuilding GPU data...
 //	...or just set new function pointers!
-void a3demo_loadValidate(a3_DemoState* demoState)
+void a3demo_loadValidateRelease(a3_DemoState* demoState)
 {
 	a3_BufferObject* currentBuff = demoState->drawDataBuffer,
 		* const endBuff = currentBuff + demoStateMaxCount_drawDataBuffer;
@@ -949,6 +1066,15 @@ void a3demo_loadValidate(a3_DemoState* demoState)
 	//	-> uncomment framebuffer update
 /*	while (currentFBO < endFBO)
 		a3framebufferHandleUpdateReleaseCallback(currentFBO++);*/
+}
+
+// re-link everything that depends on the library or the state's address
+void a3demo_loadValidate(a3_DemoState* demoState)
+{
+	a3_BufferObject* currentBuff;
+	a3_VertexArrayDescriptor* currentVAO;
+
+	a3demo_loadValidateRelease(demoState);
 
 	// re-link specific object pointers for different asset types
 	currentBuff = demoState->vbo_staticSceneObjectDrawBuffer;
@@ -960,6 +1086,7 @@ void a3demo_loadValidate(a3_DemoState* demoState)
 	currentVAO = demoState->vao_position;
 	currentVAO->vertexBuffer = currentBuff;
 	a3_refreshDrawable_internal(demoState->draw_grid, currentVAO, currentBuff);
+	a3_refreshDrawable_internal(demoState->draw_particle, currentVAO, currentBuff);
 
 	currentVAO = demoState->vao_position_normal_texcoord;
 	currentVAO->vertexBuffer = currentBuff;
@@ -976,6 +1103,9 @@ void a3demo_loadValidate(a3_DemoState* demoState)
 	a3_refreshDrawable_internal(demoState->draw_teapot, currentVAO, currentBuff);
 
 	a3demo_initDummyDrawable_internal(demoState);
+
+	// fluid solver lives in the state
+	demoState->fluid->multigrid = demoState->fluidMultigrid->data ? demoState->fluidMultigrid : 0;
 }
 
 
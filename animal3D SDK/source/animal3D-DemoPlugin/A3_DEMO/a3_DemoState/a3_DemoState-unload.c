@@ -33,6 +33,7 @@
 #include "../a3_DemoState.h"
 
 #include <stdio.h>
+#include <string.h>
 
 
 //-----------------------------------------------------------------------------
@@ -70,6 +71,7 @@ void a3demo_unloadShaders(a3_DemoState* demoState)
 		a3shaderProgramRelease((currentProg++)->program);
 	while (currentUBO < endUBO)
 		a3bufferRelease(currentUBO++);
+	a3shaderIncludeGraphRelease(demoState->shaderGraph);
 }
 
 
@@ -158,4 +160,47 @@ void a3demo_unloadValidate(const a3_DemoState* demoState)
 }
 
 
+// clear pointers that load validation re-links (release callbacks and 
+//	links between objects), so a saved copy of the state only holds what 
+//	actually describes it
+void a3demo_unlink(a3_DemoState* demoState)
+{
+	a3_BufferObject* currentBuff = demoState->drawDataBuffer,
+		* const endBuff = currentBuff + demoStateMaxCount_drawDataBuffer;
+	a3_VertexArrayDescriptor* currentVAO = demoState->vertexArray,
+		* const endVAO = currentVAO + demoStateMaxCount_vertexArray;
+	a3_VertexDrawable* currentDraw = demoState->drawable,
+		* const endDraw = currentDraw + demoStateMaxCount_drawable;
+	a3_DemoStateShaderProgram* currentProg = demoState->shaderProgram,
+		* const endProg = currentProg + demoStateMaxCount_shaderProgram;
+	a3_UniformBuffer* currentUBO = demoState->uniformBuffer,
+		* const endUBO = currentUBO + demoStateMaxCount_uniformBuffer;
+	a3_Texture* currentTex = demoState->texture,
+		* const endTex = currentTex + demoStateMaxCount_texture;
+
+	while (currentBuff < endBuff)
+		(currentBuff++)->handle->releaseFunc = 0;
+	for (; currentVAO < endVAO; ++currentVAO)
+	{
+		currentVAO->handle->releaseFunc = 0;
+		currentVAO->vertexBuffer = 0;
+	}
+	for (; currentDraw < endDraw; ++currentDraw)
+	{
+		currentDraw->vertexArray = 0;
+		currentDraw->indexBuffer = 0;
+	}
+	while (currentProg < endProg)
+		(currentProg++)->program->handle->releaseFunc = 0;
+	while (currentUBO < endUBO)
+		(currentUBO++)->handle->releaseFunc = 0;
+	while (currentTex < endTex)
+		(currentTex++)->handle->releaseFunc = 0;
+
+	// copy of a drawable, set up again from its original
+	memset(demoState->dummyDrawable, 0, sizeof(demoState->dummyDrawable));
+	demoState->fluid->multigrid = 0;
+}
+
+
 //-----------------------------------------------------------------------------
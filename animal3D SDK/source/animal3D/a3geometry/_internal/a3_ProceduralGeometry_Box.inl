@@ -124,7 +124,7 @@ a3ret a3proceduralInternalGenerateBox(a3_GeometryData *geomData, const a3_Proced
 	// allocate space for whole buffer required
 	const a3ui32 vertexBufferSize = a3vertexFormatGetStorageSpaceRequired(geomData->vertexFormat, numVertices);
 	const a3ui32 indexBufferSize = a3indexFormatGetStorageSpaceRequired(geomData->indexFormat, numIndices);
-	a3ubyte *const data = (a3ubyte *)malloc(vertexBufferSize + indexBufferSize);
+	a3ubyte *const data = (a3ubyte *)a3allocatorAlloc(geomData->allocator, vertexBufferSize + indexBufferSize);
 
 	// temporary pointers to non-interleaved attributes
 	a3f32 *const positions = (a3f32 *)(data),
@@ -75,7 +75,7 @@ a3ret a3proceduralInternalGeneratePyramid(a3_GeometryData *geomData, const a3_Pr
 	// allocate space for whole buffer required
 	const a3ui32 vertexBufferSize = a3vertexFormatGetStorageSpaceRequired(geomData->vertexFormat, numVertices);
 	const a3ui32 indexBufferSize = a3indexFormatGetStorageSpaceRequired(geomData->indexFormat, numIndices);
-	a3ubyte *const data = (a3ubyte *)malloc(vertexBufferSize + indexBufferSize);
+	a3ubyte *const data = (a3ubyte *)a3allocatorAlloc(geomData->allocator, vertexBufferSize + indexBufferSize);
 
 	a3f32 *const positions = (a3f32 *)(data),
 		*const texcoords = positions + geomData->vertexFormat->attribElements[a3attrib_position] * numVertices,
@@ -25,6 +25,7 @@
 */
 
 #include "animal3D/a3geometry/a3_GeometryData.h"
+#include "animal3D/a3utility/a3_Profiler.h"
 
 #include "animal3D-A3DM/a3math/a3vector.h"
 
@@ -35,21 +36,10 @@
 
 //-----------------------------------------------------------------------------
 
-a3ret a3geometryCreateVertexFormat(a3_VertexFormatDescriptor *vertexFormat_out, const a3_GeometryVertexAttributeName *attribNameList, a3ui32 attribNameCount)
+// create format from a table of the 8 fixed attributes and their types
+a3ret a3geometryInternalCreateVertexFormat(a3_VertexFormatDescriptor *vertexFormat_out, const a3_GeometryVertexAttributeName *attribNameList, a3ui32 attribNameCount, const a3_VertexAttributeDescriptor *fixedAttribs)
 {
 	static const a3ui16 secondaryAttribOffset = 2;
-	static const a3_VertexAttributeDescriptor fixedAttribs[] = {
-		// 6 explicit
-		{ a3attrib_position,		a3attrib_vec3	},
-		{ a3attrib_normal,			a3attrib_vec3	},
-		{ a3attrib_color,			a3attrib_vec4	},
-		{ a3attrib_texcoord,		a3attrib_vec2	},
-		{ a3attrib_tangent,			a3attrib_vec3	},
-		{ a3attrib_blendWeights,	a3attrib_vec4	},
-		// 2 implicit
-		{ a3attrib_bitangent,		a3attrib_vec3	},
-		{ a3attrib_blendIndices,	a3attrib_ivec4	},
-	};
 
 	// prepare list of actual attributes
 	const a3_VertexAttributeDescriptor *attribOrdered[8] = { 0 };
@@ -114,6 +104,23 @@ a3ret a3geometryCreateVertexFormat(a3_VertexFormatDescriptor *vertexFormat_out,
 	return -1;
 }
 
+a3ret a3geometryCreateVertexFormat(a3_VertexFormatDescriptor *vertexFormat_out, const a3_GeometryVertexAttributeName *attribNameList, a3ui32 attribNameCount)
+{
+	static const a3_VertexAttributeDescriptor fixedAttribs[] = {
+		// 6 explicit
+		{ a3attrib_position,		a3attrib_vec3	},
+		{ a3attrib_normal,			a3attrib_vec3	},
+		{ a3attrib_color,			a3attrib_vec4	},
+		{ a3attrib_texcoord,		a3attrib_vec2	},
+		{ a3attrib_tangent,			a3attrib_vec3	},
+		{ a3attrib_blendWeights,	a3attrib_vec4	},
+		// 2 implicit
+		{ a3attrib_bitangent,		a3attrib_vec3	},
+		{ a3attrib_blendIndices,	a3attrib_ivec4	},
+	};
+	return a3geometryInternalCreateVertexFormat(vertexFormat_out, attribNameList, attribNameCount, fixedAttribs);
+}
+
 a3ret a3geometryCreateIndexFormat(a3_IndexFormatDescriptor *indexFormat_out, const a3ui32 vertexCount)
 {
 	const a3_IndexType indexType = (vertexCount ? vertexCount < a3index_countMaxByte ? a3index_byte : vertexCount < a3index_countMaxShort ? a3index_short : a3index_int : a3index_disable);
@@ -139,7 +146,6 @@ a3ret a3geometryGenerateDrawable(a3_VertexDrawable *drawable_out, const a3_Geome
 	// create geometry attribute list
 	// attribute data to store
 	a3_VertexAttributeDataDescriptor attribData[a3attrib_geomNameMax + 2] = { 0 }, *attribDataPtr = attribData;
-	a3_VertexAttributeName fixedName;
 	a3ui32 numAttribs = 0;
 	a3ui32 i;
 	a3i32 ret = 0;
@@ -176,24 +182,13 @@ a3ret a3geometryGenerateDrawable(a3_VertexDrawable *drawable_out, const a3_Geome
 				}
 
 			// if tangents are enabled, get data
-			if (geom->attribData[a3attrib_geomTangent])
-			{
-				attribData[numAttribs].name = fixedName = fixedAttribName[a3attrib_geomTangent + 2];
-				attribData[numAttribs].data
-					= (a3f32 *)(geom->attribData[a3attrib_geomTangent])
-					+ geom->vertexFormat->attribElements[fixedName] * geom->numVertices;
-				++numAttribs;
-			}
+			//	(addresses account for packed attribute sizes)
+			if (a3geometryGetAddressBitangent(&attribData[numAttribs].data, geom) > 0)
+				attribData[numAttribs++].name = fixedAttribName[a3attrib_geomTangent + 2];
 
 			// if blend weights are enabled, them too
-			if (geom->attribData[a3attrib_geomBlending])
-			{
-				attribData[numAttribs].name = fixedName = fixedAttribName[a3attrib_geomBlending + 2];
-				attribData[numAttribs].data
-					= (a3f32 *)(geom->attribData[a3attrib_geomBlending])
-					+ geom->vertexFormat->attribElements[fixedName] * geom->numVertices;
-				++numAttribs;
-			}
+			if (a3geometryGetAddressBlendingInd(&attribData[numAttribs].data, geom) > 0)
+				attribData[numAttribs++].name = fixedAttribName[a3attrib_geomBlending + 2];
 
 
 			// send data to index buffer and create drawable
@@ -280,6 +275,7 @@ a3ret a3geometryLoadDataBinary(a3_GeometryData *geom_out, const a3_FileStream *f
 	a3ui32 vertexDataSize = 0, indexDataSize = 0, dataSize = 0;
 	a3ui32 i = 0;
 	a3i32 offset[a3attrib_geomNameMax + 1] = { 0 };
+	a3_ProfileZone zone[1];
 	if (geom_out && fileStream)
 	{
 		if (!geom_out->data)
@@ -287,6 +283,8 @@ a3ret a3geometryLoadDataBinary(a3_GeometryData *geom_out, const a3_FileStream *f
 			fp = fileStream->stream;
 			if (fp)
 			{
+				a3profileZoneBegin(zone, "a3geometryLoadDataBinary");
+
 				// read vertex format and size
 				ret += (a3ui32)fread(geom_out->vertexFormat,
 					1, sizeof(a3_VertexFormatDescriptor), fp);
@@ -305,7 +303,7 @@ a3ret a3geometryLoadDataBinary(a3_GeometryData *geom_out, const a3_FileStream *f
 				vertexDataSize = a3vertexFormatGetStorageSpaceRequired(geom_out->vertexFormat, geom_out->numVertices);
 				indexDataSize = a3indexFormatGetStorageSpaceRequired(geom_out->indexFormat, geom_out->numIndices);
 				dataSize = (vertexDataSize + indexDataSize);
-				geom_out->data = malloc(dataSize);
+				geom_out->data = a3allocatorAlloc(geom_out->allocator, dataSize);
 				ret += (a3ui32)fread(geom_out->data, 1, dataSize, fp);
 
 				// read attribute offsets for raw data and 
@@ -314,6 +312,8 @@ a3ret a3geometryLoadDataBinary(a3_GeometryData *geom_out, const a3_FileStream *f
 				for (i = 0; i < a3attrib_geomNameMax; ++i)
 					geom_out->attribData[i] = (offset[i] >= 0) ? ((a3byte *)(geom_out->data) + offset[i]) : 0;
 				geom_out->indexData = (offset[i] >= 0) ? ((a3byte *)(geom_out->data) + offset[i]) : 0;
+
+				a3profileZoneEnd(zone);
 			}
 			return ret;
 		}
@@ -389,7 +389,7 @@ a3ret a3geometryCopyStringToData(a3_GeometryData *geom_out, const a3byte *str)
 			vertexDataSize = a3vertexFormatGetStorageSpaceRequired(geom_out->vertexFormat, geom_out->numVertices);
 			indexDataSize = a3indexFormatGetStorageSpaceRequired(geom_out->indexFormat, geom_out->numIndices);
 			dataSize = (vertexDataSize + indexDataSize);
-			geom_out->data = malloc(dataSize);
+			geom_out->data = a3allocatorAlloc(geom_out->allocator, dataSize);
 			memcpy(geom_out->data, str, dataSize);
 			str += dataSize;
 
@@ -432,7 +432,7 @@ a3ret a3geometryReleaseData(a3_GeometryData *geom)
 	static const a3_GeometryData reset = { 0 };
 	if (geom && geom->data)
 	{
-		free(geom->data);
+		a3allocatorFree(geom->allocator, geom->data);
 		*geom = reset;
 		return 1;
 	}
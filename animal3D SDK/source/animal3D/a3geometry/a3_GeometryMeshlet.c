@@ -0,0 +1,363 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_GeometryMeshlet.c
+	Definitions for meshlet generation.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "animal3D/a3geometry/a3_GeometryMeshlet.h"
+
+#include "animal3D-A3DM/a3math/a3sqrt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// marker for vertex not in current meshlet
+#define A3_MESHLET_UNUSED	0xff
+
+// get vertex index for triangle corner, indexed or not
+inline a3ui32 a3meshletInternalLoadIndex(const a3_GeometryData *geom, const a3ui32 i)
+{
+	if (!geom->indexData)
+		return i;
+	else if (geom->indexFormat->indexSize < 2)
+		return ((const a3ubyte *)geom->indexData)[i];
+	else if (geom->indexFormat->indexSize < 4)
+		return ((const a3ui16 *)geom->indexData)[i];
+	else
+		return ((const a3ui32 *)geom->indexData)[i];
+}
+
+// calculate bounding sphere (Ritter) and normal cone for a finished meshlet
+inline void a3meshletInternalCalculateBounds(a3_GeometryMeshlet *meshlet, const a3ui32 *vertexIndex, const a3ubyte *triangleIndex, const a3f32 *position)
+{
+	const a3f32 *p, *p0, *p1, *p2;
+	a3f32 d[3], e1[3], e2[3], n[3], axis[3] = { 0.0f };
+	a3f32 dist, distMax, len, dotMin, t, tMax;
+	a3ui32 i, iFar;
+
+	// sphere: start at first vertex, find farthest, then farthest from that
+	p0 = position + vertexIndex[0] * 3;
+	for (i = iFar = 0, distMax = -1.0f; i < meshlet->vertexCount; ++i)
+	{
+		p = position + vertexIndex[i] * 3;
+		d[0] = p[0] - p0[0];
+		d[1] = p[1] - p0[1];
+		d[2] = p[2] - p0[2];
+		dist = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+		if (dist > distMax)
+		{
+			distMax = dist;
+			iFar = i;
+		}
+	}
+	p0 = position + vertexIndex[iFar] * 3;
+	for (i = iFar = 0, distMax = -1.0f; i < meshlet->vertexCount; ++i)
+	{
+		p = position + vertexIndex[i] * 3;
+		d[0] = p[0] - p0[0];
+		d[1] = p[1] - p0[1];
+		d[2] = p[2] - p0[2];
+		dist = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+		if (dist > distMax)
+		{
+			distMax = dist;
+			iFar = i;
+		}
+	}
+	p1 = position + vertexIndex[iFar] * 3;
+	meshlet->center[0] = (p0[0] + p1[0]) * 0.5f;
+	meshlet->center[1] = (p0[1] + p1[1]) * 0.5f;
+	meshlet->center[2] = (p0[2] + p1[2]) * 0.5f;
+	meshlet->radius = a3sqrtf(distMax) * 0.5f;
+
+	// grow to include everything
+	for (i = 0; i < meshlet->vertexCount; ++i)
+	{
+		p = position + vertexIndex[i] * 3;
+		d[0] = p[0] - meshlet->center[0];
+		d[1] = p[1] - meshlet->center[1];
+		d[2] = p[2] - meshlet->center[2];
+		dist = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+		if (dist > meshlet->radius * meshlet->radius)
+		{
+			dist = a3sqrtf(dist);
+			len = (dist - meshlet->radius) * 0.5f;
+			meshlet->radius += len;
+			len /= dist;
+			meshlet->center[0] += d[0] * len;
+			meshlet->center[1] += d[1] * len;
+			meshlet->center[2] += d[2] * len;
+		}
+	}
+
+	// cone axis: average of unit triangle normals
+	for (i = 0; i < meshlet->triangleCount; ++i, triangleIndex += 3)
+	{
+		p0 = position + vertexIndex[triangleIndex[0]] * 3;
+		p1 = position + vertexIndex[triangleIndex[1]] * 3;
+		p2 = position + vertexIndex[triangleIndex[2]] * 3;
+		e1[0] = p1[0] - p0[0];	e1[1] = p1[1] - p0[1];	e1[2] = p1[2] - p0[2];
+		e2[0] = p2[0] - p0[0];	e2[1] = p2[1] - p0[1];	e2[2] = p2[2] - p0[2];
+		n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+		n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+		n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+		len = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+		if (len > 0.0f)
+		{
+			len = 1.0f / a3sqrtf(len);
+			axis[0] += n[0] * len;
+			axis[1] += n[1] * len;
+			axis[2] += n[2] * len;
+		}
+	}
+	len = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+	if (len > 0.0f)
+	{
+		len = 1.0f / a3sqrtf(len);
+		axis[0] *= len;
+		axis[1] *= len;
+		axis[2] *= len;
+	}
+	meshlet->coneAxis[0] = axis[0];
+	meshlet->coneAxis[1] = axis[1];
+	meshlet->coneAxis[2] = axis[2];
+
+	// cone spread: smallest agreement of any normal with the axis
+	// apex: pull back along axis until behind every triangle's plane
+	triangleIndex -= meshlet->triangleCount * 3;
+	for (i = 0, dotMin = 1.0f, tMax = 0.0f; i < meshlet->triangleCount; ++i, triangleIndex += 3)
+	{
+		p0 = position + vertexIndex[triangleIndex[0]] * 3;
+		p1 = position + vertexIndex[triangleIndex[1]] * 3;
+		p2 = position + vertexIndex[triangleIndex[2]] * 3;
+		e1[0] = p1[0] - p0[0];	e1[1] = p1[1] - p0[1];	e1[2] = p1[2] - p0[2];
+		e2[0] = p2[0] - p0[0];	e2[1] = p2[1] - p0[1];	e2[2] = p2[2] - p0[2];
+		n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+		n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+		n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+		len = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+		if (len > 0.0f)
+		{
+			len = 1.0f / a3sqrtf(len);
+			n[0] *= len;
+			n[1] *= len;
+			n[2] *= len;
+			dist = n[0] * axis[0] + n[1] * axis[1] + n[2] * axis[2];
+			if (dist < dotMin)
+				dotMin = dist;
+			if (dist > 0.0f)
+			{
+				d[0] = meshlet->center[0] - p0[0];
+				d[1] = meshlet->center[1] - p0[1];
+				d[2] = meshlet->center[2] - p0[2];
+				t = (d[0] * n[0] + d[1] * n[1] + d[2] * n[2]) / dist;
+				if (t > tMax)
+					tMax = t;
+			}
+		}
+	}
+
+	// cutoff is sine of spread; degenerate if spread reaches 90 degrees
+	meshlet->coneCutoff = (dotMin > 0.0f) ? a3sqrtf(1.0f - dotMin * dotMin) : 1.0f;
+	meshlet->coneApex[0] = meshlet->center[0] - axis[0] * tMax;
+	meshlet->coneApex[1] = meshlet->center[1] - axis[1] * tMax;
+	meshlet->coneApex[2] = meshlet->center[2] - axis[2] * tMax;
+}
+
+// greedy partition; counts only if output arrays are null
+// stops with zero meshlets if an index is not a valid vertex
+a3ui32 a3meshletInternalBuild(a3_GeometryMeshletData *meshlets, const a3_GeometryData *geom, a3ubyte *marker, const a3ui32 maxVertices, const a3ui32 maxTriangles)
+{
+	a3_GeometryMeshlet current[1] = { 0 };
+	a3ui32 currentVertex[a3geomMeshlet_verticesMax];
+	const a3ui32 numCorners = geom->indexData ? geom->numIndices : geom->numVertices;
+	const a3f32 *position = (const a3f32 *)geom->attribData[a3attrib_geomPosition];
+	const a3boolean store = (meshlets->meshlet != 0);
+	a3ui32 v[3], newVerts;
+	a3ui32 i, k, j;
+	a3ui32 numMeshlets = 0, numVertexIndices = 0, numTriangles = 0;
+
+	memset(marker, A3_MESHLET_UNUSED, geom->numVertices);
+	for (i = 0; i + 2 < numCorners; i += 3)
+	{
+		// count vertices this triangle would add
+		for (k = newVerts = 0; k < 3; ++k)
+		{
+			v[k] = a3meshletInternalLoadIndex(geom, i + k);
+			if (v[k] >= geom->numVertices)
+			{
+				meshlets->numMeshlets = meshlets->numVertexIndices = meshlets->numTriangles = 0;
+				return 0;
+			}
+			if (marker[v[k]] == A3_MESHLET_UNUSED && (k < 1 || v[k] != v[0]) && (k < 2 || v[k] != v[1]))
+				++newVerts;
+		}
+
+		// flush if full
+		if (current->vertexCount + newVerts > maxVertices || current->triangleCount + 1 > maxTriangles)
+		{
+			if (store)
+			{
+				a3meshletInternalCalculateBounds(current, meshlets->vertexIndex + current->vertexOffset, meshlets->triangleIndex + current->triangleOffset * 3, position);
+				meshlets->meshlet[numMeshlets] = *current;
+			}
+			for (j = 0; j < current->vertexCount; ++j)
+				marker[currentVertex[j]] = A3_MESHLET_UNUSED;
+			++numMeshlets;
+			current->vertexOffset = numVertexIndices;
+			current->triangleOffset = numTriangles;
+			current->vertexCount = current->triangleCount = 0;
+		}
+
+		// add vertices and triangle
+		for (k = 0; k < 3; ++k)
+		{
+			if (marker[v[k]] == A3_MESHLET_UNUSED)
+			{
+				currentVertex[current->vertexCount] = v[k];
+				marker[v[k]] = (a3ubyte)current->vertexCount++;
+				if (store)
+					meshlets->vertexIndex[numVertexIndices] = v[k];
+				++numVertexIndices;
+			}
+			if (store)
+				meshlets->triangleIndex[numTriangles * 3 + k] = marker[v[k]];
+		}
+		++current->triangleCount;
+		++numTriangles;
+	}
+
+	// last one
+	if (current->triangleCount)
+	{
+		if (store)
+		{
+			a3meshletInternalCalculateBounds(current, meshlets->vertexIndex + current->vertexOffset, meshlets->triangleIndex + current->triangleOffset * 3, position);
+			meshlets->meshlet[numMeshlets] = *current;
+		}
+		++numMeshlets;
+	}
+
+	// done
+	meshlets->numMeshlets = numMeshlets;
+	meshlets->numVertexIndices = numVertexIndices;
+	meshlets->numTriangles = numTriangles;
+	return numMeshlets;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3geometryGenerateMeshlets(a3_GeometryMeshletData *meshlets_out, const a3_GeometryData *geom, a3ui32 maxVertices, a3ui32 maxTriangles)
+{
+	a3_GeometryMeshletData ret[1] = { 0 };
+	a3ubyte *marker;
+	a3ui32 numMeshlets;
+
+	if (meshlets_out && geom && geom->data)
+	{
+		if (!meshlets_out->data)
+		{
+			// validate geometry (positions must not be packed)
+			if (geom->primType != a3prim_triangles || !geom->attribData[a3attrib_geomPosition]
+				|| geom->vertexFormat->attribSize[a3attrib_position] != sizeof(a3f32) * 3)
+				return 0;
+
+			// clamp limits
+			maxVertices = maxVertices == 0 ? a3geomMeshlet_verticesDefault
+				: maxVertices < 3 ? 3 : maxVertices > a3geomMeshlet_verticesMax ? a3geomMeshlet_verticesMax : maxVertices;
+			maxTriangles = maxTriangles == 0 ? a3geomMeshlet_trianglesDefault
+				: maxTriangles > a3geomMeshlet_trianglesMax ? a3geomMeshlet_trianglesMax : maxTriangles;
+
+			// count pass
+			marker = (a3ubyte *)malloc(geom->numVertices);
+			if (!marker)
+				return 0;
+			numMeshlets = a3meshletInternalBuild(ret, geom, marker, maxVertices, maxTriangles);
+			if (numMeshlets)
+			{
+				// allocate exact storage: meshlets, vertex indices, triangles
+				ret->data = malloc(
+					sizeof(a3_GeometryMeshlet) * ret->numMeshlets
+					+ sizeof(a3ui32) * ret->numVertexIndices
+					+ sizeof(a3ubyte) * ret->numTriangles * 3);
+				if (!ret->data)
+				{
+					free(marker);
+					return 0;
+				}
+				ret->meshlet = (a3_GeometryMeshlet *)ret->data;
+				ret->vertexIndex = (a3ui32 *)(ret->meshlet + ret->numMeshlets);
+				ret->triangleIndex = (a3ubyte *)(ret->vertexIndex + ret->numVertexIndices);
+
+				// store pass
+				a3meshletInternalBuild(ret, geom, marker, maxVertices, maxTriangles);
+				*meshlets_out = *ret;
+			}
+
+			// done
+			free(marker);
+			return numMeshlets;
+		}
+	}
+	return -1;
+}
+
+a3ret a3geometryMeshletIsBackfacing(const a3_GeometryMeshlet *meshlet, const a3f32 *viewPosition)
+{
+	a3f32 d[3], len;
+	if (meshlet && viewPosition)
+	{
+		// cone test against direction from viewer to apex
+		if (meshlet->coneCutoff < 1.0f)
+		{
+			d[0] = meshlet->coneApex[0] - viewPosition[0];
+			d[1] = meshlet->coneApex[1] - viewPosition[1];
+			d[2] = meshlet->coneApex[2] - viewPosition[2];
+			len = a3sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+			return ((d[0] * meshlet->coneAxis[0] + d[1] * meshlet->coneAxis[1] + d[2] * meshlet->coneAxis[2]) >= (meshlet->coneCutoff * len));
+		}
+		return 0;
+	}
+	return -1;
+}
+
+a3ret a3geometryReleaseMeshlets(a3_GeometryMeshletData *meshlets)
+{
+	static const a3_GeometryMeshletData reset = { 0 };
+	if (meshlets && meshlets->data)
+	{
+		free(meshlets->data);
+		*meshlets = reset;
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
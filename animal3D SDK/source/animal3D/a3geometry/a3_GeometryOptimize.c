@@ -0,0 +1,407 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_GeometryOptimize.c
+	Definitions for geometry optimization.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "animal3D/a3geometry/a3_GeometryOptimize.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+// external storage utilities
+
+inline a3ubyte *a3proceduralInternalStoreIndex(a3ubyte *index, const a3ui32 indexSize, const a3ui32 i);
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// general index load
+inline a3ui32 a3geometryInternalLoadIndex(const void *indexData, const a3ui32 indexSize, const a3ui32 i)
+{
+	if (indexSize < 2)
+		return ((const a3ubyte *)indexData)[i];
+	else if (indexSize < 4)
+		return ((const a3ui16 *)indexData)[i];
+	else
+		return ((const a3ui32 *)indexData)[i];
+}
+
+// clamp cache size to valid range
+inline a3ui32 a3geometryInternalCacheSize(const a3ui32 cacheSize)
+{
+	return (cacheSize == 0 ? a3geomOptimize_cacheSizeDefault
+		: cacheSize < a3geomOptimize_cacheSizeMin ? a3geomOptimize_cacheSizeMin
+		: cacheSize > a3geomOptimize_cacheSizeMax ? a3geomOptimize_cacheSizeMax
+		: cacheSize);
+}
+
+// Forsyth vertex score: favors vertices recently used (but not the last
+//	triangle's, which are equally good) and vertices with few remaining
+//	triangles, so that lone triangles do not get left behind
+inline a3f32 a3geometryInternalVertexScore(const a3i32 cachePosition, const a3ui32 cacheSize, const a3ui32 valence)
+{
+	const a3f32 cacheDecayPower = 1.5f;
+	const a3f32 lastTriScore = 0.75f;
+	const a3f32 valenceBoostScale = 2.0f;
+	const a3f32 valenceBoostPower = 0.5f;
+	a3f32 score = 0.0f;
+
+	// no triangles left to use this vertex
+	if (valence == 0)
+		return -1.0f;
+
+	// cache position score
+	if (cachePosition >= 0)
+	{
+		if (cachePosition < 3)
+			score = lastTriScore;
+		else
+			score = powf(1.0f - (a3f32)(cachePosition - 3) / (a3f32)(cacheSize - 3), cacheDecayPower);
+	}
+
+	// valence score
+	score += valenceBoostScale * powf((a3f32)valence, -valenceBoostPower);
+	return score;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3geometryOptimizeVertexCache(a3_GeometryData *geom, a3ui32 cacheSize)
+{
+	// temporary storage (one allocation)
+	a3ui32 *indices, *triAdjOffset, *triAdjCount, *triAdj, *vertValence;
+	a3ui32 *cache, *cacheNext;
+	a3i32 *vertCachePos;
+	a3f32 *vertScore, *triScore;
+	a3ubyte *triEmitted;
+	void *tmp;
+
+	a3ubyte *indexPtr;
+	a3ui32 numTris, numVerts, indexSize;
+	a3ui32 i, j, k, v, t, tri;
+	a3ui32 cacheCount, cacheNextCount, triCursor;
+	a3i32 bestTri;
+	a3f32 bestScore;
+
+	if (geom && geom->data)
+	{
+		// must be indexed triangle list
+		if (!geom->indexData || !geom->numIndices || geom->primType != a3prim_triangles || geom->numIndices % 3)
+			return 0;
+
+		cacheSize = a3geometryInternalCacheSize(cacheSize);
+		indexSize = geom->indexFormat->indexSize;
+		numVerts = geom->numVertices;
+		numTris = geom->numIndices / 3;
+
+		// allocate everything
+		tmp = malloc(
+			sizeof(a3ui32) * geom->numIndices			// indices
+			+ sizeof(a3ui32) * numVerts * 3				// adjacency offsets and counts, valence
+			+ sizeof(a3ui32) * geom->numIndices			// adjacency
+			+ sizeof(a3i32) * numVerts					// cache positions
+			+ sizeof(a3ui32) * (cacheSize + 3) * 2		// cache and next cache
+			+ sizeof(a3f32) * numVerts					// vertex scores
+			+ sizeof(a3f32) * numTris					// triangle scores
+			+ sizeof(a3ubyte) * numTris);				// emitted flags
+		if (!tmp)
+			return 0;
+		indices = (a3ui32 *)tmp;
+		triAdjOffset = indices + geom->numIndices;
+		triAdjCount = triAdjOffset + numVerts;
+		vertValence = triAdjCount + numVerts;
+		triAdj = vertValence + numVerts;
+		vertCachePos = (a3i32 *)(triAdj + geom->numIndices);
+		cache = (a3ui32 *)(vertCachePos + numVerts);
+		cacheNext = cache + cacheSize + 3;
+		vertScore = (a3f32 *)(cacheNext + cacheSize + 3);
+		triScore = vertScore + numVerts;
+		triEmitted = (a3ubyte *)(triScore + numTris);
+
+		// load indices and count valence
+		memset(vertValence, 0, sizeof(a3ui32) * numVerts);
+		for (i = 0; i < geom->numIndices; ++i)
+		{
+			v = indices[i] = a3geometryInternalLoadIndex(geom->indexData, indexSize, i);
+			if (v >= numVerts)
+			{
+				printf("\n A3 ERROR: Geometry optimization failed; index %u out of range.", v);
+				free(tmp);
+				return 0;
+			}
+			++vertValence[v];
+		}
+
+		// build triangle adjacency per vertex
+		for (v = j = 0; v < numVerts; ++v)
+		{
+			triAdjOffset[v] = j;
+			triAdjCount[v] = 0;
+			j += vertValence[v];
+		}
+		for (i = 0; i < geom->numIndices; ++i)
+		{
+			v = indices[i];
+			triAdj[triAdjOffset[v] + triAdjCount[v]++] = i / 3;
+		}
+
+		// initial scores
+		for (v = 0; v < numVerts; ++v)
+		{
+			vertCachePos[v] = -1;
+			vertScore[v] = a3geometryInternalVertexScore(-1, cacheSize, vertValence[v]);
+		}
+		bestTri = -1;
+		bestScore = -1.0f;
+		for (t = 0; t < numTris; ++t)
+		{
+			triEmitted[t] = 0;
+			triScore[t] = vertScore[indices[t * 3 + 0]] + vertScore[indices[t * 3 + 1]] + vertScore[indices[t * 3 + 2]];
+			if (triScore[t] > bestScore)
+			{
+				bestScore = triScore[t];
+				bestTri = t;
+			}
+		}
+
+		// emit triangles into index data
+		indexPtr = (a3ubyte *)geom->indexData;
+		cacheCount = 0;
+		triCursor = 0;
+		for (tri = 0; tri < numTris; ++tri)
+		{
+			// if no good candidate was found, take the next one in order
+			if (bestTri < 0)
+			{
+				while (triEmitted[triCursor])
+					++triCursor;
+				bestTri = triCursor;
+			}
+			t = (a3ui32)bestTri;
+			triEmitted[t] = 1;
+
+			// store and remove triangle from its vertices' adjacency
+			for (k = 0; k < 3; ++k)
+			{
+				v = indices[t * 3 + k];
+				indexPtr = a3proceduralInternalStoreIndex(indexPtr, indexSize, v);
+				for (j = 0; j < triAdjCount[v]; ++j)
+					if (triAdj[triAdjOffset[v] + j] == t)
+					{
+						triAdj[triAdjOffset[v] + j] = triAdj[triAdjOffset[v] + --triAdjCount[v]];
+						break;
+					}
+				--vertValence[v];
+			}
+
+			// update LRU cache: triangle's vertices go to the front
+			for (k = 0; k < 3; ++k)
+				cacheNext[k] = indices[t * 3 + k];
+			for (i = 0, cacheNextCount = 3; i < cacheCount; ++i)
+			{
+				v = cache[i];
+				if (v != indices[t * 3 + 0] && v != indices[t * 3 + 1] && v != indices[t * 3 + 2])
+					cacheNext[cacheNextCount++] = v;
+			}
+
+			// update positions and scores for everything touched,
+			//	including vertices falling out of the cache
+			for (i = 0; i < cacheNextCount; ++i)
+			{
+				v = cacheNext[i];
+				vertCachePos[v] = (i < cacheSize) ? (a3i32)i : -1;
+				vertScore[v] = a3geometryInternalVertexScore(vertCachePos[v], cacheSize, vertValence[v]);
+			}
+
+			// re-score adjacent triangles and find next best
+			bestTri = -1;
+			bestScore = -1.0f;
+			for (i = 0; i < cacheNextCount; ++i)
+			{
+				v = cacheNext[i];
+				for (j = 0; j < triAdjCount[v]; ++j)
+				{
+					k = triAdj[triAdjOffset[v] + j];
+					triScore[k] = vertScore[indices[k * 3 + 0]] + vertScore[indices[k * 3 + 1]] + vertScore[indices[k * 3 + 2]];
+					if (triScore[k] > bestScore)
+					{
+						bestScore = triScore[k];
+						bestTri = k;
+					}
+				}
+			}
+
+			// swap caches, trimming to size
+			cacheCount = cacheNextCount < cacheSize ? cacheNextCount : cacheSize;
+			memcpy(cache, cacheNext, sizeof(a3ui32) * cacheCount);
+		}
+
+		// done
+		free(tmp);
+		return numTris;
+	}
+	return -1;
+}
+
+a3ret a3geometryOptimizeVertexFetch(a3_GeometryData *geom)
+{
+	static const a3_VertexAttributeName fixedAttribName[] = {
+		a3attrib_position,
+		a3attrib_normal,
+		a3attrib_color,
+		a3attrib_texcoord,
+		a3attrib_tangent,
+		a3attrib_blendWeights,
+		a3attrib_bitangent,
+		a3attrib_blendIndices,
+	};
+
+	// attribute blocks to permute: explicit and implicit
+	a3byte *attribData[a3attrib_geomNameMax + 2] = { 0 };
+	a3ui32 attribSize[a3attrib_geomNameMax + 2] = { 0 };
+	a3ui32 *remap, maxSize = 0;
+	a3byte *tmp, *dst;
+	a3ubyte *indexPtr;
+	a3ui32 numVerts, indexSize, numReferenced;
+	a3ui32 i, v;
+
+	if (geom && geom->data)
+	{
+		// must be indexed
+		if (!geom->indexData || !geom->numIndices)
+			return 0;
+
+		indexSize = geom->indexFormat->indexSize;
+		numVerts = geom->numVertices;
+
+		// gather attribute blocks
+		for (i = 0; i < a3attrib_geomNameMax; ++i)
+			if (geom->attribData[i])
+			{
+				attribData[i] = (a3byte *)geom->attribData[i];
+				attribSize[i] = geom->vertexFormat->attribSize[fixedAttribName[i]];
+			}
+		if (a3geometryGetAddressBitangent((const void **)(attribData + a3attrib_geomNameMax + 0), geom) > 0)
+			attribSize[a3attrib_geomNameMax + 0] = geom->vertexFormat->attribSize[fixedAttribName[a3attrib_geomNameMax + 0]];
+		if (a3geometryGetAddressBlendingInd((const void **)(attribData + a3attrib_geomNameMax + 1), geom) > 0)
+			attribSize[a3attrib_geomNameMax + 1] = geom->vertexFormat->attribSize[fixedAttribName[a3attrib_geomNameMax + 1]];
+		for (i = 0; i < a3attrib_geomNameMax + 2; ++i)
+			if (attribSize[i] > maxSize)
+				maxSize = attribSize[i];
+
+		// allocate remap table followed by copy space for the largest block
+		remap = (a3ui32 *)malloc(sizeof(a3ui32) * numVerts + maxSize * numVerts);
+		if (!remap)
+			return 0;
+		tmp = (a3byte *)(remap + numVerts);
+
+		// build remap in order of first reference
+		memset(remap, 0xff, sizeof(a3ui32) * numVerts);
+		for (i = numReferenced = 0; i < geom->numIndices; ++i)
+		{
+			v = a3geometryInternalLoadIndex(geom->indexData, indexSize, i);
+			if (v >= numVerts)
+			{
+				printf("\n A3 ERROR: Geometry optimization failed; index %u out of range.", v);
+				free(remap);
+				return 0;
+			}
+			if (remap[v] == (a3ui32)(-1))
+				remap[v] = numReferenced++;
+		}
+
+		// unreferenced vertices go last
+		for (v = 0, i = numReferenced; v < numVerts; ++v)
+			if (remap[v] == (a3ui32)(-1))
+				remap[v] = i++;
+
+		// permute each attribute block
+		for (i = 0; i < a3attrib_geomNameMax + 2; ++i)
+			if (attribData[i] && attribSize[i])
+			{
+				dst = attribData[i];
+				memcpy(tmp, dst, attribSize[i] * numVerts);
+				for (v = 0; v < numVerts; ++v)
+					memcpy(dst + remap[v] * attribSize[i], tmp + v * attribSize[i], attribSize[i]);
+			}
+
+		// rewrite indices
+		for (i = 0, indexPtr = (a3ubyte *)geom->indexData; i < geom->numIndices; ++i)
+		{
+			v = a3geometryInternalLoadIndex(geom->indexData, indexSize, i);
+			indexPtr = a3proceduralInternalStoreIndex(indexPtr, indexSize, remap[v]);
+		}
+
+		// done
+		free(remap);
+		return numReferenced;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3f32 a3geometryCalculateACMR(const a3_GeometryData *geom, a3ui32 cacheSize)
+{
+	a3ui32 cache[a3geomOptimize_cacheSizeMax];
+	a3ui32 cacheHead = 0, cacheCount = 0, misses = 0;
+	a3ui32 i, j, v;
+
+	if (geom && geom->data && geom->indexData && geom->numIndices >= 3 && geom->primType == a3prim_triangles)
+	{
+		cacheSize = a3geometryInternalCacheSize(cacheSize);
+
+		// FIFO: only misses push into the cache
+		for (i = 0; i < geom->numIndices; ++i)
+		{
+			v = a3geometryInternalLoadIndex(geom->indexData, geom->indexFormat->indexSize, i);
+			for (j = 0; j < cacheCount; ++j)
+				if (cache[j] == v)
+					break;
+			if (j == cacheCount)
+			{
+				++misses;
+				if (cacheCount < cacheSize)
+					cache[cacheCount++] = v;
+				else
+				{
+					cache[cacheHead] = v;
+					cacheHead = (cacheHead + 1) % cacheSize;
+				}
+			}
+		}
+		return ((a3f32)misses / (a3f32)(geom->numIndices / 3));
+	}
+	return -1.0f;
+}
+
+
+//-----------------------------------------------------------------------------
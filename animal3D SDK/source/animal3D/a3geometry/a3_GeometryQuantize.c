@@ -0,0 +1,225 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_GeometryQuantize.c
+	Definitions for geometry attribute packing.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "animal3D/a3geometry/a3_GeometryQuantize.h"
+
+#include "animal3D-A3DM/a3math/a3sqrt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// external utilities
+
+a3ret a3geometryInternalCreateVertexFormat(a3_VertexFormatDescriptor *vertexFormat_out, const a3_GeometryVertexAttributeName *attribNameList, a3ui32 attribNameCount, const a3_VertexAttributeDescriptor *fixedAttribs);
+
+
+//-----------------------------------------------------------------------------
+
+a3f32 *a3geometryUnpackOctahedral(a3f32 *v_out, const a3i16 *oct)
+{
+	a3f32 t, l;
+	v_out[0] = (a3f32)oct[0] / 32767.0f;
+	v_out[1] = (a3f32)oct[1] / 32767.0f;
+	v_out[0] = v_out[0] < -1.0f ? -1.0f : v_out[0];
+	v_out[1] = v_out[1] < -1.0f ? -1.0f : v_out[1];
+
+	// unfold lower hemisphere
+	v_out[2] = 1.0f - (v_out[0] < 0.0f ? -v_out[0] : v_out[0]) - (v_out[1] < 0.0f ? -v_out[1] : v_out[1]);
+	t = v_out[2] < 0.0f ? -v_out[2] : 0.0f;
+	v_out[0] += v_out[0] >= 0.0f ? -t : +t;
+	v_out[1] += v_out[1] >= 0.0f ? -t : +t;
+
+	// normalize
+	l = 1.0f / a3sqrtf(v_out[0] * v_out[0] + v_out[1] * v_out[1] + v_out[2] * v_out[2]);
+	v_out[0] *= l;
+	v_out[1] *= l;
+	v_out[2] *= l;
+	return v_out;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3geometryCreateVertexFormatQuantized(a3_VertexFormatDescriptor *vertexFormat_out, const a3_GeometryVertexAttributeName *attribNameList, a3ui32 attribNameCount, const a3ui32 quantizeFlags)
+{
+	// same as default geometry format, packed types where requested
+	a3_VertexAttributeDescriptor fixedAttribs[] = {
+		// 6 explicit
+		{ a3attrib_position,		(quantizeFlags & a3geomQuantize_position) ? a3attrib_half4 : a3attrib_vec3		},
+		{ a3attrib_normal,			(quantizeFlags & a3geomQuantize_normal) ? a3attrib_snorm16x2 : a3attrib_vec3	},
+		{ a3attrib_color,			(quantizeFlags & a3geomQuantize_color) ? a3attrib_unorm8x4 : a3attrib_vec4		},
+		{ a3attrib_texcoord,		(quantizeFlags & a3geomQuantize_texcoord) ? a3attrib_unorm16x2 : a3attrib_vec2	},
+		{ a3attrib_tangent,			(quantizeFlags & a3geomQuantize_tangent) ? a3attrib_snorm16x2 : a3attrib_vec3	},
+		{ a3attrib_blendWeights,	(quantizeFlags & a3geomQuantize_blending) ? a3attrib_unorm8x4 : a3attrib_vec4	},
+		// 2 implicit
+		{ a3attrib_bitangent,		(quantizeFlags & a3geomQuantize_tangent) ? a3attrib_snorm16x2 : a3attrib_vec3	},
+		{ a3attrib_blendIndices,	a3attrib_ivec4	},
+	};
+	return a3geometryInternalCreateVertexFormat(vertexFormat_out, attribNameList, attribNameCount, fixedAttribs);
+}
+
+a3ret a3geometryQuantize(a3_GeometryData *geom_out, const a3_GeometryData *geom, a3ui32 quantizeFlags)
+{
+	a3_GeometryData ret = { 0 };
+	a3_VertexFormatDescriptor defaultFormat[1];
+	a3_GeometryVertexAttributeName attribName[a3attrib_geomNameMax];
+	a3ui32 numAttribs = 0;
+
+	const a3f32 *src;
+	const void *srcImplicit;
+	a3byte *dst;
+	a3ui32 vertexDataSize, indexDataSize;
+	a3ui32 i, v, n;
+
+	if (geom_out && geom && geom->data)
+	{
+		if (!geom_out->data)
+		{
+			// geometry must be using the default format to be converted
+			for (i = 1; i < a3attrib_geomNameMax; ++i)
+				if (geom->attribData[i])
+					attribName[numAttribs++] = (a3_GeometryVertexAttributeName)i;
+			a3geometryCreateVertexFormat(defaultFormat, attribName, numAttribs);
+			if (memcmp(defaultFormat, geom->vertexFormat, sizeof(a3_VertexFormatDescriptor)))
+			{
+				printf("\n A3 Warning: Geometry is already packed or does not use the default format; not packed.");
+				return 0;
+			}
+
+			// texture coordinates must be in range to be normalized
+			n = geom->numVertices;
+			if ((quantizeFlags & a3geomQuantize_texcoord) && geom->attribData[a3attrib_geomTexcoord])
+			{
+				src = (const a3f32 *)geom->attribData[a3attrib_geomTexcoord];
+				for (v = 0; v < n * 2; ++v)
+					if (src[v] < 0.0f || src[v] > 1.0f)
+					{
+						printf("\n A3 Warning: Texture coordinates outside [0, 1] cannot be packed; leaving as float.");
+						quantizeFlags &= ~a3geomQuantize_texcoord;
+						break;
+					}
+			}
+
+			// create packed format and storage
+			a3geometryCreateVertexFormatQuantized(ret.vertexFormat, attribName, numAttribs, quantizeFlags);
+			*ret.indexFormat = *geom->indexFormat;
+			ret.primType = geom->primType;
+			ret.numVertices = n;
+			ret.numIndices = geom->numIndices;
+			vertexDataSize = a3vertexFormatGetStorageSpaceRequired(ret.vertexFormat, n);
+			indexDataSize = a3indexFormatGetStorageSpaceRequired(ret.indexFormat, ret.numIndices);
+			ret.data = dst = (a3byte *)malloc(vertexDataSize + indexDataSize);
+			if (!ret.data)
+				return 0;
+
+			// convert each attribute block; implicit blocks follow their
+			//	explicit partner so address utilities still work
+			for (i = 0; i < a3attrib_geomNameMax; ++i)
+			{
+				src = (const a3f32 *)geom->attribData[i];
+				if (!src)
+					continue;
+				ret.attribData[i] = dst;
+				switch (i)
+				{
+				case a3attrib_geomPosition:
+					if (quantizeFlags & a3geomQuantize_position)
+						for (v = 0; v < n; ++v, src += 3, dst += 8)
+						{
+							((a3ui16 *)dst)[0] = a3halfPack(src[0]);
+							((a3ui16 *)dst)[1] = a3halfPack(src[1]);
+							((a3ui16 *)dst)[2] = a3halfPack(src[2]);
+							((a3ui16 *)dst)[3] = a3halfPack(1.0f);
+						}
+					else
+						dst = (a3byte *)memcpy(dst, src, n * 12) + n * 12;
+					break;
+				case a3attrib_geomNormal:
+					if (quantizeFlags & a3geomQuantize_normal)
+						for (v = 0; v < n; ++v, src += 3, dst += 4)
+							a3geometryPackOctahedral((a3i16 *)dst, src);
+					else
+						dst = (a3byte *)memcpy(dst, src, n * 12) + n * 12;
+					break;
+				case a3attrib_geomColor:
+					if (quantizeFlags & a3geomQuantize_color)
+						for (v = 0; v < n * 4; ++v)
+							*(dst++) = a3geometryPackUnorm8(*(src++));
+					else
+						dst = (a3byte *)memcpy(dst, src, n * 16) + n * 16;
+					break;
+				case a3attrib_geomTexcoord:
+					if (quantizeFlags & a3geomQuantize_texcoord)
+						for (v = 0; v < n * 2; ++v, dst += 2)
+							*((a3ui16 *)dst) = a3geometryPackUnorm16(*(src++));
+					else
+						dst = (a3byte *)memcpy(dst, src, n * 8) + n * 8;
+					break;
+				case a3attrib_geomTangent:
+					// tangents then bitangents
+					a3geometryGetAddressBitangent(&srcImplicit, geom);
+					if (quantizeFlags & a3geomQuantize_tangent)
+					{
+						for (v = 0; v < n; ++v, src += 3, dst += 4)
+							a3geometryPackOctahedral((a3i16 *)dst, src);
+						for (v = 0, src = (const a3f32 *)srcImplicit; v < n; ++v, src += 3, dst += 4)
+							a3geometryPackOctahedral((a3i16 *)dst, src);
+					}
+					else
+						dst = (a3byte *)memcpy(dst, src, n * 24) + n * 24;
+					break;
+				case a3attrib_geomBlending:
+					// weights then indices (unchanged)
+					a3geometryGetAddressBlendingInd(&srcImplicit, geom);
+					if (quantizeFlags & a3geomQuantize_blending)
+						for (v = 0; v < n; ++v, src += 4, dst += 4)
+							a3geometryPackWeights((a3ubyte *)dst, src);
+					else
+						dst = (a3byte *)memcpy(dst, src, n * 16) + n * 16;
+					dst = (a3byte *)memcpy(dst, srcImplicit, n * 16) + n * 16;
+					break;
+				}
+			}
+
+			// copy indices
+			if (geom->indexData)
+			{
+				ret.indexData = memcpy((a3byte *)ret.data + vertexDataSize, geom->indexData, ret.indexFormat->indexSize * ret.numIndices);
+			}
+
+			// done
+			*geom_out = ret;
+			return ret.vertexFormat->vertexSize;
+		}
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
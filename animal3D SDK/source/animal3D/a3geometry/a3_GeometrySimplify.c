@@ -0,0 +1,579 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_GeometrySimplify.c
+	Definitions for geometry simplification.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "animal3D/a3geometry/a3_GeometrySimplify.h"
+
+#include "animal3D-A3DM/a3math/a3sqrt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// external math and storage utilities
+
+inline void a3proceduralInternalCalculateNormal(a3f32 *normal_out, const a3f32 *p0, const a3f32 *p1, const a3f32 *p2);
+
+inline a3ubyte *a3proceduralInternalStoreIndex(a3ubyte *index, const a3ui32 indexSize, const a3ui32 i);
+
+
+//-----------------------------------------------------------------------------
+// internal types and utilities
+
+// vertex classification flags
+enum a3_GeometrySimplifyVertexFlag
+{
+	a3simplify_vertexLocked = 1,
+	a3simplify_vertexTouched = 2,
+};
+
+// collapse candidate: move vertex 'from' onto vertex 'to'
+typedef struct a3_GeometrySimplifyCollapse
+{
+	a3f32 cost;
+	a3ui32 from, to;
+} a3_GeometrySimplifyCollapse;
+
+// quadric: products of plane coefficients (a, b, c, d)
+//	aa, ab, ac, ad, bb, bc, bd, cc, cd, dd, and number of planes
+typedef struct a3_GeometrySimplifyQuadric
+{
+	a3f64 q[10];
+	a3f64 w;
+} a3_GeometrySimplifyQuadric;
+
+// weld sort key: position with the vertex it belongs to, so that the 
+//	comparison needs no shared state
+typedef struct a3_GeometrySimplifyWeldKey
+{
+	a3f32 position[3];
+	a3ui32 index;
+} a3_GeometrySimplifyWeldKey;
+
+
+// general index load
+inline a3ui32 a3simplifyInternalLoadIndex(const void *indexData, const a3ui32 indexSize, const a3ui32 i)
+{
+	if (indexSize < 2)
+		return ((const a3ubyte *)indexData)[i];
+	else if (indexSize < 4)
+		return ((const a3ui16 *)indexData)[i];
+	else
+		return ((const a3ui32 *)indexData)[i];
+}
+
+// add plane to quadric
+inline void a3simplifyInternalQuadricAddPlane(a3_GeometrySimplifyQuadric *quadric, const a3f64 a, const a3f64 b, const a3f64 c, const a3f64 d)
+{
+	quadric->q[0] += a * a;
+	quadric->q[1] += a * b;
+	quadric->q[2] += a * c;
+	quadric->q[3] += a * d;
+	quadric->q[4] += b * b;
+	quadric->q[5] += b * c;
+	quadric->q[6] += b * d;
+	quadric->q[7] += c * c;
+	quadric->q[8] += c * d;
+	quadric->q[9] += d * d;
+	quadric->w += 1.0;
+}
+
+// add quadric to another
+inline void a3simplifyInternalQuadricAdd(a3_GeometrySimplifyQuadric *quadric, const a3_GeometrySimplifyQuadric *other)
+{
+	a3ui32 i;
+	for (i = 0; i < 10; ++i)
+		quadric->q[i] += other->q[i];
+	quadric->w += other->w;
+}
+
+// add planes of triangles to the quadrics of their welded vertices
+void a3simplifyInternalQuadricInit(a3_GeometrySimplifyQuadric *quadric, const a3ui32 *weld, const a3f32 *position, const a3ui32 *indices, const a3ui32 numIndices, const a3ui32 numVertices)
+{
+	a3f32 normal[3], len;
+	const a3f32 *p0, *p1, *p2;
+	a3ui32 k, t, numTris = numIndices / 3;
+
+	memset(quadric, 0, sizeof(a3_GeometrySimplifyQuadric) * numVertices);
+	for (t = 0; t < numTris; ++t)
+	{
+		p0 = position + indices[t * 3 + 0] * 3;
+		p1 = position + indices[t * 3 + 1] * 3;
+		p2 = position + indices[t * 3 + 2] * 3;
+		a3proceduralInternalCalculateNormal(normal, p0, p1, p2);
+		len = normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2];
+		if (len > 0.0f)
+		{
+			len = 1.0f / a3sqrtf(len);
+			normal[0] *= len;
+			normal[1] *= len;
+			normal[2] *= len;
+			for (k = 0; k < 3; ++k)
+				a3simplifyInternalQuadricAddPlane(quadric + weld[indices[t * 3 + k]], normal[0], normal[1], normal[2],
+					-(normal[0] * p0[0] + normal[1] * p0[1] + normal[2] * p0[2]));
+		}
+	}
+}
+
+// evaluate sum of two quadrics at point (mean squared distance to planes,
+//	so that merged quadrics stay in units of distance)
+inline a3f64 a3simplifyInternalQuadricError(const a3_GeometrySimplifyQuadric *q0, const a3_GeometrySimplifyQuadric *q1, const a3f32 *p)
+{
+	a3f64 q[10], x = p[0], y = p[1], z = p[2], w = q0->w + q1->w, err;
+	a3ui32 i;
+	for (i = 0; i < 10; ++i)
+		q[i] = q0->q[i] + q1->q[i];
+	err = q[0] * x * x + 2.0 * q[1] * x * y + 2.0 * q[2] * x * z + 2.0 * q[3] * x
+		+ q[4] * y * y + 2.0 * q[5] * y * z + 2.0 * q[6] * y
+		+ q[7] * z * z + 2.0 * q[8] * z
+		+ q[9];
+	return (err > 0.0 && w > 0.0 ? err / w : 0.0);
+}
+
+// sort collapses by cost, ties broken by vertex so results are repeatable
+a3i32 a3simplifyInternalCompareCollapse(const void *lhs, const void *rhs)
+{
+	const a3_GeometrySimplifyCollapse *c0 = (const a3_GeometrySimplifyCollapse *)lhs, *c1 = (const a3_GeometrySimplifyCollapse *)rhs;
+	return (c0->cost < c1->cost ? -1 : c0->cost > c1->cost ? +1
+		: c0->from < c1->from ? -1 : c0->from > c1->from ? +1
+		: c0->to < c1->to ? -1 : c0->to > c1->to ? +1 : 0);
+}
+
+// sort vertices by position to find coincident vertices
+a3i32 a3simplifyInternalComparePosition(const void *lhs, const void *rhs)
+{
+	const a3_GeometrySimplifyWeldKey *k0 = (const a3_GeometrySimplifyWeldKey *)lhs, *k1 = (const a3_GeometrySimplifyWeldKey *)rhs;
+	const a3f32 *p0 = k0->position, *p1 = k1->position;
+	return (p0[0] < p1[0] ? -1 : p0[0] > p1[0] ? +1
+		: p0[1] < p1[1] ? -1 : p0[1] > p1[1] ? +1
+		: p0[2] < p1[2] ? -1 : p0[2] > p1[2] ? +1
+		: k0->index < k1->index ? -1 : k0->index > k1->index ? +1 : 0);
+}
+
+// compare attributes painted on the surface (colors, texture coordinates
+//	and blending) of two vertices; normals and tangents follow the shape,
+//	so vertices that only differ in those (faceted meshes) still weld
+a3boolean a3simplifyInternalSameAttributes(const a3_GeometryData *geom, const a3ui32 v0, const a3ui32 v1)
+{
+	const void *blendIndices = 0;
+	const a3ubyte *data[4];
+	a3ui32 size[4], i;
+
+	a3geometryGetAddressBlendingInd(&blendIndices, geom);
+	data[0] = (const a3ubyte *)geom->attribData[a3attrib_geomColor];
+	data[1] = (const a3ubyte *)geom->attribData[a3attrib_geomTexcoord];
+	data[2] = (const a3ubyte *)geom->attribData[a3attrib_geomBlending];
+	data[3] = (const a3ubyte *)blendIndices;
+	size[0] = geom->vertexFormat->attribSize[a3attrib_color];
+	size[1] = geom->vertexFormat->attribSize[a3attrib_texcoord];
+	size[2] = geom->vertexFormat->attribSize[a3attrib_blendWeights];
+	size[3] = geom->vertexFormat->attribSize[a3attrib_blendIndices];
+	for (i = 0; i < 4; ++i)
+		if (data[i] && memcmp(data[i] + v0 * size[i], data[i] + v1 * size[i], size[i]))
+			return 0;
+	return 1;
+}
+
+// weld vertices by position; lock welded vertices whose attributes differ
+//	(seams) and those on open borders of the welded mesh; flags are kept
+//	on the first vertex of each weld; key holds one sort key per vertex
+void a3simplifyInternalLockVertices(a3ubyte *vertexFlag, a3ui32 *weld, a3ui32 *adjOffset, a3ui32 *adj, a3_GeometrySimplifyWeldKey *key, const a3_GeometryData *geom, const a3f32 *position, const a3ui32 *indices, const a3ui32 numIndices, const a3ui32 numVertices)
+{
+	const a3f32 *p0, *p1;
+	a3ui32 i, j, k, t, v, a, b, count, numTris = numIndices / 3;
+
+	// sort vertex list by position, weld coincident vertices to the first
+	for (v = 0; v < numVertices; ++v)
+	{
+		memcpy(key[v].position, position + v * 3, sizeof(key->position));
+		key[v].index = v;
+	}
+	qsort(key, numVertices, sizeof(a3_GeometrySimplifyWeldKey), a3simplifyInternalComparePosition);
+	for (v = 0; v < numVertices; ++v)
+		weld[v] = key[v].index;
+	for (i = 0; i < numVertices; i = j)
+	{
+		p0 = position + weld[i] * 3;
+		for (j = i + 1; j < numVertices; ++j)
+		{
+			p1 = position + weld[j] * 3;
+			if (p0[0] != p1[0] || p0[1] != p1[1] || p0[2] != p1[2])
+				break;
+		}
+
+		// more than one vertex here with different attributes: seam
+		for (k = i + 1; k < j; ++k)
+			if (!a3simplifyInternalSameAttributes(geom, weld[i], weld[k]))
+			{
+				vertexFlag[weld[i]] |= a3simplify_vertexLocked;
+				break;
+			}
+
+		// store representative in adjacency offsets temporarily
+		for (k = i; k < j; ++k)
+			adjOffset[weld[k]] = weld[i];
+	}
+	memcpy(weld, adjOffset, sizeof(a3ui32) * numVertices);
+
+	// welded vertex to triangle adjacency
+	memset(adjOffset, 0, sizeof(a3ui32) * (numVertices + 1));
+	for (i = 0; i < numIndices; ++i)
+		++adjOffset[weld[indices[i]] + 1];
+	for (v = 0; v < numVertices; ++v)
+		adjOffset[v + 1] += adjOffset[v];
+	for (t = 0; t < numTris; ++t)
+		for (k = 0; k < 3; ++k)
+		{
+			v = weld[indices[t * 3 + k]];
+			adj[adjOffset[v]++] = t;
+		}
+	for (v = numVertices; v > 0; --v)
+		adjOffset[v] = adjOffset[v - 1];
+	adjOffset[0] = 0;
+
+	// border edge: welded edge used by only one triangle
+	for (t = 0; t < numTris; ++t)
+		for (k = 0; k < 3; ++k)
+		{
+			a = weld[indices[t * 3 + k]];
+			b = weld[indices[t * 3 + (k + 1) % 3]];
+			for (i = adjOffset[a], count = 0; i < adjOffset[a + 1]; ++i)
+				for (j = 0; j < 3; ++j)
+					if (weld[indices[adj[i] * 3 + j]] == b)
+					{
+						++count;
+						break;
+					}
+			if (count < 2)
+			{
+				vertexFlag[a] |= a3simplify_vertexLocked;
+				vertexFlag[b] |= a3simplify_vertexLocked;
+			}
+		}
+}
+
+// check that moving welded vertex 'from' onto 'to' does not flip any
+//	triangle
+a3boolean a3simplifyInternalCollapseValid(const a3ui32 *indices, const a3ui32 *weld, const a3ui32 *adjOffset, const a3ui32 *adj, const a3f32 *position, const a3ui32 from, const a3ui32 to)
+{
+	a3f32 n0[3], n1[3];
+	const a3f32 *p[3], *pTo = position + to * 3;
+	a3ui32 i, k, t, v[3];
+	for (i = adjOffset[from]; i < adjOffset[from + 1]; ++i)
+	{
+		t = adj[i];
+		v[0] = weld[indices[t * 3 + 0]];
+		v[1] = weld[indices[t * 3 + 1]];
+		v[2] = weld[indices[t * 3 + 2]];
+
+		// triangles containing both vertices disappear
+		if (v[0] == to || v[1] == to || v[2] == to)
+			continue;
+
+		for (k = 0; k < 3; ++k)
+			p[k] = position + v[k] * 3;
+		a3proceduralInternalCalculateNormal(n0, p[0], p[1], p[2]);
+		for (k = 0; k < 3; ++k)
+			if (v[k] == from)
+				p[k] = pTo;
+		a3proceduralInternalCalculateNormal(n1, p[0], p[1], p[2]);
+		if (n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] <= 0.0f)
+			return 0;
+	}
+	return 1;
+}
+
+// simplify triangle list in place until target count is reached or stalled;
+//	collapses move welded vertices, and corners that move take the vertex
+//	of the other end of the collapsed edge, so attributes stay continuous;
+//	quadrics hold the planes of the original mesh and are merged as
+//	vertices collapse, so the error is measured against the original
+//	returns new index count and updates error
+a3ui32 a3simplifyInternalSimplify(a3ui32 *indices, a3ui32 numIndices, const a3ui32 targetIndexCount, a3f32 *error, a3ubyte *vertexFlag, const a3ui32 *weld, a3ui32 *remap, a3ui32 *remapVertex, a3ui32 *adjOffset, a3ui32 *adj, a3_GeometrySimplifyQuadric *quadric, a3_GeometrySimplifyCollapse *collapse, const a3f32 *position, const a3ui32 numVertices)
+{
+	a3ui32 i, j, k, t, v, a, b, c, numTris, numCollapses, numPerformed, removed, needed;
+	a3f32 errorMax = *error;
+
+	while (numIndices > targetIndexCount)
+	{
+		numTris = numIndices / 3;
+		needed = (numIndices - targetIndexCount + 2) / 3;
+
+		// welded vertex to triangle adjacency
+		memset(adjOffset, 0, sizeof(a3ui32) * (numVertices + 1));
+		for (i = 0; i < numIndices; ++i)
+			++adjOffset[weld[indices[i]] + 1];
+		for (v = 0; v < numVertices; ++v)
+			adjOffset[v + 1] += adjOffset[v];
+		for (i = 0; i < numIndices; ++i)
+			adj[adjOffset[weld[indices[i]]]++] = i / 3;
+		for (v = numVertices; v > 0; --v)
+			adjOffset[v] = adjOffset[v - 1];
+		adjOffset[0] = 0;
+
+		// candidates: every directed edge whose source may move
+		for (t = numCollapses = 0; t < numTris; ++t)
+			for (k = 0; k < 3; ++k)
+			{
+				a = weld[indices[t * 3 + k]];
+				b = weld[indices[t * 3 + (k + 1) % 3]];
+				if (!(vertexFlag[a] & a3simplify_vertexLocked))
+				{
+					collapse[numCollapses].from = a;
+					collapse[numCollapses].to = b;
+					collapse[numCollapses].cost = (a3f32)a3simplifyInternalQuadricError(quadric + a, quadric + b, position + b * 3);
+					++numCollapses;
+				}
+				if (!(vertexFlag[b] & a3simplify_vertexLocked))
+				{
+					collapse[numCollapses].from = b;
+					collapse[numCollapses].to = a;
+					collapse[numCollapses].cost = (a3f32)a3simplifyInternalQuadricError(quadric + a, quadric + b, position + a * 3);
+					++numCollapses;
+				}
+			}
+		qsort(collapse, numCollapses, sizeof(a3_GeometrySimplifyCollapse), a3simplifyInternalCompareCollapse);
+
+		// perform cheapest independent collapses
+		for (v = 0; v < numVertices; ++v)
+		{
+			remap[v] = v;
+			vertexFlag[v] &= ~a3simplify_vertexTouched;
+		}
+		for (i = numPerformed = removed = 0; i < numCollapses && removed < needed; ++i)
+		{
+			a = collapse[i].from;
+			b = collapse[i].to;
+			if ((vertexFlag[a] | vertexFlag[b]) & a3simplify_vertexTouched)
+				continue;
+			if (!a3simplifyInternalCollapseValid(indices, weld, adjOffset, adj, position, a, b))
+				continue;
+
+			// lock the neighborhood for this pass so later validity
+			//	checks see current geometry; corners of the collapsed
+			//	edge give the vertex that moved corners take
+			for (j = adjOffset[a]; j < adjOffset[a + 1]; ++j)
+			{
+				t = adj[j];
+				for (k = 0; k < 3; ++k)
+				{
+					c = indices[t * 3 + k];
+					if (weld[c] == b)
+					{
+						remapVertex[a] = c;
+						++removed;
+					}
+					vertexFlag[weld[c]] |= a3simplify_vertexTouched;
+				}
+			}
+			remap[a] = b;
+			a3simplifyInternalQuadricAdd(quadric + b, quadric + a);
+			++numPerformed;
+			if (collapse[i].cost > errorMax * errorMax)
+				errorMax = a3sqrtf(collapse[i].cost);
+		}
+
+		// stalled
+		if (!numPerformed)
+			break;
+
+		// apply remap and remove degenerate triangles
+		for (t = j = 0; t < numTris; ++t)
+		{
+			a = remap[weld[indices[t * 3 + 0]]];
+			b = remap[weld[indices[t * 3 + 1]]];
+			v = remap[weld[indices[t * 3 + 2]]];
+			if (a != b && b != v && v != a)
+				for (k = 0; k < 3; ++k)
+				{
+					c = indices[t * 3 + k];
+					indices[j++] = remap[weld[c]] != weld[c] ? remapVertex[weld[c]] : c;
+				}
+		}
+		numIndices = j;
+	}
+
+	// done
+	*error = errorMax;
+	return numIndices;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3geometryGenerateLOD(a3_GeometryData *geom_out, a3_GeometryLOD *lod_out, const a3_GeometryData *geom, a3ui32 numLevels, a3f32 reduction)
+{
+	a3_GeometryData ret[1] = { 0 };
+	a3_GeometryLOD lod[1] = { 0 };
+
+	// temporary storage
+	a3ui32 *levelIndices, *indices, *weld, *remap, *remapVertex, *adjOffset, *adj;
+	a3_GeometrySimplifyQuadric *quadric;
+	a3_GeometrySimplifyCollapse *collapse;
+	a3ubyte *vertexFlag;
+	void *tmp;
+
+	const a3f32 *position;
+	a3ubyte *indexPtr;
+	a3ui32 vertexDataSize, indexDataSize;
+	a3ui32 numIndices, numVertices, totalIndices, target;
+	a3ui32 i, level;
+	a3f32 error = 0.0f;
+
+	if (geom_out && lod_out && geom && geom->data)
+	{
+		if (!geom_out->data)
+		{
+			// validate geometry (positions must not be packed)
+			if (!geom->indexData || !geom->numIndices || geom->numIndices % 3 || geom->primType != a3prim_triangles || !geom->attribData[a3attrib_geomPosition]
+				|| geom->vertexFormat->attribSize[a3attrib_position] != sizeof(a3f32) * 3)
+				return 0;
+
+			numLevels = numLevels < 1 ? 1 : numLevels > a3geomLOD_levelMax ? a3geomLOD_levelMax : numLevels;
+			if (reduction <= 0.0f || reduction >= 1.0f)
+				reduction = 0.5f;
+			position = (const a3f32 *)geom->attribData[a3attrib_geomPosition];
+			numVertices = geom->numVertices;
+			numIndices = geom->numIndices;
+
+			// allocate worst case: all levels, plus working data; quadrics
+			//	come first to keep them aligned
+			tmp = malloc(
+				sizeof(a3_GeometrySimplifyQuadric) * numVertices		// quadrics
+				+ sizeof(a3_GeometrySimplifyCollapse) * numIndices * 2	// candidates
+				+ sizeof(a3ui32) * numIndices * numLevels				// level indices
+				+ sizeof(a3ui32) * numIndices							// adjacency
+				+ sizeof(a3ui32) * (numVertices * 4 + 1)				// weld, remaps, adjacency offsets
+				+ sizeof(a3ubyte) * numVertices);						// flags
+			if (!tmp)
+				return 0;
+			quadric = (a3_GeometrySimplifyQuadric *)tmp;
+			collapse = (a3_GeometrySimplifyCollapse *)(quadric + numVertices);
+			levelIndices = (a3ui32 *)(collapse + numIndices * 2);
+			adj = levelIndices + numIndices * numLevels;
+			weld = adj + numIndices;
+			remap = weld + numVertices;
+			remapVertex = remap + numVertices;
+			adjOffset = remapVertex + numVertices;
+			vertexFlag = (a3ubyte *)(adjOffset + numVertices + 1);
+
+			// level 0 is the original
+			for (i = 0; i < numIndices; ++i)
+				levelIndices[i] = a3simplifyInternalLoadIndex(geom->indexData, geom->indexFormat->indexSize, i);
+			lod->indexOffset[0] = 0;
+			lod->indexCount[0] = numIndices;
+			lod->error[0] = 0.0f;
+			lod->numLevels = 1;
+			totalIndices = numIndices;
+
+			// weld and classify vertices once on the original mesh, whose
+			//	planes are kept for the error of every level; quadrics are 
+			//	not built yet, so their storage holds the weld sort keys
+			memset(vertexFlag, 0, numVertices);
+			a3simplifyInternalLockVertices(vertexFlag, weld, adjOffset, adj, (a3_GeometrySimplifyWeldKey *)quadric, geom, position, levelIndices, numIndices, numVertices);
+			a3simplifyInternalQuadricInit(quadric, weld, position, levelIndices, numIndices, numVertices);
+
+			// each level starts from the previous
+			for (level = 1; level < numLevels; ++level)
+			{
+				indices = levelIndices + totalIndices;
+				memcpy(indices, levelIndices + lod->indexOffset[level - 1], sizeof(a3ui32) * numIndices);
+				target = (a3ui32)((a3f32)(numIndices / 3) * reduction) * 3;
+				target = target < 3 ? 3 : target;
+				i = a3simplifyInternalSimplify(indices, numIndices, target, &error, vertexFlag, weld, remap, remapVertex, adjOffset, adj, quadric, collapse, position, numVertices);
+
+				// stop if not meaningfully reduced
+				if (!i || i * 20 > numIndices * 19)
+					break;
+				numIndices = i;
+				lod->indexOffset[level] = totalIndices;
+				lod->indexCount[level] = numIndices;
+				lod->error[level] = error;
+				totalIndices += numIndices;
+				++lod->numLevels;
+			}
+
+			// output: copy vertex data, append all levels' indices
+			vertexDataSize = a3vertexFormatGetStorageSpaceRequired(geom->vertexFormat, numVertices);
+			*ret->vertexFormat = *geom->vertexFormat;
+			a3geometryCreateIndexFormat(ret->indexFormat, numVertices);
+			indexDataSize = a3indexFormatGetStorageSpaceRequired(ret->indexFormat, totalIndices);
+			ret->primType = geom->primType;
+			ret->numVertices = numVertices;
+			ret->numIndices = totalIndices;
+			ret->data = malloc(vertexDataSize + indexDataSize);
+			if (!ret->data)
+			{
+				free(tmp);
+				return 0;
+			}
+			memcpy(ret->data, geom->data, vertexDataSize);
+			for (i = 0; i < a3attrib_geomNameMax; ++i)
+				ret->attribData[i] = geom->attribData[i] ? ((a3byte *)ret->data + ((a3byte *)geom->attribData[i] - (a3byte *)geom->data)) : 0;
+			ret->indexData = indexPtr = (a3ubyte *)ret->data + vertexDataSize;
+			for (i = 0; i < totalIndices; ++i)
+				indexPtr = a3proceduralInternalStoreIndex(indexPtr, ret->indexFormat->indexSize, levelIndices[i]);
+
+			// done
+			free(tmp);
+			*geom_out = *ret;
+			*lod_out = *lod;
+			return lod->numLevels;
+		}
+	}
+	return -1;
+}
+
+a3ret a3geometryGenerateDrawableLOD(a3_VertexDrawable *drawables_out, const a3_GeometryData *geom, const a3_GeometryLOD *lod, a3_VertexArrayDescriptor *vertexArray, a3_IndexBuffer *indexBuffer, const a3_IndexFormatDescriptor *commonIndexFormat_opt, a3ui32 *vertexBufferOffset_out_opt, a3ui32 *indexBufferOffset_out_opt)
+{
+	a3ui32 i, indexSize;
+	a3i32 ret;
+	if (drawables_out && geom && lod && lod->numLevels && geom->numIndices)
+	{
+		// store all data once; first drawable covers everything
+		ret = a3geometryGenerateDrawable(drawables_out, geom, vertexArray, indexBuffer, commonIndexFormat_opt, vertexBufferOffset_out_opt, indexBufferOffset_out_opt);
+		if (ret > 0)
+		{
+			// each level refers to its own range of the same buffers
+			indexSize = (commonIndexFormat_opt ? commonIndexFormat_opt : geom->indexFormat)->indexSize;
+			for (i = lod->numLevels - 1; i > 0; --i)
+			{
+				drawables_out[i] = drawables_out[0];
+				drawables_out[i].count = lod->indexCount[i];
+				drawables_out[i].indexing = (const a3byte *)drawables_out[0].indexing + lod->indexOffset[i] * indexSize;
+				a3vertexDrawableReference(drawables_out + i);
+			}
+			drawables_out[0].count = lod->indexCount[0];
+			drawables_out[0].indexing = (const a3byte *)drawables_out[0].indexing + lod->indexOffset[0] * indexSize;
+		}
+		return ret;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
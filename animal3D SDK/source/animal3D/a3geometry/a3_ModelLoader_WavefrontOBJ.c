@@ -25,6 +25,8 @@
 */
 
 #include "animal3D/a3geometry/a3_ModelLoader_WavefrontOBJ.h"
+#include "animal3D/a3geometry/a3_GeometryOptimize.h"
+#include "animal3D/a3utility/a3_Profiler.h"
 
 #include "animal3D-A3DM/a3math/a3sqrt.h"
 #include "animal3D-A3DM/a3math/a3vector.h"
@@ -101,6 +103,12 @@ enum a3_ModelAttributeInternalFlag
 	a3model_internalVertexTangentFlag = 32,
 };
 
+// block size of per-load scratch arena; big files get extra blocks
+enum a3_ModelLoaderInternalSize
+{
+	a3model_internalScratchBlockSize = 1024 * 1024,
+};
+
 
 //-----------------------------------------------------------------------------
 // internal parsing utilities
@@ -197,7 +205,7 @@ inline a3ret a3modelInternalGetInfluenceIndex(const a3byte *name, const a3byte *
 //-----------------------------------------------------------------------------
 
 // load OBJ
-a3ret a3modelInternalLoadOBJ(a3_ModelLoadDataOBJ *obj, FILE *fp, const a3_ModelLoaderFlag flags, const a3f32 *transform_opt)
+a3ret a3modelInternalLoadOBJ(a3_ModelLoadDataOBJ *obj, FILE *fp, const a3_ModelLoaderFlag flags, const a3f32 *transform_opt, a3_Arena *scratch)
 {
 	// 1. load file and count contents: 
 	//	- vertices
@@ -295,7 +303,9 @@ a3ret a3modelInternalLoadOBJ(a3_ModelLoadDataOBJ *obj, FILE *fp, const a3_ModelL
 		dataSize += (numTexcoordElements = texcoordComponents * obj->numTexcoords) * sizeof(a3f32);
 		dataSize += (numNormalElements = normalComponents * obj->numNormals) * sizeof(a3f32);
 		dataSize += (numFaceElements = faceComponents * obj->numFaces) * sizeof(a3i32);
-		obj->data = malloc(dataSize);
+		obj->data = a3arenaAlloc(scratch, dataSize);
+		if (!obj->data)
+			return 0;
 		obj->positions = positionPtr = positionPtr2 = (a3f32 *)obj->data;
 		obj->texcoords = texcoordPtr = (positionPtr + numPositionElements);
 		obj->normals = normalPtr = normalPtr2 = (texcoordPtr + numTexcoordElements);
@@ -411,7 +421,7 @@ a3ret a3modelInternalLoadOBJ(a3_ModelLoadDataOBJ *obj, FILE *fp, const a3_ModelL
 
 
 // load skin
-a3ret a3modelInternalLoadSkin(a3_ModelLoadDataSkin *skin, const a3byte *influenceNames[], const a3ui32 numInfluences, FILE *fp)
+a3ret a3modelInternalLoadSkin(a3_ModelLoadDataSkin *skin, const a3byte *influenceNames[], const a3ui32 numInfluences, FILE *fp, a3_Arena *scratch)
 {
 	// 1. get vertex count from header
 	// 2. allocate space for all attributes based on this number
@@ -496,7 +506,9 @@ a3ret a3modelInternalLoadSkin(a3_ModelLoadDataSkin *skin, const a3byte *influenc
 		dataSize += (numInfluenceElements = influenceComponents * skin->numVertices) * sizeof(INFL);
 		dataSize += (numCountElements = countComponents * skin->numVertices) * sizeof(a3ubyte);
 
-		skin->data = malloc(dataSize);
+		skin->data = a3arenaAlloc(scratch, dataSize);
+		if (!skin->data)
+			return 0;
 		skin->positions = positionPtr = (a3f32 *)skin->data;
 		skin->skinWeights = maxWeightAddr = weightPtr = (positionPtr + numPositionElements);
 		skin->skinInfluences = maxInfluenceAddr = influencePtr = (INFL *)(weightPtr + numWeightElements);
@@ -614,22 +626,10 @@ a3ret a3modelInternalLoadSkin(a3_ModelLoadDataSkin *skin, const a3byte *influenc
 }
 
 
-// release functions
-void a3modelInternalReleaseOBJ(a3_ModelLoadDataOBJ *obj)
-{
-	free(obj->data);
-}
-
-void a3modelInternalReleaseSkin(a3_ModelLoadDataSkin *skin)
-{
-	free(skin->data);
-}
-
-
 //-----------------------------------------------------------------------------
 
 // storage: convert to common data format
-a3ret a3modelInternalStore(a3_GeometryData *geom, const a3_ModelLoadDataOBJ *obj, const a3_ModelLoadDataSkin *skin, const a3_ModelLoaderFlag flags)
+a3ret a3modelInternalStore(a3_GeometryData *geom, const a3_ModelLoadDataOBJ *obj, const a3_ModelLoadDataSkin *skin, const a3_ModelLoaderFlag flags, a3_Arena *scratch, a3_Allocator *allocator_opt)
 {
 	//-------------------------------------------------------------------------
 	// internal helper structs
@@ -675,7 +675,7 @@ a3ret a3modelInternalStore(a3_GeometryData *geom, const a3_ModelLoadDataOBJ *obj
 	const a3ui32 tmpIndexStorage = numIndices * sizeof(a3ui32);
 	const a3ui32 tmpBasisStorage = obj->numPositions * sizeof(a3_VertexTangentBasisOBJ);
 	const a3ui32 tmpVertexStorage = numIndices * sizeof(a3_VertexDataOBJ);
-	a3_VertexDataOBJ *const vertexData = (a3_VertexDataOBJ *)malloc(tmpVertexStorage + tmpBasisStorage + tmpIndexStorage);
+	a3_VertexDataOBJ *const vertexData = (a3_VertexDataOBJ *)a3arenaAlloc(scratch, tmpVertexStorage + tmpBasisStorage + tmpIndexStorage);
 	a3_VertexTangentBasisOBJ *const basisData = (a3_VertexTangentBasisOBJ *)(vertexData + numIndices);
 	a3ui32 *const indexData = (a3ui32 *)(basisData + obj->numPositions);
 	void *dataEnd = (void *)(indexData + numIndices);
@@ -900,7 +900,8 @@ a3ret a3modelInternalStore(a3_GeometryData *geom, const a3_ModelLoadDataOBJ *obj
 	vertexDataStorage = a3vertexFormatGetStorageSpaceRequired(geom->vertexFormat, numVerticesUnique);
 	indexDataStorage = a3indexFormatGetStorageSpaceRequired(geom->indexFormat, numIndices);
 
-	geom->data = malloc(vertexDataStorage + indexDataStorage);
+	geom->data = a3allocatorAlloc(allocator_opt, vertexDataStorage + indexDataStorage);
+	geom->allocator = allocator_opt;
 	geom->attribData[a3attrib_geomPosition] = positionItr = (a3f32 *)geom->data;
 	texcoordStart = texcoordItr = positionItr + (positionComponents * numVerticesUnique);
 	normalStart = normalItr = texcoordItr + (texcoordComponents * numVerticesUnique);
@@ -988,17 +989,19 @@ a3ret a3modelInternalStore(a3_GeometryData *geom, const a3_ModelLoadDataOBJ *obj
 
 	//-------------------------------------------------------------------------
 	// done
-	free(vertexData);
+	// temporary vertex data is released with scratch arena
 	return 1;
 }
 
 
 //-----------------------------------------------------------------------------
 
-a3ret a3modelLoadOBJ(a3_GeometryData *geom_out, const a3byte *filePath, const a3_ModelLoaderFlag flags, const a3f32 *transform_opt)
+a3ret a3modelLoadOBJ(a3_GeometryData *geom_out, const a3byte *filePath, const a3_ModelLoaderFlag flags, const a3f32 *transform_opt, a3_Allocator *allocator_opt)
 {
 	a3_GeometryData ret[1] = { 0 };
 	a3_ModelLoadDataOBJ obj[1] = { 0 };
+	a3_Arena scratch[1] = { 0 };
+	a3_ProfileZone zone[1];
 	FILE *fp = 0;
 	a3i32 result = 0;
 
@@ -1010,17 +1013,38 @@ a3ret a3modelLoadOBJ(a3_GeometryData *geom_out, const a3byte *filePath, const a3
 			fp = fopen(filePath, "r");
 			if (fp)
 			{
+				// all temporary data goes in one scratch arena
+				if (a3arenaCreate(scratch, a3model_internalScratchBlockSize) <= 0)
+				{
+					fclose(fp);
+					return 0;
+				}
+
 				// load
-				result = a3modelInternalLoadOBJ(obj, fp, flags, transform_opt);
+				a3profileZoneBegin(zone, "a3modelLoadOBJ: parse");
+				result = a3modelInternalLoadOBJ(obj, fp, flags, transform_opt, scratch);
 				fclose(fp);
+				a3profileZoneEnd(zone);
 
 				if (result)
 				{
 					// convert to geometry data
-					result = a3modelInternalStore(ret, obj, 0, flags);
-					a3modelInternalReleaseOBJ(obj);
+					a3profileZoneBegin(zone, "a3modelLoadOBJ: store");
+					result = a3modelInternalStore(ret, obj, 0, flags, scratch, allocator_opt);
+					a3profileZoneEnd(zone);
+
+					// optimize if requested
+					if (result > 0 && (flags & a3model_optimizeVertexCache))
+					{
+						a3profileZoneBegin(zone, "a3modelLoadOBJ: optimize");
+						a3geometryOptimize(ret, 0);
+						a3profileZoneEnd(zone);
+					}
 					*geom_out = *ret;
 				}
+
+				// release temporary data at once
+				a3arenaRelease(scratch);
 			}
 			return result;
 		}
@@ -1028,11 +1052,12 @@ a3ret a3modelLoadOBJ(a3_GeometryData *geom_out, const a3byte *filePath, const a3
 	return -1;
 }
 
-a3ret a3modelLoadOBJSkinWeights(a3_GeometryData *geom_out, const a3byte *filePath, const a3_ModelLoaderFlag flags, const a3byte *weightsFilePath, const a3byte *influenceNames[], const a3ui32 numInfluences, const a3f32 *transform_opt)
+a3ret a3modelLoadOBJSkinWeights(a3_GeometryData *geom_out, const a3byte *filePath, const a3_ModelLoaderFlag flags, const a3byte *weightsFilePath, const a3byte *influenceNames[], const a3ui32 numInfluences, const a3f32 *transform_opt, a3_Allocator *allocator_opt)
 {
 	a3_GeometryData ret[1] = { 0 };
 	a3_ModelLoadDataOBJ obj[1] = { 0 };
 	a3_ModelLoadDataSkin skin[1] = { 0 };
+	a3_Arena scratch[1] = { 0 };
 	FILE *fp = 0;
 	a3i32 result = 0;
 
@@ -1044,8 +1069,15 @@ a3ret a3modelLoadOBJSkinWeights(a3_GeometryData *geom_out, const a3byte *filePat
 			fp = fopen(filePath, "r");
 			if (fp)
 			{
+				// all temporary data goes in one scratch arena
+				if (a3arenaCreate(scratch, a3model_internalScratchBlockSize) <= 0)
+				{
+					fclose(fp);
+					return 0;
+				}
+
 				// load
-				result = a3modelInternalLoadOBJ(obj, fp, flags, transform_opt);
+				result = a3modelInternalLoadOBJ(obj, fp, flags, transform_opt, scratch);
 				fclose(fp);
 
 				// load skin
@@ -1057,7 +1089,7 @@ a3ret a3modelLoadOBJSkinWeights(a3_GeometryData *geom_out, const a3byte *filePat
 						fp = fopen(weightsFilePath, "r");
 						if (fp)
 						{
-							result = a3modelInternalLoadSkin(skin, influenceNames, numInfluences, fp);
+							result = a3modelInternalLoadSkin(skin, influenceNames, numInfluences, fp, scratch);
 							fclose(fp);
 							if (!result)
 								printf("\n A3: Warning: Skin weights file load failed; model was loaded.");
@@ -1069,11 +1101,16 @@ a3ret a3modelLoadOBJSkinWeights(a3_GeometryData *geom_out, const a3byte *filePat
 						printf("\n A3 Warning: Invalid skin weights parameters; model was loaded.");
 
 					// convert to geometry data
-					result = a3modelInternalStore(ret, obj, (result ? skin : 0), flags);
-					a3modelInternalReleaseOBJ(obj);
-					a3modelInternalReleaseSkin(skin);
+					result = a3modelInternalStore(ret, obj, (result ? skin : 0), flags, scratch, allocator_opt);
+
+					// optimize if requested
+					if (result > 0 && (flags & a3model_optimizeVertexCache))
+						a3geometryOptimize(ret, 0);
 					*geom_out = *ret;
 				}
+
+				// release temporary data at once
+				a3arenaRelease(scratch);
 			}
 			return result;
 		}
@@ -25,6 +25,7 @@
 */
 
 #include "animal3D/a3geometry/a3_ProceduralGeometry.h"
+#include "animal3D/a3geometry/a3_GeometryOptimize.h"
 
 #include "animal3D-A3DM/a3math/a3vector.h"
 
@@ -85,7 +86,7 @@ a3ret a3proceduralInternalGenerateNothing(a3_GeometryData *geomData, const a3_Pr
 //-----------------------------------------------------------------------------
 // internal function selector
 
-inline a3ret a3proceduralInternalGenerateData(a3_GeometryData *geomData, const a3_ProceduralGeometryDescriptor *geom)
+inline a3ret a3proceduralInternalGenerateData(a3_GeometryData *geomData, const a3_ProceduralGeometryDescriptor *geom, a3_Allocator *allocator_opt)
 {
 	const a3proceduralGenerateFunc generateFuncList[] = {
 		a3proceduralInternalGenerateNothing,	// filler
@@ -106,6 +107,7 @@ inline a3ret a3proceduralInternalGenerateData(a3_GeometryData *geomData, const a
 	}, generateFunc = generateFuncList[geom->shape];
 	const a3_GeometryData reset = { 0 };
 	*geomData = reset;
+	geomData->allocator = allocator_opt;
 	return generateFunc(geomData, geom);
 }
 
@@ -261,12 +263,12 @@ a3ret a3proceduralSetDescriptorFlagsAxis(a3_ProceduralGeometryDescriptor *geom,
 //-----------------------------------------------------------------------------
 // generate
 
-a3ret a3proceduralGenerateGeometryData(a3_GeometryData *geomData_out, const a3_ProceduralGeometryDescriptor *geom, const a3f32 *transform_opt)
+a3ret a3proceduralGenerateGeometryData(a3_GeometryData *geomData_out, const a3_ProceduralGeometryDescriptor *geom, const a3f32 *transform_opt, a3_Allocator *allocator_opt)
 {
 	if (geomData_out && geom)
 		if (!geomData_out->data && geom->shape)
 		{
-			const a3i32 result = a3proceduralInternalGenerateData(geomData_out, geom);
+			const a3i32 result = a3proceduralInternalGenerateData(geomData_out, geom, allocator_opt);
 			if (result && transform_opt)
 				a3proceduralInternalFreezeTransform(geomData_out, transform_opt);
 			return result;
@@ -274,6 +276,14 @@ a3ret a3proceduralGenerateGeometryData(a3_GeometryData *geomData_out, const a3_P
 	return -1;
 }
 
+a3ret a3proceduralGenerateGeometryDataOptimized(a3_GeometryData *geomData_out, const a3_ProceduralGeometryDescriptor *geom, const a3f32 *transform_opt, const a3ui32 cacheSize, a3_Allocator *allocator_opt)
+{
+	const a3i32 result = a3proceduralGenerateGeometryData(geomData_out, geom, transform_opt, allocator_opt);
+	if (result > 0)
+		a3geometryOptimize(geomData_out, cacheSize);
+	return result;
+}
+
 
 //-----------------------------------------------------------------------------
 // internal function prototypes
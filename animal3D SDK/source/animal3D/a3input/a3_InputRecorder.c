@@ -0,0 +1,365 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_InputRecorder.c
+	Input record and replay implementation.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "animal3D/a3input/a3_InputRecorder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+
+//-----------------------------------------------------------------------------
+// internal types
+
+// stream header; ticks follow, each a run count and that many runs of
+//	(bytes skipped since previous run, length, bytes), then a count of
+//	character keys and that many keys; counts as varints
+typedef struct a3_InputRecorderInternalHeader
+{
+	a3ui32 tag, version, frameSize, tickCount;
+} a3_InputRecorderInternalHeader;
+
+// tag of stream ("A3IR")
+#define A3_INPUTRECORDER_TAG		0x52493341u
+#define A3_INPUTRECORDER_VERSION	2u
+
+// equal bytes between two changes that still join them into one run; a
+//	run costs about two bytes, so shorter gaps are cheaper to copy
+#define A3_INPUTRECORDER_GAP		2u
+
+// snapshot layout: current states only, since previous states are
+//	derived from them by the input updates
+#define A3_INPUTRECORDER_KEY		0u
+#define A3_INPUTRECORDER_KEYASCII	(A3_INPUTRECORDER_KEY + sizeof(((a3_KeyboardInput *)0)->key))
+#define A3_INPUTRECORDER_MOUSEBTN	(A3_INPUTRECORDER_KEYASCII + sizeof(((a3_KeyboardInput *)0)->keyASCII))
+#define A3_INPUTRECORDER_MOUSEX		(A3_INPUTRECORDER_MOUSEBTN + sizeof(((a3_MouseInput *)0)->btn))
+#define A3_INPUTRECORDER_MOUSEY		(A3_INPUTRECORDER_MOUSEX + sizeof(a3i32))
+#define A3_INPUTRECORDER_CTRL		(A3_INPUTRECORDER_MOUSEY + sizeof(a3i32))
+#define A3_INPUTRECORDER_CONNECTED	(A3_INPUTRECORDER_CTRL + sizeof(((a3_XboxControllerInput *)0)->ctrl))
+#define A3_INPUTRECORDER_FRAME		(A3_INPUTRECORDER_CONNECTED + sizeof(a3byte))
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+inline void a3inputRecorderInternalCapture(a3ubyte *frame, const a3_KeyboardInput *keyboard, const a3_MouseInput *mouse, const a3_XboxControllerInput *xcontrol)
+{
+	memcpy(frame + A3_INPUTRECORDER_KEY, &keyboard->key, sizeof(keyboard->key));
+	memcpy(frame + A3_INPUTRECORDER_KEYASCII, &keyboard->keyASCII, sizeof(keyboard->keyASCII));
+	memcpy(frame + A3_INPUTRECORDER_MOUSEBTN, &mouse->btn, sizeof(mouse->btn));
+	memcpy(frame + A3_INPUTRECORDER_MOUSEX, &mouse->x, sizeof(a3i32));
+	memcpy(frame + A3_INPUTRECORDER_MOUSEY, &mouse->y, sizeof(a3i32));
+	memcpy(frame + A3_INPUTRECORDER_CTRL, &xcontrol->ctrl, sizeof(xcontrol->ctrl));
+	memcpy(frame + A3_INPUTRECORDER_CONNECTED, &xcontrol->connected, sizeof(a3byte));
+}
+
+inline void a3inputRecorderInternalApply(const a3ubyte *frame, a3_KeyboardInput *keyboard, a3_MouseInput *mouse, a3_XboxControllerInput *xcontrol)
+{
+	memcpy(&keyboard->key, frame + A3_INPUTRECORDER_KEY, sizeof(keyboard->key));
+	memcpy(&keyboard->keyASCII, frame + A3_INPUTRECORDER_KEYASCII, sizeof(keyboard->keyASCII));
+	memcpy(&mouse->btn, frame + A3_INPUTRECORDER_MOUSEBTN, sizeof(mouse->btn));
+	memcpy(&mouse->x, frame + A3_INPUTRECORDER_MOUSEX, sizeof(a3i32));
+	memcpy(&mouse->y, frame + A3_INPUTRECORDER_MOUSEY, sizeof(a3i32));
+	memcpy(&xcontrol->ctrl, frame + A3_INPUTRECORDER_CTRL, sizeof(xcontrol->ctrl));
+	memcpy(&xcontrol->connected, frame + A3_INPUTRECORDER_CONNECTED, sizeof(a3byte));
+}
+
+// make room for count more bytes of recorded data
+inline a3boolean a3inputRecorderInternalReserve(a3_InputRecorder *recorder, const a3ui32 count)
+{
+	a3ubyte *data;
+	a3ui32 capacity = recorder->capacity;
+	if (recorder->size + count > capacity)
+	{
+		while (recorder->size + count > capacity)
+			capacity *= 2;
+		data = (a3ubyte *)realloc(recorder->data, capacity);
+		if (!data)
+			return 0;
+		recorder->data = data;
+		recorder->capacity = capacity;
+	}
+	return 1;
+}
+
+inline void a3inputRecorderInternalWriteCount(a3_InputRecorder *recorder, a3ui32 value)
+{
+	while (value >= 0x80)
+	{
+		recorder->data[recorder->size++] = (a3ubyte)(value | 0x80);
+		value >>= 7;
+	}
+	recorder->data[recorder->size++] = (a3ubyte)value;
+}
+
+// read varint; returns 0 if stream ended
+inline a3boolean a3inputRecorderInternalReadCount(a3_Stream *stream, a3ui32 *value_out)
+{
+	a3ubyte const *itr = (a3ubyte const *)stream->contents + stream->offset;
+	a3ubyte const *const end = (a3ubyte const *)stream->contents + stream->length;
+	a3ui32 value = 0, shift = 0;
+	while (itr < end && shift < 32)
+	{
+		value |= (a3ui32)(*itr & 0x7F) << shift;
+		shift += 7;
+		if (!(*(itr++) & 0x80))
+		{
+			stream->offset = (a3ui32)(itr - (a3ubyte const *)stream->contents);
+			*value_out = value;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// find next run of changed bytes at or after start; returns 0 if none
+inline a3boolean a3inputRecorderInternalNextRun(const a3ubyte *frame, const a3ubyte *prev, a3ui32 start, a3ui32 *begin_out, a3ui32 *end_out)
+{
+	a3ui32 end, gap;
+	while (start < A3_INPUTRECORDER_FRAME && frame[start] == prev[start])
+		++start;
+	if (start < A3_INPUTRECORDER_FRAME)
+	{
+		// extend over changes and short gaps between them
+		for (end = start + 1, gap = 0; end + gap < A3_INPUTRECORDER_FRAME && gap <= A3_INPUTRECORDER_GAP; )
+		{
+			if (frame[end + gap] != prev[end + gap])
+			{
+				end += gap + 1;
+				gap = 0;
+			}
+			else
+				++gap;
+		}
+		*begin_out = start;
+		*end_out = end;
+		return 1;
+	}
+	return 0;
+}
+
+inline a3ret a3inputRecorderInternalRecord(a3_InputRecorder *recorder, const a3_KeyboardInput *keyboard, const a3_MouseInput *mouse, const a3_XboxControllerInput *xcontrol)
+{
+	a3ubyte frame[a3input_recorderFrameMax];
+	a3ui32 begin, end, start, runs;
+	a3inputRecorderInternalCapture(frame, keyboard, mouse, xcontrol);
+
+	// count runs first so the tick can be read without a terminator
+	for (runs = 0, start = 0; a3inputRecorderInternalNextRun(frame, recorder->frame, start, &begin, &end); start = end)
+		++runs;
+
+	// worst case: every changed byte is its own run, with two-byte counts
+	if (!a3inputRecorderInternalReserve(recorder, 5 + A3_INPUTRECORDER_FRAME * 5 + 5 + a3input_recorderKeyCharMax))
+	{
+		printf("\n A3 ERROR: Could not allocate input recording; recording stopped.");
+		return -1;
+	}
+	a3inputRecorderInternalWriteCount(recorder, runs);
+	for (start = 0; a3inputRecorderInternalNextRun(frame, recorder->frame, start, &begin, &end); start = end)
+	{
+		a3inputRecorderInternalWriteCount(recorder, begin - start);
+		a3inputRecorderInternalWriteCount(recorder, end - begin);
+		memcpy(recorder->data + recorder->size, frame + begin, end - begin);
+		recorder->size += end - begin;
+	}
+	a3inputRecorderInternalWriteCount(recorder, recorder->keyCharCount);
+	memcpy(recorder->data + recorder->size, recorder->keyChar, recorder->keyCharCount);
+	recorder->size += recorder->keyCharCount;
+	recorder->keyCharCount = 0;
+	memcpy(recorder->frame, frame, A3_INPUTRECORDER_FRAME);
+	++recorder->ticks;
+	return 1;
+}
+
+inline a3ret a3inputRecorderInternalReplay(a3_InputRecorder *recorder, a3_KeyboardInput *keyboard, a3_MouseInput *mouse, a3_XboxControllerInput *xcontrol)
+{
+	a3_Stream *const stream = recorder->stream;
+	a3ui32 runs, skip, length, start = 0, count = 0;
+	a3boolean valid;
+
+	recorder->keyCharCount = 0;
+	if (recorder->ticks >= recorder->tickCount)
+	{
+		recorder->mode = a3input_recorderIdle;
+		return 0;
+	}
+	valid = a3inputRecorderInternalReadCount(stream, &runs);
+	for (; valid && runs; --runs)
+	{
+		valid = a3inputRecorderInternalReadCount(stream, &skip) &&
+			a3inputRecorderInternalReadCount(stream, &length) &&
+			start + skip + length <= A3_INPUTRECORDER_FRAME &&
+			stream->offset + length <= stream->length;
+		if (valid)
+		{
+			start += skip;
+			memcpy(recorder->frame + start, stream->contents + stream->offset, length);
+			stream->offset += length;
+			start += length;
+		}
+	}
+	valid = valid && a3inputRecorderInternalReadCount(stream, &count) &&
+		count <= a3input_recorderKeyCharMax &&
+		stream->offset + count <= stream->length;
+	if (!valid)
+	{
+		printf("\n A3 ERROR: Input recording is damaged at tick %u; replay stopped.", recorder->ticks);
+		recorder->mode = a3input_recorderIdle;
+		return -1;
+	}
+	memcpy(recorder->keyChar, stream->contents + stream->offset, count);
+	stream->offset += count;
+	recorder->keyCharCount = count;
+	a3inputRecorderInternalApply(recorder->frame, keyboard, mouse, xcontrol);
+	++recorder->ticks;
+	return 1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3inputRecorderBeginRecord(a3_InputRecorder *recorder_out, const a3byte *filePath)
+{
+	a3_InputRecorderInternalHeader header = { A3_INPUTRECORDER_TAG, A3_INPUTRECORDER_VERSION, A3_INPUTRECORDER_FRAME, 0 };
+	if (recorder_out && filePath && *filePath)
+	{
+		if (!recorder_out->mode && !recorder_out->data && !recorder_out->stream->contents)
+		{
+			memset(recorder_out, 0, sizeof(a3_InputRecorder));
+			recorder_out->data = (a3ubyte *)malloc(4096);
+			if (recorder_out->data)
+			{
+				recorder_out->capacity = 4096;
+				memcpy(recorder_out->data, &header, sizeof(header));
+				recorder_out->size = sizeof(header);
+				strncpy(recorder_out->filePath, filePath, a3input_recorderPathMax - 1);
+				recorder_out->mode = a3input_recorderRecord;
+				return 1;
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+a3ret a3inputRecorderBeginReplay(a3_InputRecorder *recorder_out, const a3byte *filePath)
+{
+	a3_InputRecorderInternalHeader header;
+	if (recorder_out && filePath && *filePath)
+	{
+		if (!recorder_out->mode && !recorder_out->data && !recorder_out->stream->contents)
+		{
+			memset(recorder_out, 0, sizeof(a3_InputRecorder));
+			if (a3streamLoadContents(recorder_out->stream, filePath, 0) > 0)
+			{
+				if (recorder_out->stream->length >= sizeof(header))
+				{
+					memcpy(&header, recorder_out->stream->contents, sizeof(header));
+					if (header.tag == A3_INPUTRECORDER_TAG && header.version == A3_INPUTRECORDER_VERSION && header.frameSize == A3_INPUTRECORDER_FRAME)
+					{
+						recorder_out->stream->offset = sizeof(header);
+						recorder_out->tickCount = header.tickCount;
+						recorder_out->mode = a3input_recorderReplay;
+						return header.tickCount;
+					}
+				}
+				printf("\n A3 ERROR: Not an input recording of this build: %s", filePath);
+				a3streamReleaseContents(recorder_out->stream);
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+a3ret a3inputRecorderKeyChar(a3_InputRecorder *recorder, const a3i32 asciiKey, const a3boolean hold)
+{
+	if (recorder && asciiKey >= 0 && asciiKey < 0x80)
+	{
+		if (recorder->mode != a3input_recorderRecord)
+			return 0;
+		if (recorder->keyCharCount < a3input_recorderKeyCharMax)
+		{
+			recorder->keyChar[recorder->keyCharCount++] = (a3ubyte)(asciiKey | (hold ? 0x80 : 0x00));
+			return 1;
+		}
+		printf("\n A3 ERROR: Too many character keys in one tick; key not recorded.");
+	}
+	return -1;
+}
+
+a3ret a3inputRecorderTick(a3_InputRecorder *recorder, a3_KeyboardInput *keyboard, a3_MouseInput *mouse, a3_XboxControllerInput *xcontrol)
+{
+	a3ret result;
+	if (recorder && keyboard && mouse && xcontrol)
+	{
+		switch (recorder->mode)
+		{
+		case a3input_recorderRecord:
+			result = a3inputRecorderInternalRecord(recorder, keyboard, mouse, xcontrol);
+			if (result < 0)
+				recorder->mode = a3input_recorderIdle;
+			return result;
+		case a3input_recorderReplay:
+			return a3inputRecorderInternalReplay(recorder, keyboard, mouse, xcontrol);
+		default:
+			return 0;
+		}
+	}
+	return -1;
+}
+
+a3ret a3inputRecorderEnd(a3_InputRecorder *recorder)
+{
+	a3_Stream stream = { 0 };
+	a3ret result = -1;
+	if (recorder)
+	{
+		result = recorder->ticks;
+
+		// patch tick count into header and save
+		if (recorder->data)
+		{
+			memcpy(recorder->data + offsetof(a3_InputRecorderInternalHeader, tickCount), &recorder->ticks, sizeof(a3ui32));
+			stream.contents = (a3byte const *)recorder->data;
+			stream.length = recorder->size;
+			if (a3streamSaveContents(&stream, recorder->filePath) < 0)
+			{
+				printf("\n A3 ERROR: Could not save input recording: %s", recorder->filePath);
+				result = -1;
+			}
+			free(recorder->data);
+		}
+		if (recorder->stream->contents)
+			a3streamReleaseContents(recorder->stream);
+		memset(recorder, 0, sizeof(a3_InputRecorder));
+	}
+	return result;
+}
+
+
+//-----------------------------------------------------------------------------
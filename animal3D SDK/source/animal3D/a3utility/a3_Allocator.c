@@ -0,0 +1,301 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_Allocator.c
+	Allocator implementations.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "animal3D/a3utility/a3_Allocator.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// header at the start of each arena block and pool chunk; padded so the
+//	data that follows stays aligned
+typedef union a3_AllocatorHeader
+{
+	void *prev;
+	a3byte pad[a3allocator_alignment];
+} a3_AllocatorHeader;
+
+// round up to alignment
+inline a3ui32 a3allocatorInternalAlign(const a3ui32 size)
+{
+	return ((size + (a3allocator_alignment - 1)) & ~(a3ui32)(a3allocator_alignment - 1));
+}
+
+// free chain of blocks or chunks
+inline void a3allocatorInternalFreeChain(a3_AllocatorHeader *header)
+{
+	a3_AllocatorHeader *prev;
+	while (header)
+	{
+		prev = (a3_AllocatorHeader *)header->prev;
+		free(header);
+		header = prev;
+	}
+}
+
+// add arena block
+inline void *a3arenaInternalAddBlock(a3_Arena *arena, const a3ui32 capacity)
+{
+	a3_AllocatorHeader *const header = (a3_AllocatorHeader *)malloc(sizeof(a3_AllocatorHeader) + capacity);
+	if (header)
+	{
+		header->prev = arena->block;
+		arena->block = header;
+		arena->blockUsed = 0;
+		arena->blockCapacity = capacity;
+	}
+	return header;
+}
+
+// add pool chunk and put its blocks on the free list
+inline void *a3poolInternalAddChunk(a3_Pool *pool)
+{
+	a3_AllocatorHeader *const header = (a3_AllocatorHeader *)malloc(sizeof(a3_AllocatorHeader) + pool->blockSize * pool->blocksPerChunk);
+	a3byte *block;
+	a3ui32 i;
+	if (header)
+	{
+		header->prev = pool->chunk;
+		pool->chunk = header;
+
+		// link in reverse so blocks are handed out in address order
+		for (i = pool->blocksPerChunk, block = (a3byte *)(header + 1) + pool->blockSize * i; i > 0; --i)
+		{
+			block -= pool->blockSize;
+			*(void **)block = pool->freeList;
+			pool->freeList = block;
+		}
+	}
+	return header;
+}
+
+// interface functions
+void *a3arenaInternalAllocFunc(a3_Allocator *allocator, const a3ui32 size)
+{
+	return a3arenaAlloc((a3_Arena *)allocator, size);
+}
+
+void a3arenaInternalFreeFunc(a3_Allocator *allocator, void *block)
+{
+	// arena memory is returned all at once
+	(void)allocator;
+	(void)block;
+}
+
+void *a3poolInternalAllocFunc(a3_Allocator *allocator, const a3ui32 size)
+{
+	a3_Pool *const pool = (a3_Pool *)allocator;
+	if (size <= pool->blockSize)
+		return a3poolAlloc(pool);
+	printf("\n A3 ERROR: Pool block size (%u) is too small for allocation (%u).", pool->blockSize, size);
+	return 0;
+}
+
+void a3poolInternalFreeFunc(a3_Allocator *allocator, void *block)
+{
+	a3poolFree((a3_Pool *)allocator, block);
+}
+
+
+//-----------------------------------------------------------------------------
+
+void *a3allocatorAlloc(a3_Allocator *allocator_opt, const a3ui32 size)
+{
+	if (size)
+		return allocator_opt ? allocator_opt->allocFunc(allocator_opt, size) : malloc(size);
+	return 0;
+}
+
+a3ret a3allocatorFree(a3_Allocator *allocator_opt, void *block)
+{
+	if (block)
+	{
+		if (allocator_opt)
+			allocator_opt->freeFunc(allocator_opt, block);
+		else
+			free(block);
+		return 1;
+	}
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3arenaCreate(a3_Arena *arena_out, const a3ui32 blockSize)
+{
+	a3_Arena ret = { 0 };
+	if (arena_out && blockSize)
+	{
+		if (!arena_out->block)
+		{
+			ret.allocator->allocFunc = a3arenaInternalAllocFunc;
+			ret.allocator->freeFunc = a3arenaInternalFreeFunc;
+			ret.blockSize = a3allocatorInternalAlign(blockSize);
+			if (a3arenaInternalAddBlock(&ret, ret.blockSize))
+			{
+				*arena_out = ret;
+				return ret.blockSize;
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+void *a3arenaAlloc(a3_Arena *arena, const a3ui32 size)
+{
+	a3ui32 alignedSize;
+	a3byte *ret;
+	if (arena && arena->block && size)
+	{
+		// start new block if current one cannot fit this
+		alignedSize = a3allocatorInternalAlign(size);
+		if (arena->blockUsed + alignedSize > arena->blockCapacity)
+			if (!a3arenaInternalAddBlock(arena, alignedSize > arena->blockSize ? alignedSize : arena->blockSize))
+				return 0;
+
+		// bump
+		ret = (a3byte *)((a3_AllocatorHeader *)arena->block + 1) + arena->blockUsed;
+		arena->blockUsed += alignedSize;
+		arena->used += alignedSize;
+		if (arena->peak < arena->used)
+			arena->peak = arena->used;
+		return ret;
+	}
+	return 0;
+}
+
+a3ret a3arenaReset(a3_Arena *arena)
+{
+	const a3ui32 used = arena ? arena->used : 0;
+	a3_AllocatorHeader *header, *grown;
+	if (arena && arena->block)
+	{
+		header = (a3_AllocatorHeader *)arena->block;
+		if (header->prev)
+		{
+			// grew: replace all blocks with one that fits everything; if 
+			//	that cannot be allocated, keep the newest block instead
+			grown = (a3_AllocatorHeader *)a3arenaInternalAddBlock(arena, used > arena->blockSize ? used : arena->blockSize);
+			if (grown)
+				header = grown;
+			a3allocatorInternalFreeChain(header->prev);
+			header->prev = 0;
+		}
+		arena->blockUsed = 0;
+		arena->used = 0;
+		return used;
+	}
+	return -1;
+}
+
+a3ret a3arenaRelease(a3_Arena *arena)
+{
+	const a3_Arena reset = { 0 };
+	a3ui32 peak;
+	if (arena && arena->block)
+	{
+		peak = arena->peak;
+		a3allocatorInternalFreeChain((a3_AllocatorHeader *)arena->block);
+		*arena = reset;
+		return peak;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3poolCreate(a3_Pool *pool_out, const a3ui32 blockSize, const a3ui32 blocksPerChunk)
+{
+	a3_Pool ret = { 0 };
+	if (pool_out && blockSize && blocksPerChunk)
+	{
+		if (!pool_out->chunk)
+		{
+			// blocks hold the free list link while unused
+			ret.allocator->allocFunc = a3poolInternalAllocFunc;
+			ret.allocator->freeFunc = a3poolInternalFreeFunc;
+			ret.blockSize = a3allocatorInternalAlign(blockSize > sizeof(void *) ? blockSize : sizeof(void *));
+			ret.blocksPerChunk = blocksPerChunk;
+			if (a3poolInternalAddChunk(&ret))
+			{
+				*pool_out = ret;
+				return ret.blocksPerChunk;
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+void *a3poolAlloc(a3_Pool *pool)
+{
+	void *ret;
+	if (pool && pool->chunk)
+	{
+		if (pool->freeList || a3poolInternalAddChunk(pool))
+		{
+			ret = pool->freeList;
+			pool->freeList = *(void **)ret;
+			++pool->count;
+			return ret;
+		}
+	}
+	return 0;
+}
+
+a3ret a3poolFree(a3_Pool *pool, void *block)
+{
+	if (pool && pool->chunk && block && pool->count)
+	{
+		*(void **)block = pool->freeList;
+		pool->freeList = block;
+		return --pool->count;
+	}
+	return -1;
+}
+
+a3ret a3poolRelease(a3_Pool *pool)
+{
+	const a3_Pool reset = { 0 };
+	a3ui32 count;
+	if (pool && pool->chunk)
+	{
+		count = pool->count;
+		a3allocatorInternalFreeChain((a3_AllocatorHeader *)pool->chunk);
+		*pool = reset;
+		return count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
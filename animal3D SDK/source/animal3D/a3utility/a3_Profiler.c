@@ -0,0 +1,304 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_Profiler.c
+	Profiler implementation.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "animal3D/a3utility/a3_Profiler.h"
+#include "animal3D/a3utility/a3_Timer.h"
+#include "animal3D/a3utility/a3_Thread.h"
+
+#include <stdio.h>
+
+
+#if (defined _WINDOWS || defined _WIN32)
+#include <Windows.h>
+#define A3_THREAD_LOCAL						__declspec(thread)
+#define a3profilerInternalBarrier()			MemoryBarrier()
+#define a3profilerInternalIncrement(p)		InterlockedIncrement((volatile LONG *)(p))
+#define a3profilerInternalClaim(p)			(InterlockedCompareExchange((volatile LONG *)(p), 1, 0) == 0)
+#else	// !(defined _WINDOWS || defined _WIN32)
+#define A3_THREAD_LOCAL						__thread
+#define a3profilerInternalBarrier()			__sync_synchronize()
+#define a3profilerInternalIncrement(p)		__sync_add_and_fetch(p, 1)
+#define a3profilerInternalClaim(p)			__sync_bool_compare_and_swap(p, 0, 1)
+#endif	// (defined _WINDOWS || defined _WIN32)
+
+
+//-----------------------------------------------------------------------------
+// internal types and state
+
+// completed zone
+typedef struct a3_ProfileEvent
+{
+	const a3byte *name;
+	a3i64 start, end;
+} a3_ProfileEvent;
+
+// single-producer, single-consumer ring: the owning thread only writes
+//	events and advances head, the flushing thread only reads events and
+//	advances tail, so no locks are needed; a ring is released when its
+//	thread exits and claimed again by another once it is empty; writing 
+//	is raised by the owner while it may store an event, so that ending a 
+//	capture can wait for writers that saw it still running
+typedef struct a3_ProfileRing
+{
+	a3_ProfileEvent event[a3profiler_eventMax];
+	volatile a3ui32 head, tail;
+	volatile a3i32 owned, writing;
+	a3ui32 threadID;
+	a3ui32 dropped;
+} a3_ProfileRing;
+
+// profiler state
+static a3_ProfileRing a3profilerRing[a3profiler_threadMax];
+static volatile a3i32 a3profilerRingCount;
+static A3_THREAD_LOCAL a3_ProfileRing *a3profilerThreadRing;
+static A3_THREAD_LOCAL a3boolean a3profilerThreadRegistered;
+static volatile a3boolean a3profilerCapturing;
+static FILE *a3profilerFile;
+static a3i64 a3profilerOrigin, a3profilerFrequency;
+static a3ui32 a3profilerWritten;
+
+
+// internal get ID utility
+a3ret a3threadInternalGetID();
+
+// get or claim the calling thread's ring: first one released by a thread
+//	that exited whose zones are all written, otherwise a new one
+static inline a3_ProfileRing *a3profilerInternalGetRing()
+{
+	a3_ProfileRing *ring;
+	a3i32 i, n;
+	if (!a3profilerThreadRegistered)
+	{
+		a3profilerThreadRegistered = 1;
+		n = a3profilerRingCount < a3profiler_threadMax ? a3profilerRingCount : a3profiler_threadMax;
+		for (i = 0, ring = a3profilerRing; i < n; ++i, ++ring)
+			if (!ring->owned && ring->tail == ring->head && a3profilerInternalClaim(&ring->owned))
+			{
+				a3profilerThreadRing = ring;
+				break;
+			}
+		if (!a3profilerThreadRing)
+		{
+			i = a3profilerInternalIncrement(&a3profilerRingCount) - 1;
+			if (i < a3profiler_threadMax)
+			{
+				a3profilerThreadRing = a3profilerRing + i;
+				a3profilerThreadRing->owned = 1;
+			}
+			else
+				printf("\n A3 Warning: Profiler thread limit (%d) reached; zones on this thread are ignored.", a3profiler_threadMax);
+		}
+		if (a3profilerThreadRing)
+			a3profilerThreadRing->threadID = (a3ui32)a3threadInternalGetID();
+	}
+	return a3profilerThreadRing;
+}
+
+// release the calling thread's ring when it exits, so that threads
+//	launched later can use it once its zones are written
+void a3profilerInternalReleaseThread()
+{
+	if (a3profilerThreadRing)
+	{
+		a3profilerInternalBarrier();
+		a3profilerThreadRing->owned = 0;
+		a3profilerThreadRing = 0;
+	}
+	a3profilerThreadRegistered = 0;
+}
+
+// write all events in ring
+static inline a3ui32 a3profilerInternalFlushRing(a3_ProfileRing *ring)
+{
+	const a3f64 usPerCount = 1000000.0 / (a3f64)a3profilerFrequency;
+	const a3_ProfileEvent *e;
+	a3ui32 tail = ring->tail, head = ring->head, count = 0;
+
+	// make sure event data is visible before reading it
+	a3profilerInternalBarrier();
+	for (; tail != head; ++tail, ++count)
+	{
+		e = ring->event + (tail & (a3profiler_eventMax - 1));
+		fprintf(a3profilerFile, "%s\n{\"name\":\"%s\",\"cat\":\"a3\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+			(a3profilerWritten++ ? "," : ""), e->name, ring->threadID,
+			(a3f64)(e->start - a3profilerOrigin) * usPerCount, (a3f64)(e->end - e->start) * usPerCount);
+	}
+
+	// release slots only after reading
+	a3profilerInternalBarrier();
+	ring->tail = tail;
+	return count;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3profilerBeginCapture(const a3byte *filePath)
+{
+	a3i32 i, n;
+	if (filePath)
+	{
+		if (!a3profilerCapturing)
+		{
+			a3profilerFile = fopen(filePath, "w");
+			if (a3profilerFile)
+			{
+				// discard anything left from a previous capture
+				n = a3profilerRingCount < a3profiler_threadMax ? a3profilerRingCount : a3profiler_threadMax;
+				for (i = 0; i < n; ++i)
+				{
+					a3profilerRing[i].tail = a3profilerRing[i].head;
+					a3profilerRing[i].dropped = 0;
+				}
+
+				fprintf(a3profilerFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+				a3profilerWritten = 0;
+				a3timerGetCounter(&a3profilerOrigin, &a3profilerFrequency);
+				a3profilerInternalBarrier();
+				a3profilerCapturing = 1;
+				return 1;
+			}
+			printf("\n A3 ERROR: Profiler could not open trace file \'%s\'.", filePath);
+		}
+		return 0;
+	}
+	return -1;
+}
+
+a3ret a3profilerFlush()
+{
+	a3i32 i, n;
+	a3ui32 count = 0;
+	if (a3profilerCapturing)
+	{
+		n = a3profilerRingCount < a3profiler_threadMax ? a3profilerRingCount : a3profiler_threadMax;
+		for (i = 0; i < n; ++i)
+			count += a3profilerInternalFlushRing(a3profilerRing + i);
+		return count;
+	}
+	return 0;
+}
+
+a3ret a3profilerEndCapture()
+{
+	a3i32 i, n;
+	a3ui32 dropped = 0;
+	if (a3profilerCapturing)
+	{
+		// stop recording, wait for threads still storing a zone, then 
+		//	write what is left
+		a3profilerCapturing = 0;
+		a3profilerInternalBarrier();
+		n = a3profilerRingCount < a3profiler_threadMax ? a3profilerRingCount : a3profiler_threadMax;
+		for (i = 0; i < n; ++i)
+		{
+			while (a3profilerRing[i].writing)
+				a3profilerInternalBarrier();
+			a3profilerInternalFlushRing(a3profilerRing + i);
+			dropped += a3profilerRing[i].dropped;
+		}
+		fprintf(a3profilerFile, "\n]}\n");
+		fclose(a3profilerFile);
+		a3profilerFile = 0;
+
+		if (dropped)
+			printf("\n A3 Warning: Profiler dropped %u zones; flush more often.", dropped);
+		return a3profilerWritten;
+	}
+	return 0;
+}
+
+a3ret a3profilerIsCapturing()
+{
+	return a3profilerCapturing;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3profileZoneBegin(a3_ProfileZone *zone, const a3byte *name)
+{
+	if (zone && name)
+	{
+		if (a3profilerCapturing)
+		{
+			zone->name = name;
+			a3timerGetCounter(&zone->start, 0);
+			return 1;
+		}
+		zone->name = 0;
+		return 0;
+	}
+	return -1;
+}
+
+a3ret a3profileZoneEnd(a3_ProfileZone *zone)
+{
+	a3_ProfileRing *ring;
+	a3_ProfileEvent *e;
+	a3ui32 head;
+	if (zone)
+	{
+		if (zone->name && a3profilerCapturing)
+		{
+			ring = a3profilerInternalGetRing();
+			if (ring)
+			{
+				// announce the write before checking again, so that either 
+				//	this sees the capture ended or the end waits for this
+				ring->writing = 1;
+				a3profilerInternalBarrier();
+				if (a3profilerCapturing)
+				{
+					head = ring->head;
+					if (head - ring->tail < a3profiler_eventMax)
+					{
+						e = ring->event + (head & (a3profiler_eventMax - 1));
+						e->name = zone->name;
+						e->start = zone->start;
+						a3timerGetCounter(&e->end, 0);
+
+						// publish event only after it is written
+						a3profilerInternalBarrier();
+						ring->head = head + 1;
+						ring->writing = 0;
+						zone->name = 0;
+						return 1;
+					}
+					++ring->dropped;
+				}
+				a3profilerInternalBarrier();
+				ring->writing = 0;
+			}
+		}
+		zone->name = 0;
+		return 0;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,286 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_Serializer.c
+	Chunked serialization implementation.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "animal3D/a3utility/a3_Serializer.h"
+#include "animal3D/a3/a3macros.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+// internal types
+
+// tag of created serializer ("A3SZ")
+#define A3_SERIALIZER_TAG	0x5A533341u
+
+// saved field description, stored at the start of chunk data
+typedef struct a3_SerializerInternalField
+{
+	a3byte name[a3serializer_nameMax];
+	a3ui32 size, offset;
+} a3_SerializerInternalField;
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// FNV-1a, continued from previous hash
+inline a3ui64 a3serializerInternalHash(a3ui64 hash, const void *data, a3ui32 size)
+{
+	const a3ubyte *itr = (const a3ubyte *)data, *const end = itr + size;
+	while (itr < end)
+		hash = (hash ^ *(itr++)) * 0x100000001B3ull;
+	return hash;
+}
+
+inline a3ui64 a3serializerInternalLayout(const a3_SerializerSection *section)
+{
+	a3ui64 hash = 0xCBF29CE484222325ull;
+	const a3_SerializerField *field = section->fieldList, *const end = field + section->fieldCount;
+	hash = a3serializerInternalHash(hash, &section->version, sizeof(section->version));
+	for (; field < end; ++field)
+	{
+		hash = a3serializerInternalHash(hash, field->name, (a3ui32)strlen(field->name) + 1);
+		hash = a3serializerInternalHash(hash, &field->size, sizeof(field->size));
+	}
+	return hash;
+}
+
+inline a3ui64 a3serializerInternalContents(const a3_SerializerSection *section, const a3ubyte *object)
+{
+	a3ui64 hash = 0xCBF29CE484222325ull;
+	const a3_SerializerField *field = section->fieldList, *const end = field + section->fieldCount;
+	for (; field < end; ++field)
+		hash = a3serializerInternalHash(hash, object + field->offset, field->size);
+	return hash;
+}
+
+inline a3_SerializerChunk const *a3serializerInternalFind(const a3_Serializer *serializer, const a3byte *name)
+{
+	a3_SerializerChunk const *chunk = serializer->chunk, *const end = chunk + serializer->chunkCount;
+	for (; chunk < end; ++chunk)
+		if (!strncmp(chunk->name, name, a3serializer_nameMax - 1))
+			return chunk;
+	return 0;
+}
+
+inline a3_SerializerInternalField const *a3serializerInternalFindField(const a3_SerializerChunk *chunk, const a3byte *name)
+{
+	a3_SerializerInternalField const *field = (a3_SerializerInternalField const *)chunk->data, *const end = field + chunk->fieldCount;
+	for (; field < end; ++field)
+		if (!strncmp(field->name, name, a3serializer_nameMax - 1))
+			return field;
+	return 0;
+}
+
+// write section to chunk, replacing previous contents
+inline a3boolean a3serializerInternalWrite(a3_SerializerChunk *chunk, const a3_SerializerSection *section, const a3ubyte *object, const a3ui64 layout, const a3ui64 hash)
+{
+	a3_SerializerInternalField *saved;
+	const a3_SerializerField *field = section->fieldList, *const end = field + section->fieldCount;
+	a3ui32 size = section->fieldCount * sizeof(a3_SerializerInternalField);
+	a3ubyte *data;
+	for (; field < end; ++field)
+		size += field->size;
+
+	// reuse block if the size did not change
+	data = (a3ubyte *)chunk->data;
+	if (size != chunk->size)
+	{
+		data = (a3ubyte *)realloc(chunk->data, size ? size : 1);
+		if (!data)
+			return a3false;
+		chunk->data = data;
+		chunk->size = size;
+	}
+
+	// descriptions, then contents
+	saved = (a3_SerializerInternalField *)data;
+	data += section->fieldCount * sizeof(a3_SerializerInternalField);
+	for (field = section->fieldList; field < end; ++field, ++saved)
+	{
+		memset(saved->name, 0, sizeof(saved->name));
+		strncpy(saved->name, field->name, a3serializer_nameMax - 1);
+		saved->size = field->size;
+		saved->offset = (a3ui32)(data - (a3ubyte *)chunk->data);
+		memcpy(data, object + field->offset, field->size);
+		data += field->size;
+	}
+	memset(chunk->name, 0, sizeof(chunk->name));
+	strncpy(chunk->name, section->name, a3serializer_nameMax - 1);
+	chunk->version = section->version;
+	chunk->fieldCount = section->fieldCount;
+	chunk->layout = layout;
+	chunk->hash = hash;
+	return a3true;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3serializerCreate(a3_Serializer *serializer_out)
+{
+	if (serializer_out)
+	{
+		if (serializer_out->tag != A3_SERIALIZER_TAG)
+		{
+			memset(serializer_out, 0, sizeof(a3_Serializer));
+			serializer_out->tag = A3_SERIALIZER_TAG;
+			return 1;
+		}
+	}
+	return -1;
+}
+
+a3ret a3serializerCheck(const void *ptr)
+{
+	if (ptr)
+		return (((const a3_Serializer *)ptr)->tag == A3_SERIALIZER_TAG);
+	return -1;
+}
+
+a3ret a3serializerSave(a3_Serializer *serializer, const void *object, const a3_SerializerSection *sectionList, const a3ui32 count)
+{
+	a3_SerializerChunk *chunk;
+	const a3_SerializerSection *section, *const end = sectionList + count;
+	a3ui64 layout, hash;
+	a3ret result = 0;
+
+	if (serializer && serializer->tag == A3_SERIALIZER_TAG && object && sectionList)
+	{
+		for (section = sectionList; section < end; ++section)
+		{
+			layout = a3serializerInternalLayout(section);
+			hash = a3serializerInternalContents(section, (const a3ubyte *)object);
+			chunk = (a3_SerializerChunk *)a3serializerInternalFind(serializer, section->name);
+			if (!chunk)
+			{
+				if (serializer->chunkCount >= a3serializer_chunkMax)
+				{
+					printf("\n A3 ERROR: Serializer is full; section '%s' not saved.", section->name);
+					continue;
+				}
+				chunk = serializer->chunk + serializer->chunkCount++;
+			}
+
+			// unchanged since last save
+			else if (chunk->layout == layout && chunk->hash == hash)
+				continue;
+
+			if (a3serializerInternalWrite(chunk, section, (const a3ubyte *)object, layout, hash))
+				++result;
+			else
+				printf("\n A3 ERROR: Could not allocate section '%s'.", section->name);
+		}
+		return result;
+	}
+	return -1;
+}
+
+a3ret a3serializerLoad(const a3_Serializer *serializer, void *object, const a3_SerializerSection *sectionList, const a3ui32 count, a3boolean *sectionRestored_out_opt)
+{
+	a3_SerializerChunk const *chunk;
+	a3_SerializerInternalField const *saved;
+	const a3_SerializerSection *section, *const end = sectionList + count;
+	const a3_SerializerField *field, *fieldEnd;
+	a3ubyte *const dst = (a3ubyte *)object;
+	a3ubyte const *data;
+	a3ui32 restored;
+	a3ret result = 0;
+
+	if (serializer && serializer->tag == A3_SERIALIZER_TAG && object && sectionList)
+	{
+		for (section = sectionList; section < end; ++section)
+		{
+			restored = 0;
+			chunk = a3serializerInternalFind(serializer, section->name);
+			if (chunk)
+			{
+				data = (a3ubyte const *)chunk->data;
+				fieldEnd = section->fieldList + section->fieldCount;
+
+				// same layout: every field can be copied directly
+				if (chunk->layout == a3serializerInternalLayout(section))
+					for (field = section->fieldList, saved = (a3_SerializerInternalField const *)data; field < fieldEnd; ++field, ++saved, ++restored)
+						memcpy(dst + field->offset, data + saved->offset, field->size);
+
+				// different layout: match fields by name and migrate those
+				//	whose size or version changed
+				else for (field = section->fieldList; field < fieldEnd; ++field)
+				{
+					saved = a3serializerInternalFindField(chunk, field->name);
+					if (!saved)
+						continue;
+					if (chunk->version == section->version && saved->size == field->size)
+					{
+						memcpy(dst + field->offset, data + saved->offset, field->size);
+						++restored;
+					}
+					else if (section->migrate_opt && section->migrate_opt(object, field, chunk->version, data + saved->offset, saved->size) > 0)
+						++restored;
+				}
+			}
+			if (restored == section->fieldCount)
+				++result;
+			if (sectionRestored_out_opt)
+				sectionRestored_out_opt[section - sectionList] = (restored == section->fieldCount);
+		}
+		return result;
+	}
+	return -1;
+}
+
+a3ret a3serializerClear(void *object, const a3_SerializerSection *section)
+{
+	const a3_SerializerField *field, *end;
+	if (object && section)
+	{
+		for (field = section->fieldList, end = field + section->fieldCount; field < end; ++field)
+			memset((a3ubyte *)object + field->offset, 0, field->size);
+		return section->fieldCount;
+	}
+	return -1;
+}
+
+a3ret a3serializerRelease(a3_Serializer *serializer)
+{
+	a3ret result;
+	a3ui32 i;
+	if (serializer && serializer->tag == A3_SERIALIZER_TAG)
+	{
+		for (i = 0; i < serializer->chunkCount; ++i)
+			free(serializer->chunk[i].data);
+		result = serializer->chunkCount;
+		memset(serializer, 0, sizeof(a3_Serializer));
+		return result;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -25,6 +25,7 @@
 */
 
 #include "animal3D/a3utility/a3_Stream.h"
+#include "animal3D/a3utility/a3_Profiler.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -55,7 +56,7 @@ a3ret a3streamAllocate(a3_Stream *stream_out, const a3ui32 size)
 }
 
 
-a3ret a3streamLoadContents(a3_Stream *stream_out, const a3byte *filePath)
+a3ret a3streamLoadContents(a3_Stream *stream_out, const a3byte *filePath, a3_Allocator *allocator_opt)
 {
 	if (stream_out && filePath && *filePath)
 	{
@@ -63,24 +64,34 @@ a3ret a3streamLoadContents(a3_Stream *stream_out, const a3byte *filePath)
 		{
 			// open file
 			a3_Stream ret = { 0 };
+			a3_ProfileZone zone[1];
 			FILE *fp = fopen(filePath, "rb");
 			if (fp)
 			{
+				a3profileZoneBegin(zone, "a3streamLoadContents");
+
 				// get character count
 				fseek(fp, 0, SEEK_END);
 				ret.length = (a3ui32)ftell(fp);
 				if (ret.length)
 				{
 					// allocate and read from beginning
-					ret.contents = ret.ptr = (a3byte *)malloc(ret.length + 1);
-					rewind(fp);
-					fread(ret.ptr, 1, ret.length, fp);
-					ret.ptr[ret.length] = 0;
-					*stream_out = ret;
+					ret.contents = ret.ptr = (a3byte *)a3allocatorAlloc(allocator_opt, ret.length + 1);
+					ret.allocator = allocator_opt;
+					if (ret.ptr)
+					{
+						rewind(fp);
+						fread(ret.ptr, 1, ret.length, fp);
+						ret.ptr[ret.length] = 0;
+						*stream_out = ret;
+					}
+					else
+						ret.length = 0;
 				}
 
 				// done
 				fclose(fp);
+				a3profileZoneEnd(zone);
 				return ret.length;
 			}
 			return 0;
@@ -89,6 +100,105 @@ a3ret a3streamLoadContents(a3_Stream *stream_out, const a3byte *filePath)
 	return -1;
 }
 
+
+#if (defined _WINDOWS || defined _WIN32)
+#include <Windows.h>
+#else	// !(defined _WINDOWS || defined _WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif	// (defined _WINDOWS || defined _WIN32)
+
+a3ret a3streamMapContents(a3_Stream *stream_out, const a3byte *filePath)
+{
+	a3_Stream ret = { 0 };
+	a3_ProfileZone zone[1];
+	a3ui32 pageSize;
+	void *view = 0;
+	if (stream_out && filePath && *filePath)
+	{
+		if (!stream_out->contents)
+		{
+#if (defined _WINDOWS || defined _WIN32)
+			SYSTEM_INFO info[1];
+			LARGE_INTEGER size[1];
+			HANDLE mapping, file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+			if (file == INVALID_HANDLE_VALUE)
+				return 0;
+			a3profileZoneBegin(zone, "a3streamMapContents");
+			GetSystemInfo(info);
+			pageSize = info->dwPageSize;
+			if (GetFileSizeEx(file, size) && size->QuadPart > 0 && size->QuadPart < 0xffffffff)
+			{
+				// rest of last page reads as zero: free terminator
+				ret.length = (a3ui32)size->QuadPart;
+				if (ret.length % pageSize)
+				{
+					// copy-on-write view; handles can close once mapped
+					mapping = CreateFileMappingA(file, 0, PAGE_WRITECOPY, 0, 0, 0);
+					if (mapping)
+					{
+						view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+						CloseHandle(mapping);
+					}
+				}
+			}
+			CloseHandle(file);
+#else	// !(defined _WINDOWS || defined _WIN32)
+			struct stat info[1];
+			const a3i32 fd = open(filePath, O_RDONLY);
+			if (fd < 0)
+				return 0;
+			a3profileZoneBegin(zone, "a3streamMapContents");
+			pageSize = (a3ui32)sysconf(_SC_PAGESIZE);
+			if (fstat(fd, info) == 0 && info->st_size > 0 && info->st_size < 0xffffffff)
+			{
+				// rest of last page reads as zero: free terminator
+				ret.length = (a3ui32)info->st_size;
+				if (ret.length % pageSize)
+				{
+					// copy-on-write view; descriptor can close once mapped
+					view = mmap(0, ret.length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+					if (view != MAP_FAILED)
+					{
+						madvise(view, ret.length, MADV_SEQUENTIAL);
+						madvise(view, ret.length, MADV_WILLNEED);
+					}
+					else
+						view = 0;
+				}
+			}
+			close(fd);
+#endif	// (defined _WINDOWS || defined _WIN32)
+			a3profileZoneEnd(zone);
+
+			if (view)
+			{
+				ret.contents = ret.ptr = (a3byte *)view;
+				ret.mapped = 1;
+				*stream_out = ret;
+				return ret.length;
+			}
+
+			// could not map: copy
+			return a3streamLoadContents(stream_out, filePath, 0);
+		}
+	}
+	return -1;
+}
+
+// unmap contents
+inline void a3streamInternalUnmap(const a3_Stream *stream)
+{
+#if (defined _WINDOWS || defined _WIN32)
+	UnmapViewOfFile(stream->contents);
+#else	// !(defined _WINDOWS || defined _WIN32)
+	munmap((void *)stream->contents, stream->length);
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+
 a3ret a3streamSaveContents(const a3_Stream *stream, const a3byte *filePath)
 {
 	if (stream && filePath && *filePath)
@@ -163,9 +273,14 @@ a3ret a3streamReleaseContents(a3_Stream *stream)
 	if (stream && stream->contents)
 	{
 		const a3ui32 length = stream->length;
-		free((a3byte *)stream->contents);
+		if (stream->mapped)
+			a3streamInternalUnmap(stream);
+		else
+			a3allocatorFree(stream->allocator, (a3byte *)stream->contents);
 		stream->contents = stream->ptr = 0;
 		stream->length = stream->offset = 0;
+		stream->allocator = 0;
+		stream->mapped = 0;
 		return length;
 	}
 	return -1;
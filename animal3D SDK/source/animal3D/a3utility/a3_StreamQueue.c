@@ -0,0 +1,686 @@
+/*
+	Copyright 2011-2021 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_StreamQueue.c
+	Asynchronous file reading implementation.
+
+	**DO NOT MODIFY THIS FILE**
+*/
+
+#include "animal3D/a3utility/a3_StreamQueue.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+#if (defined _WINDOWS || defined _WIN32)
+#include <Windows.h>
+#else	// !(defined _WINDOWS || defined _WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if (defined __linux__ && defined __has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#ifdef __NR_io_uring_setup
+#define A3_STREAMQUEUE_RING
+#endif	// __NR_io_uring_setup
+#endif	// __has_include(<linux/io_uring.h>)
+#endif	// (defined __linux__ && defined __has_include)
+#endif	// (defined _WINDOWS || defined _WIN32)
+
+
+//-----------------------------------------------------------------------------
+// internal types
+
+#ifdef A3_STREAMQUEUE_RING
+// io_uring submission and completion rings, mapped from the kernel
+typedef struct a3_StreamQueueRing
+{
+	a3i32 fd;
+	a3ui32 entries;
+	a3ui32 *sqHead, *sqTail, *sqMask, *sqArray;
+	a3ui32 *cqHead, *cqTail, *cqMask;
+	struct io_uring_sqe *sqe;
+	struct io_uring_cqe *cqe;
+	void *sqMap, *cqMap;
+	size_t sqMapSize, cqMapSize, sqeMapSize;
+} a3_StreamQueueRing;
+
+// number of reads in flight at once
+enum a3_StreamQueueRingSize
+{
+	a3streamqueue_ringSize = 64,
+};
+#endif	// A3_STREAMQUEUE_RING
+
+// queue state shared with I/O thread
+typedef struct a3_StreamQueueInternal
+{
+#if (defined _WINDOWS || defined _WIN32)
+	CRITICAL_SECTION lock[1];
+	CONDITION_VARIABLE signal[1];
+#else	// !(defined _WINDOWS || defined _WIN32)
+	pthread_mutex_t lock[1];
+	pthread_cond_t signal[1];
+#endif	// (defined _WINDOWS || defined _WIN32)
+	a3_StreamRequest *submitted;
+	a3_StreamRequest *completed;
+	a3ui32 pending;
+	a3ui32 served;
+	a3boolean stop;
+#ifdef A3_STREAMQUEUE_RING
+	a3_StreamQueueRing ring[1];
+#endif	// A3_STREAMQUEUE_RING
+} a3_StreamQueueInternal;
+
+
+//-----------------------------------------------------------------------------
+// internal utilities
+
+// platform lock and signal; one signal wakes both the I/O thread and
+//	anyone waiting, so always broadcast
+inline void a3streamQueueInternalCreateLock(a3_StreamQueueInternal *q)
+{
+#if (defined _WINDOWS || defined _WIN32)
+	InitializeCriticalSection(q->lock);
+	InitializeConditionVariable(q->signal);
+#else	// !(defined _WINDOWS || defined _WIN32)
+	pthread_mutex_init(q->lock, 0);
+	pthread_cond_init(q->signal, 0);
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+inline void a3streamQueueInternalReleaseLock(a3_StreamQueueInternal *q)
+{
+#if (defined _WINDOWS || defined _WIN32)
+	DeleteCriticalSection(q->lock);
+#else	// !(defined _WINDOWS || defined _WIN32)
+	pthread_cond_destroy(q->signal);
+	pthread_mutex_destroy(q->lock);
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+inline void a3streamQueueInternalLock(a3_StreamQueueInternal *q)
+{
+#if (defined _WINDOWS || defined _WIN32)
+	EnterCriticalSection(q->lock);
+#else	// !(defined _WINDOWS || defined _WIN32)
+	pthread_mutex_lock(q->lock);
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+inline void a3streamQueueInternalUnlock(a3_StreamQueueInternal *q)
+{
+#if (defined _WINDOWS || defined _WIN32)
+	LeaveCriticalSection(q->lock);
+#else	// !(defined _WINDOWS || defined _WIN32)
+	pthread_mutex_unlock(q->lock);
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+inline void a3streamQueueInternalWait(a3_StreamQueueInternal *q)
+{
+#if (defined _WINDOWS || defined _WIN32)
+	SleepConditionVariableCS(q->signal, q->lock, INFINITE);
+#else	// !(defined _WINDOWS || defined _WIN32)
+	pthread_cond_wait(q->signal, q->lock);
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+inline void a3streamQueueInternalSignal(a3_StreamQueueInternal *q)
+{
+#if (defined _WINDOWS || defined _WIN32)
+	WakeAllConditionVariable(q->signal);
+#else	// !(defined _WINDOWS || defined _WIN32)
+	pthread_cond_broadcast(q->signal);
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+
+// reverse linked list of requests (lists are built newest first)
+inline a3_StreamRequest *a3streamQueueInternalReverse(a3_StreamRequest *request)
+{
+	a3_StreamRequest *ret = 0, *next;
+	for (; request; request = next)
+	{
+		next = request->next;
+		request->next = ret;
+		ret = request;
+	}
+	return ret;
+}
+
+// mark request done and hand it to poll if it has a callback; the
+//	request must not be touched after it is marked done
+inline void a3streamQueueInternalComplete(a3_StreamQueueInternal *q, a3_StreamRequest *request)
+{
+	a3streamQueueInternalLock(q);
+	--q->pending;
+	++q->served;
+	if (request->callback)
+	{
+		request->next = q->completed;
+		q->completed = request;
+	}
+
+	// publish results before raising flag
+	a3atomicBarrier();
+	request->done = 1;
+	a3streamQueueInternalSignal(q);
+	a3streamQueueInternalUnlock(q);
+}
+
+// blocking read on the I/O thread
+inline void a3streamQueueInternalRead(a3_StreamRequest *request)
+{
+	a3_FileStream fs[1] = { 0 };
+	request->result = 0;
+	if (request->readFunc)
+	{
+		if (a3fileStreamOpenRead(fs, request->filePath) > 0)
+		{
+			request->result = a3fileStreamReadObject(fs, request->object, request->readFunc);
+			a3fileStreamClose(fs);
+		}
+	}
+	else
+		request->result = a3streamLoadContents(request->stream, request->filePath, 0);
+	if (request->result < 0)
+		request->result = 0;
+}
+
+// submit request to queue
+inline a3ret a3streamQueueInternalSubmit(a3_StreamQueue *queue, a3_StreamRequest *request, const a3byte *filePath, void *object, const a3_FileStreamReadFunc streamReadFunc, a3_StreamRequestFunc callback_opt, void *user_opt)
+{
+	a3_StreamQueueInternal *const q = (a3_StreamQueueInternal *)queue->internal;
+	a3_StreamRequest ret = { 0 };
+	ret.filePath = filePath;
+	ret.object = object;
+	ret.readFunc = streamReadFunc;
+	ret.callback = callback_opt;
+	ret.user = user_opt;
+	ret.file = -1;
+	*request = ret;
+
+	a3streamQueueInternalLock(q);
+	request->next = q->submitted;
+	q->submitted = request;
+	++q->pending;
+	a3streamQueueInternalSignal(q);
+	a3streamQueueInternalUnlock(q);
+	return 1;
+}
+
+
+#ifdef A3_STREAMQUEUE_RING
+// set up io_uring; fails quietly on kernels (or sandboxes) without it
+inline a3boolean a3streamQueueInternalRingCreate(a3_StreamQueueRing *ring)
+{
+	struct io_uring_params params[1] = { 0 };
+	a3byte *sq, *cq;
+	ring->fd = (a3i32)syscall(__NR_io_uring_setup, a3streamqueue_ringSize, params);
+	if (ring->fd < 0)
+		return 0;
+
+	// newer kernels share one mapping for both rings
+	ring->sqMapSize = params->sq_off.array + params->sq_entries * sizeof(a3ui32);
+	ring->cqMapSize = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+	if ((params->features & IORING_FEAT_SINGLE_MMAP) && ring->sqMapSize < ring->cqMapSize)
+		ring->sqMapSize = ring->cqMapSize;
+	ring->sqeMapSize = params->sq_entries * sizeof(struct io_uring_sqe);
+	sq = (a3byte *)mmap(0, ring->sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+	cq = (params->features & IORING_FEAT_SINGLE_MMAP) ? sq : (a3byte *)mmap(0, ring->cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+	ring->sqe = (struct io_uring_sqe *)mmap(0, ring->sqeMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+	ring->sqMap = sq;
+	ring->cqMap = cq;
+	if (sq == MAP_FAILED || cq == MAP_FAILED || ring->sqe == MAP_FAILED)
+	{
+		if (ring->sqe != MAP_FAILED)
+			munmap(ring->sqe, ring->sqeMapSize);
+		if (cq != MAP_FAILED && cq != sq)
+			munmap(cq, ring->cqMapSize);
+		if (sq != MAP_FAILED)
+			munmap(sq, ring->sqMapSize);
+		close(ring->fd);
+		ring->fd = -1;
+		return 0;
+	}
+
+	ring->entries = params->sq_entries;
+	ring->sqHead = (a3ui32 *)(sq + params->sq_off.head);
+	ring->sqTail = (a3ui32 *)(sq + params->sq_off.tail);
+	ring->sqMask = (a3ui32 *)(sq + params->sq_off.ring_mask);
+	ring->sqArray = (a3ui32 *)(sq + params->sq_off.array);
+	ring->cqHead = (a3ui32 *)(cq + params->cq_off.head);
+	ring->cqTail = (a3ui32 *)(cq + params->cq_off.tail);
+	ring->cqMask = (a3ui32 *)(cq + params->cq_off.ring_mask);
+	ring->cqe = (struct io_uring_cqe *)(cq + params->cq_off.cqes);
+	return 1;
+}
+
+inline void a3streamQueueInternalRingRelease(a3_StreamQueueRing *ring)
+{
+	if (ring->fd >= 0)
+	{
+		munmap(ring->sqe, ring->sqeMapSize);
+		if (ring->cqMap != ring->sqMap)
+			munmap(ring->cqMap, ring->cqMapSize);
+		munmap(ring->sqMap, ring->sqMapSize);
+		close(ring->fd);
+		ring->fd = -1;
+	}
+}
+
+// open file and allocate contents for a ring read
+inline a3boolean a3streamQueueInternalRingOpen(a3_StreamRequest *request)
+{
+	const a3_Stream reset = { 0 };
+	struct stat info[1];
+	request->file = open(request->filePath, O_RDONLY);
+	if (request->file >= 0)
+	{
+		if (fstat(request->file, info) == 0 && info->st_size > 0 && info->st_size < 0xffffffff)
+		{
+			request->stream->length = (a3ui32)info->st_size;
+			request->stream->contents = request->stream->ptr = (a3byte *)malloc(request->stream->length + 1);
+			if (request->stream->contents)
+			{
+				// offset tracks bytes read until done
+				request->stream->offset = 0;
+				return 1;
+			}
+		}
+		close(request->file);
+		request->file = -1;
+	}
+	*request->stream = reset;
+	return 0;
+}
+
+// queue read of the rest of the file; caller guarantees a free slot
+inline void a3streamQueueInternalRingPush(a3_StreamQueueRing *ring, a3_StreamRequest *request)
+{
+	const a3ui32 tail = *ring->sqTail, index = tail & *ring->sqMask;
+	struct io_uring_sqe *const sqe = ring->sqe + index;
+	const struct io_uring_sqe reset = { 0 };
+	*sqe = reset;
+	sqe->opcode = IORING_OP_READ;
+	sqe->fd = request->file;
+	sqe->off = request->stream->offset;
+	sqe->addr = (a3ui64)(request->stream->ptr + request->stream->offset);
+	sqe->len = request->stream->length - request->stream->offset;
+	sqe->user_data = (a3ui64)request;
+	ring->sqArray[index] = index;
+
+	// entry must be visible before kernel sees new tail
+	a3atomicBarrier();
+	*ring->sqTail = tail + 1;
+}
+
+// finish ring read
+inline void a3streamQueueInternalRingFinish(a3_StreamRequest *request, const a3boolean success)
+{
+	const a3_Stream reset = { 0 };
+	close(request->file);
+	request->file = -1;
+	if (success)
+	{
+		request->stream->ptr[request->stream->length] = 0;
+		request->stream->offset = 0;
+		request->result = request->stream->length;
+	}
+	else
+	{
+		free(request->stream->ptr);
+		*request->stream = reset;
+		request->result = 0;
+	}
+}
+
+// read batch through ring; object reads and files that cannot be opened 
+//	are handled immediately; if the ring stops working, reads the kernel 
+//	has not taken are done normally, the rest are drained, and the ring 
+//	is released so that later batches use normal reads
+inline a3ui32 a3streamQueueInternalRingRead(a3_StreamQueue *queue, a3_StreamQueueInternal *q, a3_StreamRequest *batch)
+{
+	a3_StreamQueueRing *const ring = q->ring;
+	a3_StreamRequest *request;
+	const struct io_uring_cqe *cqe;
+	a3ui32 inFlight = 0, toSubmit = 0, count = 0, head, tail;
+	a3boolean failed = 0;
+	a3i32 result;
+
+	while (batch || inFlight)
+	{
+		// fill ring
+		while (batch && !failed && inFlight < ring->entries)
+		{
+			request = batch;
+			batch = batch->next;
+			if (!request->readFunc && a3streamQueueInternalRingOpen(request))
+			{
+				a3streamQueueInternalRingPush(ring, request);
+				++inFlight;
+				++toSubmit;
+			}
+			else
+			{
+				if (request->readFunc)
+					a3streamQueueInternalRead(request);
+				a3streamQueueInternalComplete(q, request);
+				++count;
+			}
+		}
+
+		// ring failed: everything not in the kernel is read normally
+		while (batch && failed)
+		{
+			request = batch;
+			batch = batch->next;
+			a3streamQueueInternalRead(request);
+			a3streamQueueInternalComplete(q, request);
+			++count;
+		}
+		if (!inFlight)
+			continue;
+
+		// submit new reads and wait for at least one to finish
+		result = (a3i32)syscall(__NR_io_uring_enter, ring->fd, failed ? 0 : toSubmit, 1, IORING_ENTER_GETEVENTS, 0, 0);
+		if (result >= 0)
+			toSubmit -= (a3ui32)result < toSubmit ? (a3ui32)result : toSubmit;
+		else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+		{
+			if (!failed)
+			{
+				printf("\n A3 ERROR: Stream queue ring failed (%d); reading normally.", errno);
+				failed = 1;
+			}
+
+			// take back entries the kernel has not consumed
+			head = *ring->sqHead;
+			a3atomicBarrier();
+			for (tail = *ring->sqTail; head != tail; ++head)
+			{
+				request = (a3_StreamRequest *)ring->sqe[ring->sqArray[head & *ring->sqMask]].user_data;
+				a3streamQueueInternalRingFinish(request, 0);
+				a3streamQueueInternalRead(request);
+				a3streamQueueInternalComplete(q, request);
+				++count;
+				--inFlight;
+			}
+			*ring->sqTail = head;
+			toSubmit = 0;
+
+			// wait for the kernel to finish the reads it owns
+			if (inFlight && *ring->cqHead == *ring->cqTail)
+				usleep(1000);
+		}
+
+		// handle completions
+		head = *ring->cqHead;
+		a3atomicBarrier();
+		tail = *ring->cqTail;
+		for (; head != tail; ++head)
+		{
+			cqe = ring->cqe + (head & *ring->cqMask);
+			request = (a3_StreamRequest *)cqe->user_data;
+			result = cqe->res;
+			--inFlight;
+			if (result > 0)
+			{
+				// short read: queue the rest
+				request->stream->offset += (a3ui32)result;
+				if (request->stream->offset < request->stream->length && !failed)
+				{
+					a3streamQueueInternalRingPush(ring, request);
+					++inFlight;
+					++toSubmit;
+					continue;
+				}
+				else if (request->stream->offset < request->stream->length)
+				{
+					a3streamQueueInternalRingFinish(request, 0);
+					a3streamQueueInternalRead(request);
+				}
+				else
+					a3streamQueueInternalRingFinish(request, 1);
+			}
+			else if ((result == -EINTR || result == -EAGAIN) && !failed)
+			{
+				a3streamQueueInternalRingPush(ring, request);
+				++inFlight;
+				++toSubmit;
+				continue;
+			}
+			else if (result == 0)
+			{
+				// file shrank since opened
+				request->stream->length = request->stream->offset;
+				a3streamQueueInternalRingFinish(request, request->stream->length > 0);
+			}
+			else
+			{
+				// kernel cannot read this (e.g. no read op): read normally
+				a3streamQueueInternalRingFinish(request, 0);
+				a3streamQueueInternalRead(request);
+			}
+			a3streamQueueInternalComplete(q, request);
+			++count;
+		}
+		a3atomicBarrier();
+		*ring->cqHead = head;
+	}
+
+	// nothing is in flight any more, so the ring can go
+	if (failed)
+	{
+		a3streamQueueInternalRingRelease(ring);
+		queue->ring = 0;
+	}
+	return count;
+}
+#endif	// A3_STREAMQUEUE_RING
+
+
+// I/O thread: serve requests until stopped and nothing is left
+a3ret a3streamQueueInternalThread(a3_StreamQueue *queue)
+{
+	a3_StreamQueueInternal *const q = (a3_StreamQueueInternal *)queue->internal;
+	a3_StreamRequest *batch, *request;
+	a3ui32 count = 0;
+	while (1)
+	{
+		// take everything submitted so far
+		a3streamQueueInternalLock(q);
+		while (!q->submitted && !q->stop)
+			a3streamQueueInternalWait(q);
+		batch = a3streamQueueInternalReverse(q->submitted);
+		q->submitted = 0;
+		a3streamQueueInternalUnlock(q);
+		if (!batch)
+			break;
+
+#ifdef A3_STREAMQUEUE_RING
+		if (queue->ring)
+		{
+			count += a3streamQueueInternalRingRead(queue, q, batch);
+			continue;
+		}
+#endif	// A3_STREAMQUEUE_RING
+		while (batch)
+		{
+			request = batch;
+			batch = batch->next;
+			a3streamQueueInternalRead(request);
+			a3streamQueueInternalComplete(q, request);
+			++count;
+		}
+	}
+	return count;
+}
+
+
+//-----------------------------------------------------------------------------
+
+a3ret a3streamQueueCreate(a3_StreamQueue *queue_out)
+{
+	a3_StreamQueueInternal *q;
+	if (queue_out)
+	{
+		if (!queue_out->internal)
+		{
+			q = (a3_StreamQueueInternal *)calloc(1, sizeof(a3_StreamQueueInternal));
+			if (q)
+			{
+				a3streamQueueInternalCreateLock(q);
+				queue_out->internal = q;
+				queue_out->ring = 0;
+#ifdef A3_STREAMQUEUE_RING
+				queue_out->ring = a3streamQueueInternalRingCreate(q->ring);
+#endif	// A3_STREAMQUEUE_RING
+				if (a3threadLaunch(queue_out->thread, (a3_threadfunc)a3streamQueueInternalThread, queue_out, "animal3D stream queue") > 0)
+					return 1;
+
+#ifdef A3_STREAMQUEUE_RING
+				a3streamQueueInternalRingRelease(q->ring);
+#endif	// A3_STREAMQUEUE_RING
+				a3streamQueueInternalReleaseLock(q);
+				free(q);
+				queue_out->internal = 0;
+				printf("\n A3 ERROR: Stream queue could not launch I/O thread.");
+			}
+			return 0;
+		}
+	}
+	return -1;
+}
+
+a3ret a3streamQueueReadContents(a3_StreamQueue *queue, a3_StreamRequest *request, const a3byte *filePath, a3_StreamRequestFunc callback_opt, void *user_opt)
+{
+	if (queue && queue->internal && request && filePath && *filePath)
+	{
+		if (!request->stream->contents)
+			return a3streamQueueInternalSubmit(queue, request, filePath, 0, 0, callback_opt, user_opt);
+	}
+	return -1;
+}
+
+a3ret a3streamQueueReadObject(a3_StreamQueue *queue, a3_StreamRequest *request, const a3byte *filePath, void *object, const a3_FileStreamReadFunc streamReadFunc, a3_StreamRequestFunc callback_opt, void *user_opt)
+{
+	if (queue && queue->internal && request && filePath && *filePath && object && streamReadFunc)
+	{
+		if (!request->stream->contents)
+			return a3streamQueueInternalSubmit(queue, request, filePath, object, streamReadFunc, callback_opt, user_opt);
+	}
+	return -1;
+}
+
+a3ret a3streamRequestIsDone(const a3_StreamRequest *request)
+{
+	if (request)
+	{
+		if (request->done)
+		{
+			// results are read after this
+			a3atomicBarrier();
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+a3ret a3streamQueuePoll(a3_StreamQueue *queue)
+{
+	a3_StreamQueueInternal *q;
+	a3_StreamRequest *request, *next;
+	a3i32 count = 0;
+	if (queue && queue->internal)
+	{
+		q = (a3_StreamQueueInternal *)queue->internal;
+		a3streamQueueInternalLock(q);
+		request = a3streamQueueInternalReverse(q->completed);
+		q->completed = 0;
+		a3streamQueueInternalUnlock(q);
+
+		// callbacks may submit more requests or release this one
+		for (; request; request = next, ++count)
+		{
+			next = request->next;
+			request->next = 0;
+			request->callback(request, request->user);
+		}
+		return count;
+	}
+	return -1;
+}
+
+a3ret a3streamQueueWait(a3_StreamQueue *queue, a3_StreamRequest *request_opt)
+{
+	a3_StreamQueueInternal *q;
+	if (queue && queue->internal)
+	{
+		q = (a3_StreamQueueInternal *)queue->internal;
+		a3streamQueueInternalLock(q);
+		while (request_opt ? !request_opt->done : q->pending)
+			a3streamQueueInternalWait(q);
+		a3streamQueueInternalUnlock(q);
+		return a3streamQueuePoll(queue);
+	}
+	return -1;
+}
+
+a3ret a3streamQueueRelease(a3_StreamQueue *queue)
+{
+	a3_StreamQueueInternal *q;
+	a3ret count;
+	if (queue && queue->internal)
+	{
+		// thread finishes what was submitted before stopping
+		q = (a3_StreamQueueInternal *)queue->internal;
+		a3streamQueueInternalLock(q);
+		q->stop = 1;
+		a3streamQueueInternalSignal(q);
+		a3streamQueueInternalUnlock(q);
+		a3threadWait(queue->thread);
+		a3streamQueuePoll(queue);
+
+#ifdef A3_STREAMQUEUE_RING
+		a3streamQueueInternalRingRelease(q->ring);
+#endif	// A3_STREAMQUEUE_RING
+		a3streamQueueInternalReleaseLock(q);
+		count = q->served;
+		free(q);
+
+		// thread descriptor resets itself when thread exits
+		queue->internal = 0;
+		queue->ring = 0;
+		return count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
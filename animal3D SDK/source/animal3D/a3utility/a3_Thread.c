@@ -33,6 +33,7 @@
 #include <Windows.h>
 #else	// !(defined _WINDOWS || defined _WIN32)
 #include <pthread.h>
+#include <sched.h>
 #include <signal.h>
 #include <sys/types.h>
 #endif	// (defined _WINDOWS || defined _WIN32)
@@ -85,6 +86,10 @@ a3ret a3threadInternalSetName(a3ui32 id, const a3byte *name)
 }
 
 
+// internal profiler release utility
+void a3profilerInternalReleaseThread();
+
+
 // internal thread launcher
 #if (defined _WINDOWS || defined _WIN32)
 a3ui32 __stdcall a3threadInternalLaunch(a3_Thread *thread)
@@ -106,6 +111,9 @@ void *a3threadInternalLaunch(a3_Thread *thread)
 	thread->result = thread->threadFunc(thread->threadArgs);
 	thread->inThreadFunc = 0;
 
+	// give up profiler ring, if any, for threads launched later
+	a3profilerInternalReleaseThread();
+
 	// post-call: lower active flag and invalidate handle(s) to indicate 
 	//	thread is done
 	thread->threadID = 0;
@@ -118,7 +126,7 @@ void *a3threadInternalLaunch(a3_Thread *thread)
 }
 #else	// !(defined _WINDOWS || defined _WIN32)
 	// pop "non-complete flag"
-	return p;
+	return 0;
 }
 #endif	// (defined _WINDOWS || defined _WIN32)
 
@@ -227,3 +235,38 @@ a3ret a3threadInternalGetID()
 	return gettid();
 #endif	// (defined _WINDOWS || defined _WIN32)
 }
+
+
+//-----------------------------------------------------------------------------
+
+// shared counter increment
+a3i32 a3atomicIncrement(volatile a3i32 *counter)
+{
+#if (defined _WINDOWS || defined _WIN32)
+	return InterlockedIncrement((volatile LONG *)counter);
+#else	// !(defined _WINDOWS || defined _WIN32)
+	return __sync_add_and_fetch(counter, 1);
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+
+// memory barrier
+void a3atomicBarrier()
+{
+#if (defined _WINDOWS || defined _WIN32)
+	MemoryBarrier();
+#else	// !(defined _WINDOWS || defined _WIN32)
+	__sync_synchronize();
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
+
+
+// yield time slice
+void a3threadYield()
+{
+#if (defined _WINDOWS || defined _WIN32)
+	SwitchToThread();
+#else	// !(defined _WINDOWS || defined _WIN32)
+	sched_yield();
+#endif	// (defined _WINDOWS || defined _WIN32)
+}
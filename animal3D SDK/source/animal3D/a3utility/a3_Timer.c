@@ -198,3 +198,44 @@ a3ret a3timerUpdate(a3_Timer *timer)
 	}
 	return -1;
 }
+
+
+// step: tick once by the expected delta
+a3ret a3timerStep(a3_Timer *timer)
+{
+	if (timer && timer->secondsPerTick > 0.0)
+	{
+		if (timer->started)
+		{
+			timer->totalTime += timer->secondsPerTick;
+			timer->previousTick = timer->secondsPerTick;
+			timer->currentTick = 0.0;
+			++timer->ticks;
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+
+// read counter
+a3ret a3timerGetCounter(a3i64 *counter_out, a3i64 *frequency_out_opt)
+{
+	if (counter_out)
+	{
+#ifdef _WIN32
+		QueryPerformanceCounter((LARGE_INTEGER *)counter_out);
+		if (frequency_out_opt)
+			QueryPerformanceFrequency((LARGE_INTEGER *)frequency_out_opt);
+#else   // !_WIN32
+		struct timespec t;
+		clock_gettime(CLOCK_MONOTONIC, &t);
+		*counter_out = BILLION*(a3i64)(t.tv_sec) + (a3i64)(t.tv_nsec);
+		if (frequency_out_opt)
+			*frequency_out_opt = BILLION;
+#endif  // _WIN32
+		return 1;
+	}
+	return -1;
+}